@@ -8,7 +8,7 @@ plugins {
     kotlin("jvm") version Versions.kotlin
     with(Plugins.Jgitver) { id(id) version (version) }
     with(Plugins.Shadow) { id(id) version (version) }
-    with(Plugins.Jmh) { id(id) version (version) apply false }
+    with(Plugins.Jmh) { id(id) version (version) }
     `maven-publish`
 }
 
@@ -99,6 +99,21 @@ dependencies {
     testImplementation(Libs.Okio.okio)
 }
 
+// Results are tagged (by the commit, unless `-PbenchmarkTag=...` is given),
+// so that `scripts/compare_benchmarks.R` can compare the runs made on different commits.
+val benchmarkTag: String = findProperty("benchmarkTag") as String?
+    ?: providers.exec {
+        commandLine("git", "rev-parse", "--short", "HEAD")
+        isIgnoreExitValue = true
+    }.standardOutput.asText.get().trim().ifEmpty { "local" }
+
+jmh {
+    jmhVersion = Versions.jmh
+    humanOutputFile = layout.buildDirectory.file("reports/jmh/human-$benchmarkTag.txt").get().asFile
+    resultsFile = layout.buildDirectory.file("reports/jmh/results-$benchmarkTag.json").get().asFile
+    resultFormat = "JSON"
+}
+
 jgitver {
     strategy("MAVEN")
 }
@@ -0,0 +1,42 @@
+package com.github.lipen.satlib.card
+
+import com.github.lipen.satlib.core.Lit
+import com.github.lipen.satlib.core.LitArray
+
+/**
+ * Solver capable of generating cardinality encodings natively, bypassing [addClause][com.github.lipen.satlib.solver.Solver.addClause].
+ *
+ * All encodings return the unary representation of the number of true input literals:
+ * `outputs[i]` is true iff at least `i+1` literals are true.
+ * When `bound` is given, only the first `bound` outputs are encoded,
+ * the last one meaning "at least `bound`".
+ * New variables and clauses are accounted in the solver's `numberOfVariables` and `numberOfClauses`.
+ */
+interface CardinalityEncoder {
+    fun encodeTotalizer(literals: LitArray, bound: Int = literals.size): LitArray
+    fun encodeSequentialCounter(literals: LitArray, bound: Int = literals.size): LitArray
+    fun encodeSortingNetwork(literals: LitArray): LitArray
+
+    /**
+     * Encode the totalizer (up to the [bound]) which can later be [extended][IncrementalTotalizer.extend]
+     * to a larger bound without re-encoding.
+     */
+    fun encodeIncrementalTotalizer(literals: LitArray, bound: Int): IncrementalTotalizer
+}
+
+/**
+ * Totalizer whose bound can be changed without re-encoding.
+ *
+ * Tightening the bound requires no new clauses: just restrict or assume the existing [outputs],
+ * e.g. via [declareComparatorLessThan] or [Cardinality.assumeUpperBoundLessThan].
+ * Loosening the bound beyond the encoded [outputs] requires [extend].
+ */
+interface IncrementalTotalizer : AutoCloseable {
+    val bound: Int
+    val outputs: List<Lit>
+
+    /**
+     * Encode the missing outputs (and only the clauses involving them) up to the [newBound].
+     */
+    fun extend(newBound: Int)
+}
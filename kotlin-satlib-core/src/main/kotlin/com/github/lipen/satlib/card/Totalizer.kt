@@ -2,8 +2,21 @@ package com.github.lipen.satlib.card
 
 import com.github.lipen.satlib.core.Lit
 import com.github.lipen.satlib.solver.Solver
+import com.github.lipen.satlib.utils.toList_
 
+/**
+ * Declare the totalizer over [variables] and return its outputs,
+ * where `outputs[i]` is true iff at least `i+1` variables are true.
+ *
+ * Solvers implementing [CardinalityEncoder] generate the encoding natively.
+ */
 fun Solver.declareTotalizer(variables: Iterable<Lit>): List<Lit> {
+    if (this is CardinalityEncoder) {
+        val literals = variables.toList_().toIntArray()
+        comment("Totalizer(${literals.size})")
+        return encodeTotalizer(literals).asList()
+    }
+
     val queue = ArrayDeque<List<Lit>>()
 
     for (e in variables) {
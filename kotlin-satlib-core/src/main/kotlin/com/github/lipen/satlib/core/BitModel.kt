@@ -0,0 +1,37 @@
+package com.github.lipen.satlib.core
+
+import kotlin.math.absoluteValue
+
+/**
+ * [Model] backed by a bitset: the value of the variable `v` is stored in the `(v-1)`-th bit of [bits].
+ *
+ * Such model takes only `size/8` bytes, and its [data] is a view over the [bits] without any copying.
+ */
+class BitModel(
+    val bits: LongArray,
+    val size: Int,
+) : Model {
+    init {
+        require(size >= 0) { "Size must be non-negative" }
+        require(bits.size.toLong() * 64 >= size) { "Not enough bits (${bits.size} words) for $size variables" }
+    }
+
+    override val data: List<Boolean> = object : AbstractList<Boolean>() {
+        override val size: Int get() = this@BitModel.size
+        override fun get(index: Int): Boolean = bit(index)
+    }
+
+    override fun get(v: Lit): Boolean {
+        // Note: `v` is 1-based, but bits are 0-based.
+        return bit(v.absoluteValue - 1) xor (v < 0)
+    }
+
+    private fun bit(i: Int): Boolean {
+        if (i !in 0 until size) throw IndexOutOfBoundsException("Index $i is out of bounds for size $size")
+        return (bits[i ushr 6] ushr (i and 63)) and 1L != 0L
+    }
+
+    override fun toString(): String {
+        return data.toString()
+    }
+}
@@ -44,6 +44,11 @@ class Context internal constructor(
         return map[key]?.let { it as T }
     }
 
+    /**
+     * Shallow copy of the context: the stored values are shared, but the mapping is independent.
+     */
+    fun copy(): Context = Context(map.toMutableMap())
+
     operator fun <T : Any> invoke(name: String, value: T): T {
         this[name] = value
         return value
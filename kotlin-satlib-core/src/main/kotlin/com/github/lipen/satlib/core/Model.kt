@@ -9,12 +9,29 @@ import com.github.lipen.satlib.utils.Tuple
 import com.github.lipen.satlib.utils.mapValues
 import kotlin.math.absoluteValue
 
-class Model private constructor(
-    /** 0-based storage of values inside model. */
-    val data: List<Boolean>,
-) {
+interface Model {
+    /** 0-based values inside model. */
+    val data: List<Boolean>
+
     /** Retrieve the value of 1-based literal [v]. */
-    operator fun get(v: Lit): Boolean {
+    operator fun get(v: Lit): Boolean
+
+    companion object {
+        fun from(data: List<Boolean>, zerobased: Boolean): Model =
+            if (zerobased) ListModel(data)
+            else ListModel(data.subList(1, data.size))
+
+        fun from(data: BooleanArray, zerobased: Boolean): Model = from(data.asList(), zerobased)
+
+        /** See [BitModel]. */
+        fun fromBits(bits: LongArray, size: Int): Model = BitModel(bits, size)
+    }
+}
+
+private class ListModel(
+    override val data: List<Boolean>,
+) : Model {
+    override fun get(v: Lit): Boolean {
         // Note: `v` is 1-based, but `data` is 0-based.
         return data[v.absoluteValue - 1] xor (v < 0)
     }
@@ -22,14 +39,6 @@ class Model private constructor(
     override fun toString(): String {
         return data.toString()
     }
-
-    companion object {
-        fun from(data: List<Boolean>, zerobased: Boolean): Model =
-            if (zerobased) Model(data)
-            else Model(data.subList(1, data.size))
-
-        fun from(data: BooleanArray, zerobased: Boolean): Model = from(data.asList(), zerobased)
-    }
 }
 
 fun <T> DomainVar<T>.convert(model: Model): T? =
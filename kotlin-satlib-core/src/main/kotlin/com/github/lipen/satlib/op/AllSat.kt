@@ -1,9 +1,11 @@
 package com.github.lipen.satlib.op
 
 import com.github.lipen.satlib.core.Lit
+import com.github.lipen.satlib.core.LitArray
 import com.github.lipen.satlib.core.Model
 import com.github.lipen.satlib.core.sign
 import com.github.lipen.satlib.solver.Solver
+import com.github.lipen.satlib.solver.addClause
 import io.github.oshai.kotlinlogging.KotlinLogging
 
 private val logger = KotlinLogging.logger {}
@@ -37,3 +39,59 @@ fun Solver.allSolutions(
     }
     logger.trace { "No more solutions" }
 }
+
+/**
+ * Enumerate all models projected onto [projection], where `model[i]` is the value of `projection[i-1]`.
+ *
+ * Solvers implementing [ModelEnumerator] enumerate natively, fetching [batchSize] models at once.
+ * Otherwise, the models are enumerated via [Solver.solve] and blocked one by one
+ * (in which case [minimize] is ignored).
+ */
+fun Solver.allProjectedSolutions(
+    projection: LitArray,
+    minimize: Boolean = false,
+    batchSize: Int = 1024,
+): Sequence<Model> = sequence {
+    require(batchSize > 0) { "Bad batch size: $batchSize" }
+    val solver = this@allProjectedSolutions
+    if (solver is ModelEnumerator) {
+        val words = maxOf(1, (projection.size + 63) / 64)
+        val buffer = LongArray(batchSize * words)
+        do {
+            val count = solver.enumerateModels(projection, buffer, minimize)
+            logger.trace { "Enumerated $count models" }
+            for (k in 0 until count) {
+                yield(Model.fromBits(buffer.copyOfRange(k * words, (k + 1) * words), projection.size))
+            }
+        } while (count == batchSize)
+    } else {
+        while (solve()) {
+            val values = getValues(projection)
+            yield(Model.from(values, zerobased = true))
+            addClause(LitArray(projection.size) { i -> if (values[i]) -projection[i] else projection[i] })
+        }
+    }
+    logger.trace { "No more solutions" }
+}
+
+/**
+ * Count (up to the [limit]) the models projected onto [projection].
+ *
+ * @see allProjectedSolutions
+ */
+fun Solver.countSolutions(
+    projection: LitArray,
+    minimize: Boolean = false,
+    limit: Long = Long.MAX_VALUE,
+): Long {
+    if (this is ModelEnumerator) {
+        return countModels(projection, minimize, limit)
+    }
+    var count = 0L
+    while (count < limit && solve()) {
+        count++
+        val values = getValues(projection)
+        addClause(LitArray(projection.size) { i -> if (values[i]) -projection[i] else projection[i] })
+    }
+    return count
+}
@@ -0,0 +1,42 @@
+package com.github.lipen.satlib.op
+
+import com.github.lipen.satlib.solver.Solver
+import io.github.oshai.kotlinlogging.KotlinLogging
+import kotlinx.coroutines.CancellationException
+import kotlinx.coroutines.NonCancellable
+import kotlinx.coroutines.future.await
+import kotlinx.coroutines.withContext
+import kotlinx.coroutines.withTimeoutOrNull
+
+private val logger = KotlinLogging.logger {}
+
+/**
+ * Suspending counterpart of [Solver.solve], based on [Solver.solveAsync].
+ *
+ * Cancellation of the coroutine interrupts the solver and then waits (non-cancellably)
+ * until the solve is actually over, so that the solver can be used right away.
+ */
+suspend fun Solver.solveAwait(): Boolean {
+    val future = solveAsync()
+    try {
+        // Note: await a dependent stage, since cancelling the future itself
+        //  would lose the moment when the solve is actually over
+        return future.thenApply { it }.await()
+    } catch (e: CancellationException) {
+        logger.debug { "Cancelled! Interrupting..." }
+        interrupt()
+        withContext(NonCancellable) { future.await() }
+        throw e
+    }
+}
+
+/**
+ * Non-blocking counterpart of `runWithTimeout(timeMillis) { solve() }`,
+ * which returns `false` on timeout (after the interrupted solver actually stops).
+ *
+ * Unlike [runWithTimeout], this does not pin a thread for the whole solve,
+ * so many solvers can be driven concurrently by a few threads.
+ */
+suspend fun Solver.solveWithTimeout(timeMillis: Long): Boolean {
+    return withTimeoutOrNull(timeMillis) { solveAwait() } ?: false
+}
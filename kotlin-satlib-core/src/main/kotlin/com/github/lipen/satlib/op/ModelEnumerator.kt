@@ -0,0 +1,31 @@
+package com.github.lipen.satlib.op
+
+import com.github.lipen.satlib.core.LitArray
+
+/**
+ * Solver capable of enumerating (projected) models natively, without a round trip per model.
+ *
+ * Each found model is blocked by a new clause over the projection literals,
+ * so the enumeration modifies the formula, and subsequent calls continue it.
+ * The projected variables are frozen (excluded from the preprocessing) from then on,
+ * and a projection onto an already eliminated variable fails with [IllegalArgumentException].
+ */
+interface ModelEnumerator {
+    /**
+     * Enumerate the models projected onto [projection] into the [buffer],
+     * as consecutive bitsets of `max(1, (projection.size + 63) / 64)` words each,
+     * where bit `i` is the value of `projection[i]`.
+     *
+     * When [minimize] is true, blocking clauses are shrunk by dropping
+     * the literals implied by the rest of the projected model.
+     *
+     * Returns the number of written models, which is less than the buffer capacity
+     * only if the enumeration is complete.
+     */
+    fun enumerateModels(projection: LitArray, buffer: LongArray, minimize: Boolean = false): Int
+
+    /**
+     * Count (up to the [limit]) the models projected onto [projection], without transferring them.
+     */
+    fun countModels(projection: LitArray, minimize: Boolean = false, limit: Long = Long.MAX_VALUE): Long
+}
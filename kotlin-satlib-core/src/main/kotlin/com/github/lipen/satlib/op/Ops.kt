@@ -6,7 +6,7 @@ import com.github.lipen.satlib.core.eq
 import com.github.lipen.satlib.core.neq
 import com.github.lipen.satlib.solver.Solver
 import com.github.lipen.satlib.solver.addClause
-import com.github.lipen.satlib.utils.pairs
+import com.github.lipen.satlib.solver.buildClause
 import com.github.lipen.satlib.utils.toList_
 
 // Note: iterate over Iterable not more than once!
@@ -19,8 +19,10 @@ fun Solver.atLeastOne(literals: Iterable<Lit>) {
 
 /** `AtMostOne`([literals]) */
 fun Solver.atMostOne(literals: Iterable<Lit>) {
-    for ((a, b) in literals.pairs())
-        imply(a, -b)
+    val pool = literals.toList_()
+    for (i in pool.indices)
+        for (j in i + 1 until pool.size)
+            imply(pool[i], -pool[j])
 }
 
 /** `ExactlyOne`([literals]) */
@@ -55,10 +57,10 @@ fun Solver.implyAnd(lhs: Lit, rhs: Iterable<Lit>) {
 
 /** [lhs] => `OR`([rhs]) */
 fun Solver.implyOr(lhs: Lit, rhs: Iterable<Lit>) {
-    addClause {
-        yield(-lhs)
+    buildClause {
+        add(-lhs)
         for (x in rhs)
-            yield(x)
+            add(x)
     }
 }
 
@@ -87,11 +89,11 @@ fun Solver.implyImplyAnd(x1: Lit, x2: Lit, xs: Iterable<Lit>) {
 
 /** [x1] => ([x2] => `OR`([xs]) */
 fun Solver.implyImplyOr(x1: Lit, x2: Lit, xs: Iterable<Lit>) {
-    addClause {
-        yield(-x1)
-        yield(-x2)
+    buildClause {
+        add(-x1)
+        add(-x2)
         for (x in xs)
-            yield(x)
+            add(x)
     }
 }
 
@@ -120,12 +122,12 @@ fun Solver.implyImplyImplyAnd(x1: Lit, x2: Lit, x3: Lit, xs: Iterable<Lit>) {
 
 /** [x1] => ([x2] => ([x3] => `OR`([xs]))) */
 fun Solver.implyImplyImplyOr(x1: Lit, x2: Lit, x3: Lit, xs: Iterable<Lit>) {
-    addClause {
-        yield(-x1)
-        yield(-x2)
-        yield(-x3)
+    buildClause {
+        add(-x1)
+        add(-x2)
+        add(-x3)
         for (x in xs)
-            yield(x)
+            add(x)
     }
 }
 
@@ -139,24 +141,24 @@ fun Solver.implyImplyImplyImply(x1: Lit, x2: Lit, x3: Lit, x4: Lit, x5: Lit) {
 
 /** [x1] => ([x2] <=> `AND`([xs])) */
 fun Solver.implyIffAnd(x1: Lit, x2: Lit, xs: Iterable<Lit>) {
-    addClause {
-        yield(-x1)
-        yield(x2)
+    buildClause {
+        add(-x1)
+        add(x2)
         for (x in xs) {
             implyImply(x1, x2, x)
-            yield(-x)
+            add(-x)
         }
     }
 }
 
 /** [x1] => ([x2] <=> `OR`([xs])) */
 fun Solver.implyIffOr(x1: Lit, x2: Lit, xs: Iterable<Lit>) {
-    addClause {
-        yield(-x1)
-        yield(-x2)
+    buildClause {
+        add(-x1)
+        add(-x2)
         for (x in xs) {
             implyImply(x1, x, x2)
-            yield(x)
+            add(x)
         }
     }
 }
@@ -174,26 +176,26 @@ fun Solver.implyIffIte(x1: Lit, x2: Lit, cond: Lit, a: Lit, b: Lit) {
 
 /** [x1] => ([x2] => ([x3] <=> `AND`([xs])) */
 fun Solver.implyImplyIffAnd(x1: Lit, x2: Lit, x3: Lit, xs: Iterable<Lit>) {
-    addClause {
-        yield(-x1)
-        yield(-x2)
-        yield(x3)
+    buildClause {
+        add(-x1)
+        add(-x2)
+        add(x3)
         for (x in xs) {
             implyImplyImply(x1, x2, x3, x)
-            yield(-x)
+            add(-x)
         }
     }
 }
 
 /** [x1] => ([x2] => ([x3] <=> `OR`([xs]))) */
 fun Solver.implyImplyIffOr(x1: Lit, x2: Lit, x3: Lit, xs: Iterable<Lit>) {
-    addClause {
-        yield(-x1)
-        yield(-x2)
-        yield(-x3)
+    buildClause {
+        add(-x1)
+        add(-x2)
+        add(-x3)
         for (x in xs) {
             implyImplyImply(x1, x2, x, x3)
-            yield(x)
+            add(x)
         }
     }
 }
@@ -204,22 +206,22 @@ fun Solver.implyImplyIffOr(x1: Lit, x2: Lit, x3: Lit, xs: Iterable<Lit>) {
 
 /** [lhs] <=> `AND`([rhs]) */
 fun Solver.iffAnd(lhs: Lit, rhs: Iterable<Lit>) {
-    addClause {
-        yield(lhs)
+    buildClause {
+        add(lhs)
         for (x in rhs) {
             imply(lhs, x)
-            yield(-x)
+            add(-x)
         }
     }
 }
 
 /** [lhs] <=> `OR`([rhs]) */
 fun Solver.iffOr(lhs: Lit, rhs: Iterable<Lit>) {
-    addClause {
-        yield(-lhs)
+    buildClause {
+        add(-lhs)
         for (x in rhs) {
             imply(x, lhs)
-            yield(x)
+            add(x)
         }
     }
 }
@@ -6,10 +6,12 @@ import com.github.lipen.satlib.core.Lit
 import com.github.lipen.satlib.core.LitArray
 import com.github.lipen.satlib.core.SequenceScopeLit
 import com.github.lipen.satlib.solver.Solver
+import com.github.lipen.satlib.solver.addClause
+import com.github.lipen.satlib.solver.buildClause
 
 /** `AtLeastOne`([literals]) */
 fun Solver.atLeastOne_(literals: LitArray) {
-    atLeastOne(literals.asList())
+    addClause(literals)
 }
 
 /** `AtLeastOne`([literals]) */
@@ -29,7 +31,9 @@ fun Solver.atLeastOne(block: SequenceScopeLit) {
 
 /** `AtMostOne`([literals]) */
 fun Solver.atMostOne_(literals: LitArray) {
-    atMostOne(literals.asList())
+    for (i in literals.indices)
+        for (j in i + 1 until literals.size)
+            imply(literals[i], -literals[j])
 }
 
 /** `AtMostOne`([literals]) */
@@ -49,7 +53,8 @@ fun Solver.atMostOne(block: SequenceScopeLit) {
 
 /** `ExactlyOne`([literals]) */
 fun Solver.exactlyOne_(literals: LitArray) {
-    exactlyOne(literals.asList())
+    atLeastOne_(literals)
+    atMostOne_(literals)
 }
 
 /** `ExactlyOne`([literals]) */
@@ -69,7 +74,8 @@ fun Solver.exactlyOne(block: SequenceScopeLit) {
 
 /** [lhs] => `AND`([rhs]) */
 fun Solver.implyAnd_(lhs: Lit, rhs: LitArray) {
-    implyAnd(lhs, rhs.asList())
+    for (x in rhs)
+        imply(lhs, x)
 }
 
 /** [lhs] => `AND`([rhs]) */
@@ -89,7 +95,10 @@ fun Solver.implyAnd(lhs: Lit, block: SequenceScopeLit) {
 
 /** [lhs] => `OR`([rhs]) */
 fun Solver.implyOr_(lhs: Lit, rhs: LitArray) {
-    implyOr(lhs, rhs.asList())
+    buildClause {
+        add(-lhs)
+        addAll(rhs)
+    }
 }
 
 /** [lhs] => `OR`([rhs]) */
@@ -109,7 +118,8 @@ fun Solver.implyOr(lhs: Lit, block: SequenceScopeLit) {
 
 /** [x1] => (x2 => `AND`([rhs]) */
 fun Solver.implyImplyAnd_(x1: Lit, x2: Lit, rhs: LitArray) {
-    implyImplyAnd(x1, x2, rhs.asList())
+    for (x in rhs)
+        implyImply(x1, x2, x)
 }
 
 /** [x1] => (x2 => `AND`([rhs]) */
@@ -129,7 +139,11 @@ fun Solver.implyImplyAnd(x1: Lit, x2: Lit, block: SequenceScopeLit) {
 
 /** [x1] => (x2 => `OR`([rhs]) */
 fun Solver.implyImplyOr_(x1: Lit, x2: Lit, rhs: LitArray) {
-    implyImplyOr(x1, x2, rhs.asList())
+    buildClause {
+        add(-x1)
+        add(-x2)
+        addAll(rhs)
+    }
 }
 
 /** [x1] => (x2 => `OR`([rhs]) */
@@ -149,7 +163,8 @@ fun Solver.implyImplyOr(x1: Lit, x2: Lit, block: SequenceScopeLit) {
 
 /** [x1] => ([x2] => ([x3] => `AND`([xs])) */
 fun Solver.implyImplyImplyAnd_(x1: Lit, x2: Lit, x3: Lit, xs: LitArray) {
-    implyImplyImplyAnd(x1, x2, x3, xs.asList())
+    for (x in xs)
+        implyImplyImply(x1, x2, x3, x)
 }
 
 /** [x1] => ([x2] => ([x3] => `AND`([xs])) */
@@ -169,7 +184,12 @@ fun Solver.implyImplyImplyAnd(x1: Lit, x2: Lit, x3: Lit, block: SequenceScopeLit
 
 /** [x1] => ([x2] => ([x3] => `OR`([xs])) */
 fun Solver.implyImplyImplyOr_(x1: Lit, x2: Lit, x3: Lit, xs: LitArray) {
-    implyImplyImplyOr(x1, x2, x3, xs.asList())
+    buildClause {
+        add(-x1)
+        add(-x2)
+        add(-x3)
+        addAll(xs)
+    }
 }
 
 /** [x1] => ([x2] => ([x3] => `OR`([xs])) */
@@ -189,7 +209,15 @@ fun Solver.implyImplyImplyOr(x1: Lit, x2: Lit, x3: Lit, block: SequenceScopeLit)
 
 /** [x1] => ([x2] => ([x3] <=> `AND`([xs])) */
 fun Solver.implyImplyIffAnd_(x1: Lit, x2: Lit, x3: Lit, xs: LitArray) {
-    implyImplyIffAnd(x1, x2, x3, xs.asList())
+    buildClause {
+        add(-x1)
+        add(-x2)
+        add(x3)
+        for (x in xs) {
+            implyImplyImply(x1, x2, x3, x)
+            add(-x)
+        }
+    }
 }
 
 /** [x1] => ([x2] => ([x3] <=> `AND`([xs])) */
@@ -209,7 +237,15 @@ fun Solver.implyImplyIffAnd(x1: Lit, x2: Lit, x3: Lit, block: SequenceScopeLit)
 
 /** [x1] => ([x2] => ([x3] <=> `OR`([xs])) */
 fun Solver.implyImplyIffOr_(x1: Lit, x2: Lit, x3: Lit, xs: LitArray) {
-    implyImplyIffOr(x1, x2, x3, xs.asList())
+    buildClause {
+        add(-x1)
+        add(-x2)
+        add(-x3)
+        for (x in xs) {
+            implyImplyImply(x1, x2, x, x3)
+            add(x)
+        }
+    }
 }
 
 /** [x1] => ([x2] => ([x3] <=> `OR`([xs])) */
@@ -229,7 +265,14 @@ fun Solver.implyImplyIffOr(x1: Lit, x2: Lit, x3: Lit, block: SequenceScopeLit) {
 
 /** [x1] => ([x2] <=> `AND`([xs])) */
 fun Solver.implyIffAnd_(x1: Lit, x2: Lit, xs: LitArray) {
-    implyIffAnd(x1, x2, xs.asList())
+    buildClause {
+        add(-x1)
+        add(x2)
+        for (x in xs) {
+            implyImply(x1, x2, x)
+            add(-x)
+        }
+    }
 }
 
 /** [x1] => ([x2] <=> `AND`([xs])) */
@@ -249,7 +292,14 @@ fun Solver.implyIffAnd(x1: Lit, x2: Lit, block: SequenceScopeLit) {
 
 /** [x1] => ([x2] <=> `OR`([xs])) */
 fun Solver.implyIffOr_(x1: Lit, x2: Lit, xs: LitArray) {
-    implyIffOr(x1, x2, xs.asList())
+    buildClause {
+        add(-x1)
+        add(-x2)
+        for (x in xs) {
+            implyImply(x1, x, x2)
+            add(x)
+        }
+    }
 }
 
 /** [x1] => ([x2] <=> `OR`([xs])) */
@@ -269,7 +319,13 @@ fun Solver.implyIffOr(x1: Lit, x2: Lit, block: SequenceScopeLit) {
 
 /** [lhs] <=> `AND`([rhs]) */
 fun Solver.iffAnd_(lhs: Lit, rhs: LitArray) {
-    iffAnd(lhs, rhs.asList())
+    buildClause {
+        add(lhs)
+        for (x in rhs) {
+            imply(lhs, x)
+            add(-x)
+        }
+    }
 }
 
 /** [lhs] <=> `AND`([rhs]) */
@@ -289,7 +345,13 @@ fun Solver.iffAnd(lhs: Lit, block: SequenceScopeLit) {
 
 /** [lhs] <=> `OR`([rhs]) */
 fun Solver.iffOr_(lhs: Lit, rhs: LitArray) {
-    iffOr(lhs, rhs.asList())
+    buildClause {
+        add(-lhs)
+        for (x in rhs) {
+            imply(x, lhs)
+            add(x)
+        }
+    }
 }
 
 /** [lhs] <=> `OR`([rhs]) */
@@ -2,10 +2,14 @@ package com.github.lipen.satlib.solver
 
 import com.github.lipen.satlib.core.Context
 import com.github.lipen.satlib.core.Lit
+import com.github.lipen.satlib.core.LitArray
+import com.github.lipen.satlib.core.Model
 import com.github.lipen.satlib.core.newContext
 import com.github.lipen.satlib.utils.toList_
 import io.github.oshai.kotlinlogging.KotlinLogging
 import java.io.File
+import java.util.concurrent.CancellationException
+import java.util.concurrent.CompletableFuture
 
 private val logger = KotlinLogging.logger {}
 
@@ -17,11 +21,38 @@ abstract class AbstractSolver : Solver {
         private set
     final override val assumptions: MutableList<Lit> = mutableListOf()
 
+    private var hash: Long = 0
+    private var hashed: Boolean = true
+
+    /**
+     * Order-independent hash of the added clauses (see [FormulaHash]),
+     * or `null` if some clauses were added to the backend bypassing it (see [registerClauses]).
+     */
+    val formulaHash: Long?
+        get() = if (hashed) hash else null
+
+    /**
+     * Cache of the results of [solve] (see [SolveCache]), keyed by the [formulaHash] and the [assumptions].
+     * On a hit, the backend is not called at all, and the model is served from the cache.
+     *
+     * Note: only the blocking [solve] consults the cache,
+     * and only the definite (SAT or UNSAT) results of the solves which were not [interrupt]ed are stored.
+     */
+    var solveCache: SolveCache? = null
+
+    private var cachedModel: Model? = null
+
+    @Volatile
+    private var interrupted: Boolean = false
+
     final override fun reset() {
         context = newContext()
         numberOfVariables = 0
         numberOfClauses = 0
         assumptions.clear()
+        hash = 0
+        hashed = true
+        cachedModel = null
         _reset()
     }
 
@@ -30,6 +61,7 @@ abstract class AbstractSolver : Solver {
     }
 
     final override fun interrupt() {
+        interrupted = true
         _interrupt()
     }
 
@@ -52,13 +84,137 @@ abstract class AbstractSolver : Solver {
         ++numberOfClauses
         val pool = literals.toList_()
         // log.trace { "addClause($pool)" }
+        hash += FormulaHash.clause(pool)
         _addClause(pool)
     }
 
+    final override fun addClause(literals: LitArray, fromIndex: Int, toIndex: Int) {
+        if (fromIndex < 0 || toIndex > literals.size || fromIndex > toIndex) {
+            throw IndexOutOfBoundsException("Bad range [$fromIndex, $toIndex) for ${literals.size} literals")
+        }
+        ++numberOfClauses
+        hash += FormulaHash.clause(literals, fromIndex, toIndex)
+        _addClause(literals, fromIndex, toIndex)
+    }
+
+    final override fun addClause(lit: Lit) {
+        ++numberOfClauses
+        hash += FormulaHash.clause(lit)
+        _addClause(lit)
+    }
+
+    final override fun addClause(lit1: Lit, lit2: Lit) {
+        ++numberOfClauses
+        hash += FormulaHash.clause(lit1, lit2)
+        _addClause(lit1, lit2)
+    }
+
+    final override fun addClause(lit1: Lit, lit2: Lit, lit3: Lit) {
+        ++numberOfClauses
+        hash += FormulaHash.clause(lit1, lit2, lit3)
+        _addClause(lit1, lit2, lit3)
+    }
+
     final override fun solve(): Boolean {
+        cachedModel = null
+        val cache = solveCache
+        val key = if (cache != null && hashed) {
+            SolveKey(hash, numberOfVariables, numberOfClauses, assumptions)
+        } else {
+            null
+        }
+        if (key != null) {
+            val entry = cache!![key]
+            if (entry != null) {
+                logger.debug { "solve(): cache hit for $key" }
+                assumptions.clear()
+                return when (entry) {
+                    is SolveCacheEntry.Sat -> {
+                        cachedModel = entry.toModel()
+                        true
+                    }
+                    is SolveCacheEntry.Unsat -> false
+                }
+            }
+        }
+        interrupted = false
         val res = _solve()
+        if (key != null && res != null && !interrupted) {
+            val entry = if (res) SolveCacheEntry.Sat.of(_getModel()) else SolveCacheEntry.Unsat(_getCore())
+            cache!!.put(key, entry)
+        }
         assumptions.clear()
-        return res
+        // Note: the unknown result (the search was stopped) is reported as UNSAT, just like before
+        return res ?: false
+    }
+
+    final override fun solveAsync(): CompletableFuture<Boolean> {
+        cachedModel = null
+        // Note: assumptions are consumed right away, so that the caller can prepare the next ones
+        val assumptions = assumptions.toList()
+        this.assumptions.clear()
+        return _solveAsync(assumptions)
+    }
+
+    final override fun fork(): Solver {
+        logger.debug { "fork()" }
+        val copy = _fork()
+        copy.context = context.copy()
+        copy.numberOfVariables = numberOfVariables
+        copy.numberOfClauses = numberOfClauses
+        copy.assumptions.addAll(assumptions)
+        copy.hash = hash
+        copy.hashed = hashed
+        copy.solveCache = solveCache
+        return copy
+    }
+
+    final override fun getValue(lit: Lit): Boolean {
+        val model = cachedModel ?: return _getValue(lit)
+        return model[lit]
+    }
+
+    final override fun getValues(literals: LitArray): BooleanArray {
+        val model = cachedModel ?: return _getValues(literals)
+        return BooleanArray(literals.size) { i -> model[literals[i]] }
+    }
+
+    final override fun getModel(): Model {
+        return cachedModel ?: _getModel()
+    }
+
+    /**
+     * Account for [count] clauses added directly to the backend, bypassing [addClause]
+     * (_e.g._, generated by native encoders).
+     *
+     * Since the clauses are unknown, the [formulaHash] is lost (until [reset]).
+     */
+    protected fun registerClauses(count: Int) {
+        numberOfClauses += count
+        hashed = false
+    }
+
+    /**
+     * Same as `registerClauses(Int)` for a [count] reported as a [Long] (_e.g._, by model counting),
+     * saturating [numberOfClauses] at [Int.MAX_VALUE].
+     */
+    protected fun registerClauses(count: Long) {
+        registerClauses(count.coerceAtMost(Int.MAX_VALUE.toLong() - numberOfClauses).toInt())
+    }
+
+    /**
+     * Account for [count] clauses added directly to the backend, whose combined [FormulaHash] is [hash].
+     */
+    protected fun registerClauses(count: Int, hash: Long) {
+        numberOfClauses += count
+        this.hash += hash
+    }
+
+    /**
+     * Forget the model served from the [solveCache], for the solves bypassing [solve].
+     */
+    protected fun dropCachedModel() {
+        cachedModel = null
     }
 
     override fun toString(): String {
@@ -73,5 +229,66 @@ abstract class AbstractSolver : Solver {
     protected abstract fun _comment(comment: String)
     protected abstract fun _newLiteral(outer: Lit): Lit
     protected abstract fun _addClause(literals: List<Lit>)
-    protected abstract fun _solve(): Boolean
+
+    /**
+     * Note: the array is reused by the caller, so it must not be retained.
+     * By default, the slice is copied into a list.
+     */
+    protected open fun _addClause(literals: LitArray, fromIndex: Int, toIndex: Int) {
+        _addClause(literals.copyOfRange(fromIndex, toIndex).asList())
+    }
+
+    protected open fun _addClause(lit: Lit) {
+        _addClause(listOf(lit))
+    }
+
+    protected open fun _addClause(lit1: Lit, lit2: Lit) {
+        _addClause(listOf(lit1, lit2))
+    }
+
+    protected open fun _addClause(lit1: Lit, lit2: Lit, lit3: Lit) {
+        _addClause(listOf(lit1, lit2, lit3))
+    }
+
+    /**
+     * Solve under the [assumptions], returning `true` (SAT), `false` (UNSAT),
+     * or `null` if the search was stopped (by some limit or interrupt) before the result was known.
+     */
+    protected abstract fun _solve(): Boolean?
+    protected abstract fun _getValue(lit: Lit): Boolean
+    protected abstract fun _getModel(): Model
+
+    /** By default, the values are queried one by one via [_getValue]. */
+    protected open fun _getValues(literals: LitArray): BooleanArray {
+        return BooleanArray(literals.size) { i -> _getValue(literals[i]) }
+    }
+
+    /**
+     * The subset of the assumptions of the last (UNSAT) [_solve] sufficient for UNSAT,
+     * stored in the [solveCache], or `null` if the backend does not provide it.
+     */
+    protected open fun _getCore(): LitArray? = null
+
+    /**
+     * Start solving under the given [assumptions] (already removed from [Solver.assumptions]).
+     * Cancelling the resulting future must interrupt the solver.
+     *
+     * By default, the blocking [_solve] is run on the common pool.
+     */
+    protected open fun _solveAsync(assumptions: List<Lit>): CompletableFuture<Boolean> {
+        val future = CompletableFuture.supplyAsync {
+            this.assumptions.addAll(assumptions)
+            (_solve() ?: false).also { this.assumptions.clear() }
+        }
+        future.whenComplete { _, e -> if (e is CancellationException) _interrupt() }
+        return future
+    }
+
+    /**
+     * Create a solver with the copy of the backend state.
+     * The counters, assumptions and context are copied by [fork].
+     */
+    protected open fun _fork(): AbstractSolver {
+        throw UnsupportedOperationException("$this does not support forking")
+    }
 }
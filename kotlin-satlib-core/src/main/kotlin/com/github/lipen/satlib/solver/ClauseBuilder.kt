@@ -0,0 +1,79 @@
+package com.github.lipen.satlib.solver
+
+import com.github.lipen.satlib.core.Lit
+import com.github.lipen.satlib.core.LitArray
+
+/**
+ * Reusable builder of a single clause, backed by a growable [LitArray].
+ *
+ * Once the builder has grown to the size of the clauses at hand, building and adding a clause
+ * (via [Solver.addClause] or [Solver.buildClause]) allocates nothing.
+ */
+class ClauseBuilder @JvmOverloads constructor(
+    initialCapacity: Int = 16,
+) {
+    init {
+        require(initialCapacity > 0) { "Capacity must be positive" }
+    }
+
+    /** Note: only the first [size] literals belong to the clause. */
+    var literals: LitArray = LitArray(initialCapacity)
+        private set
+
+    var size: Int = 0
+        private set
+
+    fun add(lit: Lit): ClauseBuilder {
+        if (size == literals.size) {
+            literals = literals.copyOf(2 * size)
+        }
+        literals[size++] = lit
+        return this
+    }
+
+    fun addAll(literals: Iterable<Lit>): ClauseBuilder {
+        for (lit in literals) add(lit)
+        return this
+    }
+
+    fun addAll(literals: LitArray): ClauseBuilder {
+        for (lit in literals) add(lit)
+        return this
+    }
+
+    fun clear() {
+        size = 0
+    }
+
+    fun toLitArray(): LitArray {
+        return literals.copyOf(size)
+    }
+
+    override fun toString(): String {
+        return toLitArray().contentToString()
+    }
+
+    /**
+     * Per-thread stack of the builders used by [Solver.buildClause], so that nested builds do not interfere.
+     */
+    @PublishedApi
+    internal class Pool {
+        private val builders: MutableList<ClauseBuilder> = mutableListOf()
+        private var depth: Int = 0
+
+        fun acquire(): ClauseBuilder {
+            if (depth == builders.size) builders.add(ClauseBuilder())
+            return builders[depth++].also { it.clear() }
+        }
+
+        fun release() {
+            depth--
+        }
+
+        companion object {
+            private val local: ThreadLocal<Pool> = ThreadLocal.withInitial { Pool() }
+
+            fun get(): Pool = local.get()
+        }
+    }
+}
@@ -14,12 +14,26 @@ import okio.buffer
 import okio.sink
 import okio.source
 import java.io.File
+import kotlin.concurrent.thread
 
 private val logger = KotlinLogging.logger {}
 
+/**
+ * Solver which runs an external [command] and communicates with it via standard streams.
+ *
+ * The solver's output is always drained on a separate thread while the CNF is being written.
+ *
+ * When [pipelined] is true, the solver process is started as soon as the first clause is added,
+ * and the clauses are streamed to it while they are still being generated,
+ * thus overlapping encoding, transfer and solving.
+ * Note that in pipelined mode the `p cnf` header is not written to the process
+ * (since the numbers of variables and clauses are not known beforehand),
+ * so the [command] must accept DIMACS without the header.
+ */
 @Suppress("MemberVisibilityCanBePrivate")
-class DimacsStreamSolver(
+class DimacsStreamSolver @JvmOverloads constructor(
     val command: String,
+    val pipelined: Boolean = false,
 ) : Solver {
     override var context: Context = newContext()
     override var numberOfVariables: Int = 0
@@ -30,6 +44,7 @@ class DimacsStreamSolver(
 
     private val buffer = Buffer()
     private var model: Model? = null
+    private var run: SolverRun? = null
 
     override fun reset() {
         logger.debug { "reset()" }
@@ -39,15 +54,19 @@ class DimacsStreamSolver(
         assumptions.clear()
         buffer.clear()
         model = null
+        run?.close()
+        run = null
     }
 
     override fun close() {
         logger.debug { "close()" }
+        run?.close()
+        run = null
         buffer.close()
     }
 
     override fun interrupt() {
-        logger.debug { "close()" }
+        logger.debug { "interrupt()" }
         throw UnsupportedOperationException(INTERRUPTION_NOT_SUPPORTED)
     }
 
@@ -65,8 +84,11 @@ class DimacsStreamSolver(
 
     override fun comment(comment: String) {
         logger.trace { "// $comment" }
+        // Note: the pipe must be opened before buffering, since opening it replays the buffer
+        val pipe = if (pipelined) pipe() else null
         for (line in comment.lineSequence()) {
             buffer.write("c ").writeln(line)
+            pipe?.write("c ")?.writeln(line)
         }
     }
 
@@ -77,10 +99,26 @@ class DimacsStreamSolver(
     override fun addClause(literals: List<Lit>) {
         logger.trace { "addClause($literals)" }
         ++numberOfClauses
+        val pipe = if (pipelined) pipe() else null
         for (lit in literals) {
             buffer.write(lit.toString()).write(" ")
+            pipe?.write(lit.toString())?.write(" ")
         }
         buffer.writeln("0")
+        pipe?.writeln("0")
+    }
+
+    /**
+     * Stdin of the pipelined solver process, which is started on demand
+     * (in which case, all previously buffered clauses are replayed to it).
+     */
+    private fun pipe(): BufferedSink {
+        run?.let { return it.stdin }
+        val newRun = SolverRun(command)
+        run = newRun
+        buffer.copyTo(newRun.stdin.buffer)
+        newRun.stdin.emitCompleteSegments()
+        return newRun.stdin
     }
 
     override fun solve(): Boolean {
@@ -88,14 +126,18 @@ class DimacsStreamSolver(
         if (assumptions.isNotEmpty()) {
             throw UnsupportedOperationException(ASSUMPTIONS_NOT_SUPPORTED)
         }
-        buffer.writeln("c solve")
-        val process = Runtime.getRuntime().exec(command)
-        process.outputStream.sink().buffer().use {
-            writeDimacs(it)
-            // Note: process' stdin must be closed in order to start the solving process
+        val run = if (pipelined) {
+            pipe().writeln("c solve")
+            this.run!!.also { this.run = null }
+        } else {
+            SolverRun(command)
         }
-        process.inputStream.source().buffer().use { out ->
-            model = parseDimacsOutput(out)
+        run.use {
+            buffer.writeln("c solve")
+            if (!pipelined) {
+                writeDimacs(it.stdin)
+            }
+            model = it.await()
             return model != null
         }
     }
@@ -108,6 +150,29 @@ class DimacsStreamSolver(
         return model ?: error("Model is null because the solver is not in the SAT state")
     }
 
+    /** Running solver process with its output being parsed on a separate thread. */
+    private class SolverRun(command: String) : AutoCloseable {
+        private val process: Process = Runtime.getRuntime().exec(command)
+        val stdin: BufferedSink = process.outputStream.sink().buffer()
+        private var result: Result<Model?>? = null
+        private val reader = thread(isDaemon = true, name = "$NAME-output") {
+            result = runCatching {
+                process.inputStream.source().buffer().use { parseDimacsOutput(it) }
+            }
+        }
+
+        fun await(): Model? {
+            // Note: process' stdin must be closed in order to start the solving process
+            stdin.close()
+            reader.join()
+            return result!!.getOrThrow()
+        }
+
+        override fun close() {
+            process.destroy()
+        }
+    }
+
     companion object {
         private const val NAME = "DimacsStreamSolver"
         private const val ASSUMPTIONS_NOT_SUPPORTED =
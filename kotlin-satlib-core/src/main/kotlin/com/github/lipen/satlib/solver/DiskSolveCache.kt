@@ -0,0 +1,139 @@
+package com.github.lipen.satlib.solver
+
+import io.github.oshai.kotlinlogging.KotlinLogging
+import java.io.File
+import java.io.IOException
+import java.nio.BufferUnderflowException
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.channels.FileChannel
+import java.nio.file.Files
+import java.nio.file.StandardCopyOption
+import java.nio.file.StandardOpenOption
+
+private val logger = KotlinLogging.logger {}
+
+/**
+ * On-disk [SolveCache], storing each entry in its own file in the [directory],
+ * named after the [SolveKey] (so the cache is content-addressed and can be shared between processes).
+ *
+ * Entries are written to a temporary file and moved into place atomically,
+ * and are read via memory-mapping.
+ * The whole key is stored in the entry and checked on reading, and malformed entries are ignored.
+ *
+ * Usually, it is used behind the [LruSolveCache].
+ */
+class DiskSolveCache(val directory: File) : SolveCache {
+    init {
+        directory.mkdirs()
+    }
+
+    override fun get(key: SolveKey): SolveCacheEntry? {
+        val file = fileOf(key)
+        if (!file.exists()) return null
+        return try {
+            FileChannel.open(file.toPath(), StandardOpenOption.READ).use { channel ->
+                val buffer = channel.map(FileChannel.MapMode.READ_ONLY, 0, channel.size())
+                read(buffer.order(ByteOrder.LITTLE_ENDIAN), key)
+            }
+        } catch (e: IOException) {
+            logger.warn { "Could not read the cached result from '$file': $e" }
+            null
+        } catch (e: BufferUnderflowException) {
+            null
+        }
+    }
+
+    override fun put(key: SolveKey, entry: SolveCacheEntry) {
+        val file = fileOf(key)
+        val temp = File.createTempFile(file.name, ".tmp", directory)
+        try {
+            FileChannel.open(temp.toPath(), StandardOpenOption.WRITE).use { channel ->
+                val buffer = write(key, entry)
+                while (buffer.hasRemaining()) channel.write(buffer)
+            }
+            Files.move(temp.toPath(), file.toPath(), StandardCopyOption.ATOMIC_MOVE, StandardCopyOption.REPLACE_EXISTING)
+        } catch (e: IOException) {
+            logger.warn { "Could not store the cached result to '$file': $e" }
+        } finally {
+            temp.delete()
+        }
+    }
+
+    private fun fileOf(key: SolveKey): File {
+        return File(directory, "%016x-%08x.result".format(key.formulaHash, key.hashCode()))
+    }
+
+    // Layout (little-endian):
+    //   magic, version, status (10 or 20), formula hash, number of variables, number of clauses,
+    //   number of assumptions, assumptions,
+    //   then either the model size, number of words and the words (SAT),
+    //   or the core size (-1 if unknown) and the core (UNSAT).
+
+    private fun read(buffer: ByteBuffer, key: SolveKey): SolveCacheEntry? {
+        if (buffer.long != MAGIC || buffer.int != VERSION) return null
+        val status = buffer.int
+        if (buffer.long != key.formulaHash ||
+            buffer.int != key.numberOfVariables ||
+            buffer.int != key.numberOfClauses
+        ) return null
+        val numberOfAssumptions = buffer.int
+        if (numberOfAssumptions != key.assumptions.size) return null
+        val assumptions = IntArray(numberOfAssumptions)
+        buffer.asIntBuffer().get(assumptions)
+        if (!assumptions.contentEquals(key.assumptions)) return null
+        buffer.position(buffer.position() + 4 * assumptions.size)
+        return when (status) {
+            10 -> {
+                val size = buffer.int
+                val words = buffer.int
+                if (size < 0 || words < 0 || words.toLong() * 64 < size) return null
+                val bits = LongArray(words)
+                buffer.asLongBuffer().get(bits)
+                SolveCacheEntry.Sat(bits, size)
+            }
+            20 -> {
+                val size = buffer.int
+                if (size < 0) {
+                    SolveCacheEntry.Unsat(null)
+                } else {
+                    val core = IntArray(size)
+                    buffer.asIntBuffer().get(core)
+                    SolveCacheEntry.Unsat(core)
+                }
+            }
+            else -> null
+        }
+    }
+
+    private fun write(key: SolveKey, entry: SolveCacheEntry): ByteBuffer {
+        val payload = when (entry) {
+            is SolveCacheEntry.Sat -> 8 + 8 * entry.bits.size
+            is SolveCacheEntry.Unsat -> 4 + 4 * (entry.core?.size ?: 0)
+        }
+        val buffer = ByteBuffer.allocate(36 + 4 * key.assumptions.size + payload).order(ByteOrder.LITTLE_ENDIAN)
+        buffer.putLong(MAGIC).putInt(VERSION)
+        buffer.putInt(if (entry is SolveCacheEntry.Sat) 10 else 20)
+        buffer.putLong(key.formulaHash).putInt(key.numberOfVariables).putInt(key.numberOfClauses)
+        buffer.putInt(key.assumptions.size)
+        for (lit in key.assumptions) buffer.putInt(lit)
+        when (entry) {
+            is SolveCacheEntry.Sat -> {
+                buffer.putInt(entry.size).putInt(entry.bits.size)
+                for (word in entry.bits) buffer.putLong(word)
+            }
+            is SolveCacheEntry.Unsat -> {
+                val core = entry.core
+                buffer.putInt(core?.size ?: -1)
+                if (core != null) for (lit in core) buffer.putInt(lit)
+            }
+        }
+        buffer.flip()
+        return buffer
+    }
+
+    companion object {
+        private const val MAGIC: Long = 0x435342494c544153L // "SATLIBSC" read as a little-endian long
+        private const val VERSION: Int = 1
+    }
+}
@@ -0,0 +1,54 @@
+package com.github.lipen.satlib.solver
+
+import com.github.lipen.satlib.core.Lit
+import com.github.lipen.satlib.core.LitArray
+
+/**
+ * Order-independent hash of a CNF formula, maintained incrementally as the clauses are added.
+ *
+ * The hash of a clause is the mixed sum of the mixed literals (and the size) of the clause,
+ * and the hash of a formula is the sum of the hashes of its clauses (modulo 2^64),
+ * so neither the order of the clauses nor the order of the literals matter,
+ * and adding a clause costs a couple of multiplications per literal.
+ *
+ * Note: the same function is computed natively for the `JCnf` arenas (see `Cnf.hpp`), so both must be kept in sync.
+ */
+object FormulaHash {
+    private const val GOLDEN: Long = -0x61c8864680b583ebL // 0x9E3779B97F4A7C15
+
+    /** The finalizer of SplitMix64. */
+    fun mix(x: Long): Long {
+        var z = x
+        z = (z xor (z ushr 30)) * -0x40a7b892e31b1a47L // 0xBF58476D1CE4E5B9
+        z = (z xor (z ushr 27)) * -0x6b2fb644ecceee15L // 0x94D049BB133111EB
+        return z xor (z ushr 31)
+    }
+
+    fun clause(literals: List<Lit>): Long {
+        var sum = 0L
+        for (lit in literals) {
+            sum += mix(lit.toLong())
+        }
+        return mix(sum + literals.size * GOLDEN)
+    }
+
+    fun clause(literals: LitArray, fromIndex: Int = 0, toIndex: Int = literals.size): Long {
+        var sum = 0L
+        for (i in fromIndex until toIndex) {
+            sum += mix(literals[i].toLong())
+        }
+        return mix(sum + (toIndex - fromIndex) * GOLDEN)
+    }
+
+    fun clause(lit: Lit): Long {
+        return mix(mix(lit.toLong()) + GOLDEN)
+    }
+
+    fun clause(lit1: Lit, lit2: Lit): Long {
+        return mix(mix(lit1.toLong()) + mix(lit2.toLong()) + 2 * GOLDEN)
+    }
+
+    fun clause(lit1: Lit, lit2: Lit, lit3: Lit): Long {
+        return mix(mix(lit1.toLong()) + mix(lit2.toLong()) + mix(lit3.toLong()) + 3 * GOLDEN)
+    }
+}
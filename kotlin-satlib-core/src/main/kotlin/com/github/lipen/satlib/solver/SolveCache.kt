@@ -0,0 +1,176 @@
+package com.github.lipen.satlib.solver
+
+import com.github.lipen.satlib.core.BitModel
+import com.github.lipen.satlib.core.Lit
+import com.github.lipen.satlib.core.LitArray
+import com.github.lipen.satlib.core.Model
+
+/**
+ * Cache of the solve results, consulted by [AbstractSolver.solve] (see [AbstractSolver.solveCache]).
+ *
+ * Implementations must be thread-safe, since the same cache may be shared by many solvers.
+ */
+interface SolveCache {
+    operator fun get(key: SolveKey): SolveCacheEntry?
+    fun put(key: SolveKey, entry: SolveCacheEntry)
+}
+
+/**
+ * Key of the solve: the formula (identified by its [FormulaHash] and size)
+ * and the set of [assumptions] (sorted, without duplicates).
+ *
+ * Note: formulas are only compared by their 64-bit hashes, so (very unlikely) collisions are not detected.
+ */
+class SolveKey(
+    val formulaHash: Long,
+    val numberOfVariables: Int,
+    val numberOfClauses: Int,
+    assumptions: Collection<Lit>,
+) {
+    val assumptions: LitArray = assumptions.toIntArray().apply { sort() }.distinct().toIntArray()
+
+    /** Whether the other key is about the same formula. */
+    fun sameFormula(other: SolveKey): Boolean {
+        return formulaHash == other.formulaHash &&
+            numberOfVariables == other.numberOfVariables &&
+            numberOfClauses == other.numberOfClauses
+    }
+
+    override fun equals(other: Any?): Boolean {
+        if (this === other) return true
+        if (other !is SolveKey) return false
+        return sameFormula(other) && assumptions.contentEquals(other.assumptions)
+    }
+
+    override fun hashCode(): Int {
+        var h = FormulaHash.mix(formulaHash + numberOfVariables.toLong() * 31 + numberOfClauses)
+        for (lit in assumptions) {
+            h = FormulaHash.mix(h + lit)
+        }
+        return h.toInt() xor (h ushr 32).toInt()
+    }
+
+    override fun toString(): String {
+        return "SolveKey(formula=%016x, vars=%d, clauses=%d, assumptions=%s)".format(
+            formulaHash, numberOfVariables, numberOfClauses, assumptions.contentToString()
+        )
+    }
+}
+
+sealed class SolveCacheEntry {
+    /** SAT, with the model packed into [bits] (see [BitModel]). */
+    class Sat(
+        val bits: LongArray,
+        val size: Int,
+    ) : SolveCacheEntry() {
+        fun toModel(): Model = BitModel(bits, size)
+
+        companion object {
+            fun of(model: Model): Sat {
+                if (model is BitModel) {
+                    return Sat(model.bits.copyOf(), model.size)
+                }
+                val data = model.data
+                val bits = LongArray((data.size + 63) / 64)
+                for (i in data.indices) {
+                    if (data[i]) bits[i ushr 6] = bits[i ushr 6] or (1L shl (i and 63))
+                }
+                return Sat(bits, data.size)
+            }
+        }
+    }
+
+    /**
+     * UNSAT, with the [core] (the subset of the assumptions sufficient for UNSAT),
+     * or `null` if the solver does not provide it.
+     */
+    class Unsat(
+        val core: LitArray?,
+    ) : SolveCacheEntry()
+}
+
+/**
+ * In-memory [SolveCache] holding (at most) [capacity] least recently used entries,
+ * optionally backed by the [next] (slower, _e.g._ [DiskSolveCache]) cache,
+ * which is written through and consulted on misses.
+ *
+ * The known UNSAT [cores][SolveCacheEntry.Unsat.core] of each formula are also kept,
+ * so that the solve under any superset of the core is answered without the exact match.
+ */
+class LruSolveCache @JvmOverloads constructor(
+    val capacity: Int,
+    private val next: SolveCache? = null,
+) : SolveCache {
+    init {
+        require(capacity > 0) { "Capacity must be positive" }
+    }
+
+    private val entries = object : LinkedHashMap<SolveKey, SolveCacheEntry>(16, 0.75f, true) {
+        override fun removeEldestEntry(eldest: MutableMap.MutableEntry<SolveKey, SolveCacheEntry>): Boolean {
+            return size > capacity
+        }
+    }
+    private val cores = object : LinkedHashMap<SolveKey, ArrayDeque<LitArray>>(16, 0.75f, true) {
+        override fun removeEldestEntry(eldest: MutableMap.MutableEntry<SolveKey, ArrayDeque<LitArray>>): Boolean {
+            return size > capacity
+        }
+    }
+
+    val size: Int
+        @Synchronized get() = entries.size
+
+    @Synchronized
+    override fun get(key: SolveKey): SolveCacheEntry? {
+        entries[key]?.let { return it }
+        val formula = formulaOf(key)
+        cores[formula]?.let { known ->
+            for (core in known) {
+                if (isSubset(core, key.assumptions)) return SolveCacheEntry.Unsat(core)
+            }
+        }
+        val entry = next?.get(key) ?: return null
+        remember(key, entry)
+        return entry
+    }
+
+    @Synchronized
+    override fun put(key: SolveKey, entry: SolveCacheEntry) {
+        remember(key, entry)
+        next?.put(key, entry)
+    }
+
+    @Synchronized
+    fun clear() {
+        entries.clear()
+        cores.clear()
+    }
+
+    private fun remember(key: SolveKey, entry: SolveCacheEntry) {
+        entries[key] = entry
+        if (entry is SolveCacheEntry.Unsat && entry.core != null) {
+            val known = cores.getOrPut(formulaOf(key)) { ArrayDeque() }
+            val core = entry.core.copyOf().apply { sort() }
+            known.addFirst(core)
+            if (known.size > MAX_CORES_PER_FORMULA) known.removeLast()
+        }
+    }
+
+    companion object {
+        private const val MAX_CORES_PER_FORMULA: Int = 16
+
+        private fun formulaOf(key: SolveKey): SolveKey {
+            return SolveKey(key.formulaHash, key.numberOfVariables, key.numberOfClauses, emptyList())
+        }
+
+        /** Note: both arrays must be sorted. */
+        private fun isSubset(sub: LitArray, sup: LitArray): Boolean {
+            var j = 0
+            for (lit in sub) {
+                while (j < sup.size && sup[j] < lit) j++
+                if (j == sup.size || sup[j] != lit) return false
+                j++
+            }
+            return true
+        }
+    }
+}
@@ -7,6 +7,8 @@ import com.github.lipen.satlib.core.Model
 import com.github.lipen.satlib.core.SequenceScopeLit
 import com.github.lipen.satlib.utils.toList_
 import java.io.File
+import java.util.concurrent.CancellationException
+import java.util.concurrent.CompletableFuture
 
 /**
  * Generic SAT solver.
@@ -93,9 +95,55 @@ interface Solver : AutoCloseable {
     // TODO: doc
     fun addClause(literals: List<Lit>)
 
+    /**
+     * Add the clause of `literals[fromIndex until toIndex]`.
+     *
+     * The array is not retained, so it can be reused for the next clause (see [ClauseBuilder]).
+     * By default, the slice is copied into a list, while the native backends consume it without any allocation.
+     */
+    fun addClause(literals: LitArray, fromIndex: Int, toIndex: Int) {
+        addClause(literals.copyOfRange(fromIndex, toIndex).asList())
+    }
+
+    /**
+     * Add the unit clause.
+     *
+     * The fixed-arity overloads (up to three literals) cover the most of the clauses produced by the encoders,
+     * which then avoid boxing the literals into a list (or an array), unless the backend requires it.
+     */
+    fun addClause(lit: Lit) {
+        addClause(listOf(lit))
+    }
+
+    /** Add the binary clause (see the unit [addClause]). */
+    fun addClause(lit1: Lit, lit2: Lit) {
+        addClause(listOf(lit1, lit2))
+    }
+
+    /** Add the ternary clause (see the unit [addClause]). */
+    fun addClause(lit1: Lit, lit2: Lit, lit3: Lit) {
+        addClause(listOf(lit1, lit2, lit3))
+    }
+
     // TODO: doc
     fun solve(): Boolean
 
+    /**
+     * Solve the SAT problem (under [assumptions]) without blocking the caller.
+     *
+     * Cancelling the resulting future [interrupt]s the solver.
+     * Note: the solver must not be used until the solve is actually over,
+     * which may happen slightly after the cancellation (see [com.github.lipen.satlib.op.solveWithTimeout]).
+     *
+     * By default, the blocking [solve] is run on the common pool,
+     * while native backends solve on their own native worker threads, without occupying any JVM thread.
+     */
+    fun solveAsync(): CompletableFuture<Boolean> {
+        val future = CompletableFuture.supplyAsync { solve() }
+        future.whenComplete { _, e -> if (e is CancellationException) interrupt() }
+        return future
+    }
+
     /**
      * Query the Boolean value of a literal.
      *
@@ -105,6 +153,18 @@ interface Solver : AutoCloseable {
      */
     fun getValue(lit: Lit): Boolean
 
+    /**
+     * Query the Boolean values of multiple literals, `result[i]` being the value of `literals[i]`.
+     *
+     * Backends may override this method to fetch all values at once,
+     * which is cheaper than both calling [getValue] for each literal and constructing the whole [Model].
+     *
+     * **Note:** the solver should be in the SAT state.
+     */
+    fun getValues(literals: LitArray): BooleanArray {
+        return BooleanArray(literals.size) { i -> getValue(literals[i]) }
+    }
+
     /**
      * Query the satisfying assignment (model) for the SAT problem.
      *
@@ -117,6 +177,19 @@ interface Solver : AutoCloseable {
      * but it is advisable to query the model right after the call to [solve] which returned `true`.
      */
     fun getModel(): Model
+
+    /**
+     * Create an independent copy of the solver, with the same variables, clauses, [assumptions]
+     * and a (shallow) copy of the [context].
+     *
+     * The copy can be extended and solved separately (_e.g._, on another thread),
+     * which allows to explore many continuations of the same base problem without re-encoding it.
+     *
+     * @throws UnsupportedOperationException if the backend is unable to copy its state.
+     */
+    fun fork(): Solver {
+        throw UnsupportedOperationException("$this does not support forking")
+    }
 }
 
 inline fun Solver.switchContext(newContext: Context, block: () -> Unit) {
@@ -133,7 +206,28 @@ fun Solver.addClause(literals: Iterable<Lit>) {
 }
 
 fun Solver.addClause(literals: LitArray) {
-    addClause(literals.asList())
+    addClause(literals, 0, literals.size)
+}
+
+fun Solver.addClause(builder: ClauseBuilder) {
+    addClause(builder.literals, 0, builder.size)
+}
+
+/**
+ * Build the clause via [block] and add it, using a pooled [ClauseBuilder],
+ * so that no allocation happens once the pool is warmed up.
+ *
+ * Note: the [block] may add other clauses (even via nested [buildClause]), which are added first.
+ */
+inline fun Solver.buildClause(block: ClauseBuilder.() -> Unit) {
+    val pool = ClauseBuilder.Pool.get()
+    val builder = pool.acquire()
+    try {
+        builder.block()
+        addClause(builder)
+    } finally {
+        pool.release()
+    }
 }
 
 @JvmName("addClauseVararg")
@@ -192,4 +286,14 @@ fun Solver.solve(vararg assumptions: Lit): Boolean {
     return solve(assumptions)
 }
 
+fun Solver.solveAsync(assumptions: Iterable<Lit>): CompletableFuture<Boolean> {
+    assume(assumptions)
+    return solveAsync()
+}
+
+@JvmName("solveAsyncVararg")
+fun Solver.solveAsync(vararg assumptions: Lit): CompletableFuture<Boolean> {
+    return solveAsync(assumptions.asList())
+}
+
 // endregion
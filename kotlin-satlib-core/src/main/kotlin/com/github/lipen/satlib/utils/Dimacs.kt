@@ -3,27 +3,146 @@ package com.github.lipen.satlib.utils
 import com.github.lipen.satlib.core.Model
 import okio.BufferedSource
 
+/**
+ * Parse the solver's output in DIMACS format: the answer line (`s ...`) and the values lines (`v ...`).
+ *
+ * The output is scanned byte by byte (without splitting it into lines and words),
+ * and the values are packed directly into the bitset of the resulting [Model].
+ * The value of the variable `v` is taken from the literal `v` or `-v` met before the terminating `0`.
+ */
 internal fun parseDimacsOutput(source: BufferedSource): Model? {
     // TODO: if solver's output is malformed and does not contain 's ' line,
     //  then the misleading "no answer from solver" exception is thrown.
     //  We should fix the error message, or/and show the solver's output with it.
-    val answer = source.lineSequence().firstOrNull { it.startsWith("s ") }
-        ?: error("No answer from solver")
+    val parser = DimacsOutputParser()
+    val chunk = ByteArray(8192)
+    while (true) {
+        val n = source.read(chunk)
+        if (n == -1) break
+        parser.feed(chunk, n)
+    }
+    parser.finish()
+
+    val answer = parser.answer ?: error("No answer from solver")
     return when {
         "UNSAT" in answer -> null
         "INDETERMINATE" in answer -> null
-        "SAT" in answer ->
-            source
-                .lineSequence()
-                .filter { it.startsWith("v ") }
-                .flatMap { it.drop(2).trim().splitToSequence(' ') }
-                .map { it.toInt() }
-                .takeWhile { it != 0 }
-                .map { it > 0 }
-                .toList()
-                .also { check(it.isNotEmpty()) { "Model is empty" } }
-                .let { Model.from(it, zerobased = true) }
+        "SAT" in answer -> {
+            check(parser.size > 0) { "Model is empty" }
+            Model.fromBits(parser.bits, parser.size)
+        }
 
         else -> error("Bad answer (neither SAT nor UNSAT) from solver: '$answer'")
     }
 }
+
+private class DimacsOutputParser {
+    /** The first answer line, e.g. `s SATISFIABLE`. */
+    var answer: String? = null
+        private set
+    var bits: LongArray = LongArray(16)
+        private set
+    var size: Int = 0
+        private set
+
+    private var state = LINE_START
+    private val line = StringBuilder()
+    private var number = 0
+    private var negative = false
+    private var inNumber = false
+    private var finished = false // terminating `0` in values was met
+
+    fun feed(bytes: ByteArray, n: Int) {
+        for (i in 0 until n) {
+            val b = bytes[i].toInt()
+            when (state) {
+                LINE_START -> state = when (b) {
+                    'v'.code -> VALUES_PREFIX
+                    's'.code -> ANSWER.also { line.setLength(0) }
+                    NEWLINE -> LINE_START
+                    else -> SKIP
+                }
+
+                SKIP -> if (b == NEWLINE) state = LINE_START
+
+                ANSWER -> if (b == NEWLINE) {
+                    endAnswer()
+                    state = LINE_START
+                } else {
+                    line.append(b.toChar())
+                }
+
+                VALUES_PREFIX -> state = when (b) {
+                    ' '.code, '\t'.code -> VALUES
+                    NEWLINE -> LINE_START
+                    else -> SKIP
+                }
+
+                VALUES -> when (b) {
+                    in '0'.code..'9'.code -> {
+                        number = number * 10 + (b - '0'.code)
+                        inNumber = true
+                    }
+
+                    '-'.code -> negative = true
+                    else -> {
+                        endNumber()
+                        if (b == NEWLINE) state = LINE_START
+                    }
+                }
+            }
+        }
+    }
+
+    fun finish() {
+        when (state) {
+            ANSWER -> endAnswer()
+            VALUES -> endNumber()
+        }
+        state = LINE_START
+    }
+
+    private fun endAnswer() {
+        if (answer == null && line.isNotEmpty() && (line[0] == ' ' || line[0] == '\t')) {
+            answer = "s" + line.toString().trimEnd()
+        }
+    }
+
+    private fun endNumber() {
+        if (inNumber) {
+            value(number, negative)
+        }
+        number = 0
+        negative = false
+        inNumber = false
+    }
+
+    private fun value(v: Int, negative: Boolean) {
+        if (v == 0) {
+            finished = true
+            return
+        }
+        if (finished) return
+        if (v > size) {
+            size = v
+            val words = (size + 63) / 64
+            if (words > bits.size) {
+                bits = bits.copyOf(maxOf(words, 2 * bits.size))
+            }
+        }
+        val i = v - 1
+        if (!negative) {
+            bits[i ushr 6] = bits[i ushr 6] or (1L shl (i and 63))
+        }
+    }
+
+    companion object {
+        private const val LINE_START = 0
+        private const val SKIP = 1
+        private const val ANSWER = 2
+        private const val VALUES_PREFIX = 3
+        private const val VALUES = 4
+
+        private const val NEWLINE = '\n'.code
+    }
+}
@@ -0,0 +1,39 @@
+package com.github.lipen.satlib.core
+
+import org.amshove.kluent.shouldBeEqualTo
+import org.amshove.kluent.shouldBeFalse
+import org.amshove.kluent.shouldBeTrue
+import org.junit.jupiter.api.Test
+import org.junit.jupiter.api.assertThrows
+
+class BitModelTest {
+    @Test
+    fun `bits are 1-based variables`() {
+        // Variables 1, 3 and 65 are true
+        val model = Model.fromBits(longArrayOf(0b101L, 0b1L), 66)
+        model[1].shouldBeTrue()
+        model[2].shouldBeFalse()
+        model[3].shouldBeTrue()
+        model[-3].shouldBeFalse()
+        model[65].shouldBeTrue()
+        model[66].shouldBeFalse()
+        model[-66].shouldBeTrue()
+    }
+
+    @Test
+    fun `data view matches list model`() {
+        val values = BooleanArray(130) { it % 3 == 0 }
+        val bits = LongArray(3)
+        for (i in values.indices) {
+            if (values[i]) bits[i / 64] = bits[i / 64] or (1L shl (i % 64))
+        }
+        Model.fromBits(bits, values.size).data shouldBeEqualTo Model.from(values, zerobased = true).data
+    }
+
+    @Test
+    fun `out of bounds`() {
+        val model = Model.fromBits(LongArray(1), 10)
+        assertThrows<IndexOutOfBoundsException> { model[11] }
+        assertThrows<IllegalArgumentException> { Model.fromBits(LongArray(1), 65) }
+    }
+}
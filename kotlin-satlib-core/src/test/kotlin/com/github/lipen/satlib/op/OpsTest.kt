@@ -7,6 +7,7 @@ import com.github.lipen.satlib.core.newDomainVar
 import com.github.lipen.satlib.solver.MockSolver
 import com.github.lipen.satlib.solver.Solver
 import com.github.lipen.satlib.solver.addClause
+import com.github.lipen.satlib.solver.buildClause
 import org.amshove.kluent.shouldBeEqualTo
 import org.junit.jupiter.api.Test
 import org.junit.jupiter.api.TestInstance
@@ -33,6 +34,24 @@ class OpsTest {
         )
     }
 
+    @Test
+    fun `clause builders and slices`() {
+        solver.buildClause {
+            add(1)
+            solver.buildClause {
+                add(2)
+                add(3)
+            }
+            add(4)
+        }
+        solver.addClause(intArrayOf(5, 6, 7, 8), 1, 3)
+        clauses shouldBeEqualTo listOf(
+            listOf(2, 3),
+            listOf(1, 4),
+            listOf(6, 7)
+        )
+    }
+
     @Test
     fun imply() {
         solver.imply(1, 2)
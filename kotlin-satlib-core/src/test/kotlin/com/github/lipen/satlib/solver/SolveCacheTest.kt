@@ -0,0 +1,43 @@
+package com.github.lipen.satlib.solver
+
+import com.github.lipen.satlib.core.Model
+import org.amshove.kluent.shouldBeEqualTo
+import org.amshove.kluent.shouldBeInstanceOf
+import org.amshove.kluent.shouldBeNull
+import org.junit.jupiter.api.Test
+import java.nio.file.Files
+
+class SolveCacheTest {
+    @Test
+    fun `formula hash is order-independent`() {
+        val a = FormulaHash.clause(listOf(1, -2, 3)) + FormulaHash.clause(listOf(-4))
+        val b = FormulaHash.clause(intArrayOf(-4)) + FormulaHash.clause(intArrayOf(3, 1, -2))
+        a shouldBeEqualTo b
+        (FormulaHash.clause(listOf(1, 2)) == FormulaHash.clause(listOf(1, -2))) shouldBeEqualTo false
+    }
+
+    @Test
+    fun `lru cache answers supersets of cores`() {
+        val cache = LruSolveCache(capacity = 2)
+        cache.put(SolveKey(42, 5, 7, listOf(3, 1, 2)), SolveCacheEntry.Unsat(intArrayOf(3, 1)))
+        cache[SolveKey(42, 5, 7, listOf(1, 3, 5, 3))].shouldBeInstanceOf<SolveCacheEntry.Unsat>()
+        cache[SolveKey(42, 5, 7, listOf(1, 5))].shouldBeNull()
+        cache[SolveKey(43, 5, 7, listOf(1, 3))].shouldBeNull()
+    }
+
+    @Test
+    fun `disk cache round-trip`() {
+        val directory = Files.createTempDirectory("satlib-solve-cache").toFile()
+        try {
+            val key = SolveKey(-1, 70, 3, listOf(2, -1))
+            val model = Model.from(BooleanArray(70) { it % 3 == 0 }, zerobased = true)
+            DiskSolveCache(directory).put(key, SolveCacheEntry.Sat.of(model))
+            val entry = DiskSolveCache(directory)[key]
+            entry.shouldBeInstanceOf<SolveCacheEntry.Sat>()
+            (entry as SolveCacheEntry.Sat).toModel().data shouldBeEqualTo model.data
+            DiskSolveCache(directory)[SolveKey(-1, 70, 3, listOf(2))].shouldBeNull()
+        } finally {
+            directory.deleteRecursively()
+        }
+    }
+}
@@ -0,0 +1,53 @@
+package com.github.lipen.satlib.utils
+
+import okio.Buffer
+import org.amshove.kluent.shouldBeEqualTo
+import org.amshove.kluent.shouldBeNull
+import org.amshove.kluent.shouldNotBeNull
+import org.junit.jupiter.api.Test
+import org.junit.jupiter.api.assertThrows
+
+class DimacsOutputTest {
+    private fun parse(output: String) = parseDimacsOutput(Buffer().writeUtf8(output))
+
+    @Test
+    fun `satisfiable with multiple value lines`() {
+        val model = parse(
+            """
+            c comment with v and s letters
+            s SATISFIABLE
+            v 1 -2 3
+            v -4 5 0
+            """.trimIndent()
+        ).shouldNotBeNull()
+        model.data shouldBeEqualTo listOf(true, false, true, false, true)
+    }
+
+    @Test
+    fun `unsatisfiable`() {
+        parse("c foo\ns UNSATISFIABLE\n").shouldBeNull()
+    }
+
+    @Test
+    fun `values after terminating zero are ignored`() {
+        val model = parse("s SATISFIABLE\r\nv -1 2 0\r\nv 3 0\r\n").shouldNotBeNull()
+        model.data shouldBeEqualTo listOf(false, true)
+    }
+
+    @Test
+    fun `large model without final newline`() {
+        val n = 100_000
+        val output = buildString {
+            append("s SATISFIABLE\nv")
+            for (v in 1..n) append(' ').append(if (v % 3 == 0) v else -v)
+            append(" 0")
+        }
+        val model = parse(output).shouldNotBeNull()
+        model.data shouldBeEqualTo List(n) { (it + 1) % 3 == 0 }
+    }
+
+    @Test
+    fun `missing answer`() {
+        assertThrows<IllegalStateException> { parse("c nothing\nv 1 0\n") }
+    }
+}
@@ -0,0 +1,610 @@
+/**
+ * Copyright © 2020, Darya Grechishkina, Konstantin Chukharev, ITMO University
+ */
+
+// Native benchmark separating the cost of the JNI shims from the cost of the solvers themselves.
+//
+// A clause/assumption trace is replayed through each solver twice: directly via its C++ API ("raw"),
+// and via the very same entry points which are called by the JVM ("shim" per clause, "bulk" via `add_clauses`),
+// passing real Java arrays created in an embedded JVM. The difference in ns/op is the overhead of the JNI layer.
+// Additionally, the building blocks of the shims (JNI array access, literal conversion, per-call vectors,
+// sorting in `to_literals_vector`) are measured separately on the clauses of the trace.
+//
+// The trace is in iCNF format: `p inccnf` header, clauses, and `a <lits> 0` lines,
+// each meaning "solve under these assumptions". Without a trace, a random 3-SAT one is generated.
+//
+// Usage: shimbench [trace.icnf] [repetitions]
+// Output: tab-separated `solver path op count ns/op overhead`, where `overhead` is relative to "raw".
+
+#include <jni.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Note: Glucose defines `l_True`, `l_False`, `l_Undef` and `var_Undef` as macros (see JPortfolio.cpp),
+//  so it must be included last, and these names must not be used below.
+#include <minisat/simp/SimpSolver.h>
+#include <cryptominisat5/cryptominisat.h>
+#include <cadical/cadical.hpp>
+#include <glucose/simp/SimpSolver.h>
+
+// Shim entry points, linked from the J*.cpp sources
+#define SHIM(rtype, cls, name) \
+    extern "C" JNIEXPORT rtype JNICALL Java_com_github_lipen_satlib_jni_##cls##_##name
+
+SHIM(jlong, JMiniSat, minisat_1ctor)(JNIEnv*, jobject);
+SHIM(void, JMiniSat, minisat_1dtor)(JNIEnv*, jobject, jlong);
+SHIM(jint, JMiniSat, minisat_1new_1var)(JNIEnv*, jobject, jlong, jbyte, jboolean);
+SHIM(jboolean, JMiniSat, minisat_1add_1clause__J_3I)(JNIEnv*, jobject, jlong, jintArray);
+SHIM(jboolean, JMiniSat, minisat_1add_1clauses)(JNIEnv*, jobject, jlong, jintArray, jint);
+SHIM(jboolean, JMiniSat, minisat_1solve__J_3IZZ)(JNIEnv*, jobject, jlong, jintArray, jboolean, jboolean);
+
+SHIM(jlong, JGlucose, glucose_1ctor)(JNIEnv*, jobject);
+SHIM(void, JGlucose, glucose_1dtor)(JNIEnv*, jobject, jlong);
+SHIM(jint, JGlucose, glucose_1new_1var)(JNIEnv*, jobject, jlong, jboolean, jboolean);
+SHIM(jboolean, JGlucose, glucose_1add_1clause__J_3I)(JNIEnv*, jobject, jlong, jintArray);
+SHIM(jboolean, JGlucose, glucose_1add_1clauses)(JNIEnv*, jobject, jlong, jintArray, jint);
+SHIM(jboolean, JGlucose, glucose_1solve__J_3IZZ)(JNIEnv*, jobject, jlong, jintArray, jboolean, jboolean);
+
+SHIM(jlong, JCadical, cadical_1create)(JNIEnv*, jobject);
+SHIM(void, JCadical, cadical_1delete)(JNIEnv*, jobject, jlong);
+SHIM(void, JCadical, cadical_1add_1clause)(JNIEnv*, jobject, jlong, jintArray);
+SHIM(void, JCadical, cadical_1add_1clauses)(JNIEnv*, jobject, jlong, jintArray, jint);
+SHIM(void, JCadical, cadical_1add_1assumptions)(JNIEnv*, jobject, jlong, jintArray);
+SHIM(jint, JCadical, cadical_1solve)(JNIEnv*, jobject, jlong);
+
+SHIM(jlong, JCryptoMiniSat, cms_1create)(JNIEnv*, jobject);
+SHIM(void, JCryptoMiniSat, cms_1delete)(JNIEnv*, jobject, jlong);
+SHIM(void, JCryptoMiniSat, cms_1new_1var)(JNIEnv*, jobject, jlong);
+SHIM(void, JCryptoMiniSat, cms_1add_1clause)(JNIEnv*, jobject, jlong, jintArray);
+SHIM(void, JCryptoMiniSat, cms_1add_1clauses)(JNIEnv*, jobject, jlong, jintArray, jint);
+SHIM(jint, JCryptoMiniSat, cms_1solve__J_3I)(JNIEnv*, jobject, jlong, jintArray);
+
+static inline int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Keeps the results of the measured loops alive
+static volatile int64_t sink;
+
+// Same conversions as in the shims
+static inline Minisat::Lit minisat_lit(int lit) {
+    return Minisat::toLit(lit > 0 ? (lit - 1) << 1 : ((-lit - 1) << 1) + 1);
+}
+
+static inline Glucose::Lit glucose_lit(int lit) {
+    return Glucose::toLit(lit > 0 ? (lit - 1) << 1 : ((-lit - 1) << 1) + 1);
+}
+
+static inline CMSat::Lit cms_lit(int lit) {
+    return CMSat::Lit(abs(lit) - 1, lit < 0);
+}
+
+// Clauses followed by a solve under the assumptions (unless it is the tail of the trace)
+struct Batch {
+    std::vector<std::vector<jint>> clauses;
+    std::vector<jint> assumptions;
+    bool solve;
+};
+
+struct Trace {
+    int max_var;
+    size_t num_clauses;
+    size_t num_solves;
+    std::vector<Batch> batches;
+};
+
+// The same batches as Java arrays (global references)
+struct JBatch {
+    std::vector<jintArray> clauses;
+    jintArray bulk; // zero-terminated clauses
+    jint bulk_size;
+    jintArray assumptions;
+};
+
+static jintArray new_array(JNIEnv* env, const jint* data, size_t size) {
+    jintArray local = env->NewIntArray((jsize) size);
+    env->SetIntArrayRegion(local, 0, (jsize) size, data);
+    jintArray global = (jintArray) env->NewGlobalRef(local);
+    env->DeleteLocalRef(local);
+    return global;
+}
+
+static std::vector<JBatch> to_java(JNIEnv* env, const Trace& trace) {
+    std::vector<JBatch> result(trace.batches.size());
+    for (size_t i = 0; i < trace.batches.size(); i++) {
+        const Batch& b = trace.batches[i];
+        JBatch& j = result[i];
+        std::vector<jint> bulk;
+        for (const std::vector<jint>& clause : b.clauses) {
+            j.clauses.push_back(new_array(env, clause.data(), clause.size()));
+            bulk.insert(bulk.end(), clause.begin(), clause.end());
+            bulk.push_back(0);
+        }
+        j.bulk = new_array(env, bulk.data(), bulk.size());
+        j.bulk_size = (jint) bulk.size();
+        j.assumptions = new_array(env, b.assumptions.data(), b.assumptions.size());
+    }
+    return result;
+}
+
+static void add_literal(Trace& trace, std::vector<jint>& into, int lit) {
+    into.push_back(lit);
+    trace.max_var = std::max(trace.max_var, abs(lit));
+}
+
+// Note: returns false on I/O or syntax error
+static bool read_trace(const char* path, Trace& trace) {
+    FILE* f = fopen(path, "r");
+    if (f == NULL) return false;
+    trace.batches.push_back(Batch());
+    int c;
+    bool ok = true;
+    while (ok && (c = fgetc(f)) != EOF) {
+        if (c == 'c' || c == 'p') {
+            while ((c = fgetc(f)) != EOF && c != '\n') {}
+            continue;
+        }
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') continue;
+        bool query = c == 'a';
+        if (!query) ungetc(c, f);
+        Batch& b = trace.batches.back();
+        std::vector<jint> clause;
+        int lit;
+        while ((ok = fscanf(f, "%d", &lit) == 1) && lit != 0) {
+            add_literal(trace, query ? b.assumptions : clause, lit);
+        }
+        if (!ok) break;
+        if (query) {
+            b.solve = true;
+            trace.num_solves++;
+            trace.batches.push_back(Batch());
+        } else {
+            b.clauses.push_back(clause);
+            trace.num_clauses++;
+        }
+    }
+    ok = ok || feof(f);
+    fclose(f);
+    return ok;
+}
+
+// Random 3-SAT (below the threshold) added in chunks, each followed by a few solves under random assumptions
+static void generate_trace(Trace& trace, int n = 1000, int chunks = 10, int solves = 10, int assumptions = 10) {
+    uint64_t seed = 42;
+    auto next = [&seed](int bound) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (int) ((seed >> 33) % (uint64_t) bound);
+    };
+    auto literal = [&](void) {
+        int v = next(n) + 1;
+        return next(2) ? v : -v;
+    };
+    int per_chunk = n * 7 / 2 / chunks;
+    for (int k = 0; k < chunks; k++) {
+        for (int s = 0; s < solves; s++) {
+            trace.batches.push_back(Batch());
+            Batch& b = trace.batches.back();
+            for (int i = 0; s == 0 && i < per_chunk; i++) {
+                std::vector<jint> clause;
+                for (int j = 0; j < 3; j++) add_literal(trace, clause, literal());
+                b.clauses.push_back(clause);
+                trace.num_clauses++;
+            }
+            for (int i = 0; i < assumptions; i++) add_literal(trace, b.assumptions, literal());
+            b.solve = true;
+            trace.num_solves++;
+        }
+    }
+}
+
+// Replay results, the solve results being normalized to 10/20/0
+struct Replay {
+    int64_t add_ns;
+    int64_t solve_ns;
+    std::vector<int> results;
+};
+
+// Runner interface: `init(max_var)`, `add(batch, jbatch)`, `solve(batch, jbatch)`, `done()`
+template<typename R>
+static Replay replay(R& runner, const Trace& trace, const std::vector<JBatch>& jtrace) {
+    Replay r = {0, 0, {}};
+    runner.init(trace.max_var);
+    for (size_t i = 0; i < trace.batches.size(); i++) {
+        int64_t t0 = now_ns();
+        runner.add(trace.batches[i], jtrace[i]);
+        int64_t t1 = now_ns();
+        r.add_ns += t1 - t0;
+        if (trace.batches[i].solve) {
+            r.results.push_back(runner.solve(trace.batches[i], jtrace[i]));
+            r.solve_ns += now_ns() - t1;
+        }
+    }
+    runner.done();
+    return r;
+}
+
+// Note: simplification is disabled in all MiniSat/Glucose runners,
+//  since it may eliminate the variables used in the subsequent clauses and assumptions of the trace.
+
+struct MiniSatRaw {
+    Minisat::SimpSolver* solver;
+    Minisat::vec<Minisat::Lit> buffer;
+
+    void init(int n) {
+        solver = new Minisat::SimpSolver();
+        while (solver->nVars() < n) solver->newVar();
+    }
+
+    void add(const Batch& b, const JBatch&) {
+        for (const std::vector<jint>& clause : b.clauses) {
+            buffer.clear();
+            for (jint lit : clause) buffer.push(minisat_lit(lit));
+            solver->addClause_(buffer);
+        }
+    }
+
+    int solve(const Batch& b, const JBatch&) {
+        buffer.clear();
+        for (jint lit : b.assumptions) buffer.push(minisat_lit(lit));
+        return solver->solve(buffer, false, false) ? 10 : 20;
+    }
+
+    void done() {
+        delete solver;
+    }
+};
+
+struct MiniSatShim {
+    JNIEnv* env;
+    bool bulk;
+    jlong handle;
+
+    void init(int n) {
+        handle = Java_com_github_lipen_satlib_jni_JMiniSat_minisat_1ctor(env, NULL);
+        for (int i = 0; i < n; i++) {
+            Java_com_github_lipen_satlib_jni_JMiniSat_minisat_1new_1var(env, NULL, handle, 2, JNI_TRUE);
+        }
+    }
+
+    void add(const Batch&, const JBatch& j) {
+        if (bulk) {
+            Java_com_github_lipen_satlib_jni_JMiniSat_minisat_1add_1clauses(env, NULL, handle, j.bulk, j.bulk_size);
+        } else {
+            for (jintArray clause : j.clauses) {
+                Java_com_github_lipen_satlib_jni_JMiniSat_minisat_1add_1clause__J_3I(env, NULL, handle, clause);
+            }
+        }
+    }
+
+    int solve(const Batch&, const JBatch& j) {
+        return Java_com_github_lipen_satlib_jni_JMiniSat_minisat_1solve__J_3IZZ(
+            env, NULL, handle, j.assumptions, JNI_FALSE, JNI_FALSE) ? 10 : 20;
+    }
+
+    void done() {
+        Java_com_github_lipen_satlib_jni_JMiniSat_minisat_1dtor(env, NULL, handle);
+    }
+};
+
+struct GlucoseRaw {
+    Glucose::SimpSolver* solver;
+    Glucose::vec<Glucose::Lit> buffer;
+
+    void init(int n) {
+        solver = new Glucose::SimpSolver();
+        while (solver->nVars() < n) solver->newVar();
+    }
+
+    void add(const Batch& b, const JBatch&) {
+        for (const std::vector<jint>& clause : b.clauses) {
+            buffer.clear();
+            for (jint lit : clause) buffer.push(glucose_lit(lit));
+            solver->addClause_(buffer);
+        }
+    }
+
+    int solve(const Batch& b, const JBatch&) {
+        buffer.clear();
+        for (jint lit : b.assumptions) buffer.push(glucose_lit(lit));
+        return solver->solve(buffer, false, false) ? 10 : 20;
+    }
+
+    void done() {
+        delete solver;
+    }
+};
+
+struct GlucoseShim {
+    JNIEnv* env;
+    bool bulk;
+    jlong handle;
+
+    void init(int n) {
+        handle = Java_com_github_lipen_satlib_jni_JGlucose_glucose_1ctor(env, NULL);
+        for (int i = 0; i < n; i++) {
+            Java_com_github_lipen_satlib_jni_JGlucose_glucose_1new_1var(env, NULL, handle, JNI_TRUE, JNI_TRUE);
+        }
+    }
+
+    void add(const Batch&, const JBatch& j) {
+        if (bulk) {
+            Java_com_github_lipen_satlib_jni_JGlucose_glucose_1add_1clauses(env, NULL, handle, j.bulk, j.bulk_size);
+        } else {
+            for (jintArray clause : j.clauses) {
+                Java_com_github_lipen_satlib_jni_JGlucose_glucose_1add_1clause__J_3I(env, NULL, handle, clause);
+            }
+        }
+    }
+
+    int solve(const Batch&, const JBatch& j) {
+        return Java_com_github_lipen_satlib_jni_JGlucose_glucose_1solve__J_3IZZ(
+            env, NULL, handle, j.assumptions, JNI_FALSE, JNI_FALSE) ? 10 : 20;
+    }
+
+    void done() {
+        Java_com_github_lipen_satlib_jni_JGlucose_glucose_1dtor(env, NULL, handle);
+    }
+};
+
+struct CadicalRaw {
+    CaDiCaL::Solver* solver;
+
+    void init(int) {
+        solver = new CaDiCaL::Solver;
+    }
+
+    void add(const Batch& b, const JBatch&) {
+        for (const std::vector<jint>& clause : b.clauses) {
+            for (jint lit : clause) solver->add(lit);
+            solver->add(0);
+        }
+    }
+
+    int solve(const Batch& b, const JBatch&) {
+        for (jint lit : b.assumptions) solver->assume(lit);
+        return solver->solve();
+    }
+
+    void done() {
+        delete solver;
+    }
+};
+
+struct CadicalShim {
+    JNIEnv* env;
+    bool bulk;
+    jlong handle;
+
+    void init(int) {
+        handle = Java_com_github_lipen_satlib_jni_JCadical_cadical_1create(env, NULL);
+    }
+
+    void add(const Batch&, const JBatch& j) {
+        if (bulk) {
+            Java_com_github_lipen_satlib_jni_JCadical_cadical_1add_1clauses(env, NULL, handle, j.bulk, j.bulk_size);
+        } else {
+            for (jintArray clause : j.clauses) {
+                Java_com_github_lipen_satlib_jni_JCadical_cadical_1add_1clause(env, NULL, handle, clause);
+            }
+        }
+    }
+
+    int solve(const Batch&, const JBatch& j) {
+        Java_com_github_lipen_satlib_jni_JCadical_cadical_1add_1assumptions(env, NULL, handle, j.assumptions);
+        return Java_com_github_lipen_satlib_jni_JCadical_cadical_1solve(env, NULL, handle);
+    }
+
+    void done() {
+        Java_com_github_lipen_satlib_jni_JCadical_cadical_1delete(env, NULL, handle);
+    }
+};
+
+struct CmsRaw {
+    CMSat::SATSolver* solver;
+    std::vector<CMSat::Lit> buffer;
+
+    void init(int n) {
+        solver = new CMSat::SATSolver;
+        solver->new_vars(n);
+    }
+
+    void add(const Batch& b, const JBatch&) {
+        for (const std::vector<jint>& clause : b.clauses) {
+            buffer.clear();
+            for (jint lit : clause) buffer.push_back(cms_lit(lit));
+            solver->add_clause(buffer);
+        }
+    }
+
+    int solve(const Batch& b, const JBatch&) {
+        buffer.clear();
+        for (jint lit : b.assumptions) buffer.push_back(cms_lit(lit));
+        int res = solver->solve(&buffer).getValue();
+        return res == 0 ? 10 : res == 1 ? 20 : 0;
+    }
+
+    void done() {
+        delete solver;
+    }
+};
+
+struct CmsShim {
+    JNIEnv* env;
+    bool bulk;
+    jlong handle;
+
+    void init(int n) {
+        handle = Java_com_github_lipen_satlib_jni_JCryptoMiniSat_cms_1create(env, NULL);
+        for (int i = 0; i < n; i++) {
+            Java_com_github_lipen_satlib_jni_JCryptoMiniSat_cms_1new_1var(env, NULL, handle);
+        }
+    }
+
+    void add(const Batch&, const JBatch& j) {
+        if (bulk) {
+            Java_com_github_lipen_satlib_jni_JCryptoMiniSat_cms_1add_1clauses(env, NULL, handle, j.bulk, j.bulk_size);
+        } else {
+            for (jintArray clause : j.clauses) {
+                Java_com_github_lipen_satlib_jni_JCryptoMiniSat_cms_1add_1clause(env, NULL, handle, clause);
+            }
+        }
+    }
+
+    int solve(const Batch&, const JBatch& j) {
+        return Java_com_github_lipen_satlib_jni_JCryptoMiniSat_cms_1solve__J_3I(env, NULL, handle, j.assumptions);
+    }
+
+    void done() {
+        Java_com_github_lipen_satlib_jni_JCryptoMiniSat_cms_1delete(env, NULL, handle);
+    }
+};
+
+static int64_t median(std::vector<int64_t> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+static void report(const char* solver, const char* path, const char* op, size_t count, double ns, double raw) {
+    printf("%s\t%s\t%s\t%zu\t%.1f\t%.3f\n", solver, path, op, count, ns, raw > 0 ? ns / raw : 1.0);
+}
+
+// Replay the trace through the "raw", "shim" and "bulk" runners of a solver, reporting the medians
+template<typename Raw, typename Shim>
+static void bench_solver(const char* name, JNIEnv* env, const Trace& trace, const std::vector<JBatch>& jtrace,
+                         int repetitions) {
+    const char* paths[] = {"raw", "shim", "bulk"};
+    double add[3], solve[3];
+    std::vector<int> expected;
+    for (int p = 0; p < 3; p++) {
+        std::vector<int64_t> add_ns, solve_ns;
+        for (int k = 0; k < repetitions; k++) {
+            Replay r;
+            if (p == 0) {
+                Raw runner;
+                r = replay(runner, trace, jtrace);
+            } else {
+                Shim runner;
+                runner.env = env;
+                runner.bulk = p == 2;
+                r = replay(runner, trace, jtrace);
+            }
+            if (expected.empty()) {
+                expected = r.results;
+            } else if (r.results != expected) {
+                fprintf(stderr, "%s/%s: results differ from the raw replay\n", name, paths[p]);
+            }
+            add_ns.push_back(r.add_ns);
+            solve_ns.push_back(r.solve_ns);
+        }
+        add[p] = (double) median(add_ns) / std::max<size_t>(trace.num_clauses, 1);
+        solve[p] = (double) median(solve_ns) / std::max<size_t>(trace.num_solves, 1);
+        report(name, paths[p], "add", trace.num_clauses, add[p], add[0]);
+        report(name, paths[p], "solve", trace.num_solves, solve[p], solve[0]);
+    }
+}
+
+// Measure `body(clause, jclause)` over all clauses of the trace, reporting the median ns per clause
+template<typename F>
+static void bench_part(const char* part, const Trace& trace, const std::vector<JBatch>& jtrace,
+                       int repetitions, F body) {
+    std::vector<int64_t> times;
+    for (int k = 0; k < repetitions; k++) {
+        int64_t t0 = now_ns();
+        for (size_t i = 0; i < trace.batches.size(); i++) {
+            for (size_t c = 0; c < trace.batches[i].clauses.size(); c++) {
+                body(trace.batches[i].clauses[c], jtrace[i].clauses[c]);
+            }
+        }
+        times.push_back(now_ns() - t0);
+    }
+    double ns = (double) median(times) / std::max<size_t>(trace.num_clauses, 1);
+    report("-", part, "clause", trace.num_clauses, ns, 0);
+}
+
+static void bench_parts(JNIEnv* env, const Trace& trace, const std::vector<JBatch>& jtrace, int repetitions) {
+    bench_part("GetIntArrayElements", trace, jtrace, repetitions, [env](const std::vector<jint>&, jintArray a) {
+        jsize len = env->GetArrayLength(a);
+        jint* array = env->GetIntArrayElements(a, 0);
+        if (len > 0) sink += array[len - 1];
+        env->ReleaseIntArrayElements(a, array, 0);
+    });
+    bench_part("GetPrimitiveArrayCritical", trace, jtrace, repetitions, [env](const std::vector<jint>&, jintArray a) {
+        jsize len = env->GetArrayLength(a);
+        jint* array = (jint*) env->GetPrimitiveArrayCritical(a, 0);
+        if (len > 0) sink += array[len - 1];
+        env->ReleasePrimitiveArrayCritical(a, array, JNI_ABORT);
+    });
+    Minisat::vec<Minisat::Lit> reused;
+    bench_part("convert", trace, jtrace, repetitions, [&reused](const std::vector<jint>& clause, jintArray) {
+        reused.clear();
+        for (jint lit : clause) reused.push(minisat_lit(lit));
+        sink += reused.size();
+    });
+    bench_part("convert+vec", trace, jtrace, repetitions, [](const std::vector<jint>& clause, jintArray) {
+        Minisat::vec<Minisat::Lit> vec((int) clause.size());
+        for (size_t i = 0; i < clause.size(); i++) vec[(int) i] = minisat_lit(clause[i]);
+        sink += vec.size();
+    });
+    bench_part("to_literals_vector", trace, jtrace, repetitions, [](const std::vector<jint>& clause, jintArray) {
+        std::vector<CMSat::Lit> lits;
+        lits.reserve(clause.size());
+        for (jint lit : clause) lits.push_back(cms_lit(lit));
+        std::sort(lits.begin(), lits.end());
+        sink += lits.size();
+    });
+    bench_part("to_literals_vector-sort", trace, jtrace, repetitions, [](const std::vector<jint>& clause, jintArray) {
+        std::vector<CMSat::Lit> lits;
+        lits.reserve(clause.size());
+        for (jint lit : clause) lits.push_back(cms_lit(lit));
+        sink += lits.size();
+    });
+}
+
+int main(int argc, char** argv) {
+    Trace trace = {0, 0, 0, {}};
+    if (argc > 1) {
+        if (!read_trace(argv[1], trace)) {
+            fprintf(stderr, "Could not read the trace '%s'\n", argv[1]);
+            return 1;
+        }
+    } else {
+        generate_trace(trace);
+    }
+    int repetitions = argc > 2 ? atoi(argv[2]) : 5;
+    if (repetitions <= 0) {
+        fprintf(stderr, "Bad repetitions: %s\n", argv[2]);
+        return 1;
+    }
+
+    JavaVM* vm;
+    JNIEnv* env;
+    JavaVMInitArgs args;
+    args.version = JNI_VERSION_1_8;
+    args.nOptions = 0;
+    args.options = NULL;
+    args.ignoreUnrecognized = JNI_TRUE;
+    if (JNI_CreateJavaVM(&vm, (void**) &env, &args) != JNI_OK) {
+        fprintf(stderr, "Could not create the JVM\n");
+        return 1;
+    }
+    std::vector<JBatch> jtrace = to_java(env, trace);
+
+    fprintf(stderr, "Trace: %d variables, %zu clauses, %zu solves, %d repetitions\n",
+            trace.max_var, trace.num_clauses, trace.num_solves, repetitions);
+    printf("solver\tpath\top\tcount\tns/op\toverhead\n");
+    bench_parts(env, trace, jtrace, repetitions);
+    bench_solver<MiniSatRaw, MiniSatShim>("minisat", env, trace, jtrace, repetitions);
+    bench_solver<GlucoseRaw, GlucoseShim>("glucose", env, trace, jtrace, repetitions);
+    bench_solver<CadicalRaw, CadicalShim>("cadical", env, trace, jtrace, repetitions);
+    bench_solver<CmsRaw, CmsShim>("cms", env, trace, jtrace, repetitions);
+
+    vm->DestroyJavaVM();
+    return 0;
+}
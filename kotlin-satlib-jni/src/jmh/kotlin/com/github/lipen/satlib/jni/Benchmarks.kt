@@ -73,12 +73,14 @@ open class Bench_withK : BenchBase() {
     )
     var k: Int = 0
     lateinit var literals: List<Int>
+    lateinit var literalsArray: IntArray
 
     @Setup
     fun setupWithK() {
         check(k > 0) { "k must be a positive number" }
         check(k <= n) { "k = $k is too much for n = $n" }
         literals = (1..n).shuffled().take(k)
+        literalsArray = literals.toIntArray()
     }
 
     @Benchmark
@@ -87,6 +89,11 @@ open class Bench_withK : BenchBase() {
             bh.consume(solver.getValue(x))
         }
     }
+
+    @Benchmark
+    fun getValues(bh: Blackhole) {
+        bh.consume(solver.getValues(literalsArray))
+    }
 }
 
 @Suppress("ClassName")
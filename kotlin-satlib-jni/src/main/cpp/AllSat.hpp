@@ -0,0 +1,137 @@
+/**
+ * Copyright © 2020, Darya Grechishkina, Konstantin Chukharev, ITMO University
+ */
+
+#ifndef SATLIB_ALLSAT_HPP
+#define SATLIB_ALLSAT_HPP
+
+#include <jni.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <string>
+#include <vector>
+
+// Enumeration of models projected onto the given literals, entirely in native code.
+//
+// The backend is an adapter (with the same interface in every binding) providing:
+//   int solve(const std::vector<jint>& assumptions) -- 10 (SAT), 20 (UNSAT) or 0 (unknown), as in IPASIR,
+//   bool value(jint lit) -- value of `lit` in the last model,
+//   void add_clause(const std::vector<jint>& literals),
+//   bool eliminated(jint lit) -- whether the variable of `lit` has been eliminated by the preprocessing,
+//   void freeze(jint lit) -- protect the variable of `lit` from the elimination (permanently).
+//
+// Each found projected model is blocked by a new (permanent) clause,
+// so the enumeration can be continued by subsequent calls.
+// Blocking clauses must not mention eliminated variables, so the projected variables are frozen,
+// and a projection onto an already eliminated variable is rejected.
+
+static const int ALLSAT_SAT = 10;
+static const int ALLSAT_UNSAT = 20;
+
+// Drop the literals of the `cube` that are implied by the rest of it (w.r.t. the formula),
+// i.e. `F & (cube \ {l}) |= l`. The shrunk cube still matches only the current projected model,
+// but the resulting blocking clause is shorter.
+// Note: the literal is dropped only when the solver definitely returned UNSAT.
+template <typename Backend>
+static void allsat_shrink(Backend& backend, std::vector<jint>& cube) {
+    std::vector<jint> assumptions;
+    for (size_t i = cube.size(); i-- > 0;) {
+        assumptions.clear();
+        for (size_t j = 0; j < cube.size(); j++) {
+            if (j != i) assumptions.push_back(cube[j]);
+        }
+        assumptions.push_back(-cube[i]);
+        if (backend.solve(assumptions) == ALLSAT_UNSAT) {
+            cube.erase(cube.begin() + i);
+        }
+    }
+}
+
+// Find the next projected model and block it.
+// When `bits` is not NULL, the model is written into it:
+// bit `i` is set iff `projection[i]` is true (the words must be zeroed beforehand).
+// Returns false when there are no more models (or the solver was interrupted).
+template <typename Backend>
+static bool allsat_next(Backend& backend, const jint* projection, jint n, bool minimize, jlong* bits) {
+    if (backend.solve(std::vector<jint>()) != ALLSAT_SAT) {
+        return false;
+    }
+    std::vector<jint> cube(n);
+    for (jint i = 0; i < n; i++) {
+        bool v = backend.value(projection[i]);
+        cube[i] = v ? projection[i] : -projection[i];
+        if (v && bits != NULL) {
+            bits[i >> 6] |= (jlong) ((uint64_t) 1 << (i & 63));
+        }
+    }
+    if (minimize) {
+        allsat_shrink(backend, cube);
+    }
+    for (size_t i = 0; i < cube.size(); i++) {
+        cube[i] = -cube[i];
+    }
+    backend.add_clause(cube);
+    return true;
+}
+
+// Check that no projected variable has been eliminated, and freeze all of them.
+// Returns false with the pending `IllegalArgumentException` otherwise.
+template <typename Backend>
+static bool allsat_project(JNIEnv* env, Backend& backend, const std::vector<jint>& projection) {
+    for (size_t i = 0; i < projection.size(); i++) {
+        if (backend.eliminated(projection[i])) {
+            std::string message = "Projected variable " + std::to_string(std::abs(projection[i])) + " has been eliminated";
+            env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), message.c_str());
+            return false;
+        }
+    }
+    for (size_t i = 0; i < projection.size(); i++) {
+        backend.freeze(projection[i]);
+    }
+    return true;
+}
+
+static inline jint allsat_words(jint n) {
+    // Note: even the empty projection occupies one word per model
+    return n > 0 ? (n + 63) / 64 : 1;
+}
+
+// Enumerate up to `buffer.length / words` projected models into the `buffer`.
+// Returns the number of written models (less than the capacity iff the enumeration is complete).
+template <typename Backend>
+static jint allsat_enumerate(JNIEnv* env, Backend& backend, jintArray projection, jboolean minimize, jlongArray buffer) {
+    jint n = env->GetArrayLength(projection);
+    jint words = allsat_words(n);
+    jint capacity = env->GetArrayLength(buffer) / words;
+    std::vector<jint> lits(n);
+    env->GetIntArrayRegion(projection, 0, n, lits.data());
+    if (!allsat_project(env, backend, lits)) {
+        return 0;
+    }
+    std::vector<jlong> bits((size_t) capacity * words, 0);
+    jint count = 0;
+    while (count < capacity && allsat_next(backend, lits.data(), n, minimize, bits.data() + (size_t) count * words)) {
+        count++;
+    }
+    env->SetLongArrayRegion(buffer, 0, count * words, bits.data());
+    return count;
+}
+
+// Count (up to the `limit`) projected models, without transferring them.
+template <typename Backend>
+static jlong allsat_count(JNIEnv* env, Backend& backend, jintArray projection, jboolean minimize, jlong limit) {
+    jint n = env->GetArrayLength(projection);
+    std::vector<jint> lits(n);
+    env->GetIntArrayRegion(projection, 0, n, lits.data());
+    if (!allsat_project(env, backend, lits)) {
+        return 0;
+    }
+    jlong count = 0;
+    while (count < limit && allsat_next(backend, lits.data(), n, minimize, (jlong*) NULL)) {
+        count++;
+    }
+    return count;
+}
+
+#endif // SATLIB_ALLSAT_HPP
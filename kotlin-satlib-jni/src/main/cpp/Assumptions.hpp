@@ -0,0 +1,127 @@
+/**
+ * Copyright © 2020, Darya Grechishkina, Konstantin Chukharev, ITMO University
+ */
+
+#ifndef SATLIB_ASSUMPTIONS_HPP
+#define SATLIB_ASSUMPTIONS_HPP
+
+#include <jni.h>
+#include <stdint.h>
+
+#include <unordered_map>
+#include <vector>
+
+// Containers of solver literals: MiniSat-style `vec` (push/pop) or `std::vector`
+template<typename V, typename L>
+static inline void assumptions_push(V& v, const L& lit) {
+    v.push(lit);
+}
+
+template<typename L>
+static inline void assumptions_push(std::vector<L>& v, const L& lit) {
+    v.push_back(lit);
+}
+
+template<typename V>
+static inline void assumptions_pop(V& v) {
+    v.pop();
+}
+
+template<typename L>
+static inline void assumptions_pop(std::vector<L>& v) {
+    v.pop_back();
+}
+
+// Persistent set of assumptions, kept in native memory already translated into the solver literals (`lits`),
+// so that solving under it requires neither copying nor converting the literals (see `AssumptionSet`).
+// Updates cost O(|delta|): the literals are located via `position`, and the removed ones are
+// replaced by the last literal of the set, so the order of assumptions is not preserved.
+template<typename V, typename L>
+struct AssumptionSet {
+    V lits; // solver literals, passed to `solve` as is
+    std::vector<jint> external; // `external[i]` is the external literal of `lits[i]`
+    std::unordered_map<jint, size_t> position;
+
+    // Note: returns the number of added literals, skipping the ones already present
+    template<typename F>
+    jint add(const jint* literals, jint len, F convert) {
+        jint added = 0;
+        for (jint i = 0; i < len; i++) {
+            jint lit = literals[i];
+            if (!position.emplace(lit, external.size()).second) continue;
+            external.push_back(lit);
+            assumptions_push(lits, convert(lit));
+            added++;
+        }
+        return added;
+    }
+
+    // Note: returns the number of removed literals, skipping the ones not present
+    jint remove(const jint* literals, jint len) {
+        jint removed = 0;
+        for (jint i = 0; i < len; i++) {
+            auto it = position.find(literals[i]);
+            if (it == position.end()) continue;
+            size_t k = it->second;
+            size_t last = external.size() - 1;
+            position.erase(it);
+            if (k != last) {
+                external[k] = external[last];
+                lits[(int) k] = lits[(int) last];
+                position[external[k]] = k;
+            }
+            external.pop_back();
+            assumptions_pop(lits);
+            removed++;
+        }
+        return removed;
+    }
+
+    void clear() {
+        while (!external.empty()) {
+            external.pop_back();
+            assumptions_pop(lits);
+        }
+        position.clear();
+    }
+};
+
+template<typename S>
+static inline jlong encode_assumptions(S* p) {
+    return (jlong) (intptr_t) p;
+}
+
+template<typename S>
+static inline S* decode_assumptions(jlong h) {
+    return (S*) (intptr_t) h;
+}
+
+// Note: `literals[0 until size]` are pinned only for the duration of the update
+template<typename S, typename F>
+static jint assumptions_add(JNIEnv* env, jlong set, jintArray literals, jint size, F convert) {
+    jint* array = (jint*) env->GetPrimitiveArrayCritical(literals, 0);
+    jint added = decode_assumptions<S>(set)->add(array, size, convert);
+    env->ReleasePrimitiveArrayCritical(literals, array, JNI_ABORT);
+    return added;
+}
+
+template<typename S>
+static jint assumptions_remove(JNIEnv* env, jlong set, jintArray literals, jint size) {
+    jint* array = (jint*) env->GetPrimitiveArrayCritical(literals, 0);
+    jint removed = decode_assumptions<S>(set)->remove(array, size);
+    env->ReleasePrimitiveArrayCritical(literals, array, JNI_ABORT);
+    return removed;
+}
+
+// Note: returns the external literals in the current order, or NULL when out of memory
+template<typename S>
+static jintArray assumptions_literals(JNIEnv* env, jlong set) {
+    const std::vector<jint>& external = decode_assumptions<S>(set)->external;
+    jsize size = (jsize) external.size();
+    jintArray result = env->NewIntArray(size);
+    if (result == NULL) return NULL;
+    env->SetIntArrayRegion(result, 0, size, external.data());
+    return result;
+}
+
+#endif // SATLIB_ASSUMPTIONS_HPP
@@ -0,0 +1,169 @@
+/**
+ * Copyright © 2020, Darya Grechishkina, Konstantin Chukharev, ITMO University
+ */
+
+#ifndef SATLIB_ASYNC_SOLVE_HPP
+#define SATLIB_ASYNC_SOLVE_HPP
+
+#include <jni.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+// Result codes passed to `SolveFuture.onSolved` (the same as in CaDiCaL and Kissat)
+static const int ASYNC_UNKNOWN = 0;
+static const int ASYNC_SAT = 10;
+static const int ASYNC_UNSAT = 20;
+static const int ASYNC_FAILED = -1;
+
+// Workers idle for this long exit
+static const int ASYNC_IDLE_MS = 60000;
+
+// Bounded pool of native worker threads: a solve starts right away while fewer than `max_workers`
+// are busy, and waits in the queue otherwise (stopping the running ones is up to the cancellation, see `SolveFuture`).
+// The workers are not attached to the JVM: each task attaches only around its upcalls (see `async_upcall`),
+// so no JVM thread exists for the duration of the search.
+// Note: every library has its own pool, created on the first async solve and never destroyed,
+//  since its detached workers may still be running while the library is being unloaded.
+struct AsyncPool {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::function<void()>> tasks;
+    size_t workers; // running workers
+    size_t idle; // workers waiting for a task
+
+    AsyncPool() : workers(0), idle(0) {}
+
+    // Note: `max_workers` is passed on each call, so lowering it only stops spawning new workers
+    void submit(std::function<void()> task, size_t max_workers) {
+        bool spawn;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+            spawn = tasks.size() > idle && workers < max_workers;
+            if (spawn) {
+                workers++;
+            }
+        }
+        if (spawn) {
+            try {
+                std::thread(&AsyncPool::work, this).detach();
+                return;
+            } catch (const std::system_error&) {
+                // Note: the task stays queued for the running workers (if any)
+                std::lock_guard<std::mutex> lock(mutex);
+                workers--;
+            }
+        }
+        cv.notify_one();
+    }
+
+    void work() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            idle++;
+            bool ready = cv.wait_for(lock, std::chrono::milliseconds(ASYNC_IDLE_MS), [this] { return !tasks.empty(); });
+            idle--;
+            if (!ready) {
+                break;
+            }
+            std::function<void()> task = std::move(tasks.front());
+            tasks.pop_front();
+            lock.unlock();
+            task();
+            task = nullptr;
+            lock.lock();
+        }
+        workers--;
+    }
+};
+
+static AsyncPool* async_pool() {
+    static AsyncPool* pool = new AsyncPool();
+    return pool;
+}
+
+// Attach the current (worker) thread to the JVM as a daemon for the duration of `upcall`.
+// Returns false if the thread cannot be attached, in which case `upcall` is not called.
+static bool async_upcall(JavaVM* vm, const std::function<void(JNIEnv*)>& upcall) {
+    JNIEnv* env;
+    if (vm->AttachCurrentThreadAsDaemon((void**) &env, NULL) != JNI_OK) {
+        return false;
+    }
+    upcall(env);
+    vm->DetachCurrentThread();
+    return true;
+}
+
+// Copy the (nullable) array of assumptions, since it cannot be accessed from the worker thread
+static std::vector<jint> async_assumptions(JNIEnv* env, jintArray assumptions) {
+    std::vector<jint> result;
+    if (assumptions != NULL) {
+        result.resize(env->GetArrayLength(assumptions));
+        env->GetIntArrayRegion(assumptions, 0, (jsize) result.size(), result.data());
+    }
+    return result;
+}
+
+// Run `solve` (returning one of the ASYNC_* codes) on the pool and pass its result to `future.onSolved(int)`,
+// which completes the future on a JVM executor, so the continuations never run on the worker thread.
+// The solve is skipped (reporting ASYNC_UNKNOWN) if the future gets cancelled before it starts.
+// The pool size is read from `SolveFuture.getMaxWorkers()` on each call.
+// Note: `solve` runs on another thread, so it must not capture any JNI references
+//  (see `async_assumptions`), and the solver must not be used until the future is done.
+static void async_solve(JNIEnv* env, jobject future, std::function<int()> solve) {
+    jclass cls = env->GetObjectClass(future);
+    jmethodID on_solved = env->GetMethodID(cls, "onSolved", "(I)V");
+    jmethodID is_cancelled = env->GetMethodID(cls, "isCancelled", "()Z");
+    jmethodID get_max_workers = env->GetStaticMethodID(cls, "getMaxWorkers", "()I");
+    if (on_solved == NULL || is_cancelled == NULL || get_max_workers == NULL) {
+        env->DeleteLocalRef(cls);
+        return; // NoSuchMethodError is pending
+    }
+    jint max_workers = env->CallStaticIntMethod(cls, get_max_workers);
+    env->DeleteLocalRef(cls);
+    if (env->ExceptionCheck()) {
+        return;
+    }
+    JavaVM* vm;
+    if (env->GetJavaVM(&vm) != JNI_OK) {
+        return;
+    }
+    jobject target = env->NewGlobalRef(future);
+    async_pool()->submit([vm, target, on_solved, is_cancelled, solve] {
+        int result = ASYNC_UNKNOWN;
+        jboolean cancelled = JNI_FALSE;
+        bool attached = async_upcall(vm, [&](JNIEnv* env) {
+            cancelled = env->CallBooleanMethod(target, is_cancelled);
+            if (env->ExceptionCheck()) {
+                env->ExceptionClear();
+                result = ASYNC_FAILED;
+            }
+        });
+        if (!attached) {
+            result = ASYNC_FAILED;
+        } else if (result != ASYNC_FAILED && !cancelled) {
+            try {
+                result = solve();
+            } catch (...) {
+                result = ASYNC_FAILED;
+            }
+        }
+        // Note: if the thread cannot be attached, the future is never completed (and `target` leaks),
+        //  but this only happens when the JVM is shutting down
+        async_upcall(vm, [&](JNIEnv* env) {
+            env->CallVoidMethod(target, on_solved, (jint) result);
+            // Note: `onSolved` handles its own failures, so there is nobody left to report this one to
+            env->ExceptionClear();
+            env->DeleteGlobalRef(target);
+        });
+    }, (size_t) max_workers);
+}
+
+#endif // SATLIB_ASYNC_SOLVE_HPP
@@ -0,0 +1,249 @@
+/**
+ * Copyright © 2020, Darya Grechishkina, Konstantin Chukharev, ITMO University
+ */
+
+#ifndef SATLIB_CARDINALITY_HPP
+#define SATLIB_CARDINALITY_HPP
+
+#include <jni.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "Cnf.hpp"
+
+// Cardinality encodings, generated directly into the `Cnf` arena.
+// All encodings produce the unary representation of the number of true input literals:
+// `outputs[i]` is true iff at least `i+1` inputs are true (both directions are encoded).
+// When `bound` is given, only the first `bound` outputs are produced,
+// so the last output means "at least `bound`".
+// Note: new variables are allocated sequentially starting from `next_var`,
+//  and each of them occurs in the generated clauses.
+
+struct CardEncoder {
+    Cnf* cnf;
+    jint next_var;
+
+    CardEncoder(Cnf* cnf, jint first_var) : cnf(cnf), next_var(first_var) {}
+
+    jint fresh() {
+        return next_var++;
+    }
+
+    void clause(jint a, jint b) {
+        jint c[3] = {a, b, 0};
+        cnf->add(c, 3);
+    }
+
+    void clause(jint a, jint b, jint c) {
+        jint d[4] = {a, b, c, 0};
+        cnf->add(d, 4);
+    }
+
+    // Add the clause made of non-zero literals among `a`, `b`, `c`
+    void clause_nz(jint a, jint b, jint c) {
+        jint d[4];
+        jint n = 0;
+        if (a != 0) d[n++] = a;
+        if (b != 0) d[n++] = b;
+        if (c != 0) d[n++] = c;
+        d[n++] = 0;
+        cnf->add(d, n);
+    }
+};
+
+// region Totalizer
+
+// Totalizer tree, kept alive to support incremental extension of the bound.
+struct Totalizer {
+    struct Node {
+        jint left; // -1 for leaves
+        jint right;
+        jint leaves; // number of input literals under the node
+        std::vector<jint> outputs; // 0-based: `outputs[i]` means "at least i+1"
+    };
+
+    std::vector<Node> nodes;
+    jint root;
+    jint bound;
+
+    // Build the tree over `literals[0 until n]` and encode it up to `bound`
+    Totalizer(CardEncoder& enc, const jint* literals, jint n, jint bound) : bound(0) {
+        nodes.reserve(n > 0 ? 2 * n - 1 : 0);
+        root = n > 0 ? build(literals, 0, n) : -1;
+        extend(enc, bound);
+    }
+
+    const std::vector<jint>& outputs() const {
+        static const std::vector<jint> none;
+        return root >= 0 ? nodes[root].outputs : none;
+    }
+
+    // Increase the bound to `new_bound`, adding only the missing outputs and clauses.
+    // Note: decreasing the bound is a no-op, since it is enough to
+    //  restrict (or assume) the already existing outputs.
+    void extend(CardEncoder& enc, jint new_bound) {
+        if (new_bound <= bound) return;
+        bound = new_bound;
+        if (root >= 0) encode(enc, root);
+    }
+
+private:
+    jint build(const jint* literals, jint from, jint to) {
+        Node node;
+        if (to - from == 1) {
+            node.left = -1;
+            node.right = -1;
+            node.leaves = 1;
+            node.outputs.push_back(literals[from]);
+        } else {
+            jint mid = from + (to - from) / 2;
+            node.left = build(literals, from, mid);
+            node.right = build(literals, mid, to);
+            node.leaves = to - from;
+        }
+        nodes.push_back(node);
+        return (jint) nodes.size() - 1;
+    }
+
+    void encode(CardEncoder& enc, jint index) {
+        if (nodes[index].left < 0) return;
+        encode(enc, nodes[index].left);
+        encode(enc, nodes[index].right);
+
+        Node& node = nodes[index];
+        const std::vector<jint>& a = nodes[node.left].outputs;
+        const std::vector<jint>& b = nodes[node.right].outputs;
+        std::vector<jint>& r = node.outputs;
+        jint m1 = (jint) a.size();
+        jint m2 = (jint) b.size();
+        jint old_m = (jint) r.size();
+        jint m = std::min(node.leaves, bound);
+        if (m <= old_m) return;
+        for (jint i = old_m; i < m; i++) {
+            r.push_back(enc.fresh());
+        }
+
+        // Note: only the clauses involving the new outputs `r[old_m until m]` are added,
+        //  the previously added clauses stay valid, since the truncated children
+        //  (having exactly `old_m` outputs) never occur in the "downward" clauses.
+        for (jint alpha = 0; alpha <= m1; alpha++) {
+            for (jint beta = 0; beta <= m2; beta++) {
+                jint sigma = alpha + beta;
+                // "Upward": a[alpha] & b[beta] => r[sigma]
+                if (sigma > old_m && sigma <= m) {
+                    enc.clause_nz(
+                        alpha > 0 ? -a[alpha - 1] : 0,
+                        beta > 0 ? -b[beta - 1] : 0,
+                        r[sigma - 1]
+                    );
+                }
+                // "Downward": r[sigma+1] => a[alpha+1] | b[beta+1]
+                if (sigma + 1 > old_m && sigma + 1 <= m) {
+                    enc.clause_nz(
+                        alpha < m1 ? a[alpha] : 0,
+                        beta < m2 ? b[beta] : 0,
+                        -r[sigma]
+                    );
+                }
+            }
+        }
+    }
+};
+
+static inline Totalizer* decode_totalizer(jlong h) {
+    return (Totalizer*) (intptr_t) h;
+}
+
+// endregion
+
+// region Sequential counter
+
+// Sinz' sequential counter with registers `s[i][j]` <=> "at least j+1 of the first i+1 inputs",
+// encoded in both directions: `s[i][j] <=> s[i-1][j] | (x[i] & s[i-1][j-1])`.
+static std::vector<jint> encode_sequential_counter(CardEncoder& enc, const jint* x, jint n, jint bound) {
+    std::vector<jint> prev;
+    std::vector<jint> cur;
+    if (n == 0 || bound <= 0) return prev;
+    prev.push_back(x[0]);
+    for (jint i = 1; i < n; i++) {
+        jint k = std::min(i + 1, bound);
+        cur.clear();
+        for (jint j = 0; j < k; j++) {
+            jint s = enc.fresh();
+            cur.push_back(s);
+            jint same = j < (jint) prev.size() ? prev[j] : 0; // s[i-1][j], 0 if false
+            jint less = j > 0 ? prev[j - 1] : 0; // s[i-1][j-1], 0 if true
+            if (same != 0) {
+                enc.clause(-same, s);
+                enc.clause_nz(-s, same, x[i]);
+            } else {
+                enc.clause(-s, x[i]);
+            }
+            enc.clause_nz(-x[i], less != 0 ? -less : 0, s);
+            if (less != 0) {
+                enc.clause_nz(-s, same, less);
+            }
+        }
+        prev.swap(cur);
+    }
+    return prev;
+}
+
+// endregion
+
+// region Sorting network
+
+// Comparator: `hi = a | b`, `lo = a & b`
+static void encode_comparator(CardEncoder& enc, jint a, jint b, jint* hi, jint* lo) {
+    *hi = enc.fresh();
+    *lo = enc.fresh();
+    enc.clause(-a, *hi);
+    enc.clause(-b, *hi);
+    enc.clause(a, b, -*hi);
+    enc.clause(-a, -b, *lo);
+    enc.clause(a, -*lo);
+    enc.clause(b, -*lo);
+}
+
+// Batcher's odd-even merge of two sequences sorted in descending order (of arbitrary sizes)
+static std::vector<jint> encode_merge(CardEncoder& enc, const std::vector<jint>& a, const std::vector<jint>& b) {
+    if (a.empty()) return b;
+    if (b.empty()) return a;
+    std::vector<jint> r(2);
+    if (a.size() == 1 && b.size() == 1) {
+        encode_comparator(enc, a[0], b[0], &r[0], &r[1]);
+        return r;
+    }
+    std::vector<jint> a_odd, a_even, b_odd, b_even;
+    for (size_t i = 0; i < a.size(); i++) (i % 2 == 0 ? a_odd : a_even).push_back(a[i]);
+    for (size_t i = 0; i < b.size(); i++) (i % 2 == 0 ? b_odd : b_even).push_back(b[i]);
+    std::vector<jint> odd = encode_merge(enc, a_odd, b_odd);
+    std::vector<jint> even = encode_merge(enc, a_even, b_even);
+
+    r.clear();
+    r.push_back(odd[0]);
+    size_t i = 0;
+    for (; i < even.size() && i + 1 < odd.size(); i++) {
+        jint hi, lo;
+        encode_comparator(enc, even[i], odd[i + 1], &hi, &lo);
+        r.push_back(hi);
+        r.push_back(lo);
+    }
+    r.insert(r.end(), even.begin() + i, even.end());
+    r.insert(r.end(), odd.begin() + std::min(i + 1, odd.size()), odd.end());
+    return r;
+}
+
+static std::vector<jint> encode_sorting_network(CardEncoder& enc, const jint* x, jint n) {
+    if (n <= 1) return std::vector<jint>(x, x + n);
+    jint mid = n / 2;
+    std::vector<jint> left = encode_sorting_network(enc, x, mid);
+    std::vector<jint> right = encode_sorting_network(enc, x + mid, n - mid);
+    return encode_merge(enc, left, right);
+}
+
+// endregion
+
+#endif // SATLIB_CARDINALITY_HPP
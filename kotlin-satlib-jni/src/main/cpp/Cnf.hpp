@@ -0,0 +1,89 @@
+/**
+ * Copyright © 2020, Darya Grechishkina, Konstantin Chukharev, ITMO University
+ */
+
+#ifndef SATLIB_CNF_HPP
+#define SATLIB_CNF_HPP
+
+#include <jni.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <vector>
+
+static const uint64_t HASH_GOLDEN = 0x9E3779B97F4A7C15ULL;
+
+// The finalizer of SplitMix64
+static inline uint64_t hash_mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// CNF stored as a contiguous arena of zero-terminated clauses.
+// Note: this header is shared by `JCnf` (which owns the arena) and the solver bindings
+//  (which load it), so the layout of `Cnf` must not depend on any solver.
+struct Cnf {
+    std::vector<jint> data;
+    jint max_var;
+    jint num_clauses;
+    // Order-independent hash of the terminated clauses (see `FormulaHash` on the Kotlin side, which must match),
+    // along with the sum of the mixed literals and the size of the unterminated one
+    uint64_t hash;
+    uint64_t pending_sum;
+    jint pending_size;
+
+    Cnf() : max_var(0), num_clauses(0), hash(0), pending_sum(0), pending_size(0) {}
+
+    // Append zero-terminated clauses from `literals[0 until len]`
+    void add(const jint* literals, jint len) {
+        for (jint i = 0; i < len; i++) {
+            jint lit = literals[i];
+            if (lit == 0) {
+                num_clauses++;
+                hash += hash_mix(pending_sum + (uint64_t) pending_size * HASH_GOLDEN);
+                pending_sum = 0;
+                pending_size = 0;
+            } else {
+                if (abs(lit) > max_var) max_var = abs(lit);
+                pending_sum += hash_mix((uint64_t) (int64_t) lit);
+                pending_size++;
+            }
+        }
+        data.insert(data.end(), literals, literals + len);
+    }
+
+    void clear() {
+        data.clear();
+        max_var = 0;
+        num_clauses = 0;
+        hash = 0;
+        pending_sum = 0;
+        pending_size = 0;
+    }
+
+    const jint* begin() const {
+        return data.data();
+    }
+
+    jint size() const {
+        return (jint) data.size();
+    }
+};
+
+static inline Cnf* decode_cnf(jlong h) {
+    return (Cnf*) (intptr_t) h;
+}
+
+// Address of the direct `buffer` with the clauses passed to the `*_add_clauses_direct` functions.
+// Returns NULL with the pending `IllegalArgumentException` if the buffer is not direct
+// (or the JVM does not support the access to direct buffers from JNI).
+static inline jint* direct_clauses(JNIEnv* env, jobject buffer) {
+    jint* array = (jint*) env->GetDirectBufferAddress(buffer);
+    if (array == NULL) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Buffer is not accessible from JNI");
+    }
+    return array;
+}
+
+#endif // SATLIB_CNF_HPP
@@ -0,0 +1,83 @@
+/**
+ * Copyright © 2020, Darya Grechishkina, Konstantin Chukharev, ITMO University
+ */
+
+#ifndef SATLIB_CORE_HPP
+#define SATLIB_CORE_HPP
+
+#include <jni.h>
+#include <stdint.h>
+
+#include <unordered_set>
+#include <vector>
+
+#include "AllSat.hpp"
+
+// Extraction and minimization of the cores of failed assumptions, entirely in native code.
+//
+// The backend is an AllSat.hpp adapter additionally providing:
+//   void core(const std::vector<jint>& assumptions, std::vector<jint>& out) -- the failed `assumptions`
+//     of the last solve (which must have returned UNSAT under them), as external literals.
+
+// Store the `core` into a new Java array, or return NULL when out of memory
+static jintArray core_to_array(JNIEnv* env, const std::vector<jint>& core) {
+    jsize size = (jsize) core.size();
+    jintArray result = env->NewIntArray(size);
+    if (result == NULL) return NULL;
+    env->SetIntArrayRegion(result, 0, size, core.data());
+    return result;
+}
+
+// Deletion-based minimization of the core of `assumptions` with core refinement:
+// each candidate literal is dropped from the core, and when the rest is still UNSAT,
+// the core is replaced with the (possibly smaller) core of the rest.
+// Returns false (leaving `core` empty) when the solver did not return UNSAT under the `assumptions`.
+// Note: a literal is dropped only when the solver definitely returned UNSAT,
+//  so the core may be non-minimal when some solve was interrupted.
+template <typename Backend>
+static bool core_minimize(Backend& backend, const std::vector<jint>& assumptions, std::vector<jint>& core) {
+    core.clear();
+    if (backend.solve(assumptions) != ALLSAT_UNSAT) {
+        return false;
+    }
+    std::vector<jint> candidates;
+    backend.core(assumptions, candidates);
+    std::vector<jint> trial;
+    std::vector<jint> refined;
+    std::unordered_set<jint> kept;
+    while (!candidates.empty()) {
+        jint lit = candidates.back();
+        candidates.pop_back();
+        trial.assign(core.begin(), core.end());
+        trial.insert(trial.end(), candidates.begin(), candidates.end());
+        if (backend.solve(trial) != ALLSAT_UNSAT) {
+            core.push_back(lit); // necessary
+            continue;
+        }
+        // Note: the refined core always contains the necessary literals, so only the candidates are filtered
+        backend.core(trial, refined);
+        kept.clear();
+        kept.insert(refined.begin(), refined.end());
+        size_t k = 0;
+        for (size_t i = 0; i < candidates.size(); i++) {
+            if (kept.count(candidates[i])) candidates[k++] = candidates[i];
+        }
+        candidates.resize(k);
+    }
+    return true;
+}
+
+// Note: returns NULL when the solver did not return UNSAT under the `assumptions`
+template <typename Backend>
+static jintArray core_minimize(JNIEnv* env, Backend& backend, jintArray assumptions) {
+    jint n = env->GetArrayLength(assumptions);
+    std::vector<jint> lits(n);
+    env->GetIntArrayRegion(assumptions, 0, n, lits.data());
+    std::vector<jint> core;
+    if (!core_minimize(backend, lits, core)) {
+        return NULL;
+    }
+    return core_to_array(env, core);
+}
+
+#endif // SATLIB_CORE_HPP
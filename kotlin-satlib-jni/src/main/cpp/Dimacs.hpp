@@ -0,0 +1,335 @@
+/**
+ * Copyright © 2020, Darya Grechishkina, Konstantin Chukharev, ITMO University
+ */
+
+#ifndef SATLIB_DIMACS_HPP
+#define SATLIB_DIMACS_HPP
+
+#include <jni.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// The file is parsed by windows of (approximately) this size,
+// so that the memory used for parsed literals stays bounded even for huge files.
+static const size_t DIMACS_WINDOW_SIZE = (size_t) 64 << 20;
+
+struct DimacsResult {
+    jint num_vars;
+    int64_t num_clauses;
+    int64_t header_clauses; // declared in the header, -1 if there is no header
+    bool unsat; // some sink reported that the formula became UNSAT while loading
+};
+
+struct DimacsChunk {
+    std::vector<jint> literals;
+    jint max_var;
+    jint header_vars; // -1 if there is no header in the chunk
+    int64_t header_clauses; // -1 if there is no header in the chunk
+    int64_t num_clauses;
+    bool finished; // `%` end marker (used in SATLIB benchmarks) was met
+    bool error;
+};
+
+static inline bool dimacs_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static inline bool dimacs_is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline const char* dimacs_skip_line(const char* p, const char* end) {
+    const char* nl = (const char*) memchr(p, '\n', end - p);
+    return nl ? nl + 1 : end;
+}
+
+// Parse the decimal number at `*p` (advancing it) into `*x`, returns false if there are no digits,
+// the number exceeds `max`, or it is not followed by a whitespace or the end of input (e.g. `1-2`)
+template <typename T>
+static inline bool dimacs_parse_number(const char** p, const char* end, T max, T* x) {
+    const char* q = *p;
+    T value = 0;
+    while (q < end && dimacs_is_digit(*q)) {
+        int digit = *q - '0';
+        if (value > (max - digit) / 10) return false;
+        value = value * 10 + digit;
+        q++;
+    }
+    if (q == *p) return false;
+    if (q < end && !dimacs_is_space(*q)) return false;
+    *p = q;
+    *x = value;
+    return true;
+}
+
+// Parse DIMACS text in `[p, end)`, which must start at the beginning of a line
+static void parse_dimacs_chunk(const char* p, const char* end, DimacsChunk* out) {
+    out->literals.clear();
+    out->literals.reserve((end - p) / 4);
+    out->max_var = 0;
+    out->header_vars = -1;
+    out->header_clauses = -1;
+    out->num_clauses = 0;
+    out->finished = false;
+    out->error = false;
+
+    while (p < end) {
+        char c = *p;
+        if (dimacs_is_space(c)) {
+            p++;
+        } else if (c == 'c') {
+            p = dimacs_skip_line(p, end);
+        } else if (c == 'p') {
+            // Header: `p cnf <vars> <clauses>`
+            const char* q = p + 1;
+            while (q < end && dimacs_is_space(*q) && *q != '\n') q++;
+            if (end - q < 3 || memcmp(q, "cnf", 3) != 0) {
+                out->error = true;
+                return;
+            }
+            q += 3;
+            while (q < end && dimacs_is_space(*q) && *q != '\n') q++;
+            jint vars;
+            if (!dimacs_parse_number<jint>(&q, end, INT_MAX, &vars)) {
+                out->error = true;
+                return;
+            }
+            while (q < end && dimacs_is_space(*q) && *q != '\n') q++;
+            int64_t clauses;
+            if (!dimacs_parse_number<int64_t>(&q, end, INT64_MAX, &clauses)) {
+                out->error = true;
+                return;
+            }
+            out->header_vars = vars;
+            out->header_clauses = clauses;
+            p = dimacs_skip_line(q, end);
+        } else if (c == '%') {
+            out->finished = true;
+            return;
+        } else {
+            bool negative = c == '-';
+            if (negative) p++;
+            // Note: variables above INT_MAX cannot be represented (nor negated), so they are rejected
+            jint x;
+            if (!dimacs_parse_number<jint>(&p, end, INT_MAX, &x)) {
+                out->error = true;
+                return;
+            }
+            if (x == 0) {
+                out->num_clauses++;
+            } else if (x > out->max_var) {
+                out->max_var = x;
+            }
+            out->literals.push_back(negative ? -x : x);
+        }
+    }
+}
+
+// Source of consecutive pieces of the file, each ending at the line boundary
+class DimacsReader {
+public:
+    DimacsReader() : data(NULL), size(0), pos(0), file(NULL) {
+#ifndef _WIN32
+        fd = -1;
+#endif
+    }
+
+    ~DimacsReader() {
+#ifndef _WIN32
+        if (data != NULL) munmap((void*) data, size);
+        if (fd >= 0) close(fd);
+#endif
+        if (file != NULL) fclose(file);
+    }
+
+    bool open(const char* path) {
+#ifndef _WIN32
+        fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) return false;
+        if (S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* p = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                madvise(p, (size_t) st.st_size, MADV_SEQUENTIAL);
+                data = (const char*) p;
+                size = (size_t) st.st_size;
+                return true;
+            }
+        }
+        // Note: fall back to plain reading, e.g. for pipes and empty files
+#endif
+        file = fopen(path, "rb");
+        return file != NULL;
+    }
+
+    // Get the next piece `[*begin, *end)`, returns false at the end of file
+    bool next(const char** begin, const char** end) {
+        if (file != NULL) return next_buffered(begin, end);
+        if (pos >= size) return false;
+        size_t stop = pos + DIMACS_WINDOW_SIZE < size ? pos + DIMACS_WINDOW_SIZE : size;
+        *begin = data + pos;
+        *end = dimacs_skip_line(data + stop, data + size);
+        pos = *end - data;
+        return true;
+    }
+
+private:
+    const char* data;
+    size_t size;
+    size_t pos;
+#ifndef _WIN32
+    int fd;
+#endif
+    // Fallback without mmap
+    FILE* file;
+    std::vector<char> buffer;
+    std::vector<char> carry;
+
+    bool next_buffered(const char** begin, const char** end) {
+        buffer.swap(carry);
+        carry.clear();
+        // Note: just like a mapped window, the piece is extended up to the end of line,
+        //  so a line is never split, even if it is longer than the window
+        for (;;) {
+            size_t have = buffer.size();
+            buffer.resize(have + DIMACS_WINDOW_SIZE);
+            size_t n = fread(buffer.data() + have, 1, DIMACS_WINDOW_SIZE, file);
+            buffer.resize(have + n);
+            if (n < DIMACS_WINDOW_SIZE) break; // the end of file
+            // Note: the incomplete last line is carried over to the next piece
+            //  (the carried part has no line breaks, so only the new data is searched)
+            size_t i = buffer.size();
+            while (i > have && buffer[i - 1] != '\n') i--;
+            if (i > have) {
+                carry.assign(buffer.begin() + i, buffer.end());
+                buffer.resize(i);
+                break;
+            }
+        }
+        if (buffer.empty()) return false;
+        *begin = buffer.data();
+        *end = buffer.data() + buffer.size();
+        return true;
+    }
+};
+
+// Load DIMACS CNF from `path`, passing the zero-terminated clauses (in file order)
+// to `sink(literals, len, max_var)`, where `max_var` is the largest variable seen so far.
+// The sink returns false once the formula is known to be UNSAT (which is reported in `result->unsat`),
+// though the loading goes on, so that the whole file is checked and counted.
+// Chunks of each window are parsed on `threads` threads, but clauses are always passed in order.
+// Returns false on I/O or syntax error.
+// Note: the clauses preceding the syntax error have already been passed to the sink by then,
+//  and there is no way to take them back from the solvers, so the solver is left half-loaded.
+template <typename Sink>
+static bool load_dimacs(const char* path, int threads, Sink sink, DimacsResult* result) {
+    DimacsReader reader;
+    if (!reader.open(path)) return false;
+    if (threads < 1) threads = 1;
+
+    std::vector<DimacsChunk> chunks(threads);
+    std::vector<jint> pending; // incomplete clause continued in the next chunk
+    jint max_var = 0;
+    jint header_vars = 0;
+    int64_t header_clauses = -1;
+    int64_t num_clauses = 0;
+    bool finished = false;
+    bool unsat = false;
+
+    const char* begin;
+    const char* end;
+    while (!finished && reader.next(&begin, &end)) {
+        // Split the window at line boundaries
+        std::vector<const char*> bounds(1, begin);
+        size_t step = (end - begin) / threads + 1;
+        for (int i = 1; i < threads; i++) {
+            const char* b = bounds.back();
+            bounds.push_back((size_t) (end - b) > step ? dimacs_skip_line(b + step, end) : end);
+        }
+        bounds.push_back(end);
+
+        std::vector<std::thread> workers;
+        for (int i = 1; i < threads; i++) {
+            workers.push_back(std::thread(parse_dimacs_chunk, bounds[i], bounds[i + 1], &chunks[i]));
+        }
+        parse_dimacs_chunk(bounds[0], bounds[1], &chunks[0]);
+        for (size_t i = 0; i < workers.size(); i++) {
+            workers[i].join();
+        }
+
+        for (int i = 0; i < threads && !finished; i++) {
+            DimacsChunk& chunk = chunks[i];
+            if (chunk.error) return false;
+            finished = chunk.finished;
+            if (chunk.header_vars > header_vars) header_vars = chunk.header_vars;
+            if (chunk.header_clauses >= 0) header_clauses = chunk.header_clauses;
+            if (chunk.max_var > max_var) max_var = chunk.max_var;
+            num_clauses += chunk.num_clauses;
+
+            const jint* lits = chunk.literals.data();
+            size_t n = chunk.literals.size();
+            size_t first = 0;
+            while (first < n && lits[first] != 0) first++;
+            if (first == n) {
+                pending.insert(pending.end(), lits, lits + n);
+                continue;
+            }
+            size_t start = 0;
+            if (!pending.empty()) {
+                pending.insert(pending.end(), lits, lits + first + 1);
+                if (!sink(pending.data(), (jint) pending.size(), max_var)) unsat = true;
+                pending.clear();
+                start = first + 1;
+            }
+            size_t last = n;
+            while (lits[last - 1] != 0) last--;
+            if (last > start) {
+                if (!sink(lits + start, (jint) (last - start), max_var)) unsat = true;
+            }
+            pending.assign(lits + last, lits + n);
+        }
+    }
+
+    if (!pending.empty()) {
+        // Note: the last clause is not terminated, which is tolerated
+        pending.push_back(0);
+        num_clauses++;
+        if (!sink(pending.data(), (jint) pending.size(), max_var)) unsat = true;
+    }
+    if (header_vars > max_var) max_var = header_vars;
+    // Note: make sure all declared variables exist, even those not used in any clause
+    if (!sink((const jint*) NULL, 0, max_var)) unsat = true;
+
+    result->num_vars = max_var;
+    result->num_clauses = num_clauses;
+    result->header_clauses = header_clauses;
+    result->unsat = unsat;
+    return true;
+}
+
+// Pack the result as `[numberOfVariables, numberOfClauses, declaredClauses, unsat]` (see `DimacsInfo`)
+static jlongArray dimacs_result_array(JNIEnv* env, const DimacsResult& result) {
+    jlongArray array = env->NewLongArray(4);
+    if (array == NULL) {
+        return NULL;
+    }
+    jlong values[4] = {(jlong) result.num_vars, (jlong) result.num_clauses, (jlong) result.header_clauses,
+                       result.unsat ? 1 : 0};
+    env->SetLongArrayRegion(array, 0, 4, values);
+    return array;
+}
+
+#endif // SATLIB_DIMACS_HPP
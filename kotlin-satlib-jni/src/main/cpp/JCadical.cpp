@@ -3,27 +3,456 @@
  */
 
 #include <jni.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <climits>
+#include <thread>
+#include <vector>
 
 #include <cadical/cadical.hpp>
 
+#include "AllSat.hpp"
+#include "Assumptions.hpp"
+#include "AsyncSolve.hpp"
+#include "Cnf.hpp"
+#include "Core.hpp"
+#include "Dimacs.hpp"
+#include "Limits.hpp"
+#include "MaxSat.hpp"
+#include "Progress.hpp"
+#include "Stats.hpp"
+
 #define JNI_METHOD(rtype, name) \
     JNIEXPORT rtype JNICALL Java_com_github_lipen_satlib_jni_JCadical_##name
 
-static inline jlong encode(CaDiCaL::Solver* p) {
+#define JNI_SHARE_METHOD(rtype, name) \
+    JNIEXPORT rtype JNICALL Java_com_github_lipen_satlib_jni_JCadicalShare_##name
+
+// Learner of each solver, which is called by CaDiCaL for each learnt clause, that is, once per conflict of the search.
+// During the solves (see `solve`), it counts the conflicts for the live stats
+// and publishes the progress (see Progress.hpp) from inside the search.
+// The clauses are passed on to the `inner` learner (the endpoint of the share bus), if any,
+// since CaDiCaL only supports a single learner.
+// Note: the statistics of CaDiCaL cannot be queried during the solve, so only the conflicts are reported
+//  until the solve is finished.
+struct ProgressLearner : CaDiCaL::Learner {
+    std::atomic<int64_t> conflicts; // -1 outside of `solve`
+    std::shared_ptr<ProgressPublisher> progress;
+    CaDiCaL::Learner* inner;
+
+    ProgressLearner() : conflicts(-1), inner(NULL) {}
+
+    bool learning(int size) {
+        int64_t c = conflicts.load(std::memory_order_relaxed);
+        if (c >= 0) {
+            conflicts.store(++c, std::memory_order_relaxed);
+            if (progress && progress->due(c)) {
+                int64_t record[PROGRESS_FIELDS];
+                progress_record_init(record);
+                record[PROGRESS_CONFLICTS] = c;
+                progress->publish(record);
+            }
+        }
+        return inner != NULL && inner->learning(size);
+    }
+
+    void learn(int lit) {
+        inner->learn(lit);
+    }
+};
+
+// CaDiCaL solver remembering the assumptions of the next solve (passed to CaDiCaL by `solve`),
+// with its learner connected for the whole lifetime.
+struct Cadical : CaDiCaL::Solver {
+    std::vector<int> assumptions;
+    ProgressLearner learner;
+
+    Cadical() {
+        connect_learner(&learner);
+    }
+
+    ~Cadical() {
+        disconnect_learner();
+    }
+};
+
+static inline jlong encode(Cadical* p) {
     return (jlong) (intptr_t) p;
 }
 
-static inline CaDiCaL::Solver* decode(jlong h) {
-    return (CaDiCaL::Solver*) (intptr_t) h;
+static inline Cadical* decode(jlong h) {
+    return (Cadical*) (intptr_t) h;
+}
+
+// Fill the progress record (except for the time) from the counters of the `solver`, which must not be solving
+static void sample(CaDiCaL::Solver* solver, int64_t* record) {
+    record[PROGRESS_CONFLICTS] = solver->conflicts();
+    record[PROGRESS_DECISIONS] = solver->decisions();
+    record[PROGRESS_PROPAGATIONS] = solver->propagations();
+    record[PROGRESS_RESTARTS] = solver->restarts();
+    record[PROGRESS_LEARNTS] = solver->redundant();
+}
+
+// Solve under the remembered assumptions (forgetting them afterwards),
+// with the `conflicts` limit of this very solve (if positive).
+// The progress is published by the learner during the search, and once more after the solve,
+// with all the counters (see `ProgressLearner`).
+// Note: all the solves (except those of the share bus) go through here.
+static int solve(Cadical* solver, int64_t conflicts = 0) {
+    for (size_t i = 0; i < solver->assumptions.size(); i++) {
+        solver->assume(solver->assumptions[i]);
+    }
+    solver->assumptions.clear();
+    if (conflicts > 0) {
+        solver->limit("conflicts", (int) std::min<int64_t>(conflicts, INT_MAX));
+    }
+    ProgressLearner& learner = solver->learner;
+    learner.progress = progress_find(solver);
+    learner.conflicts = solver->conflicts();
+    int res = solver->solve();
+    learner.conflicts = -1;
+    if (learner.progress) {
+        int64_t record[PROGRESS_FIELDS];
+        progress_record_init(record);
+        sample(solver, record);
+        learner.progress->publish(record);
+        learner.progress.reset();
+    }
+    return res;
+}
+
+static inline int identity(int lit) {
+    return lit;
+}
+
+typedef AssumptionSet<std::vector<int>, int> CadicalAssumptions;
+
+// Backend adapter for AllSat.hpp, Core.hpp and MaxSat.hpp
+struct CadicalBackend {
+    Cadical* solver;
+
+    explicit CadicalBackend(Cadical* solver) : solver(solver) {}
+
+    int solve(const std::vector<jint>& assumptions) {
+        solver->assumptions.assign(assumptions.begin(), assumptions.end());
+        return ::solve(solver);
+    }
+
+    bool value(jint lit) {
+        return solver->val(lit) > 0;
+    }
+
+    void add_clause(const std::vector<jint>& literals) {
+        for (size_t i = 0; i < literals.size(); i++) {
+            solver->add(literals[i]);
+        }
+        solver->add(0);
+    }
+
+    // Note: CaDiCaL does not expose the conflict, so the `assumptions` are queried one by one
+    void core(const std::vector<jint>& assumptions, std::vector<jint>& out) {
+        out.clear();
+        for (size_t i = 0; i < assumptions.size(); i++) {
+            if (solver->failed(assumptions[i])) out.push_back(assumptions[i]);
+        }
+    }
+
+    jint max_var() {
+        return solver->vars();
+    }
+
+    void reserve(jint max_var) {
+        solver->reserve(max_var);
+    }
+
+    // Note: CaDiCaL restores the eliminated variables by itself once they are used again
+    bool eliminated(jint) {
+        return false;
+    }
+
+    void freeze(jint lit) {
+        solver->freeze(lit);
+    }
+
+    // Note: CaDiCaL collects the satisfied clauses by itself
+    void retire(jint act) {
+        solver->add(-act);
+        solver->add(0);
+    }
+};
+
+// Learnt clause sharing between CaDiCaL instances solving the same formula.
+//
+// Short learnt clauses are exported via the `Learner` interface into a ring buffer shared by all solvers.
+// Producers claim consecutive tickets atomically: the slot of the ticket `t` is `t % capacity`,
+// its sequence number is `2t+1` while the clause is being written, and `2t+2` once it is written.
+// Each solver has its own read cursor and imports new clauses (via `add`) between `solve` calls.
+// `share_solve` runs in rounds, and a round ends early (via the terminator poll) once enough clauses are pending,
+// so the import lags behind the export by about `SHARE_IMPORT_BATCH` clauses rather than a whole round.
+// Nobody ever waits: a clause overwritten before it was read is just counted as dropped,
+// and so is a clause whose slot is still being written by a producer a full lap behind
+// (then its ticket is marked as skipped in the slot, so the readers do not wait for it either).
+//
+// Note: CaDiCaL can only `add` irredundant clauses, so the imported clauses are permanent:
+//  they are never reduced, and stay in the solver after it is disconnected (see `share_1disconnect`).
+//  Hence the number of clauses imported into each solver is capped by `max_imports` (the rest are dropped).
+//  This is sound as long as the formulas of the connected solvers stay the same (or only grow),
+//  since the shared clauses are implied by the formula of their source.
+
+static const int SHARE_MAX_SIZE = 32;
+
+// A round ends early once this many clauses are waiting for the import (counting the own ones as well),
+// but not before `SHARE_MIN_ROUND` conflicts, so that the cost of re-entering the solve stays amortized.
+static const uint64_t SHARE_IMPORT_BATCH = 256;
+static const int64_t SHARE_MIN_ROUND = 1000;
+
+struct ShareSlot {
+    std::atomic<uint64_t> seq;
+    std::atomic<int> source;
+    std::atomic<int> size;
+    std::atomic<int> lits[SHARE_MAX_SIZE];
+    std::atomic<uint64_t> skipped; // 1 + the latest ticket dropped due to the contention, or 0
+};
+
+struct ShareBus;
+
+struct ShareEndpoint : CaDiCaL::Learner, CaDiCaL::Terminator {
+    ShareBus* bus;
+    Cadical* solver;
+    int id;
+    uint64_t cursor; // next ticket to read
+    std::vector<int> clause; // clause being exported
+    std::atomic<bool> stop;
+    int result;
+    bool connected;
+    int64_t conflicts; // learnt clauses so far
+    int64_t round_start; // `conflicts` at the start of the current round
+    jlong imported; // clauses imported into this solver so far
+
+    ShareEndpoint(ShareBus* bus, Cadical* solver, int id)
+        : bus(bus), solver(solver), id(id), cursor(0), stop(false), result(0), connected(true),
+          conflicts(0), round_start(0), imported(0) {}
+
+    bool learning(int size);
+    void learn(int lit);
+    bool terminate();
+};
+
+struct ShareBus {
+    std::vector<ShareSlot> slots;
+    int max_size;
+    std::atomic<uint64_t> head; // next ticket to write
+    std::atomic<jlong> exported;
+    std::atomic<jlong> imported;
+    std::atomic<jlong> dropped;
+    jlong max_imports; // per solver
+    std::vector<ShareEndpoint*> endpoints;
+    std::atomic<int> winner;
+    std::atomic<bool> interrupted;
+
+    ShareBus(size_t capacity, int max_size, jlong max_imports)
+        : slots(capacity), max_size(max_size), head(0), exported(0), imported(0), dropped(0),
+          max_imports(max_imports), winner(-1), interrupted(false) {
+        for (size_t i = 0; i < capacity; i++) {
+            slots[i].seq.store(0);
+            slots[i].skipped.store(0);
+        }
+    }
+
+    ~ShareBus() {
+        for (size_t i = 0; i < endpoints.size(); i++) {
+            if (endpoints[i]->connected) {
+                endpoints[i]->solver->learner.inner = NULL;
+            }
+            delete endpoints[i];
+        }
+    }
+};
+
+static inline jlong encode_share(ShareBus* bus) {
+    return (jlong) (intptr_t) bus;
+}
+
+static inline ShareBus* decode_share(jlong h) {
+    return (ShareBus*) (intptr_t) h;
+}
+
+// Mark the ticket `t` as skipped, unless some later ticket of the slot is already marked
+static void share_skip(ShareSlot& slot, uint64_t t) {
+    uint64_t k = slot.skipped.load(std::memory_order_relaxed);
+    while (k < t + 1 && !slot.skipped.compare_exchange_weak(k, t + 1, std::memory_order_release)) {}
 }
 
+static void share_publish(ShareBus* bus, int source, const std::vector<int>& clause) {
+    uint64_t t = bus->head.fetch_add(1);
+    ShareSlot& slot = bus->slots[t % bus->slots.size()];
+    uint64_t written = 2 * t + 2;
+    // Claim the slot, or drop the clause if the slot is taken by a newer ticket or is still being written.
+    // Note: it can be busy only when two producers are a full lap apart.
+    uint64_t s = slot.seq.load(std::memory_order_relaxed);
+    if (s >= written || (s & 1) || !slot.seq.compare_exchange_strong(s, written - 1, std::memory_order_acquire)) {
+        share_skip(slot, t);
+        bus->dropped++;
+        return;
+    }
+    slot.source.store(source, std::memory_order_relaxed);
+    slot.size.store((int) clause.size(), std::memory_order_relaxed);
+    for (size_t i = 0; i < clause.size(); i++) {
+        slot.lits[i].store(clause[i], std::memory_order_relaxed);
+    }
+    slot.seq.store(written, std::memory_order_release);
+    bus->exported++;
+}
+
+bool ShareEndpoint::learning(int size) {
+    conflicts++;
+    clause.clear();
+    return size > 0 && size <= bus->max_size;
+}
+
+void ShareEndpoint::learn(int lit) {
+    if (lit != 0) {
+        clause.push_back(lit);
+    } else {
+        share_publish(bus, id, clause);
+    }
+}
+
+// Note: only connected during the rounds of `share_run`
+bool ShareEndpoint::terminate() {
+    if (stop.load()) {
+        return true;
+    }
+    return imported < bus->max_imports && conflicts - round_start >= SHARE_MIN_ROUND
+        && bus->head.load(std::memory_order_relaxed) - cursor >= SHARE_IMPORT_BATCH;
+}
+
+// Import the clauses exported by other solvers since the last import (up to the `max_imports` in total).
+// Note: must be called only when the solver is not solving.
+static int share_import(ShareEndpoint* e) {
+    if (!e->connected) {
+        return 0;
+    }
+    ShareBus* bus = e->bus;
+    uint64_t capacity = bus->slots.size();
+    uint64_t head = bus->head.load(std::memory_order_acquire);
+    if (head > e->cursor + capacity) {
+        bus->dropped += (jlong) (head - capacity - e->cursor);
+        e->cursor = head - capacity;
+    }
+    int count = 0;
+    int lits[SHARE_MAX_SIZE];
+    while (e->cursor < head) {
+        ShareSlot& slot = bus->slots[e->cursor % capacity];
+        uint64_t written = 2 * e->cursor + 2;
+        uint64_t s = slot.seq.load(std::memory_order_acquire);
+        if (s < written) {
+            if (slot.skipped.load(std::memory_order_acquire) > e->cursor) {
+                // Dropped by the producer (and already counted)
+                e->cursor++;
+                continue;
+            }
+            break; // not written yet, retry on the next import
+        }
+        if (s == written) {
+            int source = slot.source.load(std::memory_order_relaxed);
+            int size = slot.size.load(std::memory_order_relaxed);
+            for (int i = 0; i < size; i++) {
+                lits[i] = slot.lits[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != s) {
+                bus->dropped++;
+            } else if (source != e->id) {
+                if (e->imported < bus->max_imports) {
+                    for (int i = 0; i < size; i++) {
+                        e->solver->add(lits[i]);
+                    }
+                    e->solver->add(0);
+                    e->imported++;
+                    count++;
+                } else {
+                    bus->dropped++;
+                }
+            }
+        } else {
+            bus->dropped++;
+        }
+        e->cursor++;
+    }
+    bus->imported += count;
+    return count;
+}
+
+// Solve in rounds of at most `conflicts` conflicts (see `ShareEndpoint::terminate`),
+// importing the shared clauses before each round, until some solver finds a definitive answer
+// or the bus is interrupted.
+static void share_run(ShareBus* bus, size_t i, const std::vector<int>* assumptions, int conflicts) {
+    ShareEndpoint* e = bus->endpoints[i];
+    CaDiCaL::Solver* solver = e->solver;
+    e->result = 0;
+    while (bus->winner < 0 && !bus->interrupted) {
+        share_import(e);
+        for (size_t j = 0; j < assumptions->size(); j++) {
+            solver->assume((*assumptions)[j]);
+        }
+        if (conflicts > 0) {
+            solver->limit("conflicts", conflicts);
+        }
+        e->round_start = e->conflicts;
+        solver->connect_terminator(e);
+        int res = solver->solve();
+        solver->disconnect_terminator();
+        if (res == 10 || res == 20) {
+            e->result = res;
+            int expected = -1;
+            if (bus->winner.compare_exchange_strong(expected, (int) i)) {
+                for (size_t k = 0; k < bus->endpoints.size(); k++) {
+                    bus->endpoints[k]->stop = true;
+                }
+            }
+            break;
+        }
+    }
+}
+
+static int share_solve(ShareBus* bus, const std::vector<int>& assumptions, int conflicts) {
+    bus->winner = -1;
+    for (size_t i = 0; i < bus->endpoints.size(); i++) {
+        bus->endpoints[i]->stop = bus->interrupted.load();
+    }
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < bus->endpoints.size(); i++) {
+        if (bus->endpoints[i]->connected) {
+            threads.push_back(std::thread(share_run, bus, i, &assumptions, conflicts));
+        }
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+    int w = bus->winner;
+    return w >= 0 ? bus->endpoints[w]->result : 0;
+}
+
+// Terminator of a limited solve, stopping the search once the watchdog has fired some limit.
+// Note: polling the fired limit here (instead of calling `terminate` from the watchdog)
+//  confines the termination to this very solve.
+struct LimitTerminator : CaDiCaL::Terminator {
+    const LimitScope* scope;
+
+    explicit LimitTerminator(const LimitScope* scope) : scope(scope) {}
+
+    bool terminate() { return scope->fired() != LIMIT_NONE; }
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 JNI_METHOD(jlong, cadical_1create)
   (JNIEnv*, jobject) {
-    return encode(new CaDiCaL::Solver);
+    return encode(new Cadical);
   }
 
 JNI_METHOD(void, cadical_1delete)
@@ -31,6 +460,15 @@ JNI_METHOD(void, cadical_1delete)
     delete decode(p);
   }
 
+// Note: `copy` transfers the options, irredundant clauses, units, frozen flags and the extension stack,
+//  but neither learnt clauses nor saved phases. The solver must not be solving.
+JNI_METHOD(jlong, cadical_1clone)
+  (JNIEnv*, jobject, jlong p) {
+    Cadical* clone = new Cadical;
+    decode(p)->copy(*clone);
+    return encode(clone);
+  }
+
 JNI_METHOD(jboolean, cadical_1set)
   (JNIEnv* env, jobject, jlong p, jstring name, jint value) {
     const char* s = env->GetStringUTFChars(name, 0);
@@ -72,6 +510,44 @@ JNI_METHOD(jlong, cadical_1propagations)
     return decode(handle)->propagations();
   }
 
+// Note: `out` receives the snapshot laid out as in Stats.hpp.
+//  Only the conflicts are reported while `solving` (see `ProgressLearner`).
+JNI_METHOD(void, cadical_1stats)
+  (JNIEnv* env, jobject, jlong handle, jboolean solving, jlongArray out) {
+    CaDiCaL::Solver* solver = decode(handle);
+    jlong values[STATS_SIZE];
+    stats_init(values);
+    if (solving) {
+        // Note: only the conflicts are counted during the solve (see `ProgressLearner`)
+        values[STAT_CONFLICTS] = decode(handle)->learner.conflicts.load(std::memory_order_relaxed);
+    } else {
+        values[STAT_VARIABLES] = solver->vars();
+        values[STAT_CLAUSES] = solver->irredundant();
+        values[STAT_LEARNTS] = solver->redundant();
+        values[STAT_CONFLICTS] = solver->conflicts();
+        values[STAT_DECISIONS] = solver->decisions();
+        values[STAT_PROPAGATIONS] = solver->propagations();
+        values[STAT_RESTARTS] = solver->restarts();
+    }
+    stats_store(env, out, values);
+  }
+
+// Note: returns a handle of the `ProgressPublisher` attached to the solver (see Progress.hpp)
+JNI_METHOD(jlong, cadical_1progress_1start)
+  (JNIEnv*, jobject, jlong handle, jlong conflicts_step, jint capacity) {
+    return progress_attach(decode(handle), conflicts_step, capacity);
+  }
+
+JNI_METHOD(jint, cadical_1progress_1drain)
+  (JNIEnv* env, jobject, jlong progress, jlongArray out) {
+    return progress_drain(env, progress, out);
+  }
+
+JNI_METHOD(void, cadical_1progress_1stop)
+  (JNIEnv*, jobject, jlong progress) {
+    progress_detach(progress);
+  }
+
 JNI_METHOD(jboolean, cadical_1frozen)
   (JNIEnv*, jobject, jlong p, jint lit) {
     return decode(p)->frozen(lit);
@@ -104,7 +580,12 @@ JNI_METHOD(void, cadical_1optimize)
 
 JNI_METHOD(void, cadical_1simplify)
   (JNIEnv*, jobject, jlong p) {
-    decode(p)->simplify();
+    Cadical* solver = decode(p);
+    for (size_t i = 0; i < solver->assumptions.size(); i++) {
+        solver->assume(solver->assumptions[i]);
+    }
+    solver->assumptions.clear();
+    solver->simplify();
   }
 
 JNI_METHOD(void, cadical_1terminate)
@@ -126,7 +607,7 @@ JNI_METHOD(void, cadical_1add)
 
 JNI_METHOD(void, cadical_1assume)
   (JNIEnv*, jobject, jlong p, jint lit) {
-    decode(p)->assume(lit);
+    decode(p)->assumptions.push_back(lit);
   }
 
 JNI_METHOD(void, cadical_1add_1clause)
@@ -142,22 +623,149 @@ JNI_METHOD(void, cadical_1add_1clause)
     env->ReleaseIntArrayElements(literals, array, 0);
   }
 
+JNI_METHOD(void, cadical_1add_1clauses)
+  (JNIEnv* env, jobject, jlong p, jintArray literals, jint size) {
+    CaDiCaL::Solver* solver = decode(p);
+
+    jint* array = (jint*) env->GetPrimitiveArrayCritical(literals, 0);
+    for (jint i = 0; i < size; i++) {
+        solver->add(array[i]);
+    }
+    env->ReleasePrimitiveArrayCritical(literals, array, JNI_ABORT);
+  }
+
+JNI_METHOD(void, cadical_1add_1clauses_1direct)
+  (JNIEnv* env, jobject, jlong p, jobject buffer, jint size) {
+    CaDiCaL::Solver* solver = decode(p);
+
+    jint* array = direct_clauses(env, buffer);
+    if (array == NULL) return;
+    for (jint i = 0; i < size; i++) {
+        solver->add(array[i]);
+    }
+  }
+
+// Note: `cnf` is a handle of `JCnf`
+JNI_METHOD(void, cadical_1load_1cnf)
+  (JNIEnv*, jobject, jlong p, jlong cnf) {
+    CaDiCaL::Solver* solver = decode(p);
+    const Cnf* q = decode_cnf(cnf);
+    const jint* array = q->begin();
+    for (jint i = 0; i < q->size(); i++) {
+        solver->add(array[i]);
+    }
+  }
+
+// Note: returns `dimacs_result_array`, or NULL on I/O or syntax error
+JNI_METHOD(jlongArray, cadical_1load_1dimacs)
+  (JNIEnv* env, jobject, jlong p, jstring path, jint threads) {
+    CaDiCaL::Solver* solver = decode(p);
+    const char* s = env->GetStringUTFChars(path, 0);
+    DimacsResult result;
+    // Note: CaDiCaL does not tell whether the formula became UNSAT while adding the clauses
+    bool ok = load_dimacs(s, threads, [solver](const jint* literals, jint len, jint) {
+        for (jint i = 0; i < len; i++) {
+            solver->add(literals[i]);
+        }
+        return true;
+    }, &result);
+    env->ReleaseStringUTFChars(path, s);
+    if (!ok) {
+        return NULL;
+    }
+    return dimacs_result_array(env, result);
+  }
+
 JNI_METHOD(void, cadical_1add_1assumptions)
   (JNIEnv* env, jobject, jlong p, jintArray literals) {
     jsize array_length = env->GetArrayLength(literals);
-    CaDiCaL::Solver* solver = decode(p);
+    Cadical* solver = decode(p);
 
     // TODO: use GetPrimitiveArrayCritical
     jint* array = env->GetIntArrayElements(literals, 0);
     for (int i = 0; i < array_length; i++) {
-        solver->assume(array[i]);
+        solver->assumptions.push_back(array[i]);
     }
     env->ReleaseIntArrayElements(literals, array, 0);
   }
 
 JNI_METHOD(jint, cadical_1solve)
   (JNIEnv*, jobject, jlong p) {
-    return decode(p)->solve();
+    return solve(decode(p));
+  }
+
+JNI_METHOD(jlong, cadical_1assumptions_1new)
+  (JNIEnv*, jobject) {
+    return encode_assumptions(new CadicalAssumptions());
+  }
+
+JNI_METHOD(void, cadical_1assumptions_1delete)
+  (JNIEnv*, jobject, jlong set) {
+    delete decode_assumptions<CadicalAssumptions>(set);
+  }
+
+JNI_METHOD(jint, cadical_1assumptions_1add)
+  (JNIEnv* env, jobject, jlong set, jintArray literals, jint size) {
+    return assumptions_add<CadicalAssumptions>(env, set, literals, size, identity);
+  }
+
+JNI_METHOD(jint, cadical_1assumptions_1remove)
+  (JNIEnv* env, jobject, jlong set, jintArray literals, jint size) {
+    return assumptions_remove<CadicalAssumptions>(env, set, literals, size);
+  }
+
+JNI_METHOD(void, cadical_1assumptions_1clear)
+  (JNIEnv*, jobject, jlong set) {
+    decode_assumptions<CadicalAssumptions>(set)->clear();
+  }
+
+JNI_METHOD(jint, cadical_1assumptions_1size)
+  (JNIEnv*, jobject, jlong set) {
+    return (jint) decode_assumptions<CadicalAssumptions>(set)->external.size();
+  }
+
+JNI_METHOD(jintArray, cadical_1assumptions_1literals)
+  (JNIEnv* env, jobject, jlong set) {
+    return assumptions_literals<CadicalAssumptions>(env, set);
+  }
+
+// Note: `set` is a handle of the assumption set, whose literals are assumed without any JNI array access
+JNI_METHOD(jint, cadical_1solve_1assumptions)
+  (JNIEnv*, jobject, jlong p, jlong set) {
+    Cadical* solver = decode(p);
+    const std::vector<int>& lits = decode_assumptions<CadicalAssumptions>(set)->lits;
+    solver->assumptions.insert(solver->assumptions.end(), lits.begin(), lits.end());
+    return solve(solver);
+  }
+
+// Note: `limits` is `SolveLimits.toArray()`, the result is packed by `limits_result` (see Limits.hpp).
+//  The propagation limit is not supported, since the statistics cannot be queried during the search.
+JNI_METHOD(jint, cadical_1solve_1with_1limits)
+  (JNIEnv* env, jobject, jlong p, jlongArray limits) {
+    Cadical* solver = decode(p);
+    Limits l = read_limits(env, limits);
+    int64_t conflicts = solver->conflicts();
+    LimitScope scope(l, std::function<void()>());
+    LimitTerminator terminator(&scope);
+    solver->connect_terminator(&terminator);
+    int res = solve(solver, l.conflicts);
+    solver->disconnect_terminator();
+    int limit = scope.finish();
+    if (limit == LIMIT_NONE && l.conflicts > 0 && solver->conflicts() - conflicts >= l.conflicts) {
+        limit = LIMIT_CONFLICTS;
+    }
+    return limits_result(res, limit);
+  }
+
+// Note: `future` is a `SolveFuture`, completed from a native worker thread (see AsyncSolve.hpp)
+JNI_METHOD(void, cadical_1solve_1async)
+  (JNIEnv* env, jobject, jlong p, jintArray assumptions, jobject future) {
+    Cadical* solver = decode(p);
+    std::vector<jint> assumps = async_assumptions(env, assumptions);
+    async_solve(env, future, [solver, assumps] {
+        solver->assumptions.insert(solver->assumptions.end(), assumps.begin(), assumps.end());
+        return solve(solver);
+    });
   }
 
 JNI_METHOD(jboolean, cadical_1get_1value)
@@ -182,6 +790,207 @@ JNI_METHOD(jbooleanArray, cadical_1get_1model)
     return result;
   }
 
+// Note: bit `i` of `bits` holds the value of the variable `i+1`
+JNI_METHOD(void, cadical_1get_1model_1bits)
+  (JNIEnv* env, jobject, jlong p, jlongArray bits) {
+    CaDiCaL::Solver* solver = decode(p);
+    int n = solver->vars();
+    jsize words = (n + 63) / 64;
+    if (env->GetArrayLength(bits) < words) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Bits array is too short for the model");
+        return;
+    }
+    jlong* out = (jlong*) env->GetPrimitiveArrayCritical(bits, 0);
+    for (jsize w = 0; w < words; w++) {
+        uint64_t word = 0;
+        int begin = w * 64;
+        int end = begin + 64 < n ? begin + 64 : n;
+        for (int v = begin; v < end; v++) {
+            if (solver->val(v + 1) > 0) {
+                word |= (uint64_t) 1 << (v - begin);
+            }
+        }
+        out[w] = (jlong) word;
+    }
+    env->ReleasePrimitiveArrayCritical(bits, out, 0);
+  }
+
+// Note: `values` receives lbool codes (0 = true, 1 = false) of the corresponding `literals`
+JNI_METHOD(void, cadical_1get_1values)
+  (JNIEnv* env, jobject, jlong p, jintArray literals, jbyteArray values) {
+    CaDiCaL::Solver* solver = decode(p);
+    jsize len = env->GetArrayLength(literals);
+    if (env->GetArrayLength(values) < len) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Values array is shorter than literals array");
+        return;
+    }
+    jint* lits = (jint*) env->GetPrimitiveArrayCritical(literals, 0);
+    jbyte* out = (jbyte*) env->GetPrimitiveArrayCritical(values, 0);
+    for (jsize i = 0; i < len; i++) {
+        out[i] = solver->val(lits[i]) > 0 ? 0 : 1;
+    }
+    env->ReleasePrimitiveArrayCritical(values, out, 0);
+    env->ReleasePrimitiveArrayCritical(literals, lits, JNI_ABORT);
+  }
+
+// Note: writes the projected models (bit `i` is the value of `projection[i]`) into `buffer`,
+//  returns the number of written models
+JNI_METHOD(jint, cadical_1enumerate)
+  (JNIEnv* env, jobject, jlong p, jintArray projection, jboolean minimize, jlongArray buffer) {
+    CadicalBackend backend(decode(p));
+    return allsat_enumerate(env, backend, projection, minimize, buffer);
+  }
+
+JNI_METHOD(jlong, cadical_1count_1models)
+  (JNIEnv* env, jobject, jlong p, jintArray projection, jboolean minimize, jlong limit) {
+    CadicalBackend backend(decode(p));
+    return allsat_count(env, backend, projection, minimize, limit);
+  }
+
+// Note: `handles` are handles of `JCadical`, which must outlive the bus
+JNI_SHARE_METHOD(jlong, share_1create)
+  (JNIEnv* env, jobject, jlongArray handles, jint capacity, jint max_size, jlong max_imports) {
+    jsize n = env->GetArrayLength(handles);
+    std::vector<jlong> h(n);
+    env->GetLongArrayRegion(handles, 0, n, h.data());
+    ShareBus* bus = new ShareBus((size_t) capacity, max_size < SHARE_MAX_SIZE ? max_size : SHARE_MAX_SIZE, max_imports);
+    for (jsize i = 0; i < n; i++) {
+        ShareEndpoint* e = new ShareEndpoint(bus, decode(h[i]), (int) i);
+        bus->endpoints.push_back(e);
+        e->solver->learner.inner = e;
+    }
+    return encode_share(bus);
+  }
+
+JNI_SHARE_METHOD(void, share_1delete)
+  (JNIEnv*, jobject, jlong handle) {
+    delete decode_share(handle);
+  }
+
+JNI_SHARE_METHOD(jint, share_1winner)
+  (JNIEnv*, jobject, jlong handle) {
+    return decode_share(handle)->winner;
+  }
+
+// Note: `stats` receives `[exported, imported, dropped]`
+JNI_SHARE_METHOD(void, share_1stats)
+  (JNIEnv* env, jobject, jlong handle, jlongArray stats) {
+    ShareBus* bus = decode_share(handle);
+    jlong values[3] = {bus->exported, bus->imported, bus->dropped};
+    env->SetLongArrayRegion(stats, 0, 3, values);
+  }
+
+JNI_SHARE_METHOD(jint, share_1import)
+  (JNIEnv*, jobject, jlong handle, jint index) {
+    return share_import(decode_share(handle)->endpoints[index]);
+  }
+
+// Note: the clauses already imported into the solver are kept
+JNI_SHARE_METHOD(void, share_1disconnect)
+  (JNIEnv*, jobject, jlong handle, jint index) {
+    ShareEndpoint* e = decode_share(handle)->endpoints[index];
+    if (e->connected) {
+        e->solver->learner.inner = NULL;
+        e->connected = false;
+    }
+  }
+
+JNI_SHARE_METHOD(void, share_1interrupt)
+  (JNIEnv*, jobject, jlong handle) {
+    ShareBus* bus = decode_share(handle);
+    bus->interrupted = true;
+    for (size_t i = 0; i < bus->endpoints.size(); i++) {
+        bus->endpoints[i]->stop = true;
+    }
+  }
+
+JNI_SHARE_METHOD(void, share_1clear_1interrupt)
+  (JNIEnv*, jobject, jlong handle) {
+    decode_share(handle)->interrupted = false;
+  }
+
+// Note: returns 10 (SAT), 20 (UNSAT) or 0 (interrupted), just like `cadical_solve`
+JNI_SHARE_METHOD(jint, share_1solve)
+  (JNIEnv* env, jobject, jlong handle, jintArray assumptions, jint conflicts) {
+    std::vector<int> assumps;
+    if (assumptions != NULL) {
+        jsize len = env->GetArrayLength(assumptions);
+        assumps.resize(len);
+        env->GetIntArrayRegion(assumptions, 0, len, (jint*) assumps.data());
+    }
+    return share_solve(decode_share(handle), assumps, conflicts);
+  }
+
+// Note: returns the failed ones among the `assumptions` of the last (UNSAT) solve
+JNI_METHOD(jintArray, cadical_1get_1core)
+  (JNIEnv* env, jobject, jlong p, jintArray assumptions) {
+    jint n = env->GetArrayLength(assumptions);
+    std::vector<jint> lits(n);
+    env->GetIntArrayRegion(assumptions, 0, n, lits.data());
+    CadicalBackend backend(decode(p));
+    std::vector<jint> core;
+    backend.core(lits, core);
+    return core_to_array(env, core);
+  }
+
+// Note: `set` is a handle of the assumption set of the last (UNSAT) solve
+JNI_METHOD(jintArray, cadical_1get_1core_1assumptions)
+  (JNIEnv* env, jobject, jlong p, jlong set) {
+    CadicalBackend backend(decode(p));
+    std::vector<jint> core;
+    backend.core(decode_assumptions<CadicalAssumptions>(set)->external, core);
+    return core_to_array(env, core);
+  }
+
+// Note: returns NULL when the solver did not return UNSAT under the `assumptions`
+JNI_METHOD(jintArray, cadical_1minimize_1core)
+  (JNIEnv* env, jobject, jlong p, jintArray assumptions) {
+    CadicalBackend backend(decode(p));
+    return core_minimize(env, backend, assumptions);
+  }
+
+JNI_METHOD(jlong, cadical_1maxsat_1new)
+  (JNIEnv*, jobject) {
+    return encode_maxsat(new MaxSat());
+  }
+
+JNI_METHOD(void, cadical_1maxsat_1delete)
+  (JNIEnv*, jobject, jlong engine) {
+    delete decode_maxsat(engine);
+  }
+
+JNI_METHOD(void, cadical_1maxsat_1add)
+  (JNIEnv* env, jobject, jlong engine, jintArray literals, jint size, jlong weight) {
+    maxsat_add(env, engine, literals, size, weight);
+  }
+
+JNI_METHOD(jint, cadical_1maxsat_1size)
+  (JNIEnv*, jobject, jlong engine) {
+    return decode_maxsat(engine)->size();
+  }
+
+JNI_METHOD(jint, cadical_1maxsat_1next_1var)
+  (JNIEnv*, jobject, jlong engine) {
+    return decode_maxsat(engine)->next_var;
+  }
+
+// Note: returns the status of the solve (see MaxSat.hpp)
+JNI_METHOD(jint, cadical_1maxsat_1solve)
+  (JNIEnv*, jobject, jlong p, jlong engine, jint algorithm, jboolean stratify, jint max_var) {
+    CadicalBackend backend(decode(p));
+    return maxsat_solve(backend, *decode_maxsat(engine), algorithm, stratify, max_var);
+  }
+
+JNI_METHOD(void, cadical_1maxsat_1bounds)
+  (JNIEnv* env, jobject, jlong engine, jlongArray out) {
+    maxsat_bounds(env, engine, out);
+  }
+
+JNI_METHOD(jbooleanArray, cadical_1maxsat_1model)
+  (JNIEnv* env, jobject, jlong engine) {
+    return maxsat_model(env, engine);
+  }
+
 #ifdef __cplusplus
 }
 #endif
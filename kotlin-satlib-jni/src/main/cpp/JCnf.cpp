@@ -0,0 +1,155 @@
+/**
+ * Copyright © 2020, Darya Grechishkina, Konstantin Chukharev, ITMO University
+ */
+
+#include <jni.h>
+#include <stdint.h>
+
+#include "Cardinality.hpp"
+#include "Cnf.hpp"
+
+#define JNI_METHOD(rtype, name) \
+    JNIEXPORT rtype JNICALL Java_com_github_lipen_satlib_jni_JCnf_##name
+#define JNI_TOTALIZER_METHOD(rtype, name) \
+    JNIEXPORT rtype JNICALL Java_com_github_lipen_satlib_jni_JTotalizer_##name
+
+static inline jlong encode(Cnf* p) {
+    return (jlong) (intptr_t) p;
+}
+
+static inline Cnf* decode(jlong h) {
+    return decode_cnf(h);
+}
+
+static jintArray to_int_array(JNIEnv* env, const std::vector<jint>& values) {
+    jintArray array = env->NewIntArray((jsize) values.size());
+    if (array == NULL) {
+        return NULL;
+    }
+    env->SetIntArrayRegion(array, 0, (jsize) values.size(), values.data());
+    return array;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+JNI_METHOD(jlong, cnf_1create)
+  (JNIEnv*, jobject) {
+    return encode(new Cnf);
+  }
+
+JNI_METHOD(void, cnf_1delete)
+  (JNIEnv*, jobject, jlong handle) {
+    delete decode(handle);
+  }
+
+JNI_METHOD(void, cnf_1clear)
+  (JNIEnv*, jobject, jlong handle) {
+    decode(handle)->clear();
+  }
+
+JNI_METHOD(jint, cnf_1size)
+  (JNIEnv*, jobject, jlong handle) {
+    return decode(handle)->size();
+  }
+
+JNI_METHOD(jint, cnf_1max_1var)
+  (JNIEnv*, jobject, jlong handle) {
+    return decode(handle)->max_var;
+  }
+
+JNI_METHOD(jint, cnf_1num_1clauses)
+  (JNIEnv*, jobject, jlong handle) {
+    return decode(handle)->num_clauses;
+  }
+
+JNI_METHOD(jlong, cnf_1hash)
+  (JNIEnv*, jobject, jlong handle) {
+    return (jlong) decode(handle)->hash;
+  }
+
+JNI_METHOD(void, cnf_1add_1clauses)
+  (JNIEnv* env, jobject, jlong handle, jintArray literals, jint size) {
+    jint* array = (jint*) env->GetPrimitiveArrayCritical(literals, 0);
+    decode(handle)->add(array, size);
+    env->ReleasePrimitiveArrayCritical(literals, array, JNI_ABORT);
+  }
+
+JNI_METHOD(void, cnf_1add_1clauses_1direct)
+  (JNIEnv* env, jobject, jlong handle, jobject buffer, jint size) {
+    jint* array = direct_clauses(env, buffer);
+    if (array == NULL) return;
+    decode(handle)->add(array, size);
+  }
+
+JNI_METHOD(void, cnf_1get_1literals)
+  (JNIEnv* env, jobject, jlong handle, jintArray literals) {
+    Cnf* cnf = decode(handle);
+    env->SetIntArrayRegion(literals, 0, cnf->size(), cnf->begin());
+  }
+
+JNI_METHOD(jintArray, cnf_1add_1totalizer)
+  (JNIEnv* env, jobject, jlong handle, jintArray literals, jint bound, jint first_var) {
+    CardEncoder enc(decode(handle), first_var);
+    jint n = env->GetArrayLength(literals);
+    jint* array = env->GetIntArrayElements(literals, 0);
+    Totalizer totalizer(enc, array, n, bound);
+    env->ReleaseIntArrayElements(literals, array, JNI_ABORT);
+    return to_int_array(env, totalizer.outputs());
+  }
+
+JNI_METHOD(jintArray, cnf_1add_1sequential_1counter)
+  (JNIEnv* env, jobject, jlong handle, jintArray literals, jint bound, jint first_var) {
+    CardEncoder enc(decode(handle), first_var);
+    jint n = env->GetArrayLength(literals);
+    jint* array = env->GetIntArrayElements(literals, 0);
+    std::vector<jint> outputs = encode_sequential_counter(enc, array, n, bound);
+    env->ReleaseIntArrayElements(literals, array, JNI_ABORT);
+    return to_int_array(env, outputs);
+  }
+
+JNI_METHOD(jintArray, cnf_1add_1sorting_1network)
+  (JNIEnv* env, jobject, jlong handle, jintArray literals, jint first_var) {
+    CardEncoder enc(decode(handle), first_var);
+    jint n = env->GetArrayLength(literals);
+    jint* array = env->GetIntArrayElements(literals, 0);
+    std::vector<jint> outputs = encode_sorting_network(enc, array, n);
+    env->ReleaseIntArrayElements(literals, array, JNI_ABORT);
+    return to_int_array(env, outputs);
+  }
+
+JNI_METHOD(jlong, cnf_1add_1incremental_1totalizer)
+  (JNIEnv* env, jobject, jlong handle, jintArray literals, jint bound, jint first_var) {
+    CardEncoder enc(decode(handle), first_var);
+    jint n = env->GetArrayLength(literals);
+    jint* array = env->GetIntArrayElements(literals, 0);
+    Totalizer* totalizer = new Totalizer(enc, array, n, bound);
+    env->ReleaseIntArrayElements(literals, array, JNI_ABORT);
+    return (jlong) (intptr_t) totalizer;
+  }
+
+JNI_TOTALIZER_METHOD(void, totalizer_1delete)
+  (JNIEnv*, jobject, jlong handle) {
+    delete decode_totalizer(handle);
+  }
+
+JNI_TOTALIZER_METHOD(jint, totalizer_1bound)
+  (JNIEnv*, jobject, jlong handle) {
+    return decode_totalizer(handle)->bound;
+  }
+
+JNI_TOTALIZER_METHOD(jintArray, totalizer_1outputs)
+  (JNIEnv* env, jobject, jlong handle) {
+    return to_int_array(env, decode_totalizer(handle)->outputs());
+  }
+
+JNI_TOTALIZER_METHOD(void, totalizer_1extend)
+  (JNIEnv*, jobject, jlong handle, jlong cnf, jint bound, jint first_var) {
+    CardEncoder enc(decode(cnf), first_var);
+    decode_totalizer(handle)->extend(enc, bound);
+  }
+
+#ifdef __cplusplus
+}
+#endif
@@ -3,11 +3,23 @@
  */
 
 #include <jni.h>
+#include <stdint.h>
 #include <vector>
 #include <algorithm>
+#include <limits>
 
 #include <cryptominisat5/cryptominisat.h>
 
+#include "AllSat.hpp"
+#include "Assumptions.hpp"
+#include "AsyncSolve.hpp"
+#include "Cnf.hpp"
+#include "Core.hpp"
+#include "Dimacs.hpp"
+#include "Limits.hpp"
+#include "Progress.hpp"
+#include "Stats.hpp"
+
 #define JNI_METHOD(rtype, name) \
     JNIEXPORT rtype JNICALL Java_com_github_lipen_satlib_jni_JCryptoMiniSat_##name
 
@@ -35,6 +47,12 @@ static inline CMSat::Lit toLit(int lit) {
     return CMSat::Lit(std::abs(lit) - 1, lit < 0);
 }
 
+static inline int unconvert(CMSat::Lit lit) {
+    return lit.sign() ? -(int) (lit.var() + 1) : (int) (lit.var() + 1);
+}
+
+typedef AssumptionSet<std::vector<CMSat::Lit>, CMSat::Lit> CmsAssumptions;
+
 static std::vector<CMSat::Lit> to_literals_vector(JNIEnv* env, jintArray literals) {
     jsize array_length = env->GetArrayLength(literals);
     std::vector<CMSat::Lit> clause;
@@ -48,6 +66,88 @@ static std::vector<CMSat::Lit> to_literals_vector(JNIEnv* env, jintArray literal
     return clause;
 }
 
+// Add zero-terminated clauses from `literals[0 until len]`
+static void add_clauses(CMSat::SATSolver* solver, const jint* literals, jint len) {
+    std::vector<CMSat::Lit> clause;
+    for (jint i = 0; i < len; i++) {
+        if (literals[i] == 0) {
+            solver->add_clause(clause);
+            clause.clear();
+        } else {
+            clause.push_back(toLit(literals[i]));
+        }
+    }
+}
+
+// Fill the progress record (except for the time) from the counters of the `solver`.
+// Note: called by the sampler thread of the progress publisher (see Progress.hpp) and by the stats snapshots
+//  concurrently with the solve, so only the counters (summed over the threads of CryptoMiniSat) are read.
+static void sample(const CMSat::SATSolver* solver, int64_t* record) {
+    record[PROGRESS_CONFLICTS] = (int64_t) solver->get_sum_conflicts();
+    record[PROGRESS_DECISIONS] = (int64_t) solver->get_sum_decisions();
+    record[PROGRESS_PROPAGATIONS] = (int64_t) solver->get_sum_propagations();
+}
+
+// Solve (under the `assumptions`, if not NULL), with the `conflicts` limit of this very solve (if positive).
+// Note: all the solves go through here. Returns 10 (SAT), 20 (UNSAT) or 0.
+static int solve(CMSat::SATSolver* solver, const std::vector<CMSat::Lit>* assumptions, int64_t conflicts = 0) {
+    if (conflicts > 0) {
+        solver->set_max_confl(conflicts);
+    }
+    int res = correctReturnValue(solver->solve(assumptions));
+    if (conflicts > 0) {
+        // Note: the limit is relative to the current number of conflicts, so it cannot be just `max()`
+        solver->set_max_confl(std::numeric_limits<int64_t>::max());
+    }
+    return res;
+}
+
+// Backend adapter for AllSat.hpp and Core.hpp
+struct CmsBackend {
+    CMSat::SATSolver* solver;
+
+    explicit CmsBackend(CMSat::SATSolver* solver) : solver(solver) {}
+
+    int solve(const std::vector<jint>& assumptions) {
+        std::vector<CMSat::Lit> lits;
+        lits.reserve(assumptions.size());
+        for (size_t i = 0; i < assumptions.size(); i++) {
+            lits.push_back(toLit(assumptions[i]));
+        }
+        return ::solve(solver, &lits);
+    }
+
+    bool value(jint lit) {
+        CMSat::lbool v = solver->get_model()[std::abs(lit) - 1];
+        return lit > 0 ? v == CMSat::l_True : v == CMSat::l_False;
+    }
+
+    void add_clause(const std::vector<jint>& literals) {
+        std::vector<CMSat::Lit> clause;
+        clause.reserve(literals.size());
+        for (size_t i = 0; i < literals.size(); i++) {
+            clause.push_back(toLit(literals[i]));
+        }
+        solver->add_clause(clause);
+    }
+
+    // Note: the conflict consists of the negations of the failed assumptions
+    void core(const std::vector<jint>&, std::vector<jint>& out) {
+        const std::vector<CMSat::Lit>& conflict = solver->get_conflict();
+        out.clear();
+        for (size_t i = 0; i < conflict.size(); i++) {
+            out.push_back(-unconvert(conflict[i]));
+        }
+    }
+
+    // Note: CryptoMiniSat restores the eliminated variables by itself once they are used again
+    bool eliminated(jint) {
+        return false;
+    }
+
+    void freeze(jint) {}
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -83,15 +183,138 @@ JNI_METHOD(void, cms_1add_1clause)
     decode(p)->add_clause(lits);
   }
 
+JNI_METHOD(void, cms_1add_1clauses)
+  (JNIEnv* env, jobject, jlong p, jintArray literals, jint size) {
+    jint* array = (jint*) env->GetPrimitiveArrayCritical(literals, 0);
+    add_clauses(decode(p), array, size);
+    env->ReleasePrimitiveArrayCritical(literals, array, JNI_ABORT);
+  }
+
+JNI_METHOD(void, cms_1add_1clauses_1direct)
+  (JNIEnv* env, jobject, jlong p, jobject buffer, jint size) {
+    jint* array = direct_clauses(env, buffer);
+    if (array == NULL) return;
+    add_clauses(decode(p), array, size);
+  }
+
+// Note: `cnf` is a handle of `JCnf`
+JNI_METHOD(void, cms_1load_1cnf)
+  (JNIEnv*, jobject, jlong p, jlong cnf) {
+    CMSat::SATSolver* solver = decode(p);
+    const Cnf* q = decode_cnf(cnf);
+    if (solver->nVars() < (unsigned) q->max_var) {
+        solver->new_vars(q->max_var - solver->nVars());
+    }
+    add_clauses(solver, q->begin(), q->size());
+  }
+
+// Note: returns `dimacs_result_array`, or NULL on I/O or syntax error
+JNI_METHOD(jlongArray, cms_1load_1dimacs)
+  (JNIEnv* env, jobject, jlong p, jstring path, jint threads) {
+    CMSat::SATSolver* solver = decode(p);
+    const char* s = env->GetStringUTFChars(path, 0);
+    DimacsResult result;
+    bool ok = load_dimacs(s, threads, [solver](const jint* literals, jint len, jint max_var) {
+        if (solver->nVars() < (unsigned) max_var) {
+            solver->new_vars(max_var - solver->nVars());
+        }
+        // Note: the UNSAT formula is only detected by the solve
+        add_clauses(solver, literals, len);
+        return true;
+    }, &result);
+    env->ReleaseStringUTFChars(path, s);
+    if (!ok) {
+        return NULL;
+    }
+    return dimacs_result_array(env, result);
+  }
+
 JNI_METHOD(jint, cms_1solve__J)
   (JNIEnv*, jobject, jlong p) {
-    return correctReturnValue(decode(p)->solve());
+    return solve(decode(p), NULL);
   }
 
 JNI_METHOD(jint, cms_1solve__J_3I)
   (JNIEnv* env, jobject, jlong p, jintArray assumptions) {
     auto lits = to_literals_vector(env, assumptions);
-    return correctReturnValue(decode(p)->solve(&lits));
+    return solve(decode(p), &lits);
+  }
+
+JNI_METHOD(jlong, cms_1assumptions_1new)
+  (JNIEnv*, jobject) {
+    return encode_assumptions(new CmsAssumptions());
+  }
+
+JNI_METHOD(void, cms_1assumptions_1delete)
+  (JNIEnv*, jobject, jlong set) {
+    delete decode_assumptions<CmsAssumptions>(set);
+  }
+
+JNI_METHOD(jint, cms_1assumptions_1add)
+  (JNIEnv* env, jobject, jlong set, jintArray literals, jint size) {
+    return assumptions_add<CmsAssumptions>(env, set, literals, size, toLit);
+  }
+
+JNI_METHOD(jint, cms_1assumptions_1remove)
+  (JNIEnv* env, jobject, jlong set, jintArray literals, jint size) {
+    return assumptions_remove<CmsAssumptions>(env, set, literals, size);
+  }
+
+JNI_METHOD(void, cms_1assumptions_1clear)
+  (JNIEnv*, jobject, jlong set) {
+    decode_assumptions<CmsAssumptions>(set)->clear();
+  }
+
+JNI_METHOD(jint, cms_1assumptions_1size)
+  (JNIEnv*, jobject, jlong set) {
+    return (jint) decode_assumptions<CmsAssumptions>(set)->external.size();
+  }
+
+JNI_METHOD(jintArray, cms_1assumptions_1literals)
+  (JNIEnv* env, jobject, jlong set) {
+    return assumptions_literals<CmsAssumptions>(env, set);
+  }
+
+// Note: `set` is a handle of the assumption set, solved under without any copying, conversion or sorting
+JNI_METHOD(jint, cms_1solve_1assumptions)
+  (JNIEnv*, jobject, jlong p, jlong set) {
+    return solve(decode(p), &decode_assumptions<CmsAssumptions>(set)->lits);
+  }
+
+// Note: `limits` is `SolveLimits.toArray()`, the result is packed by `limits_result` (see Limits.hpp).
+//  The propagation limit is not supported, since CryptoMiniSat has no propagation budget.
+//  Note: `assumptions` may be NULL.
+JNI_METHOD(jint, cms_1solve_1with_1limits)
+  (JNIEnv* env, jobject, jlong p, jintArray assumptions, jlongArray limits) {
+    CMSat::SATSolver* solver = decode(p);
+    Limits l = read_limits(env, limits);
+    std::vector<CMSat::Lit> lits;
+    if (assumptions != NULL) {
+        lits = to_literals_vector(env, assumptions);
+    }
+    uint64_t conflicts = solver->get_sum_conflicts();
+    LimitScope scope(l, [solver] { solver->interrupt_asap(); });
+    int res = solve(solver, assumptions != NULL ? &lits : NULL, l.conflicts);
+    int limit = scope.finish();
+    if (limit == LIMIT_NONE && l.conflicts > 0 && solver->get_sum_conflicts() - conflicts >= (uint64_t) l.conflicts) {
+        limit = LIMIT_CONFLICTS;
+    }
+    return limits_result(res, limit);
+  }
+
+// Note: `future` is a `SolveFuture`, completed from a native worker thread (see AsyncSolve.hpp)
+JNI_METHOD(void, cms_1solve_1async)
+  (JNIEnv* env, jobject, jlong p, jintArray assumptions, jobject future) {
+    CMSat::SATSolver* solver = decode(p);
+    std::vector<jint> assumps = async_assumptions(env, assumptions);
+    async_solve(env, future, [solver, assumps] {
+        std::vector<CMSat::Lit> lits;
+        lits.reserve(assumps.size());
+        for (jint lit : assumps) {
+            lits.push_back(toLit(lit));
+        }
+        return solve(solver, &lits);
+    });
   }
 
 JNI_METHOD(jint, cms_1simplify__J)
@@ -128,6 +351,95 @@ JNI_METHOD(jbooleanArray, cms_1get_1model)
     return result;
   }
 
+// Note: bit `i` of `bits` holds the value of the variable `i+1`
+JNI_METHOD(void, cms_1get_1model_1bits)
+  (JNIEnv* env, jobject, jlong p, jlongArray bits) {
+    CMSat::SATSolver* solver = decode(p);
+    const std::vector<CMSat::lbool>& model = solver->get_model();
+    int n = solver->nVars();
+    int m = (int) model.size() < n ? (int) model.size() : n;
+    jsize words = (n + 63) / 64;
+    if (env->GetArrayLength(bits) < words) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Bits array is too short for the model");
+        return;
+    }
+    jlong* out = (jlong*) env->GetPrimitiveArrayCritical(bits, 0);
+    for (jsize w = 0; w < words; w++) {
+        uint64_t word = 0;
+        int begin = w * 64;
+        int end = begin + 64 < m ? begin + 64 : m;
+        for (int v = begin; v < end; v++) {
+            if (model[v] == CMSat::l_True) {
+                word |= (uint64_t) 1 << (v - begin);
+            }
+        }
+        out[w] = (jlong) word;
+    }
+    env->ReleasePrimitiveArrayCritical(bits, out, 0);
+  }
+
+// Note: `values` receives lbool codes (0 = true, 1 = false, 2 = undef) of the corresponding `literals`
+JNI_METHOD(void, cms_1get_1values)
+  (JNIEnv* env, jobject, jlong p, jintArray literals, jbyteArray values) {
+    const std::vector<CMSat::lbool>& model = decode(p)->get_model();
+    jsize len = env->GetArrayLength(literals);
+    if (env->GetArrayLength(values) < len) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Values array is shorter than literals array");
+        return;
+    }
+    jint* lits = (jint*) env->GetPrimitiveArrayCritical(literals, 0);
+    jbyte* out = (jbyte*) env->GetPrimitiveArrayCritical(values, 0);
+    for (jsize i = 0; i < len; i++) {
+        jint lit = lits[i];
+        size_t v = (size_t) (lit > 0 ? lit : -lit) - 1;
+        if (lit != 0 && v < model.size() && model[v] != CMSat::l_Undef) {
+            out[i] = (jbyte) ((model[v] == CMSat::l_True) != (lit > 0));
+        } else {
+            out[i] = 2;
+        }
+    }
+    env->ReleasePrimitiveArrayCritical(values, out, 0);
+    env->ReleasePrimitiveArrayCritical(literals, lits, JNI_ABORT);
+  }
+
+// Note: `out` receives the snapshot laid out as in Stats.hpp.
+//  CryptoMiniSat only reports the sums of the counters over all its threads.
+JNI_METHOD(void, cms_1stats)
+  (JNIEnv* env, jobject, jlong p, jboolean solving, jlongArray out) {
+    CMSat::SATSolver* solver = decode(p);
+    jlong values[STATS_SIZE];
+    stats_init(values);
+    if (solving) {
+        int64_t record[PROGRESS_FIELDS];
+        progress_record_init(record);
+        sample(solver, record);
+        progress_stats(record, values);
+    } else {
+        values[STAT_VARIABLES] = solver->nVars();
+        values[STAT_CONFLICTS] = (jlong) solver->get_sum_conflicts();
+        values[STAT_DECISIONS] = (jlong) solver->get_sum_decisions();
+        values[STAT_PROPAGATIONS] = (jlong) solver->get_sum_propagations();
+    }
+    stats_store(env, out, values);
+  }
+
+// Note: returns a handle of the `ProgressPublisher` attached to the solver (see Progress.hpp)
+JNI_METHOD(jlong, cms_1progress_1start)
+  (JNIEnv*, jobject, jlong p, jlong conflicts_step, jint capacity) {
+    CMSat::SATSolver* solver = decode(p);
+    return progress_attach(solver, conflicts_step, capacity, [solver](int64_t* record) { sample(solver, record); });
+  }
+
+JNI_METHOD(jint, cms_1progress_1drain)
+  (JNIEnv* env, jobject, jlong progress, jlongArray out) {
+    return progress_drain(env, progress, out);
+  }
+
+JNI_METHOD(void, cms_1progress_1stop)
+  (JNIEnv*, jobject, jlong progress) {
+    progress_detach(progress);
+  }
+
 JNI_METHOD(void, cms_1set_1num_1threads)
   (JNIEnv*, jobject, jlong p, jint n) {
     decode(p)->set_num_threads(n);
@@ -158,6 +470,36 @@ JNI_METHOD(void, cms_1no_1simplify_1at_1startup)
     decode(p)->set_no_simplify_at_startup();
   }
 
+// Note: writes the projected models (bit `i` is the value of `projection[i]`) into `buffer`,
+//  returns the number of written models
+JNI_METHOD(jint, cms_1enumerate)
+  (JNIEnv* env, jobject, jlong p, jintArray projection, jboolean minimize, jlongArray buffer) {
+    CmsBackend backend(decode(p));
+    return allsat_enumerate(env, backend, projection, minimize, buffer);
+  }
+
+JNI_METHOD(jlong, cms_1count_1models)
+  (JNIEnv* env, jobject, jlong p, jintArray projection, jboolean minimize, jlong limit) {
+    CmsBackend backend(decode(p));
+    return allsat_count(env, backend, projection, minimize, limit);
+  }
+
+// Note: returns the failed assumptions of the last (UNSAT) solve
+JNI_METHOD(jintArray, cms_1get_1core)
+  (JNIEnv* env, jobject, jlong p) {
+    CmsBackend backend(decode(p));
+    std::vector<jint> core;
+    backend.core(std::vector<jint>(), core);
+    return core_to_array(env, core);
+  }
+
+// Note: returns NULL when the solver did not return UNSAT under the `assumptions`
+JNI_METHOD(jintArray, cms_1minimize_1core)
+  (JNIEnv* env, jobject, jlong p, jintArray assumptions) {
+    CmsBackend backend(decode(p));
+    return core_minimize(env, backend, assumptions);
+  }
+
 #ifdef __cplusplus
 }
 #endif
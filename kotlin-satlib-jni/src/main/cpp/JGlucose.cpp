@@ -7,6 +7,18 @@
 
 #include <glucose/simp/SimpSolver.h>
 
+#include "AllSat.hpp"
+#include "Assumptions.hpp"
+#include "AsyncSolve.hpp"
+#include "Cnf.hpp"
+#include "Core.hpp"
+#include "Dimacs.hpp"
+#include "Limits.hpp"
+#include "MaxSat.hpp"
+#include "Preprocess.hpp"
+#include "Progress.hpp"
+#include "Stats.hpp"
+
 #define JNI_METHOD(rtype, name) \
     JNIEXPORT rtype JNICALL Java_com_github_lipen_satlib_jni_JGlucose_##name
 
@@ -28,6 +40,323 @@ static inline Glucose::Lit convert(int lit) {
     return Glucose::toLit(lit > 0 ? (lit - 1) << 1 : ((-lit - 1) << 1) + 1);
 }
 
+// Internal lit to external lit
+static inline int unconvert(Glucose::Lit lit) {
+    return Glucose::sign(lit) ? -(Glucose::var(lit) + 1) : Glucose::var(lit) + 1;
+}
+
+typedef AssumptionSet<Glucose::vec<Glucose::Lit>, Glucose::Lit> GlucoseAssumptions;
+
+// Add zero-terminated clauses from `literals[0 until len]`
+static bool add_clauses(Glucose::SimpSolver* solver, const jint* literals, jint len) {
+    Glucose::vec<Glucose::Lit> clause;
+    for (jint i = 0; i < len; i++) {
+        if (literals[i] == 0) {
+            if (!solver->addClause_(clause)) return false;
+            clause.clear();
+        } else {
+            clause.push(convert(literals[i]));
+        }
+    }
+    return solver->okay();
+}
+
+// Access to the protected state of Glucose, required for cloning and for the limited solves.
+// Note: no instance of this struct is ever created, it only names the protected members,
+//  so that pointers to them can be applied to any `SimpSolver`.
+struct GlucoseState : Glucose::SimpSolver {
+    static Glucose::SimpSolver* clone(Glucose::SimpSolver* src);
+    static void save(Glucose::SimpSolver* src, Preprocessed& out);
+    static Glucose::SimpSolver* load(const PreprocessedView& in);
+    static Glucose::lbool solve_ignoring_budgets(Glucose::SimpSolver* solver, const Glucose::vec<Glucose::Lit>& assumptions,
+                                          bool do_simp, bool turn_off_simp);
+    static jint solve_with_limits(Glucose::SimpSolver* solver, const Glucose::vec<Glucose::Lit>& assumptions,
+                                  bool do_simp, bool turn_off_simp, const Limits& l);
+    static void retire(Glucose::SimpSolver* solver, Glucose::Lit guard);
+};
+
+#define STATE(solver, member) ((solver)->*(&GlucoseState::member))
+
+// Fill the progress record (except for the time) from the counters of the `solver`.
+// Note: called by the sampler thread of the progress publisher (see Progress.hpp) and by the stats snapshots
+//  concurrently with the solve, so only the plain counters and sizes are read, without synchronization.
+static void sample(const Glucose::SimpSolver* solver, int64_t* record) {
+    record[PROGRESS_CONFLICTS] = (int64_t) solver->conflicts;
+    record[PROGRESS_DECISIONS] = (int64_t) solver->decisions;
+    record[PROGRESS_PROPAGATIONS] = (int64_t) solver->propagations;
+    record[PROGRESS_RESTARTS] = (int64_t) solver->starts;
+    record[PROGRESS_TRAIL] = solver->nAssigns();
+    record[PROGRESS_LEARNTS] = solver->nLearnts();
+}
+
+// Same as `SimpSolver::solveLimited`, ignoring the budgets of the user, which are kept for the later solves
+Glucose::lbool GlucoseState::solve_ignoring_budgets(Glucose::SimpSolver* solver, const Glucose::vec<Glucose::Lit>& assumptions,
+                                          bool do_simp, bool turn_off_simp) {
+    int64_t conflict_budget = STATE(solver, conflict_budget);
+    int64_t propagation_budget = STATE(solver, propagation_budget);
+    solver->budgetOff();
+    Glucose::lbool res = solver->solveLimited(assumptions, do_simp, turn_off_simp);
+    STATE(solver, conflict_budget) = conflict_budget;
+    STATE(solver, propagation_budget) = propagation_budget;
+    return res;
+}
+
+// Solve under the limits `l`, returning `limits_result` (see Limits.hpp).
+// The conflict and propagation limits replace the budgets of the user for this solve only,
+// and the interrupt raised by the wall-clock or memory limit is cleared afterwards,
+// unless the solver has already been interrupted by the user.
+// Note: an interrupt of the user arriving after the limit has fired is indistinguishable, so it is cleared as well.
+jint GlucoseState::solve_with_limits(Glucose::SimpSolver* solver, const Glucose::vec<Glucose::Lit>& assumptions,
+                                  bool do_simp, bool turn_off_simp, const Limits& l) {
+    int64_t conflict_budget = STATE(solver, conflict_budget);
+    int64_t propagation_budget = STATE(solver, propagation_budget);
+    uint64_t conflicts = solver->conflicts;
+    uint64_t propagations = solver->propagations;
+    solver->budgetOff();
+    if (l.conflicts > 0) solver->setConfBudget(l.conflicts);
+    if (l.propagations > 0) solver->setPropBudget(l.propagations);
+    std::atomic<bool> raised(false);
+    LimitScope scope(l, [solver, &raised] {
+        if (!STATE(solver, asynch_interrupt)) {
+            raised = true;
+            solver->interrupt();
+        }
+    });
+    int res = Glucose::toInt(solver->solveLimited(assumptions, do_simp, turn_off_simp));
+    int limit = scope.finish();
+    if (raised) {
+        solver->clearInterrupt();
+    }
+    if (limit == LIMIT_NONE) {
+        if (l.conflicts > 0 && solver->conflicts - conflicts >= (uint64_t) l.conflicts) {
+            limit = LIMIT_CONFLICTS;
+        } else if (l.propagations > 0 && solver->propagations - propagations >= (uint64_t) l.propagations) {
+            limit = LIMIT_PROPAGATIONS;
+        }
+    }
+    STATE(solver, conflict_budget) = conflict_budget;
+    STATE(solver, propagation_budget) = propagation_budget;
+    return limits_result(res == 0 ? 10 : res == 1 ? 20 : 0, limit);
+}
+
+// Remove the original clauses containing the `guard` literal and fix it to true.
+// Note: the satisfied original clauses are otherwise dropped only by the simplification,
+//  which is usually off once the first solve is over (see `SimpStrategy`).
+void GlucoseState::retire(Glucose::SimpSolver* solver, Glucose::Lit guard) {
+    Glucose::vec<Glucose::CRef>& clauses = STATE(solver, clauses);
+    int j = 0;
+    for (int i = 0; i < clauses.size(); i++) {
+        const Glucose::Clause& c = STATE(solver, ca)[clauses[i]];
+        bool guarded = false;
+        for (int k = 0; k < c.size() && !guarded; k++) {
+            guarded = c[k] == guard;
+        }
+        if (guarded) {
+            (solver->*(&GlucoseState::removeClause))(clauses[i]);
+        } else {
+            clauses[j++] = clauses[i];
+        }
+    }
+    clauses.shrink(clauses.size() - j);
+    solver->addClause(guard);
+}
+
+// Same as `SimpSolver::solve`, which ignores the budgets
+static bool solve_unlimited(Glucose::SimpSolver* solver, const Glucose::vec<Glucose::Lit>& assumptions,
+                            bool do_simp, bool turn_off_simp) {
+    solver->budgetOff();
+    return Glucose::toInt(solver->solveLimited(assumptions, do_simp, turn_off_simp)) == 0;
+}
+
+// Backend adapter for AllSat.hpp, Core.hpp and MaxSat.hpp
+struct GlucoseBackend {
+    Glucose::SimpSolver* solver;
+
+    explicit GlucoseBackend(Glucose::SimpSolver* solver) : solver(solver) {}
+
+    int solve(const std::vector<jint>& assumptions) {
+        Glucose::vec<Glucose::Lit> vec((int) assumptions.size());
+        for (size_t i = 0; i < assumptions.size(); i++) {
+            vec[(int) i] = convert(assumptions[i]);
+        }
+        // Note: simplification is not performed, since blocking clauses may mention any projected variable
+        int res = Glucose::toInt(solver->solveLimited(vec, false, false));
+        return res == 0 ? ALLSAT_SAT : res == 1 ? ALLSAT_UNSAT : 0;
+    }
+
+    bool value(jint lit) {
+        return Glucose::toInt(solver->modelValue(convert(lit))) == 0;
+    }
+
+    void add_clause(const std::vector<jint>& literals) {
+        Glucose::vec<Glucose::Lit> clause((int) literals.size());
+        for (size_t i = 0; i < literals.size(); i++) {
+            clause[(int) i] = convert(literals[i]);
+        }
+        solver->addClause_(clause);
+    }
+
+    // Note: the final conflict consists of the negations of the failed assumptions
+    void core(const std::vector<jint>&, std::vector<jint>& out) {
+        out.clear();
+        for (int i = 0; i < solver->conflict.size(); i++) {
+            out.push_back(-unconvert(solver->conflict[i]));
+        }
+    }
+
+    jint max_var() {
+        return solver->nVars();
+    }
+
+    void reserve(jint max_var) {
+        while (solver->nVars() < max_var) {
+            solver->newVar();
+        }
+    }
+
+    bool eliminated(jint lit) {
+        return solver->isEliminated(lit2var(lit));
+    }
+
+    void freeze(jint lit) {
+        solver->setFrozen(lit2var(lit), true);
+    }
+
+    void retire(jint act) {
+        GlucoseState::retire(solver, convert(-act));
+    }
+};
+
+// Deep copy of the solver state: variables (with their decision flags, saved polarities,
+// frozen and eliminated flags), top-level units, original and learnt clauses (with their LBD).
+// Note: the solver must not be solving (it is at the top level then).
+Glucose::SimpSolver* GlucoseState::clone(Glucose::SimpSolver* src) {
+    Glucose::SimpSolver* dst = new Glucose::SimpSolver();
+    dst->random_seed = src->random_seed;
+    dst->random_var_freq = src->random_var_freq;
+    dst->rnd_pol = src->rnd_pol;
+    dst->rnd_init_act = src->rnd_init_act;
+    if (src->isIncremental()) {
+        dst->setIncrementalMode();
+    }
+    if (!STATE(src, use_simplification)) {
+        dst->eliminate(true);
+    }
+
+    int n = src->nVars();
+    for (Glucose::Var v = 0; v < n; v++) {
+        dst->newVar(STATE(src, polarity)[v], STATE(src, decision)[v]);
+        STATE(dst, eliminated)[v] = STATE(src, eliminated)[v];
+        if (STATE(src, frozen)[v]) dst->setFrozen(v, true);
+    }
+    STATE(src, elimclauses).copyTo(STATE(dst, elimclauses));
+    if (!src->okay()) {
+        dst->addEmptyClause();
+        return dst;
+    }
+
+    for (Glucose::Var v = 0; v < n; v++) {
+        int value = Glucose::toInt(src->value(v));
+        if (value == 0 || value == 1) dst->addClause(Glucose::mkLit(v, value == 1));
+    }
+    Glucose::vec<Glucose::Lit> lits;
+    const Glucose::vec<Glucose::CRef>& clauses = STATE(src, clauses);
+    for (int i = 0; i < clauses.size(); i++) {
+        const Glucose::Clause& c = STATE(src, ca)[clauses[i]];
+        if (c.mark() == 1) continue; // removed
+        lits.clear();
+        for (int j = 0; j < c.size(); j++) lits.push(c[j]);
+        dst->addClause_(lits);
+    }
+    // Note: learnt clauses are attached directly, so that they remain subject to the usual reduction
+    const Glucose::vec<Glucose::CRef>& learnts = STATE(src, learnts);
+    for (int i = 0; i < learnts.size() && dst->okay(); i++) {
+        Glucose::Clause& c = STATE(src, ca)[learnts[i]];
+        if (c.mark() == 1 || c.size() < 2) continue;
+        bool assigned = false;
+        lits.clear();
+        for (int j = 0; j < c.size(); j++) {
+            if (Glucose::toInt(dst->value(c[j])) != 2) assigned = true;
+            lits.push(c[j]);
+        }
+        // Note: clauses with assigned literals would break the watching invariants
+        if (assigned) continue;
+        Glucose::CRef cr = STATE(dst, ca).alloc(lits, true);
+        STATE(dst, ca)[cr].activity() = c.activity();
+        STATE(dst, ca)[cr].setLBD(c.lbd());
+        STATE(dst, learnts).push(cr);
+        (dst->*(&GlucoseState::attachClause))(cr);
+    }
+    return dst;
+}
+
+// Store the (simplified) formula into the artifact: variables (with their decision flags, saved polarities, 
+// frozen and eliminated flags), the reconstruction stack, top-level units and original clauses.
+// Note: learnt clauses are not stored, and the solver must not be solving.
+void GlucoseState::save(Glucose::SimpSolver* src, Preprocessed& out) {
+    int n = src->nVars();
+    out.var_flags.resize(n);
+    for (Glucose::Var v = 0; v < n; v++) {
+        uint8_t flags = 0;
+        if (STATE(src, polarity)[v]) flags |= VAR_POLARITY;
+        if (STATE(src, decision)[v]) flags |= VAR_DECISION;
+        if (STATE(src, frozen)[v]) flags |= VAR_FROZEN;
+        if (STATE(src, eliminated)[v]) flags |= VAR_ELIMINATED;
+        out.var_flags[v] = flags;
+    }
+    const Glucose::vec<uint32_t>& elimclauses = STATE(src, elimclauses);
+    out.elim.resize(elimclauses.size());
+    for (int i = 0; i < elimclauses.size(); i++) {
+        out.elim[i] = elimclauses[i];
+    }
+    if (!STATE(src, use_simplification)) out.header.flags |= PREPROCESSED_SIMP_OFF;
+    if (!src->okay()) return;
+    out.header.flags |= PREPROCESSED_OKAY;
+
+    for (Glucose::Var v = 0; v < n; v++) {
+        int value = Glucose::toInt(src->value(v));
+        if (value == 0 || value == 1) out.units.push_back(value == 1 ? -(v + 1) : v + 1);
+    }
+    const Glucose::vec<Glucose::CRef>& clauses = STATE(src, clauses);
+    for (int i = 0; i < clauses.size(); i++) {
+        const Glucose::Clause& c = STATE(src, ca)[clauses[i]];
+        if (c.mark() == 1) continue; // removed
+        for (int j = 0; j < c.size(); j++) out.literals.push_back(unconvert(c[j]));
+        out.literals.push_back(0);
+    }
+}
+
+// Restore the solver from the artifact (see `save`), so that its models are extended back to the eliminated variables.
+Glucose::SimpSolver* GlucoseState::load(const PreprocessedView& in) {
+    Glucose::SimpSolver* dst = new Glucose::SimpSolver();
+    if (in.header->flags & PREPROCESSED_SIMP_OFF) {
+        dst->eliminate(true);
+    }
+
+    int n = in.header->num_vars;
+    for (Glucose::Var v = 0; v < n; v++) {
+        uint8_t flags = in.var_flags[v];
+        dst->newVar((flags & VAR_POLARITY) != 0, (flags & VAR_DECISION) != 0);
+        STATE(dst, eliminated)[v] = (flags & VAR_ELIMINATED) != 0;
+        if (flags & VAR_FROZEN) dst->setFrozen(v, true);
+    }
+    for (int64_t i = 0; i < in.header->num_elim; i++) {
+        STATE(dst, elimclauses).push(in.elim[i]);
+    }
+    if (!(in.header->flags & PREPROCESSED_OKAY)) {
+        dst->addEmptyClause();
+        return dst;
+    }
+
+    for (int64_t i = 0; i < in.header->num_units; i++) {
+        dst->addClause(convert(in.units[i]));
+    }
+    add_clauses(dst, in.literals, (jint) in.header->num_literals);
+    return dst;
+}
+
+#undef STATE
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -37,6 +366,12 @@ JNI_METHOD(jlong, glucose_1ctor)
     return encode(new Glucose::SimpSolver());
   }
 
+// Note: returns a handle of the independent copy of the solver
+JNI_METHOD(jlong, glucose_1clone)
+  (JNIEnv*, jobject, jlong handle) {
+    return encode(GlucoseState::clone(decode(handle)));
+  }
+
 JNI_METHOD(void, glucose_1dtor)
   (JNIEnv*, jobject, jlong handle) {
     delete decode(handle);
@@ -87,6 +422,49 @@ JNI_METHOD(jlong, glucose_1conflicts)
     return decode(handle)->conflicts;
 }
 
+// Note: `out` receives the snapshot laid out as in Stats.hpp.
+//  The counters are read without synchronization, so the snapshot taken during the solve is approximate.
+JNI_METHOD(void, glucose_1stats)
+  (JNIEnv* env, jobject, jlong handle, jboolean solving, jlongArray out) {
+    Glucose::SimpSolver* solver = decode(handle);
+    jlong values[STATS_SIZE];
+    stats_init(values);
+    if (solving) {
+        int64_t record[PROGRESS_FIELDS];
+        progress_record_init(record);
+        sample(solver, record);
+        progress_stats(record, values);
+    } else {
+        values[STAT_VARIABLES] = solver->nVars();
+        values[STAT_CLAUSES] = solver->nClauses();
+        values[STAT_LEARNTS] = solver->nLearnts();
+        values[STAT_CONFLICTS] = (jlong) solver->conflicts;
+        values[STAT_DECISIONS] = (jlong) solver->decisions;
+        values[STAT_PROPAGATIONS] = (jlong) solver->propagations;
+        values[STAT_RESTARTS] = (jlong) solver->starts;
+        values[STAT_ELIMINATED] = solver->eliminated_vars;
+        values[STAT_REDUCTIONS] = (jlong) solver->nbReduceDB;
+    }
+    stats_store(env, out, values);
+}
+
+// Note: returns a handle of the `ProgressPublisher` attached to the solver (see Progress.hpp)
+JNI_METHOD(jlong, glucose_1progress_1start)
+  (JNIEnv*, jobject, jlong handle, jlong conflicts_step, jint capacity) {
+    Glucose::SimpSolver* solver = decode(handle);
+    return progress_attach(solver, conflicts_step, capacity, [solver](int64_t* record) { sample(solver, record); });
+  }
+
+JNI_METHOD(jint, glucose_1progress_1drain)
+  (JNIEnv* env, jobject, jlong progress, jlongArray out) {
+    return progress_drain(env, progress, out);
+  }
+
+JNI_METHOD(void, glucose_1progress_1stop)
+  (JNIEnv*, jobject, jlong progress) {
+    progress_detach(progress);
+  }
+
 JNI_METHOD(jint, glucose_1new_1var)
   (JNIEnv*, jobject, jlong handle, jboolean polarity, jboolean decision) {
     int v = decode(handle)->newVar(polarity, decision);
@@ -209,9 +587,54 @@ JNI_METHOD(jboolean, glucose_1add_1clause__J_3I)
     return decode(handle)->addClause_(vec);
   }
 
+JNI_METHOD(jboolean, glucose_1add_1clauses)
+  (JNIEnv* env, jobject, jlong handle, jintArray literals, jint size) {
+    jint* array = (jint*) env->GetPrimitiveArrayCritical(literals, 0);
+    bool ok = add_clauses(decode(handle), array, size);
+    env->ReleasePrimitiveArrayCritical(literals, array, JNI_ABORT);
+    return ok;
+  }
+
+JNI_METHOD(jboolean, glucose_1add_1clauses_1direct)
+  (JNIEnv* env, jobject, jlong handle, jobject buffer, jint size) {
+    jint* array = direct_clauses(env, buffer);
+    if (array == NULL) return false;
+    return add_clauses(decode(handle), array, size);
+  }
+
+// Note: `cnf` is a handle of `JCnf`
+JNI_METHOD(jboolean, glucose_1load_1cnf)
+  (JNIEnv*, jobject, jlong handle, jlong cnf) {
+    Glucose::SimpSolver* solver = decode(handle);
+    const Cnf* p = decode_cnf(cnf);
+    while (solver->nVars() < p->max_var) {
+        solver->newVar();
+    }
+    return add_clauses(solver, p->begin(), p->size());
+  }
+
+// Note: returns `dimacs_result_array`, or NULL on I/O or syntax error
+JNI_METHOD(jlongArray, glucose_1load_1dimacs)
+  (JNIEnv* env, jobject, jlong handle, jstring path, jint threads) {
+    Glucose::SimpSolver* solver = decode(handle);
+    const char* s = env->GetStringUTFChars(path, 0);
+    DimacsResult result;
+    bool ok = load_dimacs(s, threads, [solver](const jint* literals, jint len, jint max_var) {
+        while (solver->nVars() < max_var) {
+            solver->newVar();
+        }
+        return add_clauses(solver, literals, len);
+    }, &result);
+    env->ReleaseStringUTFChars(path, s);
+    if (!ok) {
+        return NULL;
+    }
+    return dimacs_result_array(env, result);
+  }
+
 JNI_METHOD(jboolean, glucose_1solve__JZZ)
   (JNIEnv*, jobject, jlong handle, jboolean do_simp, jboolean turn_off_simp) {
-    return decode(handle)->solve(do_simp, turn_off_simp);
+    return solve_unlimited(decode(handle), Glucose::vec<Glucose::Lit>(), do_simp, turn_off_simp);
   }
 
 JNI_METHOD(jboolean, glucose_1solve__J_3IZZ)
@@ -225,7 +648,48 @@ JNI_METHOD(jboolean, glucose_1solve__J_3IZZ)
     }
     env->ReleasePrimitiveArrayCritical(assumptions, p, 0);
 
-    return decode(handle)->solve(vec, do_simp, turn_off_simp);
+    return solve_unlimited(decode(handle), vec, do_simp, turn_off_simp);
+  }
+
+JNI_METHOD(jlong, glucose_1assumptions_1new)
+  (JNIEnv*, jobject) {
+    return encode_assumptions(new GlucoseAssumptions());
+  }
+
+JNI_METHOD(void, glucose_1assumptions_1delete)
+  (JNIEnv*, jobject, jlong set) {
+    delete decode_assumptions<GlucoseAssumptions>(set);
+  }
+
+JNI_METHOD(jint, glucose_1assumptions_1add)
+  (JNIEnv* env, jobject, jlong set, jintArray literals, jint size) {
+    return assumptions_add<GlucoseAssumptions>(env, set, literals, size, convert);
+  }
+
+JNI_METHOD(jint, glucose_1assumptions_1remove)
+  (JNIEnv* env, jobject, jlong set, jintArray literals, jint size) {
+    return assumptions_remove<GlucoseAssumptions>(env, set, literals, size);
+  }
+
+JNI_METHOD(void, glucose_1assumptions_1clear)
+  (JNIEnv*, jobject, jlong set) {
+    decode_assumptions<GlucoseAssumptions>(set)->clear();
+  }
+
+JNI_METHOD(jint, glucose_1assumptions_1size)
+  (JNIEnv*, jobject, jlong set) {
+    return (jint) decode_assumptions<GlucoseAssumptions>(set)->external.size();
+  }
+
+JNI_METHOD(jintArray, glucose_1assumptions_1literals)
+  (JNIEnv* env, jobject, jlong set) {
+    return assumptions_literals<GlucoseAssumptions>(env, set);
+  }
+
+// Note: `set` is a handle of the assumption set, solved under without any copying or conversion
+JNI_METHOD(jboolean, glucose_1solve_1assumptions)
+  (JNIEnv*, jobject, jlong handle, jlong set, jboolean do_simp, jboolean turn_off_simp) {
+    return solve_unlimited(decode(handle), decode_assumptions<GlucoseAssumptions>(set)->lits, do_simp, turn_off_simp);
   }
 
 JNI_METHOD(jbyte, glucose_1solve_1limited)
@@ -242,6 +706,41 @@ JNI_METHOD(jbyte, glucose_1solve_1limited)
     return (jbyte) Glucose::toInt(decode(handle)->solveLimited(vec, do_simp, turn_off_simp));
   }
 
+// Note: `limits` is `SolveLimits.toArray()`, the result is packed by `limits_result` (see Limits.hpp).
+//  The previous budgets are turned off, and the interrupt issued by the watchdog is cleared afterwards.
+JNI_METHOD(jint, glucose_1solve_1with_1limits)
+  (JNIEnv* env, jobject, jlong handle, jintArray assumptions, jboolean do_simp, jboolean turn_off_simp, jlongArray limits) {
+    Glucose::SimpSolver* solver = decode(handle);
+    Limits l = read_limits(env, limits);
+    jint len = env->GetArrayLength(assumptions);
+    Glucose::vec<Glucose::Lit> vec(len);
+
+    jint* p = (jint*) env->GetPrimitiveArrayCritical(assumptions, 0);
+    for (jint i = 0; i < len; i++) {
+        vec[i] = convert(p[i]);
+    }
+    env->ReleasePrimitiveArrayCritical(assumptions, p, 0);
+
+    return GlucoseState::solve_with_limits(solver, vec, do_simp, turn_off_simp, l);
+  }
+
+// Note: `future` is a `SolveFuture`, completed from a native worker thread (see AsyncSolve.hpp)
+JNI_METHOD(void, glucose_1solve_1async)
+  (JNIEnv* env, jobject, jlong handle, jintArray assumptions, jboolean do_simp, jboolean turn_off_simp, jobject future) {
+    Glucose::SimpSolver* solver = decode(handle);
+    std::vector<jint> assumps = async_assumptions(env, assumptions);
+    bool simp = do_simp, turn_off = turn_off_simp;
+    async_solve(env, future, [solver, assumps, simp, turn_off] {
+        Glucose::vec<Glucose::Lit> vec((int) assumps.size());
+        for (size_t i = 0; i < assumps.size(); i++) {
+            vec[(int) i] = convert(assumps[i]);
+        }
+        // Note: same as the blocking `solve`, which ignores the budgets
+        int res = Glucose::toInt(GlucoseState::solve_ignoring_budgets(solver, vec, simp, turn_off));
+        return res == 0 ? ASYNC_SAT : res == 1 ? ASYNC_UNSAT : ASYNC_UNKNOWN;
+    });
+  }
+
 JNI_METHOD(jbyte, glucose_1get_1value)
   (JNIEnv*, jobject, jlong handle, jint lit) {
     return (jbyte) Glucose::toInt(decode(handle)->modelValue(convert(lit)));
@@ -264,6 +763,158 @@ JNI_METHOD(jbooleanArray, glucose_1get_1model)
     return result;
 }
 
+// Note: bit `i` of `bits` holds the value of the variable `i+1`
+JNI_METHOD(void, glucose_1get_1model_1bits)
+  (JNIEnv* env, jobject, jlong handle, jlongArray bits) {
+    Glucose::SimpSolver* solver = decode(handle);
+    const Glucose::vec<Glucose::lbool>& model = solver->model;
+    int n = solver->nVars();
+    int m = model.size() < n ? model.size() : n;
+    jsize words = (n + 63) / 64;
+    if (env->GetArrayLength(bits) < words) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Bits array is too short for the model");
+        return;
+    }
+    jlong* out = (jlong*) env->GetPrimitiveArrayCritical(bits, 0);
+    for (jsize w = 0; w < words; w++) {
+        uint64_t word = 0;
+        int begin = w * 64;
+        int end = begin + 64 < m ? begin + 64 : m;
+        for (int v = begin; v < end; v++) {
+            if (model[v] == Glucose::lbool((uint8_t)0)) {
+                word |= (uint64_t) 1 << (v - begin);
+            }
+        }
+        out[w] = (jlong) word;
+    }
+    env->ReleasePrimitiveArrayCritical(bits, out, 0);
+  }
+
+// Note: `values` receives lbool codes (0 = true, 1 = false, 2 = undef) of the corresponding `literals`
+JNI_METHOD(void, glucose_1get_1values)
+  (JNIEnv* env, jobject, jlong handle, jintArray literals, jbyteArray values) {
+    Glucose::SimpSolver* solver = decode(handle);
+    int m = solver->model.size();
+    jsize len = env->GetArrayLength(literals);
+    if (env->GetArrayLength(values) < len) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Values array is shorter than literals array");
+        return;
+    }
+    jint* lits = (jint*) env->GetPrimitiveArrayCritical(literals, 0);
+    jbyte* out = (jbyte*) env->GetPrimitiveArrayCritical(values, 0);
+    for (jsize i = 0; i < len; i++) {
+        Glucose::Lit p = convert(lits[i]);
+        if (Glucose::var(p) < m) {
+            out[i] = (jbyte) Glucose::toInt(solver->modelValue(p));
+        } else {
+            out[i] = 2;
+        }
+    }
+    env->ReleasePrimitiveArrayCritical(values, out, 0);
+    env->ReleasePrimitiveArrayCritical(literals, lits, JNI_ABORT);
+  }
+
+// Note: writes the projected models (bit `i` is the value of `projection[i]`) into `buffer`,
+//  returns the number of written models
+JNI_METHOD(jint, glucose_1enumerate)
+  (JNIEnv* env, jobject, jlong handle, jintArray projection, jboolean minimize, jlongArray buffer) {
+    GlucoseBackend backend(decode(handle));
+    return allsat_enumerate(env, backend, projection, minimize, buffer);
+  }
+
+JNI_METHOD(jlong, glucose_1count_1models)
+  (JNIEnv* env, jobject, jlong handle, jintArray projection, jboolean minimize, jlong limit) {
+    GlucoseBackend backend(decode(handle));
+    return allsat_count(env, backend, projection, minimize, limit);
+  }
+
+// Note: returns the failed assumptions of the last (UNSAT) solve
+JNI_METHOD(jintArray, glucose_1get_1core)
+  (JNIEnv* env, jobject, jlong handle) {
+    GlucoseBackend backend(decode(handle));
+    std::vector<jint> core;
+    backend.core(std::vector<jint>(), core);
+    return core_to_array(env, core);
+  }
+
+// Note: returns NULL when the solver did not return UNSAT under the `assumptions`
+JNI_METHOD(jintArray, glucose_1minimize_1core)
+  (JNIEnv* env, jobject, jlong handle, jintArray assumptions) {
+    GlucoseBackend backend(decode(handle));
+    return core_minimize(env, backend, assumptions);
+  }
+
+JNI_METHOD(jlong, glucose_1maxsat_1new)
+  (JNIEnv*, jobject) {
+    return encode_maxsat(new MaxSat());
+  }
+
+JNI_METHOD(void, glucose_1maxsat_1delete)
+  (JNIEnv*, jobject, jlong engine) {
+    delete decode_maxsat(engine);
+  }
+
+JNI_METHOD(void, glucose_1maxsat_1add)
+  (JNIEnv* env, jobject, jlong engine, jintArray literals, jint size, jlong weight) {
+    maxsat_add(env, engine, literals, size, weight);
+  }
+
+JNI_METHOD(jint, glucose_1maxsat_1size)
+  (JNIEnv*, jobject, jlong engine) {
+    return decode_maxsat(engine)->size();
+  }
+
+JNI_METHOD(jint, glucose_1maxsat_1next_1var)
+  (JNIEnv*, jobject, jlong engine) {
+    return decode_maxsat(engine)->next_var;
+  }
+
+// Note: returns the status of the solve (see MaxSat.hpp)
+JNI_METHOD(jint, glucose_1maxsat_1solve)
+  (JNIEnv*, jobject, jlong handle, jlong engine, jint algorithm, jboolean stratify, jint max_var) {
+    GlucoseBackend backend(decode(handle));
+    return maxsat_solve(backend, *decode_maxsat(engine), algorithm, stratify, max_var);
+  }
+
+JNI_METHOD(void, glucose_1maxsat_1bounds)
+  (JNIEnv* env, jobject, jlong engine, jlongArray out) {
+    maxsat_bounds(env, engine, out);
+  }
+
+JNI_METHOD(jbooleanArray, glucose_1maxsat_1model)
+  (JNIEnv* env, jobject, jlong engine) {
+    return maxsat_model(env, engine);
+  }
+
+// Note: `key` (at most 32 bytes) identifies the input, see Preprocess.hpp
+JNI_METHOD(jboolean, glucose_1save_1preprocessed)
+  (JNIEnv* env, jobject, jlong handle, jstring path, jbyteArray key) {
+    jsize key_size = env->GetArrayLength(key);
+    std::vector<jbyte> k(key_size);
+    env->GetByteArrayRegion(key, 0, key_size, k.data());
+    Preprocessed artifact(PREPROCESSED_KIND_GLUCOSE, k.data(), key_size);
+    GlucoseState::save(decode(handle), artifact);
+    const char* s = env->GetStringUTFChars(path, 0);
+    bool ok = artifact.save(s);
+    env->ReleaseStringUTFChars(path, s);
+    return ok;
+  }
+
+// Note: returns a handle of the new solver restored from the artifact,
+//  or 0 when it is missing, malformed, or made for another input (`key`)
+JNI_METHOD(jlong, glucose_1load_1preprocessed)
+  (JNIEnv* env, jobject, jstring path, jbyteArray key) {
+    jsize key_size = env->GetArrayLength(key);
+    std::vector<jbyte> k(key_size);
+    env->GetByteArrayRegion(key, 0, key_size, k.data());
+    const char* s = env->GetStringUTFChars(path, 0);
+    PreprocessedView view;
+    bool ok = view.open(s, PREPROCESSED_KIND_GLUCOSE, k.data(), key_size);
+    env->ReleaseStringUTFChars(path, s);
+    if (!ok) return 0;
+    return encode(GlucoseState::load(view));
+  }
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,336 @@
+/**
+ * Copyright © 2020, Darya Grechishkina, Konstantin Chukharev, ITMO University
+ */
+
+#include <jni.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <climits>
+
+extern "C" {
+#include <kissat.h>
+}
+
+#include "AsyncSolve.hpp"
+#include "Cnf.hpp"
+#include "Dimacs.hpp"
+#include "Limits.hpp"
+#include "Stats.hpp"
+
+#define JNI_METHOD(rtype, name) \
+    JNIEXPORT rtype JNICALL Java_com_github_lipen_satlib_jni_JKissat_##name
+
+// Kissat solver together with the state of its termination callback.
+// Note: Kissat is not incremental: clauses can only be added before the (single) call to `kissat_solve`,
+//  and the values can only be queried after it returned SAT. Kissat aborts the process otherwise,
+//  so the status is tracked here and the illegal calls are ignored.
+struct Kissat {
+    kissat* solver;
+    int max_var; // Kissat does not report the number of variables
+    int status; // 0 (not solved yet or unknown), 10 (SAT) or 20 (UNSAT)
+    bool solved;
+    std::atomic<bool> stop;
+    std::atomic<int64_t> deadline; // in nanoseconds of `steady_clock`, or 0 when there is no deadline
+    unsigned checks;
+    const LimitScope* scope; // limits of the running `kissat_solve_with_limits`, if any
+
+    Kissat() : solver(kissat_init()), max_var(0), status(0), solved(false), stop(false), deadline(0), checks(0),
+               scope(NULL) {}
+
+    ~Kissat() {
+        kissat_release(solver);
+    }
+};
+
+static inline jlong encode(Kissat* p) {
+    return (jlong) (intptr_t) p;
+}
+
+static inline Kissat* decode(jlong h) {
+    return (Kissat*) (intptr_t) h;
+}
+
+// Called by Kissat regularly during the search
+static int terminate_callback(void* state) {
+    Kissat* k = (Kissat*) state;
+    if (k->stop.load(std::memory_order_relaxed)) return 1;
+    if (k->scope != NULL && k->scope->fired() != LIMIT_NONE) return 1;
+    int64_t deadline = k->deadline.load(std::memory_order_relaxed);
+    // Note: the clock is consulted only on every 64-th call, since the callback is hot
+    if (deadline != 0 && (++k->checks & 63) == 0 && now_ns() >= deadline) return 1;
+    return 0;
+}
+
+// Add zero-terminated clauses from `literals[0 until len]`
+static void add_clauses(Kissat* k, const jint* literals, jint len) {
+    if (k->solved) return;
+    int max_var = k->max_var;
+    for (jint i = 0; i < len; i++) {
+        jint lit = literals[i];
+        int v = abs(lit);
+        if (v > max_var) max_var = v;
+        kissat_add(k->solver, lit);
+    }
+    k->max_var = max_var;
+}
+
+// Value of `lit` in the model: 1 (true), -1 (false), or 0 when there is no model.
+// Note: variables not mentioned in any clause are unassigned in Kissat, treat them as false.
+static inline int value(Kissat* k, jint lit) {
+    if (k->status != 10 || abs(lit) > k->max_var) return k->status == 10 ? -1 : 0;
+    return kissat_value(k->solver, lit) == lit ? 1 : -1;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+JNI_METHOD(jlong, kissat_1create)
+  (JNIEnv*, jobject) {
+    Kissat* k = new Kissat();
+    kissat_set_terminate(k->solver, k, terminate_callback);
+    return encode(k);
+  }
+
+JNI_METHOD(void, kissat_1delete)
+  (JNIEnv*, jobject, jlong handle) {
+    delete decode(handle);
+  }
+
+JNI_METHOD(jstring, kissat_1signature)
+  (JNIEnv* env, jclass) {
+    return env->NewStringUTF(kissat_signature());
+  }
+
+JNI_METHOD(jint, kissat_1nvars)
+  (JNIEnv*, jobject, jlong handle) {
+    return decode(handle)->max_var;
+  }
+
+JNI_METHOD(jint, kissat_1get_1option)
+  (JNIEnv* env, jobject, jlong handle, jstring name) {
+    const char* s = env->GetStringUTFChars(name, 0);
+    int value = kissat_get_option(decode(handle)->solver, s);
+    env->ReleaseStringUTFChars(name, s);
+    return value;
+  }
+
+// Note: returns the previous value of the option
+JNI_METHOD(jint, kissat_1set_1option)
+  (JNIEnv* env, jobject, jlong handle, jstring name, jint value) {
+    const char* s = env->GetStringUTFChars(name, 0);
+    int old = kissat_set_option(decode(handle)->solver, s, value);
+    env->ReleaseStringUTFChars(name, s);
+    return old;
+  }
+
+JNI_METHOD(jboolean, kissat_1set_1configuration)
+  (JNIEnv* env, jobject, jlong handle, jstring name) {
+    const char* s = env->GetStringUTFChars(name, 0);
+    bool ok = kissat_has_configuration(s) && kissat_set_configuration(decode(handle)->solver, s);
+    env->ReleaseStringUTFChars(name, s);
+    return ok;
+  }
+
+JNI_METHOD(void, kissat_1reserve)
+  (JNIEnv*, jobject, jlong handle, jint max_var) {
+    Kissat* k = decode(handle);
+    if (k->solved) return;
+    kissat_reserve(k->solver, max_var);
+  }
+
+JNI_METHOD(void, kissat_1set_1conflict_1limit)
+  (JNIEnv*, jobject, jlong handle, jint limit) {
+    kissat_set_conflict_limit(decode(handle)->solver, (unsigned) limit);
+  }
+
+JNI_METHOD(void, kissat_1set_1decision_1limit)
+  (JNIEnv*, jobject, jlong handle, jint limit) {
+    kissat_set_decision_limit(decode(handle)->solver, (unsigned) limit);
+  }
+
+// Note: `millis <= 0` removes the deadline
+JNI_METHOD(void, kissat_1set_1timeout)
+  (JNIEnv*, jobject, jlong handle, jlong millis) {
+    decode(handle)->deadline = millis > 0 ? now_ns() + millis * 1000000 : 0;
+  }
+
+JNI_METHOD(void, kissat_1interrupt)
+  (JNIEnv*, jobject, jlong handle) {
+    decode(handle)->stop = true;
+  }
+
+JNI_METHOD(void, kissat_1print_1statistics)
+  (JNIEnv*, jobject, jlong handle) {
+    kissat_print_statistics(decode(handle)->solver);
+  }
+
+// Note: `out` receives the snapshot laid out as in Stats.hpp.
+//  Kissat does not expose its statistics (except for printing them), so only the variables are reported.
+JNI_METHOD(void, kissat_1stats)
+  (JNIEnv* env, jobject, jlong handle, jlongArray out) {
+    jlong values[STATS_SIZE];
+    stats_init(values);
+    values[STAT_VARIABLES] = decode(handle)->max_var;
+    stats_store(env, out, values);
+  }
+
+JNI_METHOD(void, kissat_1add)
+  (JNIEnv*, jobject, jlong handle, jint lit) {
+    add_clauses(decode(handle), &lit, 1);
+  }
+
+JNI_METHOD(void, kissat_1add_1clause)
+  (JNIEnv* env, jobject, jlong handle, jintArray literals) {
+    jsize len = env->GetArrayLength(literals);
+    jint* array = (jint*) env->GetPrimitiveArrayCritical(literals, 0);
+    Kissat* k = decode(handle);
+    add_clauses(k, array, len);
+    env->ReleasePrimitiveArrayCritical(literals, array, JNI_ABORT);
+    jint zero = 0;
+    add_clauses(k, &zero, 1);
+  }
+
+JNI_METHOD(void, kissat_1add_1clauses)
+  (JNIEnv* env, jobject, jlong handle, jintArray literals, jint size) {
+    jint* array = (jint*) env->GetPrimitiveArrayCritical(literals, 0);
+    add_clauses(decode(handle), array, size);
+    env->ReleasePrimitiveArrayCritical(literals, array, JNI_ABORT);
+  }
+
+JNI_METHOD(void, kissat_1add_1clauses_1direct)
+  (JNIEnv* env, jobject, jlong handle, jobject buffer, jint size) {
+    jint* array = direct_clauses(env, buffer);
+    if (array == NULL) return;
+    add_clauses(decode(handle), array, size);
+  }
+
+// Note: `cnf` is a handle of `JCnf`
+JNI_METHOD(void, kissat_1load_1cnf)
+  (JNIEnv*, jobject, jlong handle, jlong cnf) {
+    const Cnf* q = decode_cnf(cnf);
+    add_clauses(decode(handle), q->begin(), q->size());
+  }
+
+// Note: returns `dimacs_result_array`, or NULL on I/O or syntax error
+JNI_METHOD(jlongArray, kissat_1load_1dimacs)
+  (JNIEnv* env, jobject, jlong handle, jstring path, jint threads) {
+    Kissat* k = decode(handle);
+    const char* s = env->GetStringUTFChars(path, 0);
+    DimacsResult result;
+    // Note: Kissat does not tell whether the formula became UNSAT while adding the clauses
+    bool ok = load_dimacs(s, threads, [k](const jint* literals, jint len, jint) {
+        add_clauses(k, literals, len);
+        return true;
+    }, &result);
+    env->ReleaseStringUTFChars(path, s);
+    if (!ok) {
+        return NULL;
+    }
+    return dimacs_result_array(env, result);
+  }
+
+// Note: returns 10 (SAT), 20 (UNSAT) or 0 (unknown, also when the solver was already used)
+JNI_METHOD(jint, kissat_1solve)
+  (JNIEnv*, jobject, jlong handle) {
+    Kissat* k = decode(handle);
+    if (k->solved) return 0;
+    k->solved = true;
+    k->status = kissat_solve(k->solver);
+    return k->status;
+  }
+
+// Note: `limits` is `SolveLimits.toArray()`, the result is packed by `limits_result` (see Limits.hpp).
+//  The propagation limit is not supported, since Kissat has no propagation budget.
+JNI_METHOD(jint, kissat_1solve_1with_1limits)
+  (JNIEnv* env, jobject, jlong handle, jlongArray limits) {
+    Kissat* k = decode(handle);
+    if (k->solved) return 0;
+    k->solved = true;
+    Limits l = read_limits(env, limits);
+    if (l.conflicts > 0) {
+        kissat_set_conflict_limit(k->solver, (unsigned) std::min<int64_t>(l.conflicts, UINT_MAX));
+    }
+    LimitScope scope(l, std::function<void()>());
+    k->scope = &scope;
+    k->status = kissat_solve(k->solver);
+    k->scope = NULL;
+    int limit = scope.finish();
+    // Note: Kissat does not report the number of conflicts, so an unknown result
+    //  which is neither due to the interrupt nor the timeout is attributed to the conflict limit
+    if (limit == LIMIT_NONE && l.conflicts > 0 && !k->stop) {
+        int64_t deadline = k->deadline;
+        if (deadline == 0 || now_ns() < deadline) limit = LIMIT_CONFLICTS;
+    }
+    return limits_result(k->status, limit);
+  }
+
+// Note: `future` is a `SolveFuture`, completed from a native worker thread (see AsyncSolve.hpp)
+JNI_METHOD(void, kissat_1solve_1async)
+  (JNIEnv* env, jobject, jlong handle, jobject future) {
+    Kissat* k = decode(handle);
+    async_solve(env, future, [k] {
+        if (k->solved) return 0;
+        k->solved = true;
+        k->status = kissat_solve(k->solver);
+        return k->status;
+    });
+  }
+
+JNI_METHOD(jint, kissat_1get_1value)
+  (JNIEnv*, jobject, jlong handle, jint lit) {
+    return value(decode(handle), lit);
+  }
+
+// Note: `values` receives lbool codes (0 = true, 1 = false, 2 = undef) of the corresponding `literals`
+JNI_METHOD(void, kissat_1get_1values)
+  (JNIEnv* env, jobject, jlong handle, jintArray literals, jbyteArray values) {
+    Kissat* k = decode(handle);
+    jsize len = env->GetArrayLength(literals);
+    if (env->GetArrayLength(values) < len) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Values array is shorter than literals array");
+        return;
+    }
+    jint* lits = (jint*) env->GetPrimitiveArrayCritical(literals, 0);
+    jbyte* out = (jbyte*) env->GetPrimitiveArrayCritical(values, 0);
+    for (jsize i = 0; i < len; i++) {
+        int v = value(k, lits[i]);
+        out[i] = v > 0 ? 0 : v < 0 ? 1 : 2;
+    }
+    env->ReleasePrimitiveArrayCritical(values, out, 0);
+    env->ReleasePrimitiveArrayCritical(literals, lits, JNI_ABORT);
+  }
+
+// Note: bit `i` of `bits` holds the value of the variable `i+1`
+JNI_METHOD(void, kissat_1get_1model_1bits)
+  (JNIEnv* env, jobject, jlong handle, jlongArray bits) {
+    Kissat* k = decode(handle);
+    int n = k->max_var;
+    jsize words = (n + 63) / 64;
+    if (env->GetArrayLength(bits) < words) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Bits array is too short for the model");
+        return;
+    }
+    if (k->status != 10) {
+        return;
+    }
+    jlong* out = (jlong*) env->GetPrimitiveArrayCritical(bits, 0);
+    for (jsize w = 0; w < words; w++) {
+        uint64_t word = 0;
+        int begin = w * 64;
+        int end = begin + 64 < n ? begin + 64 : n;
+        for (int v = begin; v < end; v++) {
+            if (kissat_value(k->solver, v + 1) > 0) {
+                word |= (uint64_t) 1 << (v - begin);
+            }
+        }
+        out[w] = (jlong) word;
+    }
+    env->ReleasePrimitiveArrayCritical(bits, out, 0);
+  }
+
+#ifdef __cplusplus
+}
+#endif
@@ -26,6 +26,17 @@
 
 #include <minisat/simp/SimpSolver.h>
 
+#include "AllSat.hpp"
+#include "Assumptions.hpp"
+#include "AsyncSolve.hpp"
+#include "Cnf.hpp"
+#include "Core.hpp"
+#include "Dimacs.hpp"
+#include "Limits.hpp"
+#include "Preprocess.hpp"
+#include "Progress.hpp"
+#include "Stats.hpp"
+
 #define JNI_METHOD(rtype, name) \
     JNIEXPORT rtype JNICALL Java_com_github_lipen_satlib_jni_JMiniSat_##name
 
@@ -47,6 +58,293 @@ static inline Minisat::Lit convert(int lit) {
     return Minisat::toLit(lit > 0 ? (lit - 1) << 1 : ((-lit - 1) << 1) + 1);
 }
 
+// Internal lit to external lit
+static inline int unconvert(Minisat::Lit lit) {
+    return Minisat::sign(lit) ? -(Minisat::var(lit) + 1) : Minisat::var(lit) + 1;
+}
+
+typedef AssumptionSet<Minisat::vec<Minisat::Lit>, Minisat::Lit> MiniSatAssumptions;
+
+// Add zero-terminated clauses from `literals[0 until len]`
+static bool add_clauses(Minisat::SimpSolver* solver, const jint* literals, jint len) {
+    Minisat::vec<Minisat::Lit> clause;
+    for (jint i = 0; i < len; i++) {
+        if (literals[i] == 0) {
+            if (!solver->addClause_(clause)) return false;
+            clause.clear();
+        } else {
+            clause.push(convert(literals[i]));
+        }
+    }
+    return solver->okay();
+}
+
+// Access to the protected state of MiniSat, required for cloning and for the limited solves.
+// Note: no instance of this struct is ever created, it only names the protected members,
+//  so that pointers to them can be applied to any `SimpSolver`.
+struct MiniSatState : Minisat::SimpSolver {
+    static Minisat::SimpSolver* clone(Minisat::SimpSolver* src);
+    static void save(Minisat::SimpSolver* src, Preprocessed& out);
+    static Minisat::SimpSolver* load(const PreprocessedView& in);
+    static Minisat::lbool solve_ignoring_budgets(Minisat::SimpSolver* solver, const Minisat::vec<Minisat::Lit>& assumptions,
+                                          bool do_simp, bool turn_off_simp);
+    static jint solve_with_limits(Minisat::SimpSolver* solver, const Minisat::vec<Minisat::Lit>& assumptions,
+                                  bool do_simp, bool turn_off_simp, const Limits& l);
+};
+
+#define STATE(solver, member) ((solver)->*(&MiniSatState::member))
+
+// Fill the progress record (except for the time) from the counters of the `solver`.
+// Note: called by the sampler thread of the progress publisher (see Progress.hpp) and by the stats snapshots
+//  concurrently with the solve, so only the plain counters and sizes are read, without synchronization.
+static void sample(const Minisat::SimpSolver* solver, int64_t* record) {
+    record[PROGRESS_CONFLICTS] = (int64_t) solver->conflicts;
+    record[PROGRESS_DECISIONS] = (int64_t) solver->decisions;
+    record[PROGRESS_PROPAGATIONS] = (int64_t) solver->propagations;
+    record[PROGRESS_RESTARTS] = (int64_t) solver->starts;
+    record[PROGRESS_TRAIL] = solver->nAssigns();
+    record[PROGRESS_LEARNTS] = solver->nLearnts();
+}
+
+// Same as `SimpSolver::solveLimited`, ignoring the budgets of the user, which are kept for the later solves
+Minisat::lbool MiniSatState::solve_ignoring_budgets(Minisat::SimpSolver* solver, const Minisat::vec<Minisat::Lit>& assumptions,
+                                          bool do_simp, bool turn_off_simp) {
+    int64_t conflict_budget = STATE(solver, conflict_budget);
+    int64_t propagation_budget = STATE(solver, propagation_budget);
+    solver->budgetOff();
+    Minisat::lbool res = solver->solveLimited(assumptions, do_simp, turn_off_simp);
+    STATE(solver, conflict_budget) = conflict_budget;
+    STATE(solver, propagation_budget) = propagation_budget;
+    return res;
+}
+
+// Solve under the limits `l`, returning `limits_result` (see Limits.hpp).
+// The conflict and propagation limits replace the budgets of the user for this solve only,
+// and the interrupt raised by the wall-clock or memory limit is cleared afterwards,
+// unless the solver has already been interrupted by the user.
+// Note: an interrupt of the user arriving after the limit has fired is indistinguishable, so it is cleared as well.
+jint MiniSatState::solve_with_limits(Minisat::SimpSolver* solver, const Minisat::vec<Minisat::Lit>& assumptions,
+                                  bool do_simp, bool turn_off_simp, const Limits& l) {
+    int64_t conflict_budget = STATE(solver, conflict_budget);
+    int64_t propagation_budget = STATE(solver, propagation_budget);
+    uint64_t conflicts = solver->conflicts;
+    uint64_t propagations = solver->propagations;
+    solver->budgetOff();
+    if (l.conflicts > 0) solver->setConfBudget(l.conflicts);
+    if (l.propagations > 0) solver->setPropBudget(l.propagations);
+    std::atomic<bool> raised(false);
+    LimitScope scope(l, [solver, &raised] {
+        if (!STATE(solver, asynch_interrupt)) {
+            raised = true;
+            solver->interrupt();
+        }
+    });
+    int res = Minisat::toInt(solver->solveLimited(assumptions, do_simp, turn_off_simp));
+    int limit = scope.finish();
+    if (raised) {
+        solver->clearInterrupt();
+    }
+    if (limit == LIMIT_NONE) {
+        if (l.conflicts > 0 && solver->conflicts - conflicts >= (uint64_t) l.conflicts) {
+            limit = LIMIT_CONFLICTS;
+        } else if (l.propagations > 0 && solver->propagations - propagations >= (uint64_t) l.propagations) {
+            limit = LIMIT_PROPAGATIONS;
+        }
+    }
+    STATE(solver, conflict_budget) = conflict_budget;
+    STATE(solver, propagation_budget) = propagation_budget;
+    return limits_result(res == 0 ? 10 : res == 1 ? 20 : 0, limit);
+}
+
+// Same as `SimpSolver::solve`, which ignores the budgets
+static bool solve_unlimited(Minisat::SimpSolver* solver, const Minisat::vec<Minisat::Lit>& assumptions,
+                            bool do_simp, bool turn_off_simp) {
+    solver->budgetOff();
+    return solver->solveLimited(assumptions, do_simp, turn_off_simp) == Minisat::l_True;
+}
+
+// Backend adapter for AllSat.hpp and Core.hpp
+struct MiniSatBackend {
+    Minisat::SimpSolver* solver;
+
+    explicit MiniSatBackend(Minisat::SimpSolver* solver) : solver(solver) {}
+
+    int solve(const std::vector<jint>& assumptions) {
+        Minisat::vec<Minisat::Lit> vec((int) assumptions.size());
+        for (size_t i = 0; i < assumptions.size(); i++) {
+            vec[(int) i] = convert(assumptions[i]);
+        }
+        // Note: simplification is not performed, since blocking clauses may mention any projected variable
+        int res = Minisat::toInt(solver->solveLimited(vec, false, false));
+        return res == 0 ? ALLSAT_SAT : res == 1 ? ALLSAT_UNSAT : 0;
+    }
+
+    bool value(jint lit) {
+        return Minisat::toInt(solver->modelValue(convert(lit))) == 0;
+    }
+
+    void add_clause(const std::vector<jint>& literals) {
+        Minisat::vec<Minisat::Lit> clause((int) literals.size());
+        for (size_t i = 0; i < literals.size(); i++) {
+            clause[(int) i] = convert(literals[i]);
+        }
+        solver->addClause_(clause);
+    }
+
+    // Note: the final conflict consists of the negations of the failed assumptions
+    void core(const std::vector<jint>&, std::vector<jint>& out) {
+        out.clear();
+        for (int i = 0; i < solver->conflict.size(); i++) {
+            out.push_back(-unconvert(solver->conflict[i]));
+        }
+    }
+
+    bool eliminated(jint lit) {
+        return solver->isEliminated(lit2var(lit));
+    }
+
+    void freeze(jint lit) {
+        solver->setFrozen(lit2var(lit), true);
+    }
+};
+
+// Deep copy of the solver state: variables (with their decision flags, user and saved polarities,
+// frozen and eliminated flags), top-level units, original and learnt clauses.
+// Note: the solver must not be solving (it is at the top level then).
+Minisat::SimpSolver* MiniSatState::clone(Minisat::SimpSolver* src) {
+    Minisat::SimpSolver* dst = new Minisat::SimpSolver();
+    dst->random_seed = src->random_seed;
+    dst->random_var_freq = src->random_var_freq;
+    dst->rnd_pol = src->rnd_pol;
+    dst->rnd_init_act = src->rnd_init_act;
+    if (!STATE(src, use_simplification)) {
+        dst->eliminate(true);
+    }
+
+    int n = src->nVars();
+    for (Minisat::Var v = 0; v < n; v++) {
+        dst->newVar(STATE(src, user_pol)[v], STATE(src, decision)[v]);
+        STATE(dst, polarity)[v] = STATE(src, polarity)[v];
+        STATE(dst, eliminated)[v] = STATE(src, eliminated)[v];
+    }
+    for (int i = 0; i < STATE(src, frozen_vars).size(); i++) {
+        dst->freezeVar(STATE(src, frozen_vars)[i]);
+    }
+    for (Minisat::Var v = 0; v < n; v++) {
+        if (STATE(src, frozen)[v] && !STATE(dst, frozen)[v]) dst->setFrozen(v, true);
+    }
+    STATE(src, elimclauses).copyTo(STATE(dst, elimclauses));
+    if (!src->okay()) {
+        dst->addEmptyClause();
+        return dst;
+    }
+
+    for (Minisat::Var v = 0; v < n; v++) {
+        int value = Minisat::toInt(src->value(v));
+        if (value == 0 || value == 1) dst->addClause(Minisat::mkLit(v, value == 1));
+    }
+    Minisat::vec<Minisat::Lit> lits;
+    const Minisat::vec<Minisat::CRef>& clauses = STATE(src, clauses);
+    for (int i = 0; i < clauses.size(); i++) {
+        const Minisat::Clause& c = STATE(src, ca)[clauses[i]];
+        if (c.mark() == 1) continue; // removed
+        lits.clear();
+        for (int j = 0; j < c.size(); j++) lits.push(c[j]);
+        dst->addClause_(lits);
+    }
+    // Note: learnt clauses are attached directly, so that they remain subject to the usual reduction
+    const Minisat::vec<Minisat::CRef>& learnts = STATE(src, learnts);
+    for (int i = 0; i < learnts.size() && dst->okay(); i++) {
+        Minisat::Clause& c = STATE(src, ca)[learnts[i]];
+        if (c.mark() == 1 || c.size() < 2) continue;
+        bool assigned = false;
+        lits.clear();
+        for (int j = 0; j < c.size(); j++) {
+            if (Minisat::toInt(dst->value(c[j])) != 2) assigned = true;
+            lits.push(c[j]);
+        }
+        // Note: clauses with assigned literals would break the watching invariants
+        if (assigned) continue;
+        Minisat::CRef cr = STATE(dst, ca).alloc(lits, true);
+        STATE(dst, ca)[cr].activity() = c.activity();
+        STATE(dst, learnts).push(cr);
+        (dst->*(&MiniSatState::attachClause))(cr);
+    }
+    return dst;
+}
+
+// Store the (simplified) formula into the artifact: variables (with their decision flags, user and saved polarities, 
+// frozen and eliminated flags), the reconstruction stack, top-level units and original clauses.
+// Note: learnt clauses are not stored, and the solver must not be solving.
+void MiniSatState::save(Minisat::SimpSolver* src, Preprocessed& out) {
+    int n = src->nVars();
+    out.var_flags.resize(n);
+    for (Minisat::Var v = 0; v < n; v++) {
+        uint8_t flags = (uint8_t) (Minisat::toInt(STATE(src, user_pol)[v]) << VAR_USER_POL_SHIFT);
+        if (STATE(src, polarity)[v]) flags |= VAR_POLARITY;
+        if (STATE(src, decision)[v]) flags |= VAR_DECISION;
+        if (STATE(src, frozen)[v]) flags |= VAR_FROZEN;
+        if (STATE(src, eliminated)[v]) flags |= VAR_ELIMINATED;
+        out.var_flags[v] = flags;
+    }
+    for (int i = 0; i < STATE(src, frozen_vars).size(); i++) {
+        out.var_flags[STATE(src, frozen_vars)[i]] |= VAR_USER_FROZEN;
+    }
+    const Minisat::vec<uint32_t>& elimclauses = STATE(src, elimclauses);
+    out.elim.resize(elimclauses.size());
+    for (int i = 0; i < elimclauses.size(); i++) {
+        out.elim[i] = elimclauses[i];
+    }
+    if (!STATE(src, use_simplification)) out.header.flags |= PREPROCESSED_SIMP_OFF;
+    if (!src->okay()) return;
+    out.header.flags |= PREPROCESSED_OKAY;
+
+    for (Minisat::Var v = 0; v < n; v++) {
+        int value = Minisat::toInt(src->value(v));
+        if (value == 0 || value == 1) out.units.push_back(value == 1 ? -(v + 1) : v + 1);
+    }
+    const Minisat::vec<Minisat::CRef>& clauses = STATE(src, clauses);
+    for (int i = 0; i < clauses.size(); i++) {
+        const Minisat::Clause& c = STATE(src, ca)[clauses[i]];
+        if (c.mark() == 1) continue; // removed
+        for (int j = 0; j < c.size(); j++) out.literals.push_back(unconvert(c[j]));
+        out.literals.push_back(0);
+    }
+}
+
+// Restore the solver from the artifact (see `save`), so that its models are extended back to the eliminated variables.
+Minisat::SimpSolver* MiniSatState::load(const PreprocessedView& in) {
+    Minisat::SimpSolver* dst = new Minisat::SimpSolver();
+    if (in.header->flags & PREPROCESSED_SIMP_OFF) {
+        dst->eliminate(true);
+    }
+
+    int n = in.header->num_vars;
+    for (Minisat::Var v = 0; v < n; v++) {
+        uint8_t flags = in.var_flags[v];
+        dst->newVar(Minisat::lbool((uint8_t) (flags >> VAR_USER_POL_SHIFT)), flags & VAR_DECISION);
+        STATE(dst, polarity)[v] = (flags & VAR_POLARITY) != 0;
+        STATE(dst, eliminated)[v] = (flags & VAR_ELIMINATED) != 0;
+        if (flags & VAR_USER_FROZEN) dst->freezeVar(v);
+        if ((flags & VAR_FROZEN) && !STATE(dst, frozen)[v]) dst->setFrozen(v, true);
+    }
+    for (int64_t i = 0; i < in.header->num_elim; i++) {
+        STATE(dst, elimclauses).push(in.elim[i]);
+    }
+    if (!(in.header->flags & PREPROCESSED_OKAY)) {
+        dst->addEmptyClause();
+        return dst;
+    }
+
+    for (int64_t i = 0; i < in.header->num_units; i++) {
+        dst->addClause(convert(in.units[i]));
+    }
+    add_clauses(dst, in.literals, (jint) in.header->num_literals);
+    return dst;
+}
+
+#undef STATE
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -56,6 +354,12 @@ JNI_METHOD(jlong, minisat_1ctor)
     return encode(new Minisat::SimpSolver());
   }
 
+// Note: returns a handle of the independent copy of the solver
+JNI_METHOD(jlong, minisat_1clone)
+  (JNIEnv*, jobject, jlong handle) {
+    return encode(MiniSatState::clone(decode(handle)));
+  }
+
 JNI_METHOD(void, minisat_1dtor)
   (JNIEnv*, jobject, jlong handle) {
     delete decode(handle);
@@ -96,6 +400,48 @@ JNI_METHOD(jlong, minisat_1conflicts)
     return decode(handle)->conflicts;
 }
 
+// Note: `out` receives the snapshot laid out as in Stats.hpp.
+//  The counters are read without synchronization, so the snapshot taken during the solve is approximate.
+JNI_METHOD(void, minisat_1stats)
+  (JNIEnv* env, jobject, jlong handle, jboolean solving, jlongArray out) {
+    Minisat::SimpSolver* solver = decode(handle);
+    jlong values[STATS_SIZE];
+    stats_init(values);
+    if (solving) {
+        int64_t record[PROGRESS_FIELDS];
+        progress_record_init(record);
+        sample(solver, record);
+        progress_stats(record, values);
+    } else {
+        values[STAT_VARIABLES] = solver->nVars();
+        values[STAT_CLAUSES] = solver->nClauses();
+        values[STAT_LEARNTS] = solver->nLearnts();
+        values[STAT_CONFLICTS] = (jlong) solver->conflicts;
+        values[STAT_DECISIONS] = (jlong) solver->decisions;
+        values[STAT_PROPAGATIONS] = (jlong) solver->propagations;
+        values[STAT_RESTARTS] = (jlong) solver->starts;
+        values[STAT_ELIMINATED] = solver->eliminated_vars;
+    }
+    stats_store(env, out, values);
+}
+
+// Note: returns a handle of the `ProgressPublisher` attached to the solver (see Progress.hpp)
+JNI_METHOD(jlong, minisat_1progress_1start)
+  (JNIEnv*, jobject, jlong handle, jlong conflicts_step, jint capacity) {
+    Minisat::SimpSolver* solver = decode(handle);
+    return progress_attach(solver, conflicts_step, capacity, [solver](int64_t* record) { sample(solver, record); });
+  }
+
+JNI_METHOD(jint, minisat_1progress_1drain)
+  (JNIEnv* env, jobject, jlong progress, jlongArray out) {
+    return progress_drain(env, progress, out);
+  }
+
+JNI_METHOD(void, minisat_1progress_1stop)
+  (JNIEnv*, jobject, jlong progress) {
+    progress_detach(progress);
+  }
+
 JNI_METHOD(jint, minisat_1new_1var)
   (JNIEnv*, jobject, jlong handle, jbyte polarity, jboolean decision) {
     int v = decode(handle)->newVar(Minisat::lbool((uint8_t) polarity), decision);
@@ -233,24 +579,78 @@ JNI_METHOD(jboolean, minisat_1add_1clause__J_3I)
     return decode(handle)->addClause_(vec);
   }
 
+JNI_METHOD(jboolean, minisat_1add_1clauses)
+  (JNIEnv* env, jobject, jlong handle, jintArray literals, jint size) {
+    jint* array = (jint*) env->GetPrimitiveArrayCritical(literals, 0);
+    bool ok = add_clauses(decode(handle), array, size);
+    env->ReleasePrimitiveArrayCritical(literals, array, JNI_ABORT);
+    return ok;
+  }
+
+JNI_METHOD(jboolean, minisat_1add_1clauses_1direct)
+  (JNIEnv* env, jobject, jlong handle, jobject buffer, jint size) {
+    jint* array = direct_clauses(env, buffer);
+    if (array == NULL) return false;
+    return add_clauses(decode(handle), array, size);
+  }
+
+// Note: `cnf` is a handle of `JCnf`
+JNI_METHOD(jboolean, minisat_1load_1cnf)
+  (JNIEnv*, jobject, jlong handle, jlong cnf) {
+    Minisat::SimpSolver* solver = decode(handle);
+    const Cnf* p = decode_cnf(cnf);
+    while (solver->nVars() < p->max_var) {
+        solver->newVar();
+    }
+    return add_clauses(solver, p->begin(), p->size());
+  }
+
+// Note: returns `dimacs_result_array`, or NULL on I/O or syntax error
+JNI_METHOD(jlongArray, minisat_1load_1dimacs)
+  (JNIEnv* env, jobject, jlong handle, jstring path, jint threads) {
+    Minisat::SimpSolver* solver = decode(handle);
+    const char* s = env->GetStringUTFChars(path, 0);
+    DimacsResult result;
+    bool ok = load_dimacs(s, threads, [solver](const jint* literals, jint len, jint max_var) {
+        while (solver->nVars() < max_var) {
+            solver->newVar();
+        }
+        return add_clauses(solver, literals, len);
+    }, &result);
+    env->ReleaseStringUTFChars(path, s);
+    if (!ok) {
+        return NULL;
+    }
+    return dimacs_result_array(env, result);
+  }
+
 JNI_METHOD(jboolean, minisat_1solve__JZZ)
   (JNIEnv*, jobject, jlong handle, jboolean do_simp, jboolean turn_off_simp) {
-    return decode(handle)->solve(do_simp, turn_off_simp);
+    return solve_unlimited(decode(handle), Minisat::vec<Minisat::Lit>(), do_simp, turn_off_simp);
   }
 
 JNI_METHOD(jboolean, minisat_1solve__JIZZ)
   (JNIEnv*, jobject, jlong handle, jint p, jboolean do_simp, jboolean turn_off_simp) {
-    return decode(handle)->solve(convert(p), do_simp, turn_off_simp);
+    Minisat::vec<Minisat::Lit> vec;
+    vec.push(convert(p));
+    return solve_unlimited(decode(handle), vec, do_simp, turn_off_simp);
   }
 
 JNI_METHOD(jboolean, minisat_1solve__JIIZZ)
   (JNIEnv*, jobject, jlong handle, jint p, jint q, jboolean do_simp, jboolean turn_off_simp) {
-    return decode(handle)->solve(convert(p), convert(q), do_simp, turn_off_simp);
+    Minisat::vec<Minisat::Lit> vec;
+    vec.push(convert(p));
+    vec.push(convert(q));
+    return solve_unlimited(decode(handle), vec, do_simp, turn_off_simp);
   }
 
 JNI_METHOD(jboolean, minisat_1solve__JIIIZZ)
   (JNIEnv*, jobject, jlong handle, jint p, jint q, jint r, jboolean do_simp, jboolean turn_off_simp) {
-    return decode(handle)->solve(convert(p), convert(q), convert(r), do_simp, turn_off_simp);
+    Minisat::vec<Minisat::Lit> vec;
+    vec.push(convert(p));
+    vec.push(convert(q));
+    vec.push(convert(r));
+    return solve_unlimited(decode(handle), vec, do_simp, turn_off_simp);
   }
 
 JNI_METHOD(jboolean, minisat_1solve__J_3IZZ)
@@ -264,7 +664,48 @@ JNI_METHOD(jboolean, minisat_1solve__J_3IZZ)
     }
     env->ReleasePrimitiveArrayCritical(assumptions, p, 0);
 
-    return decode(handle)->solve(vec, do_simp, turn_off_simp);
+    return solve_unlimited(decode(handle), vec, do_simp, turn_off_simp);
+  }
+
+JNI_METHOD(jlong, minisat_1assumptions_1new)
+  (JNIEnv*, jobject) {
+    return encode_assumptions(new MiniSatAssumptions());
+  }
+
+JNI_METHOD(void, minisat_1assumptions_1delete)
+  (JNIEnv*, jobject, jlong set) {
+    delete decode_assumptions<MiniSatAssumptions>(set);
+  }
+
+JNI_METHOD(jint, minisat_1assumptions_1add)
+  (JNIEnv* env, jobject, jlong set, jintArray literals, jint size) {
+    return assumptions_add<MiniSatAssumptions>(env, set, literals, size, convert);
+  }
+
+JNI_METHOD(jint, minisat_1assumptions_1remove)
+  (JNIEnv* env, jobject, jlong set, jintArray literals, jint size) {
+    return assumptions_remove<MiniSatAssumptions>(env, set, literals, size);
+  }
+
+JNI_METHOD(void, minisat_1assumptions_1clear)
+  (JNIEnv*, jobject, jlong set) {
+    decode_assumptions<MiniSatAssumptions>(set)->clear();
+  }
+
+JNI_METHOD(jint, minisat_1assumptions_1size)
+  (JNIEnv*, jobject, jlong set) {
+    return (jint) decode_assumptions<MiniSatAssumptions>(set)->external.size();
+  }
+
+JNI_METHOD(jintArray, minisat_1assumptions_1literals)
+  (JNIEnv* env, jobject, jlong set) {
+    return assumptions_literals<MiniSatAssumptions>(env, set);
+  }
+
+// Note: `set` is a handle of the assumption set, solved under without any copying or conversion
+JNI_METHOD(jboolean, minisat_1solve_1assumptions)
+  (JNIEnv*, jobject, jlong handle, jlong set, jboolean do_simp, jboolean turn_off_simp) {
+    return solve_unlimited(decode(handle), decode_assumptions<MiniSatAssumptions>(set)->lits, do_simp, turn_off_simp);
   }
 
 JNI_METHOD(jbyte, minisat_1solve_1limited)
@@ -281,6 +722,41 @@ JNI_METHOD(jbyte, minisat_1solve_1limited)
     return (jbyte) Minisat::toInt(decode(handle)->solveLimited(vec, do_simp, turn_off_simp));
   }
 
+// Note: `limits` is `SolveLimits.toArray()`, the result is packed by `limits_result` (see Limits.hpp).
+//  The previous budgets are turned off, and the interrupt issued by the watchdog is cleared afterwards.
+JNI_METHOD(jint, minisat_1solve_1with_1limits)
+  (JNIEnv* env, jobject, jlong handle, jintArray assumptions, jboolean do_simp, jboolean turn_off_simp, jlongArray limits) {
+    Minisat::SimpSolver* solver = decode(handle);
+    Limits l = read_limits(env, limits);
+    jint len = env->GetArrayLength(assumptions);
+    Minisat::vec<Minisat::Lit> vec(len);
+
+    jint* p = (jint*) env->GetPrimitiveArrayCritical(assumptions, 0);
+    for (jint i = 0; i < len; i++) {
+        vec[i] = convert(p[i]);
+    }
+    env->ReleasePrimitiveArrayCritical(assumptions, p, 0);
+
+    return MiniSatState::solve_with_limits(solver, vec, do_simp, turn_off_simp, l);
+  }
+
+// Note: `future` is a `SolveFuture`, completed from a native worker thread (see AsyncSolve.hpp)
+JNI_METHOD(void, minisat_1solve_1async)
+  (JNIEnv* env, jobject, jlong handle, jintArray assumptions, jboolean do_simp, jboolean turn_off_simp, jobject future) {
+    Minisat::SimpSolver* solver = decode(handle);
+    std::vector<jint> assumps = async_assumptions(env, assumptions);
+    bool simp = do_simp, turn_off = turn_off_simp;
+    async_solve(env, future, [solver, assumps, simp, turn_off] {
+        Minisat::vec<Minisat::Lit> vec((int) assumps.size());
+        for (size_t i = 0; i < assumps.size(); i++) {
+            vec[(int) i] = convert(assumps[i]);
+        }
+        // Note: same as the blocking `solve`, which ignores the budgets
+        int res = Minisat::toInt(MiniSatState::solve_ignoring_budgets(solver, vec, simp, turn_off));
+        return res == 0 ? ASYNC_SAT : res == 1 ? ASYNC_UNSAT : ASYNC_UNKNOWN;
+    });
+  }
+
 JNI_METHOD(jbyte, minisat_1get_1value)
   (JNIEnv*, jobject, jlong handle, jint lit) {
     return (jbyte) Minisat::toInt(decode(handle)->modelValue(convert(lit)));
@@ -303,6 +779,116 @@ JNI_METHOD(jbooleanArray, minisat_1get_1model)
     return result;
 }
 
+// Note: bit `i` of `bits` holds the value of the variable `i+1`
+JNI_METHOD(void, minisat_1get_1model_1bits)
+  (JNIEnv* env, jobject, jlong handle, jlongArray bits) {
+    Minisat::SimpSolver* solver = decode(handle);
+    const Minisat::vec<Minisat::lbool>& model = solver->model;
+    int n = solver->nVars();
+    int m = model.size() < n ? model.size() : n;
+    jsize words = (n + 63) / 64;
+    if (env->GetArrayLength(bits) < words) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Bits array is too short for the model");
+        return;
+    }
+    jlong* out = (jlong*) env->GetPrimitiveArrayCritical(bits, 0);
+    for (jsize w = 0; w < words; w++) {
+        uint64_t word = 0;
+        int begin = w * 64;
+        int end = begin + 64 < m ? begin + 64 : m;
+        for (int v = begin; v < end; v++) {
+            if (model[v] == Minisat::l_True) {
+                word |= (uint64_t) 1 << (v - begin);
+            }
+        }
+        out[w] = (jlong) word;
+    }
+    env->ReleasePrimitiveArrayCritical(bits, out, 0);
+  }
+
+// Note: `values` receives lbool codes (0 = true, 1 = false, 2 = undef) of the corresponding `literals`
+JNI_METHOD(void, minisat_1get_1values)
+  (JNIEnv* env, jobject, jlong handle, jintArray literals, jbyteArray values) {
+    Minisat::SimpSolver* solver = decode(handle);
+    int m = solver->model.size();
+    jsize len = env->GetArrayLength(literals);
+    if (env->GetArrayLength(values) < len) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Values array is shorter than literals array");
+        return;
+    }
+    jint* lits = (jint*) env->GetPrimitiveArrayCritical(literals, 0);
+    jbyte* out = (jbyte*) env->GetPrimitiveArrayCritical(values, 0);
+    for (jsize i = 0; i < len; i++) {
+        Minisat::Lit p = convert(lits[i]);
+        if (Minisat::var(p) < m) {
+            out[i] = (jbyte) Minisat::toInt(solver->modelValue(p));
+        } else {
+            out[i] = 2;
+        }
+    }
+    env->ReleasePrimitiveArrayCritical(values, out, 0);
+    env->ReleasePrimitiveArrayCritical(literals, lits, JNI_ABORT);
+  }
+
+// Note: writes the projected models (bit `i` is the value of `projection[i]`) into `buffer`,
+//  returns the number of written models
+JNI_METHOD(jint, minisat_1enumerate)
+  (JNIEnv* env, jobject, jlong handle, jintArray projection, jboolean minimize, jlongArray buffer) {
+    MiniSatBackend backend(decode(handle));
+    return allsat_enumerate(env, backend, projection, minimize, buffer);
+  }
+
+JNI_METHOD(jlong, minisat_1count_1models)
+  (JNIEnv* env, jobject, jlong handle, jintArray projection, jboolean minimize, jlong limit) {
+    MiniSatBackend backend(decode(handle));
+    return allsat_count(env, backend, projection, minimize, limit);
+  }
+
+// Note: returns the failed assumptions of the last (UNSAT) solve
+JNI_METHOD(jintArray, minisat_1get_1core)
+  (JNIEnv* env, jobject, jlong handle) {
+    MiniSatBackend backend(decode(handle));
+    std::vector<jint> core;
+    backend.core(std::vector<jint>(), core);
+    return core_to_array(env, core);
+  }
+
+// Note: returns NULL when the solver did not return UNSAT under the `assumptions`
+JNI_METHOD(jintArray, minisat_1minimize_1core)
+  (JNIEnv* env, jobject, jlong handle, jintArray assumptions) {
+    MiniSatBackend backend(decode(handle));
+    return core_minimize(env, backend, assumptions);
+  }
+
+// Note: `key` (at most 32 bytes) identifies the input, see Preprocess.hpp
+JNI_METHOD(jboolean, minisat_1save_1preprocessed)
+  (JNIEnv* env, jobject, jlong handle, jstring path, jbyteArray key) {
+    jsize key_size = env->GetArrayLength(key);
+    std::vector<jbyte> k(key_size);
+    env->GetByteArrayRegion(key, 0, key_size, k.data());
+    Preprocessed artifact(PREPROCESSED_KIND_MINISAT, k.data(), key_size);
+    MiniSatState::save(decode(handle), artifact);
+    const char* s = env->GetStringUTFChars(path, 0);
+    bool ok = artifact.save(s);
+    env->ReleaseStringUTFChars(path, s);
+    return ok;
+  }
+
+// Note: returns a handle of the new solver restored from the artifact,
+//  or 0 when it is missing, malformed, or made for another input (`key`)
+JNI_METHOD(jlong, minisat_1load_1preprocessed)
+  (JNIEnv* env, jobject, jstring path, jbyteArray key) {
+    jsize key_size = env->GetArrayLength(key);
+    std::vector<jbyte> k(key_size);
+    env->GetByteArrayRegion(key, 0, key_size, k.data());
+    const char* s = env->GetStringUTFChars(path, 0);
+    PreprocessedView view;
+    bool ok = view.open(s, PREPROCESSED_KIND_MINISAT, k.data(), key_size);
+    env->ReleaseStringUTFChars(path, s);
+    if (!ok) return 0;
+    return encode(MiniSatState::load(view));
+  }
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,785 @@
+/**
+ * Copyright © 2020, Darya Grechishkina, Konstantin Chukharev, ITMO University
+ */
+
+#include <jni.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Note: Glucose defines `l_True`, `l_False`, `l_Undef` and `var_Undef` as macros,
+//  which clash with the declarations of the same names in other solvers,
+//  so Glucose must be included last, and these names must not be used below.
+#include <minisat/simp/SimpSolver.h>
+#include <cryptominisat5/cryptominisat.h>
+#include <cadical/cadical.hpp>
+#include <glucose/simp/SimpSolver.h>
+
+#include "Cnf.hpp"
+#include "Dimacs.hpp"
+
+#define JNI_METHOD(rtype, name) \
+    JNIEXPORT rtype JNICALL Java_com_github_lipen_satlib_jni_JPortfolio_##name
+
+// Note: must be in sync with `JPortfolio.Backend`
+enum Kind {
+    KIND_MINISAT = 0,
+    KIND_GLUCOSE = 1,
+    KIND_CADICAL = 2,
+    KIND_CMS = 3,
+};
+
+static const jbyte LBOOL_TRUE = 0;
+static const jbyte LBOOL_FALSE = 1;
+static const jbyte LBOOL_UNDEF = 2;
+
+// Stops CaDiCaL when `flag` is set. Unlike `terminate()`, the flag is not reset on entering `solve`.
+struct StopFlag : CaDiCaL::Terminator {
+    std::atomic<bool> flag;
+    StopFlag() : flag(false) {}
+    bool terminate() { return flag.load(); }
+};
+
+struct Backend {
+    Kind kind;
+    void* solver; // owned by the corresponding J* object
+    StopFlag stop; // only for CaDiCaL
+    bool done;
+    jbyte result;
+};
+
+struct Portfolio {
+    std::vector<Backend> backends;
+    int nvars;
+    // Jeroslow-Wang scores of positive and negative literals (index is a variable),
+    // used for selecting the splitting variables in cube-and-conquer mode
+    std::vector<double> score_pos;
+    std::vector<double> score_neg;
+    bool simplified; // MiniSat/Glucose simplify only on the first solve, just like `SimpStrategy.ONCE`
+    std::atomic<int> winner;
+    std::atomic<bool> interrupted;
+    std::mutex mutex;
+    std::condition_variable cv;
+
+    explicit Portfolio(size_t n)
+        : backends(n), nvars(0), score_pos(1), score_neg(1), simplified(false), winner(-1), interrupted(false) {}
+};
+
+// Range `[begin, end)` of cube indices owned by a worker
+struct CubeRange {
+    std::mutex mutex;
+    uint64_t begin;
+    uint64_t end;
+
+    CubeRange() : begin(0), end(0) {}
+};
+
+// Cube `i` assigns `variables[j]` to the `j`-th bit of `i`
+struct CubeJob {
+    std::vector<int> variables;
+    std::vector<int> assumptions;
+    std::vector<CubeRange> ranges; // one per backend
+    std::atomic<bool> incomplete; // some cube was left unsolved
+
+    explicit CubeJob(size_t n) : ranges(n), incomplete(false) {}
+};
+
+static inline jlong encode(Portfolio* p) {
+    return (jlong) (intptr_t) p;
+}
+
+static inline Portfolio* decode(jlong h) {
+    return (Portfolio*) (intptr_t) h;
+}
+
+static inline Minisat::SimpSolver* minisat(const Backend& b) {
+    return (Minisat::SimpSolver*) b.solver;
+}
+
+static inline Glucose::SimpSolver* glucose(const Backend& b) {
+    return (Glucose::SimpSolver*) b.solver;
+}
+
+static inline CaDiCaL::Solver* cadical(const Backend& b) {
+    return (CaDiCaL::Solver*) b.solver;
+}
+
+static inline CMSat::SATSolver* cms(const Backend& b) {
+    return (CMSat::SATSolver*) b.solver;
+}
+
+static inline Minisat::Lit minisat_lit(int lit) {
+    return Minisat::toLit(lit > 0 ? (lit - 1) << 1 : ((-lit - 1) << 1) + 1);
+}
+
+static inline Glucose::Lit glucose_lit(int lit) {
+    return Glucose::toLit(lit > 0 ? (lit - 1) << 1 : ((-lit - 1) << 1) + 1);
+}
+
+static inline CMSat::Lit cms_lit(int lit) {
+    return CMSat::Lit(abs(lit) - 1, lit < 0);
+}
+
+// Access to the protected frozen flags of MiniSat and Glucose (see MiniSatState and GlucoseState).
+// Note: no instance of these structs is ever created, they only name the protected members.
+struct MiniSatFrozen : Minisat::SimpSolver {
+    static bool get(Minisat::SimpSolver* solver, int v) {
+        const Minisat::vec<char>& frozen = solver->*(&MiniSatFrozen::frozen);
+        return v < frozen.size() && frozen[v];
+    }
+};
+
+struct GlucoseFrozen : Glucose::SimpSolver {
+    static bool get(Glucose::SimpSolver* solver, int v) {
+        const Glucose::vec<char>& frozen = solver->*(&GlucoseFrozen::frozen);
+        return v < frozen.size() && frozen[v];
+    }
+};
+
+// Freeze the (0-based) variable `v` of the MiniSat-style backend `b`,
+// returns true iff it was not frozen before, so it must be unfrozen later
+static bool freeze(const Backend& b, int v) {
+    if (b.kind == KIND_MINISAT && !MiniSatFrozen::get(minisat(b), v)) {
+        minisat(b)->setFrozen(v, true);
+        return true;
+    }
+    if (b.kind == KIND_GLUCOSE && !GlucoseFrozen::get(glucose(b), v)) {
+        glucose(b)->setFrozen(v, true);
+        return true;
+    }
+    return false;
+}
+
+static void unfreeze(const Backend& b, int v) {
+    if (b.kind == KIND_MINISAT) minisat(b)->setFrozen(v, false);
+    if (b.kind == KIND_GLUCOSE) glucose(b)->setFrozen(v, false);
+}
+
+// Make sure that every backend has at least `n` variables
+static void ensure_vars(Portfolio* p, int n) {
+    if (n <= p->nvars) return;
+    for (size_t i = 0; i < p->backends.size(); i++) {
+        Backend& b = p->backends[i];
+        switch (b.kind) {
+            case KIND_MINISAT:
+                while (minisat(b)->nVars() < n) minisat(b)->newVar();
+                break;
+            case KIND_GLUCOSE:
+                while (glucose(b)->nVars() < n) glucose(b)->newVar();
+                break;
+            case KIND_CADICAL:
+                // Note: CaDiCaL declares variables implicitly
+                break;
+            case KIND_CMS:
+                if (cms(b)->nVars() < (unsigned) n) cms(b)->new_vars(n - cms(b)->nVars());
+                break;
+        }
+    }
+    p->score_pos.resize(n + 1, 0.0);
+    p->score_neg.resize(n + 1, 0.0);
+    p->nvars = n;
+}
+
+// Accumulate the Jeroslow-Wang scores of the literals in zero-terminated clauses
+static void update_scores(Portfolio* p, const jint* literals, jint len) {
+    jint start = 0;
+    for (jint i = 0; i < len; i++) {
+        if (literals[i] != 0) continue;
+        jint size = i - start;
+        // Note: clauses longer than 32 literals contribute (almost) nothing
+        double weight = size <= 32 ? 1.0 / ((uint64_t) 1 << size) : 0.0;
+        for (jint j = start; j < i; j++) {
+            jint lit = literals[j];
+            if (lit > 0) {
+                p->score_pos[lit] += weight;
+            } else {
+                p->score_neg[-lit] += weight;
+            }
+        }
+        start = i + 1;
+    }
+}
+
+// Add zero-terminated clauses from `literals[0 until len]` to every backend
+static bool add_clauses(Portfolio* p, const jint* literals, jint len) {
+    int max_var = p->nvars;
+    for (jint i = 0; i < len; i++) {
+        int v = abs(literals[i]);
+        if (v > max_var) max_var = v;
+    }
+    ensure_vars(p, max_var);
+    update_scores(p, literals, len);
+
+    bool ok = true;
+    for (size_t k = 0; k < p->backends.size(); k++) {
+        Backend& b = p->backends[k];
+        switch (b.kind) {
+            case KIND_MINISAT: {
+                Minisat::vec<Minisat::Lit> clause;
+                for (jint i = 0; i < len; i++) {
+                    if (literals[i] == 0) {
+                        minisat(b)->addClause_(clause);
+                        clause.clear();
+                    } else {
+                        clause.push(minisat_lit(literals[i]));
+                    }
+                }
+                ok &= minisat(b)->okay();
+                break;
+            }
+            case KIND_GLUCOSE: {
+                Glucose::vec<Glucose::Lit> clause;
+                for (jint i = 0; i < len; i++) {
+                    if (literals[i] == 0) {
+                        glucose(b)->addClause_(clause);
+                        clause.clear();
+                    } else {
+                        clause.push(glucose_lit(literals[i]));
+                    }
+                }
+                ok &= glucose(b)->okay();
+                break;
+            }
+            case KIND_CADICAL: {
+                for (jint i = 0; i < len; i++) {
+                    cadical(b)->add(literals[i]);
+                }
+                break;
+            }
+            case KIND_CMS: {
+                std::vector<CMSat::Lit> clause;
+                for (jint i = 0; i < len; i++) {
+                    if (literals[i] == 0) {
+                        ok &= cms(b)->add_clause(clause);
+                        clause.clear();
+                    } else {
+                        clause.push_back(cms_lit(literals[i]));
+                    }
+                }
+                break;
+            }
+        }
+    }
+    return ok;
+}
+
+static void clear_stop(Backend& b) {
+    switch (b.kind) {
+        case KIND_MINISAT:
+            minisat(b)->clearInterrupt();
+            break;
+        case KIND_GLUCOSE:
+            glucose(b)->clearInterrupt();
+            break;
+        case KIND_CADICAL:
+            b.stop.flag = false;
+            break;
+        case KIND_CMS:
+            // Note: CryptoMiniSat resets the interrupt flag by itself on entering `solve`
+            break;
+    }
+}
+
+static void request_stop(Backend& b) {
+    switch (b.kind) {
+        case KIND_MINISAT:
+            minisat(b)->interrupt();
+            break;
+        case KIND_GLUCOSE:
+            glucose(b)->interrupt();
+            break;
+        case KIND_CADICAL:
+            b.stop.flag = true;
+            break;
+        case KIND_CMS:
+            cms(b)->interrupt_asap();
+            break;
+    }
+}
+
+static jbyte solve_backend(Backend& b, const std::vector<int>& assumptions, bool do_simp, bool turn_off_simp) {
+    switch (b.kind) {
+        case KIND_MINISAT: {
+            Minisat::vec<Minisat::Lit> assumps;
+            for (size_t i = 0; i < assumptions.size(); i++) {
+                assumps.push(minisat_lit(assumptions[i]));
+            }
+            int res = Minisat::toInt(minisat(b)->solveLimited(assumps, do_simp, turn_off_simp));
+            return res < LBOOL_UNDEF ? (jbyte) res : LBOOL_UNDEF;
+        }
+        case KIND_GLUCOSE: {
+            Glucose::vec<Glucose::Lit> assumps;
+            for (size_t i = 0; i < assumptions.size(); i++) {
+                assumps.push(glucose_lit(assumptions[i]));
+            }
+            int res = Glucose::toInt(glucose(b)->solveLimited(assumps, do_simp, turn_off_simp));
+            return res < LBOOL_UNDEF ? (jbyte) res : LBOOL_UNDEF;
+        }
+        case KIND_CADICAL: {
+            CaDiCaL::Solver* solver = cadical(b);
+            for (size_t i = 0; i < assumptions.size(); i++) {
+                solver->assume(assumptions[i]);
+            }
+            solver->connect_terminator(&b.stop);
+            int res = solver->solve();
+            solver->disconnect_terminator();
+            return res == 10 ? LBOOL_TRUE : res == 20 ? LBOOL_FALSE : LBOOL_UNDEF;
+        }
+        case KIND_CMS: {
+            std::vector<CMSat::Lit> assumps;
+            for (size_t i = 0; i < assumptions.size(); i++) {
+                assumps.push_back(cms_lit(assumptions[i]));
+            }
+            int res = cms(b)->solve(&assumps).getValue();
+            return res < LBOOL_UNDEF ? (jbyte) res : LBOOL_UNDEF;
+        }
+    }
+    return LBOOL_UNDEF;
+}
+
+static void run_backend(Portfolio* p, size_t i, const std::vector<int>* assumptions, bool do_simp, bool turn_off_simp) {
+    Backend& b = p->backends[i];
+    b.result = solve_backend(b, *assumptions, do_simp, turn_off_simp);
+    if (b.result != LBOOL_UNDEF) {
+        int expected = -1;
+        p->winner.compare_exchange_strong(expected, (int) i);
+    }
+    {
+        std::lock_guard<std::mutex> lock(p->mutex);
+        b.done = true;
+    }
+    p->cv.notify_all();
+}
+
+static bool all_done(const Portfolio* p) {
+    for (size_t i = 0; i < p->backends.size(); i++) {
+        if (!p->backends[i].done) return false;
+    }
+    return true;
+}
+
+static void prepare(Portfolio* p) {
+    p->winner = -1;
+    // Note: stop requests are cleared before any backend starts, so that none of them is lost
+    for (size_t i = 0; i < p->backends.size(); i++) {
+        clear_stop(p->backends[i]);
+        p->backends[i].done = false;
+        p->backends[i].result = LBOOL_UNDEF;
+    }
+}
+
+// Wait for the first winner, then stop all the remaining backends
+static void wait_all(Portfolio* p, std::vector<std::thread>& threads) {
+    {
+        std::unique_lock<std::mutex> lock(p->mutex);
+        while (!all_done(p)) {
+            if (p->winner >= 0 || p->interrupted) {
+                // Note: stop requests are repeated until the backend finishes,
+                //  because some backends reset them on entering `solve`
+                for (size_t i = 0; i < p->backends.size(); i++) {
+                    if (!p->backends[i].done) request_stop(p->backends[i]);
+                }
+                p->cv.wait_for(lock, std::chrono::milliseconds(1));
+            } else {
+                p->cv.wait(lock);
+            }
+        }
+    }
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+}
+
+static jbyte solve(Portfolio* p, const std::vector<int>& assumptions) {
+    bool do_simp = !p->simplified;
+    bool turn_off_simp = !p->simplified;
+    p->simplified = true;
+    prepare(p);
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < p->backends.size(); i++) {
+        threads.push_back(std::thread(run_backend, p, i, &assumptions, do_simp, turn_off_simp));
+    }
+    wait_all(p, threads);
+
+    int w = p->winner;
+    return w >= 0 ? p->backends[w].result : LBOOL_UNDEF;
+}
+
+// Select up to `depth` splitting variables, not mentioned in `excluded`, with the highest
+// product of the scores of both literals. This is a static approximation of the "product"
+// heuristic of look-ahead solvers: the best splitting variables shrink the formula in both branches.
+static std::vector<int> select_cube_vars(const Portfolio* p, int depth, const std::vector<int>& excluded) {
+    std::vector<bool> skip(p->nvars + 1, false);
+    for (size_t i = 0; i < excluded.size(); i++) {
+        int v = abs(excluded[i]);
+        if (v <= p->nvars) skip[v] = true;
+    }
+    std::vector<std::pair<double, int> > candidates;
+    for (int v = 1; v <= p->nvars; v++) {
+        // Note: pure and unused variables are useless for splitting
+        if (skip[v] || p->score_pos[v] == 0.0 || p->score_neg[v] == 0.0) continue;
+        double score = p->score_pos[v] * p->score_neg[v] * 1024 + p->score_pos[v] + p->score_neg[v];
+        candidates.push_back(std::make_pair(-score, v));
+    }
+    size_t k = std::min((size_t) std::max(depth, 0), candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + k, candidates.end());
+    std::vector<int> vars(k);
+    for (size_t i = 0; i < k; i++) {
+        vars[i] = candidates[i].second;
+    }
+    return vars;
+}
+
+// Take the next cube for the `i`-th worker: either from its own range,
+// or by stealing the upper half of the remaining range of some other worker.
+static bool take_cube(CubeJob* job, size_t i, uint64_t* cube) {
+    size_t n = job->ranges.size();
+    {
+        CubeRange& own = job->ranges[i];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.begin < own.end) {
+            *cube = own.begin++;
+            return true;
+        }
+    }
+    for (size_t k = 1; k < n; k++) {
+        uint64_t begin, end;
+        {
+            CubeRange& victim = job->ranges[(i + k) % n];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.begin >= victim.end) continue;
+            begin = victim.begin + (victim.end - victim.begin) / 2;
+            end = victim.end;
+            victim.end = begin;
+        }
+        CubeRange& own = job->ranges[i];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        *cube = begin;
+        own.begin = begin + 1;
+        own.end = end;
+        return true;
+    }
+    return false;
+}
+
+static void run_cubes(Portfolio* p, size_t i, CubeJob* job, bool do_simp) {
+    Backend& b = p->backends[i];
+    std::vector<int> assumptions = job->assumptions;
+    size_t base = assumptions.size();
+    uint64_t cube;
+    while (p->winner < 0 && !p->interrupted && take_cube(job, i, &cube)) {
+        assumptions.resize(base);
+        for (size_t j = 0; j < job->variables.size(); j++) {
+            int v = job->variables[j];
+            assumptions.push_back((cube >> j) & 1 ? v : -v);
+        }
+        // Note: each backend solves its cubes incrementally, so it simplifies only on the first one
+        jbyte res = solve_backend(b, assumptions, do_simp, do_simp);
+        do_simp = false;
+        if (res == LBOOL_TRUE) {
+            b.result = res;
+            int expected = -1;
+            p->winner.compare_exchange_strong(expected, (int) i);
+            break;
+        }
+        if (res == LBOOL_UNDEF) {
+            job->incomplete = true;
+            break;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(p->mutex);
+        b.done = true;
+    }
+    p->cv.notify_all();
+}
+
+// Cube-and-conquer: split the formula into `2^k` cubes over the `k` given variables,
+// and solve them (under `assumptions`) on all backends, which steal cubes from each other.
+// Only a SAT cube produces a winner; the formula is UNSAT iff all cubes are UNSAT.
+static jbyte solve_cubes(Portfolio* p, const std::vector<int>& variables, const std::vector<int>& assumptions) {
+    bool do_simp = !p->simplified;
+    p->simplified = true;
+    prepare(p);
+
+    size_t n = p->backends.size();
+    CubeJob job(n);
+    job.variables = variables;
+    job.assumptions = assumptions;
+    // Note: initially, each worker owns a contiguous block of cubes sharing the high bits,
+    //  so that the consecutive cubes solved by the same backend are similar
+    uint64_t total = (uint64_t) 1 << variables.size();
+    for (size_t i = 0; i < n; i++) {
+        job.ranges[i].begin = total * i / n;
+        job.ranges[i].end = total * (i + 1) / n;
+    }
+    // Note: the splitting variables must survive the elimination while the cubes are solved,
+    //  but only the ones frozen here are unfrozen afterwards, so the frozen flags set by the user are kept
+    std::vector<std::vector<int> > frozen(n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < variables.size(); j++) {
+            int v = abs(variables[j]) - 1;
+            if (freeze(p->backends[i], v)) frozen[i].push_back(v);
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < n; i++) {
+        threads.push_back(std::thread(run_cubes, p, i, &job, do_simp));
+    }
+    wait_all(p, threads);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < frozen[i].size(); j++) {
+            unfreeze(p->backends[i], frozen[i][j]);
+        }
+    }
+
+    if (p->winner >= 0) return LBOOL_TRUE;
+    if (job.incomplete) return LBOOL_UNDEF;
+    for (size_t i = 0; i < n; i++) {
+        if (job.ranges[i].begin < job.ranges[i].end) return LBOOL_UNDEF;
+    }
+    return LBOOL_FALSE;
+}
+
+// Value of `lit` in the model found by the winner
+static jbyte value(const Backend& b, int lit) {
+    int v = abs(lit);
+    switch (b.kind) {
+        case KIND_MINISAT: {
+            if (v > minisat(b)->model.size()) return LBOOL_UNDEF;
+            return (jbyte) Minisat::toInt(minisat(b)->modelValue(minisat_lit(lit)));
+        }
+        case KIND_GLUCOSE: {
+            if (v > glucose(b)->model.size()) return LBOOL_UNDEF;
+            return (jbyte) Glucose::toInt(glucose(b)->modelValue(glucose_lit(lit)));
+        }
+        case KIND_CADICAL: {
+            // Note: variables never mentioned in any clause are unknown to CaDiCaL, treat them as false
+            if (v > cadical(b)->vars()) return lit > 0 ? LBOOL_FALSE : LBOOL_TRUE;
+            return cadical(b)->val(lit) > 0 ? LBOOL_TRUE : LBOOL_FALSE;
+        }
+        case KIND_CMS: {
+            const std::vector<CMSat::lbool>& model = cms(b)->get_model();
+            if ((size_t) v > model.size()) return LBOOL_UNDEF;
+            int res = model[v - 1].getValue();
+            if (res >= LBOOL_UNDEF) return LBOOL_UNDEF;
+            return (jbyte) (lit > 0 ? res : res ^ 1);
+        }
+    }
+    return LBOOL_UNDEF;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+JNI_METHOD(jlong, portfolio_1create)
+  (JNIEnv* env, jobject, jbyteArray kinds, jlongArray handles) {
+    jsize n = env->GetArrayLength(kinds);
+    jbyte* k = env->GetByteArrayElements(kinds, 0);
+    jlong* h = env->GetLongArrayElements(handles, 0);
+    Portfolio* p = new Portfolio(n);
+    for (jsize i = 0; i < n; i++) {
+        p->backends[i].kind = (Kind) k[i];
+        p->backends[i].solver = (void*) (intptr_t) h[i];
+        p->backends[i].done = true;
+        p->backends[i].result = LBOOL_UNDEF;
+    }
+    env->ReleaseLongArrayElements(handles, h, JNI_ABORT);
+    env->ReleaseByteArrayElements(kinds, k, JNI_ABORT);
+    return encode(p);
+  }
+
+JNI_METHOD(void, portfolio_1delete)
+  (JNIEnv*, jobject, jlong handle) {
+    delete decode(handle);
+  }
+
+JNI_METHOD(jint, portfolio_1nvars)
+  (JNIEnv*, jobject, jlong handle) {
+    return decode(handle)->nvars;
+  }
+
+JNI_METHOD(jint, portfolio_1winner)
+  (JNIEnv*, jobject, jlong handle) {
+    return decode(handle)->winner;
+  }
+
+JNI_METHOD(jint, portfolio_1new_1var)
+  (JNIEnv*, jobject, jlong handle) {
+    Portfolio* p = decode(handle);
+    ensure_vars(p, p->nvars + 1);
+    return p->nvars;
+  }
+
+JNI_METHOD(void, portfolio_1interrupt)
+  (JNIEnv*, jobject, jlong handle) {
+    Portfolio* p = decode(handle);
+    {
+        std::lock_guard<std::mutex> lock(p->mutex);
+        p->interrupted = true;
+    }
+    p->cv.notify_all();
+  }
+
+JNI_METHOD(void, portfolio_1clear_1interrupt)
+  (JNIEnv*, jobject, jlong handle) {
+    decode(handle)->interrupted = false;
+  }
+
+JNI_METHOD(jboolean, portfolio_1add_1clause)
+  (JNIEnv* env, jobject, jlong handle, jintArray literals) {
+    jsize len = env->GetArrayLength(literals);
+    std::vector<jint> clause(len + 1);
+    env->GetIntArrayRegion(literals, 0, len, clause.data());
+    clause[len] = 0;
+    return add_clauses(decode(handle), clause.data(), len + 1);
+  }
+
+JNI_METHOD(jboolean, portfolio_1add_1clauses)
+  (JNIEnv* env, jobject, jlong handle, jintArray literals, jint size) {
+    jint* array = (jint*) env->GetPrimitiveArrayCritical(literals, 0);
+    bool ok = add_clauses(decode(handle), array, size);
+    env->ReleasePrimitiveArrayCritical(literals, array, JNI_ABORT);
+    return ok;
+  }
+
+JNI_METHOD(jboolean, portfolio_1add_1clauses_1direct)
+  (JNIEnv* env, jobject, jlong handle, jobject buffer, jint size) {
+    jint* array = direct_clauses(env, buffer);
+    if (array == NULL) return false;
+    return add_clauses(decode(handle), array, size);
+  }
+
+// Note: `cnf` is a handle of `JCnf`
+JNI_METHOD(jboolean, portfolio_1load_1cnf)
+  (JNIEnv*, jobject, jlong handle, jlong cnf) {
+    const Cnf* q = decode_cnf(cnf);
+    return add_clauses(decode(handle), q->begin(), q->size());
+  }
+
+// Note: returns `dimacs_result_array`, or NULL on I/O or syntax error
+JNI_METHOD(jlongArray, portfolio_1load_1dimacs)
+  (JNIEnv* env, jobject, jlong handle, jstring path, jint threads) {
+    Portfolio* p = decode(handle);
+    const char* s = env->GetStringUTFChars(path, 0);
+    DimacsResult result;
+    bool ok = load_dimacs(s, threads, [p](const jint* literals, jint len, jint max_var) {
+        ensure_vars(p, max_var);
+        return add_clauses(p, literals, len);
+    }, &result);
+    env->ReleaseStringUTFChars(path, s);
+    if (!ok) {
+        return NULL;
+    }
+    return dimacs_result_array(env, result);
+  }
+
+JNI_METHOD(jbyte, portfolio_1solve)
+  (JNIEnv* env, jobject, jlong handle, jintArray assumptions) {
+    std::vector<int> assumps;
+    if (assumptions != NULL) {
+        jsize len = env->GetArrayLength(assumptions);
+        assumps.resize(len);
+        env->GetIntArrayRegion(assumptions, 0, len, (jint*) assumps.data());
+    }
+    return solve(decode(handle), assumps);
+  }
+
+static std::vector<int> to_vector(JNIEnv* env, jintArray array) {
+    std::vector<int> result;
+    if (array != NULL) {
+        jsize len = env->GetArrayLength(array);
+        result.resize(len);
+        env->GetIntArrayRegion(array, 0, len, (jint*) result.data());
+    }
+    return result;
+}
+
+JNI_METHOD(jintArray, portfolio_1select_1cube_1vars)
+  (JNIEnv* env, jobject, jlong handle, jint depth, jintArray excluded) {
+    std::vector<int> vars = select_cube_vars(decode(handle), depth, to_vector(env, excluded));
+    jintArray result = env->NewIntArray((jsize) vars.size());
+    if (result != NULL) {
+        env->SetIntArrayRegion(result, 0, (jsize) vars.size(), (const jint*) vars.data());
+    }
+    return result;
+  }
+
+JNI_METHOD(jbyte, portfolio_1solve_1cubes)
+  (JNIEnv* env, jobject, jlong handle, jintArray variables, jintArray assumptions) {
+    Portfolio* p = decode(handle);
+    std::vector<int> vars = to_vector(env, variables);
+    ensure_vars(p, vars.empty() ? 0 : abs(*std::max_element(vars.begin(), vars.end())));
+    return solve_cubes(p, vars, to_vector(env, assumptions));
+  }
+
+JNI_METHOD(jbyte, portfolio_1get_1value)
+  (JNIEnv*, jobject, jlong handle, jint lit) {
+    Portfolio* p = decode(handle);
+    int w = p->winner;
+    if (w < 0) return LBOOL_UNDEF;
+    return value(p->backends[w], lit);
+  }
+
+// Note: `values` receives lbool codes (0 = true, 1 = false, 2 = undef) of the corresponding `literals`
+JNI_METHOD(void, portfolio_1get_1values)
+  (JNIEnv* env, jobject, jlong handle, jintArray literals, jbyteArray values) {
+    Portfolio* p = decode(handle);
+    int w = p->winner;
+    jsize len = env->GetArrayLength(literals);
+    if (env->GetArrayLength(values) < len) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Values array is shorter than literals array");
+        return;
+    }
+    jint* lits = (jint*) env->GetPrimitiveArrayCritical(literals, 0);
+    jbyte* out = (jbyte*) env->GetPrimitiveArrayCritical(values, 0);
+    for (jsize i = 0; i < len; i++) {
+        out[i] = w >= 0 ? value(p->backends[w], lits[i]) : LBOOL_UNDEF;
+    }
+    env->ReleasePrimitiveArrayCritical(values, out, 0);
+    env->ReleasePrimitiveArrayCritical(literals, lits, JNI_ABORT);
+  }
+
+// Note: bit `i` of `bits` holds the value of the variable `i+1`
+JNI_METHOD(void, portfolio_1get_1model_1bits)
+  (JNIEnv* env, jobject, jlong handle, jlongArray bits) {
+    Portfolio* p = decode(handle);
+    int w = p->winner;
+    int n = p->nvars;
+    jsize words = (n + 63) / 64;
+    if (env->GetArrayLength(bits) < words) {
+        env->ThrowNew(env->FindClass("java/lang/IllegalArgumentException"), "Bits array is too short for the model");
+        return;
+    }
+    if (w < 0) {
+        return;
+    }
+    const Backend& b = p->backends[w];
+    jlong* out = (jlong*) env->GetPrimitiveArrayCritical(bits, 0);
+    for (jsize i = 0; i < words; i++) {
+        uint64_t word = 0;
+        int begin = i * 64;
+        int end = begin + 64 < n ? begin + 64 : n;
+        for (int v = begin; v < end; v++) {
+            if (value(b, v + 1) == LBOOL_TRUE) {
+                word |= (uint64_t) 1 << (v - begin);
+            }
+        }
+        out[i] = (jlong) word;
+    }
+    env->ReleasePrimitiveArrayCritical(bits, out, 0);
+  }
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,197 @@
+/**
+ * Copyright © 2020, Darya Grechishkina, Konstantin Chukharev, ITMO University
+ */
+
+#ifndef SATLIB_LIMITS_HPP
+#define SATLIB_LIMITS_HPP
+
+#include <jni.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Limit which stopped the solve (see `SolveLimits.Kind`)
+static const int LIMIT_NONE = 0;
+static const int LIMIT_TIME = 1;
+static const int LIMIT_CONFLICTS = 2;
+static const int LIMIT_PROPAGATIONS = 3;
+static const int LIMIT_MEMORY = 4;
+
+// Period of the watchdog checking the wall-clock and memory limits
+static const int LIMITS_POLL_MS = 5;
+
+static inline int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Resident memory of the whole process in bytes, or 0 when it is unknown on this platform.
+// Note: solvers do not account their own memory, so the memory limit is process-wide.
+static int64_t resident_memory() {
+#if defined(__linux__)
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (f == NULL) return 0;
+    long size, resident;
+    int n = fscanf(f, "%ld %ld", &size, &resident);
+    fclose(f);
+    return n == 2 ? (int64_t) resident * sysconf(_SC_PAGESIZE) : 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t) &info, &count) != KERN_SUCCESS) return 0;
+    return (int64_t) info.resident_size;
+#else
+    return 0;
+#endif
+}
+
+// Limits of a single solve, non-positive values meaning "no limit"
+struct Limits {
+    int64_t time_ms;
+    int64_t conflicts; // since the start of the solve
+    int64_t propagations; // since the start of the solve
+    int64_t memory; // in bytes
+};
+
+// Note: `array` is `SolveLimits.toArray()`: [timeMillis, conflicts, propagations, memoryBytes]
+static Limits read_limits(JNIEnv* env, jlongArray array) {
+    jlong values[4] = {0, 0, 0, 0};
+    if (array != NULL && env->GetArrayLength(array) >= 4) {
+        env->GetLongArrayRegion(array, 0, 4, values);
+    }
+    return Limits{values[0], values[1], values[2], values[3]};
+}
+
+// Pack the result code (0, 10 or 20) together with the limit which stopped the solve, see `LimitedSolveResult`.
+// Note: the limit is reported only for unknown results, since the solver may finish right after a limit fired.
+static inline jint limits_result(int result, int limit) {
+    return (jint) ((result == 0 ? limit : LIMIT_NONE) << 8 | result);
+}
+
+// Limits of a running solve, checked by the watchdog
+struct LimitGuard {
+    int64_t deadline; // in nanoseconds of `steady_clock`, or 0 when there is no deadline
+    int64_t memory;
+    std::function<void()> stop; // may be empty when the solver polls `fired` by itself
+    std::atomic<int> fired;
+
+    LimitGuard(const Limits& limits, std::function<void()> stop)
+        : deadline(limits.time_ms > 0 ? now_ns() + limits.time_ms * 1000000 : 0),
+          memory(limits.memory), stop(std::move(stop)), fired(LIMIT_NONE) {}
+
+    // Note: returns false if some limit has already fired
+    bool fire(int limit) {
+        int expected = LIMIT_NONE;
+        return fired.compare_exchange_strong(expected, limit);
+    }
+};
+
+// Single thread (per library) enforcing the wall-clock and memory limits of all running solves,
+// since the solvers do not check either of them by themselves.
+// Note: the thread is started on the first limited solve and never destroyed (see AsyncPool).
+struct LimitWatchdog {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<LimitGuard*> guards;
+
+    LimitWatchdog() {
+        std::thread(&LimitWatchdog::work, this).detach();
+    }
+
+    void add(LimitGuard* guard) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            guards.push_back(guard);
+        }
+        cv.notify_one();
+    }
+
+    // Note: once this returns, `stop` of the guard is never called again
+    void remove(LimitGuard* guard) {
+        std::lock_guard<std::mutex> lock(mutex);
+        guards.erase(std::remove(guards.begin(), guards.end(), guard), guards.end());
+    }
+
+    void work() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            if (guards.empty()) {
+                cv.wait(lock, [this] { return !guards.empty(); });
+            } else {
+                cv.wait_for(lock, std::chrono::milliseconds(LIMITS_POLL_MS));
+            }
+            int64_t now = now_ns();
+            int64_t memory = -1; // queried at most once per round
+            for (LimitGuard* guard : guards) {
+                int limit = LIMIT_NONE;
+                if (guard->deadline != 0 && now >= guard->deadline) {
+                    limit = LIMIT_TIME;
+                } else if (guard->memory > 0) {
+                    if (memory < 0) memory = resident_memory();
+                    if (memory > guard->memory) limit = LIMIT_MEMORY;
+                }
+                if (limit != LIMIT_NONE && guard->fire(limit) && guard->stop) {
+                    guard->stop();
+                }
+            }
+        }
+    }
+};
+
+static LimitWatchdog* limit_watchdog() {
+    static LimitWatchdog* watchdog = new LimitWatchdog();
+    return watchdog;
+}
+
+// Scope of a single limited solve, watching its wall-clock and memory limits (if any).
+// Once one of them is exceeded, the watchdog marks it as fired and calls `stop` from its own thread,
+// while the conflict and propagation limits are left to the solver budgets (see `fire`).
+struct LimitScope {
+    LimitGuard guard;
+    bool watched;
+
+    LimitScope(const Limits& limits, std::function<void()> stop)
+        : guard(limits, std::move(stop)), watched(limits.time_ms > 0 || limits.memory > 0) {
+        if (watched) limit_watchdog()->add(&guard);
+    }
+
+    ~LimitScope() {
+        finish();
+    }
+
+    LimitScope(const LimitScope&) = delete;
+    LimitScope& operator=(const LimitScope&) = delete;
+
+    // Stop watching the limits, returning the one which has fired (if any)
+    int finish() {
+        if (watched) {
+            limit_watchdog()->remove(&guard);
+            watched = false;
+        }
+        return fired();
+    }
+
+    int fired() const {
+        return guard.fired.load(std::memory_order_relaxed);
+    }
+
+    bool fire(int limit) {
+        return guard.fire(limit);
+    }
+};
+
+#endif // SATLIB_LIMITS_HPP
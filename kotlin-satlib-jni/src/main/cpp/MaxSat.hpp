@@ -0,0 +1,392 @@
+/**
+ * Copyright © 2020, Darya Grechishkina, Konstantin Chukharev, ITMO University
+ */
+
+#ifndef SATLIB_MAXSAT_HPP
+#define SATLIB_MAXSAT_HPP
+
+#include <jni.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+#include "AllSat.hpp"
+#include "Cardinality.hpp"
+#include "Cnf.hpp"
+#include "Core.hpp"
+
+// Weighted partial MaxSAT, solved entirely in native code over the clauses of the solver (hard)
+// and the soft clauses registered in the engine.
+//
+// The backend is a Core.hpp adapter additionally providing:
+//   jint max_var() -- the largest variable known to the solver,
+//   void reserve(jint max_var) -- make the variables up to `max_var` known to the solver,
+//   void freeze(jint lit) -- protect the variable of `lit` from elimination,
+//   void retire(jint act) -- add the unit `~act`, dropping the clauses guarded by `act` (see below).
+//
+// Each soft clause `C` with more than one literal is relaxed by a fresh selector `s` via the hard clause `C | ~s`,
+// the soft unit `l` is its own selector, so the cost is the total weight of the falsified selectors.
+// The selectors are added to the solver once (on the first solve after the registration),
+// while the cardinality constraints (totalizers, see Cardinality.hpp) are rebuilt by each solve.
+// The clauses of the totalizers are guarded by the activation literal `act` of the solve (as `C | ~act`),
+// which is assumed in all its SAT calls and retired at the end, so the clauses do not pile up over the solves.
+// All the bounds are only assumed, so the solver remains usable for the other queries.
+//
+// Algorithms:
+//   MAXSAT_LINEAR -- linear SAT-UNSAT search, tightening the upper bound over the totalizer of the falsified selectors
+//     (each selector counted `weight / gcd` times, so it is only suited for small weights),
+//   MAXSAT_OLL -- core-guided search (as in RC2): each core is relaxed by a totalizer over its literals,
+//     whose outputs become the new soft literals, optionally stratified by the weights.
+
+static const int MAXSAT_LINEAR = 0;
+static const int MAXSAT_OLL = 1;
+
+// Note: the statuses of the solve are the IPASIR ones, plus MAXSAT_OPTIMUM
+static const int MAXSAT_UNKNOWN = 0;
+static const int MAXSAT_SAT = 10; // feasible, but the optimality is not proven
+static const int MAXSAT_UNSAT = 20; // the hard clauses are infeasible
+static const int MAXSAT_OPTIMUM = 30;
+
+static const jlong MAXSAT_NO_COST = INT64_MAX;
+
+struct MaxSat {
+    std::vector<jint> clauses; // zero-terminated soft clauses
+    std::vector<jlong> weights;
+    std::vector<jint> selectors; // selectors of `weights[0 until selectors.size]`, the rest are not yet added
+    jint next_var;
+
+    // Note: the bounds are updated during the solve, and can be read from another thread
+    std::atomic<jlong> lower;
+    std::atomic<jlong> upper;
+    std::vector<jboolean> model; // 1-based, of the best found solution
+
+    MaxSat() : next_var(1), lower(0), upper(MAXSAT_NO_COST) {}
+
+    void add(const jint* literals, jint len, jlong weight) {
+        clauses.insert(clauses.end(), literals, literals + len);
+        clauses.push_back(0);
+        weights.push_back(weight);
+    }
+
+    jint size() const {
+        return (jint) weights.size();
+    }
+};
+
+static inline jlong encode_maxsat(MaxSat* p) {
+    return (jlong) (intptr_t) p;
+}
+
+static inline MaxSat* decode_maxsat(jlong h) {
+    return (MaxSat*) (intptr_t) h;
+}
+
+// Single run of the engine: the relaxation state is rebuilt on each solve
+template <typename Backend>
+struct MaxSatRun {
+    struct Relaxed {
+        jlong weight;
+        jint totalizer; // -1 for the selectors
+        jint index; // `lit == -outputs[index]` of the `totalizer`
+    };
+
+    Backend& backend;
+    MaxSat& engine;
+    jint first_var; // all the variables below it are taken
+    jint act; // activation literal guarding the totalizers, 0 until the first one is built
+    std::vector<Totalizer*> totalizers;
+    std::vector<jint> assumptions;
+    std::vector<jint> guarded; // `act` followed by the `assumptions`
+    std::vector<jint> core;
+    std::vector<jint> clause;
+    Cnf cnf;
+
+    MaxSatRun(Backend& backend, MaxSat& engine, jint max_var) : backend(backend), engine(engine), act(0) {
+        first_var = std::max(std::max(engine.next_var, backend.max_var() + 1), max_var + 1);
+    }
+
+    ~MaxSatRun() {
+        for (size_t i = 0; i < totalizers.size(); i++) delete totalizers[i];
+    }
+
+    jint fresh() {
+        jint v = std::max(first_var, backend.max_var() + 1);
+        first_var = v + 1;
+        engine.next_var = first_var;
+        backend.reserve(v);
+        return v;
+    }
+
+    // Add the clauses generated into `cnf` (with variables from `first_var` up to `next_var`) to the solver,
+    // guarded by the `act`
+    void flush(jint next_var) {
+        if (next_var > first_var) {
+            backend.reserve(next_var - 1);
+            first_var = next_var;
+            engine.next_var = next_var;
+        }
+        const jint* data = cnf.begin();
+        clause.clear();
+        for (jint i = 0; i < cnf.size(); i++) {
+            if (data[i] == 0) {
+                clause.push_back(-act);
+                backend.add_clause(clause);
+                clause.clear();
+            } else {
+                clause.push_back(data[i]);
+            }
+        }
+        cnf.clear();
+    }
+
+    Totalizer* totalizer(const std::vector<jint>& inputs, jint bound) {
+        if (act == 0) {
+            act = fresh();
+            backend.freeze(act);
+        }
+        CardEncoder enc(&cnf, std::max(first_var, backend.max_var() + 1));
+        Totalizer* t = new Totalizer(enc, inputs.data(), (jint) inputs.size(), bound);
+        flush(enc.next_var);
+        totalizers.push_back(t);
+        return t;
+    }
+
+    void extend(Totalizer* t, jint bound) {
+        CardEncoder enc(&cnf, std::max(first_var, backend.max_var() + 1));
+        t->extend(enc, bound);
+        flush(enc.next_var);
+    }
+
+    int solve() {
+        if (act == 0) return backend.solve(assumptions);
+        guarded.assign(1, act);
+        guarded.insert(guarded.end(), assumptions.begin(), assumptions.end());
+        return backend.solve(guarded);
+    }
+
+    // Retire the totalizers of this run (see above)
+    void finish() {
+        if (act != 0) backend.retire(act);
+    }
+
+    // Add the selectors of the newly registered soft clauses (and make sure their variables are known)
+    void prepare() {
+        const jint* data = engine.clauses.data();
+        size_t pos = 0;
+        for (size_t i = 0; i < engine.selectors.size(); i++) {
+            while (data[pos] != 0) pos++;
+            pos++;
+        }
+        for (size_t i = engine.selectors.size(); i < engine.weights.size(); i++) {
+            size_t end = pos;
+            while (data[end] != 0) end++;
+            jint max_var = 0;
+            for (size_t j = pos; j < end; j++) max_var = std::max(max_var, std::abs(data[j]));
+            backend.reserve(max_var);
+            first_var = std::max(first_var, max_var + 1);
+            jint selector;
+            if (end - pos == 1) {
+                selector = data[pos];
+            } else {
+                // Note: the empty soft clause gets the selector too, which is then falsified by the unit `~s`
+                selector = fresh();
+                clause.assign(data + pos, data + end);
+                clause.push_back(-selector);
+                backend.add_clause(clause);
+            }
+            backend.freeze(selector);
+            engine.selectors.push_back(selector);
+            pos = end + 1;
+        }
+    }
+
+    // Cost of the soft clauses falsified by the last model, which is recorded when it improves the upper bound
+    jlong improve() {
+        const jint* data = engine.clauses.data();
+        jlong cost = 0;
+        size_t pos = 0;
+        for (size_t i = 0; i < engine.weights.size(); i++) {
+            bool satisfied = false;
+            for (; data[pos] != 0; pos++) {
+                if (!satisfied && backend.value(data[pos])) satisfied = true;
+            }
+            pos++;
+            if (!satisfied) cost += engine.weights[i];
+        }
+        if (cost < engine.upper.load()) {
+            jint n = backend.max_var();
+            engine.model.assign((size_t) n + 1, JNI_FALSE);
+            for (jint v = 1; v <= n; v++) {
+                engine.model[v] = backend.value(v) ? JNI_TRUE : JNI_FALSE;
+            }
+            engine.upper.store(cost);
+        }
+        return cost;
+    }
+
+    int linear() {
+        jlong g = 0;
+        for (size_t i = 0; i < engine.weights.size(); i++) g = gcd(g, engine.weights[i]);
+        Totalizer* t = NULL;
+        assumptions.clear();
+        while (true) {
+            int res = solve();
+            if (res == ALLSAT_UNSAT) {
+                if (t == NULL) return MAXSAT_UNSAT;
+                engine.lower.store(engine.upper.load());
+                return MAXSAT_OPTIMUM;
+            }
+            if (res != ALLSAT_SAT) return engine.upper.load() == MAXSAT_NO_COST ? MAXSAT_UNKNOWN : MAXSAT_SAT;
+            improve();
+            jlong units = engine.upper.load() / (g > 0 ? g : 1);
+            if (units == 0) {
+                engine.lower.store(0);
+                return MAXSAT_OPTIMUM;
+            }
+            if (t == NULL) {
+                std::vector<jint> inputs;
+                for (size_t i = 0; i < engine.selectors.size(); i++) {
+                    for (jlong k = engine.weights[i] / g; k > 0; k--) inputs.push_back(-engine.selectors[i]);
+                }
+                t = totalizer(inputs, (jint) units);
+            }
+            // Note: the totalizer is never extended, since the bound only decreases
+            assumptions.assign(1, -t->outputs()[units - 1]);
+        }
+    }
+
+    int oll(bool stratify) {
+        std::vector<jint> order; // the relaxed literals in the order of appearance
+        std::unordered_map<jint, Relaxed> relaxed;
+        jlong base = 0;
+        for (size_t i = 0; i < engine.selectors.size(); i++) {
+            jint s = engine.selectors[i];
+            if (relaxed.count(s) == 0) order.push_back(s);
+            Relaxed& r = relaxed[s];
+            r.weight += engine.weights[i];
+            r.totalizer = -1;
+            r.index = 0;
+        }
+        jlong threshold = 1;
+        if (stratify) {
+            for (size_t i = 0; i < order.size(); i++) threshold = std::max(threshold, relaxed[order[i]].weight);
+        }
+
+        while (true) {
+            assumptions.clear();
+            for (size_t i = 0; i < order.size(); i++) {
+                const Relaxed& r = relaxed[order[i]];
+                if (r.weight >= threshold) assumptions.push_back(order[i]);
+            }
+            int res = solve();
+            if (res == ALLSAT_SAT) {
+                improve();
+                if (engine.upper.load() == engine.lower.load()) return MAXSAT_OPTIMUM;
+                // Lower the stratum to the largest weight below the current one
+                jlong next = 0;
+                for (size_t i = 0; i < order.size(); i++) {
+                    jlong w = relaxed[order[i]].weight;
+                    if (w < threshold && w > next) next = w;
+                }
+                if (next == 0) {
+                    // Note: the model satisfying all the relaxed literals costs exactly the lower bound,
+                    //  so this is only reached on a mismatch between the cost and the cores (which the model settles)
+                    engine.lower.store(engine.upper.load());
+                    return MAXSAT_OPTIMUM;
+                }
+                threshold = next;
+                continue;
+            }
+            if (res != ALLSAT_UNSAT) return engine.upper.load() == MAXSAT_NO_COST ? MAXSAT_UNKNOWN : MAXSAT_SAT;
+
+            backend.core(assumptions, core);
+            // Note: the `act` is not relaxable, and the totalizers alone are always satisfiable
+            core.erase(std::remove(core.begin(), core.end(), act), core.end());
+            if (core.empty()) return MAXSAT_UNSAT;
+            jlong w = MAXSAT_NO_COST;
+            for (size_t i = 0; i < core.size(); i++) w = std::min(w, relaxed[core[i]].weight);
+            base += w;
+            engine.lower.store(base);
+            std::vector<jint> inputs;
+            for (size_t i = 0; i < core.size(); i++) {
+                Relaxed& r = relaxed[core[i]];
+                r.weight -= w;
+                inputs.push_back(-core[i]);
+                // The output `~o[k]` of the totalizer is relaxed to `~o[k+1]`
+                if (r.totalizer >= 0) {
+                    Totalizer* t = totalizers[r.totalizer];
+                    jint k = r.index + 1;
+                    extend(t, k + 1);
+                    if (k < (jint) t->outputs().size()) {
+                        relax(order, relaxed, -t->outputs()[k], w, r.totalizer, k);
+                    }
+                }
+            }
+            if (inputs.size() > 1) {
+                Totalizer* t = totalizer(inputs, 2);
+                relax(order, relaxed, -t->outputs()[1], w, (jint) totalizers.size() - 1, 1);
+            }
+            if (engine.upper.load() == engine.lower.load()) return MAXSAT_OPTIMUM;
+        }
+    }
+
+private:
+    static jlong gcd(jlong a, jlong b) {
+        while (b != 0) {
+            jlong t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
+
+    static void relax(std::vector<jint>& order, std::unordered_map<jint, Relaxed>& relaxed, jint lit, jlong weight, jint totalizer, jint index) {
+        if (relaxed.count(lit) == 0) order.push_back(lit);
+        Relaxed& r = relaxed[lit];
+        r.weight += weight;
+        r.totalizer = totalizer;
+        r.index = index;
+    }
+};
+
+// Solve the MaxSAT problem with the given algorithm, returning the status (MAXSAT_*).
+// The variables up to `max_var` are considered taken (in addition to the ones known to the solver).
+template <typename Backend>
+static int maxsat_solve(Backend& backend, MaxSat& engine, int algorithm, bool stratify, jint max_var) {
+    engine.lower.store(0);
+    engine.upper.store(MAXSAT_NO_COST);
+    engine.model.clear();
+    MaxSatRun<Backend> run(backend, engine, max_var);
+    run.prepare();
+    int status = algorithm == MAXSAT_LINEAR ? run.linear() : run.oll(stratify);
+    run.finish();
+    return status;
+}
+
+// Note: `out` receives `[lower, upper]` bounds, the latter is MAXSAT_NO_COST while no solution is found
+static void maxsat_bounds(JNIEnv* env, jlong handle, jlongArray out) {
+    MaxSat* engine = decode_maxsat(handle);
+    jlong bounds[2] = {engine->lower.load(), engine->upper.load()};
+    env->SetLongArrayRegion(out, 0, 2, bounds);
+}
+
+// Note: returns the 1-based model of the best found solution, or NULL when out of memory
+static jbooleanArray maxsat_model(JNIEnv* env, jlong handle) {
+    const std::vector<jboolean>& model = decode_maxsat(handle)->model;
+    jsize size = (jsize) model.size();
+    jbooleanArray result = env->NewBooleanArray(size);
+    if (result == NULL) return NULL;
+    env->SetBooleanArrayRegion(result, 0, size, model.data());
+    return result;
+}
+
+static void maxsat_add(JNIEnv* env, jlong handle, jintArray literals, jint size, jlong weight) {
+    std::vector<jint> lits(size);
+    env->GetIntArrayRegion(literals, 0, size, lits.data());
+    decode_maxsat(handle)->add(lits.data(), size, weight);
+}
+
+#endif // SATLIB_MAXSAT_HPP
@@ -0,0 +1,231 @@
+/**
+ * Copyright © 2020, Darya Grechishkina, Konstantin Chukharev, ITMO University
+ */
+
+#ifndef SATLIB_PREPROCESS_HPP
+#define SATLIB_PREPROCESS_HPP
+
+#include <jni.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Artifact of the preprocessed formula: the simplified formula (top-level units and clauses),
+// the flags of the variables (including the frozen and eliminated ones) and the reconstruction stack
+// of the eliminated variables (`elimclauses` of MiniSat-style solvers, which extend the models back).
+//
+// Layout (native byte order, so the artifact is only portable between the machines of the same endianness):
+//   PreprocessedHeader,
+//   uint8_t var_flags[num_vars] (padded to 4 bytes),
+//   int32_t units[num_units] (external literals),
+//   int32_t literals[num_literals] (zero-terminated clauses of external literals),
+//   uint32_t elim[num_elim] (the reconstruction stack, as is).
+// The `key` identifies the input (e.g. the content hash of the CNF and the frozen set),
+// and is checked on loading, so the stale artifacts are rejected.
+
+static const char PREPROCESSED_MAGIC[8] = {'S', 'A', 'T', 'L', 'I', 'B', 'P', 'P'};
+static const uint32_t PREPROCESSED_VERSION = 1;
+static const size_t PREPROCESSED_KEY_SIZE = 32;
+
+static const uint32_t PREPROCESSED_KIND_MINISAT = 1;
+static const uint32_t PREPROCESSED_KIND_GLUCOSE = 2;
+
+// Header flags
+static const uint32_t PREPROCESSED_OKAY = 1; // the formula is not (trivially) UNSAT
+static const uint32_t PREPROCESSED_SIMP_OFF = 2; // the simplification is turned off
+
+// Variable flags
+static const uint8_t VAR_POLARITY = 1;
+static const uint8_t VAR_DECISION = 2;
+static const uint8_t VAR_FROZEN = 4;
+static const uint8_t VAR_ELIMINATED = 8;
+static const uint8_t VAR_USER_FROZEN = 16; // frozen by the user (until `thaw`)
+static const uint8_t VAR_USER_POL_SHIFT = 5; // 2 bits of the user polarity (`lbool`)
+
+struct PreprocessedHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t kind;
+    uint8_t key[PREPROCESSED_KEY_SIZE];
+    int32_t num_vars;
+    uint32_t flags;
+    int64_t num_units;
+    int64_t num_literals;
+    int64_t num_elim;
+};
+
+static inline size_t preprocessed_padded(size_t n) {
+    return (n + 3) & ~(size_t) 3;
+}
+
+// In-memory contents of the artifact, filled by the solver before saving
+struct Preprocessed {
+    PreprocessedHeader header;
+    std::vector<uint8_t> var_flags;
+    std::vector<int32_t> units;
+    std::vector<int32_t> literals;
+    std::vector<uint32_t> elim;
+
+    Preprocessed(uint32_t kind, const jbyte* key, jsize key_size) {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, PREPROCESSED_MAGIC, sizeof(header.magic));
+        header.version = PREPROCESSED_VERSION;
+        header.kind = kind;
+        memcpy(header.key, key, key_size < (jsize) PREPROCESSED_KEY_SIZE ? key_size : PREPROCESSED_KEY_SIZE);
+    }
+
+    // Note: the artifact is written to `path` as a whole, the caller is responsible for the atomic replacement
+    bool save(const char* path) {
+        header.num_vars = (int32_t) var_flags.size();
+        header.num_units = (int64_t) units.size();
+        header.num_literals = (int64_t) literals.size();
+        header.num_elim = (int64_t) elim.size();
+        FILE* file = fopen(path, "wb");
+        if (file == NULL) return false;
+        static const uint8_t zeros[4] = {0, 0, 0, 0};
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1
+                  && fwrite(var_flags.data(), 1, var_flags.size(), file) == var_flags.size()
+                  && fwrite(zeros, 1, preprocessed_padded(var_flags.size()) - var_flags.size(), file)
+                         == preprocessed_padded(var_flags.size()) - var_flags.size()
+                  && fwrite(units.data(), sizeof(int32_t), units.size(), file) == units.size()
+                  && fwrite(literals.data(), sizeof(int32_t), literals.size(), file) == literals.size()
+                  && fwrite(elim.data(), sizeof(uint32_t), elim.size(), file) == elim.size();
+        return fclose(file) == 0 && ok;
+    }
+};
+
+// Read-only view of the artifact, mapped into memory (or read as a whole where `mmap` is not available)
+class PreprocessedView {
+public:
+    const PreprocessedHeader* header;
+    const uint8_t* var_flags;
+    const int32_t* units;
+    const int32_t* literals;
+    const uint32_t* elim;
+
+    PreprocessedView() : header(NULL), var_flags(NULL), units(NULL), literals(NULL), elim(NULL), data(NULL), size(0) {
+#ifndef _WIN32
+        fd = -1;
+#endif
+    }
+
+    ~PreprocessedView() {
+#ifndef _WIN32
+        if (fd >= 0) {
+            if (data != NULL) munmap((void*) data, size);
+            close(fd);
+        }
+#endif
+    }
+
+    // Map the artifact of the given `kind` from `path`, checking its `key`.
+    // Returns false when the file is missing, malformed, or made for another kind of solver or input.
+    bool open(const char* path, uint32_t kind, const jbyte* key, jsize key_size) {
+        if (!map(path)) return false;
+        if (size < sizeof(PreprocessedHeader)) return false;
+        header = (const PreprocessedHeader*) data;
+        uint8_t expected[PREPROCESSED_KEY_SIZE] = {0};
+        memcpy(expected, key, key_size < (jsize) PREPROCESSED_KEY_SIZE ? key_size : PREPROCESSED_KEY_SIZE);
+        if (memcmp(header->magic, PREPROCESSED_MAGIC, sizeof(header->magic)) != 0
+            || header->version != PREPROCESSED_VERSION
+            || header->kind != kind
+            || memcmp(header->key, expected, PREPROCESSED_KEY_SIZE) != 0
+            || header->num_vars < 0 || header->num_units < 0 || header->num_literals < 0 || header->num_elim < 0) {
+            return false;
+        }
+        // Note: the counts are bounded by the file size first, so that the expected size does not overflow
+        int64_t words = (int64_t) (size / sizeof(int32_t));
+        if (header->num_units > words || header->num_literals > words || header->num_elim > words) return false;
+        size_t expected_size = sizeof(PreprocessedHeader) + preprocessed_padded((size_t) header->num_vars)
+                               + sizeof(int32_t) * (size_t) (header->num_units + header->num_literals)
+                               + sizeof(uint32_t) * (size_t) header->num_elim;
+        if (size != expected_size) return false;
+        var_flags = data + sizeof(PreprocessedHeader);
+        units = (const int32_t*) (var_flags + preprocessed_padded((size_t) header->num_vars));
+        literals = units + header->num_units;
+        elim = (const uint32_t*) (literals + header->num_literals);
+        return check_literals() && check_elim();
+    }
+
+private:
+    const uint8_t* data;
+    size_t size;
+#ifndef _WIN32
+    int fd;
+#endif
+    // Fallback without mmap
+    std::vector<uint8_t> buffer;
+
+    bool check_lit(int32_t lit) const {
+        return lit != 0 && lit >= -header->num_vars && lit <= header->num_vars;
+    }
+
+    // Every literal must be of a known variable, and the clauses must be zero-terminated,
+    // so that they never run past the section
+    bool check_literals() const {
+        for (int64_t i = 0; i < header->num_units; i++) {
+            if (!check_lit(units[i])) return false;
+        }
+        for (int64_t i = 0; i < header->num_literals; i++) {
+            if (literals[i] != 0 && !check_lit(literals[i])) return false;
+        }
+        return header->num_literals == 0 || literals[header->num_literals - 1] == 0;
+    }
+
+    // The reconstruction stack is read backwards (see `extendModel` of MiniSat) as the groups
+    // of `n > 0` internal literals (`2 * var + sign`) followed by `n`, the first of which is of the eliminated variable.
+    // Every group must fit into the stack, so that the reading ends exactly at its bottom.
+    bool check_elim() const {
+        int64_t i = header->num_elim - 1;
+        while (i >= 0) {
+            uint32_t n = elim[i];
+            if (n == 0 || (int64_t) n > i) return false;
+            i -= (int64_t) n + 1;
+            for (int64_t j = i + 1; j <= i + (int64_t) n; j++) {
+                if ((elim[j] >> 1) >= (uint32_t) header->num_vars) return false;
+            }
+            if (!(var_flags[elim[i + 1] >> 1] & VAR_ELIMINATED)) return false;
+        }
+        return true;
+    }
+
+    bool map(const char* path) {
+#ifndef _WIN32
+        fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) return false;
+        size = (size_t) st.st_size;
+        if (size == 0) return false;
+        void* p = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            data = (const uint8_t*) p;
+            return true;
+        }
+        close(fd);
+        fd = -1;
+#endif
+        FILE* file = fopen(path, "rb");
+        if (file == NULL) return false;
+        uint8_t chunk[1 << 16];
+        size_t n;
+        while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            buffer.insert(buffer.end(), chunk, chunk + n);
+        }
+        fclose(file);
+        data = buffer.data();
+        size = buffer.size();
+        return true;
+    }
+};
+
+#endif // SATLIB_PREPROCESS_HPP
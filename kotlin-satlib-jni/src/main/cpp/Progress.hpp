@@ -0,0 +1,199 @@
+/**
+ * Copyright © 2020, Darya Grechishkina, Konstantin Chukharev, ITMO University
+ */
+
+#ifndef SATLIB_PROGRESS_HPP
+#define SATLIB_PROGRESS_HPP
+
+#include <jni.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Limits.hpp"
+#include "Stats.hpp"
+
+// Layout of a progress record (see `ProgressRecord`), fields not reported by the backend are -1
+static const int PROGRESS_TIME = 0; // nanoseconds since the start of the stream
+static const int PROGRESS_CONFLICTS = 1;
+static const int PROGRESS_DECISIONS = 2;
+static const int PROGRESS_PROPAGATIONS = 3;
+static const int PROGRESS_RESTARTS = 4;
+static const int PROGRESS_TRAIL = 5; // variables assigned at the top level
+static const int PROGRESS_LEARNTS = 6; // learnt clauses
+static const int PROGRESS_FIELDS = 7;
+
+// Period of the sampler thread of the publisher (see `ProgressPublisher`)
+static const int PROGRESS_SAMPLE_MS = 1;
+
+static inline void progress_record_init(int64_t* record) {
+    std::fill(record, record + PROGRESS_FIELDS, -1);
+}
+
+// Single-producer single-consumer ring of progress records.
+// Note: the producer never waits, the records not fitting into the ring are dropped.
+struct ProgressRing {
+    std::vector<int64_t> data;
+    uint64_t capacity;
+    std::atomic<uint64_t> head; // next record to write
+    std::atomic<uint64_t> tail; // next record to read
+
+    explicit ProgressRing(uint64_t capacity)
+        : data(capacity * PROGRESS_FIELDS), capacity(capacity), head(0), tail(0) {}
+
+    bool push(const int64_t* record) {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) == capacity) {
+            return false;
+        }
+        std::copy(record, record + PROGRESS_FIELDS, &data[(h % capacity) * PROGRESS_FIELDS]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Note: returns the number of records copied into `out`
+    uint64_t drain(int64_t* out, uint64_t max) {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        uint64_t n = std::min(head.load(std::memory_order_acquire) - t, max);
+        for (uint64_t i = 0; i < n; i++) {
+            const int64_t* record = &data[((t + i) % capacity) * PROGRESS_FIELDS];
+            std::copy(record, record + PROGRESS_FIELDS, out + i * PROGRESS_FIELDS);
+        }
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+};
+
+// Publisher of the progress of the solves of a single solver, attached via `progress_attach`.
+//
+// The solve is never split for the sake of the progress (which would change the very search being watched).
+// Instead, the counters are polled during the search, either by the solving thread itself
+// from a hook of the solver (the learner of CaDiCaL), or, for the solvers without such hooks,
+// by the sampler thread of the publisher, which reads the counters of the running solver every `PROGRESS_SAMPLE_MS`.
+// A record is published once at least `conflicts_step` conflicts have passed since the previous one,
+// so only the producer (either of the two) ever touches `next`, and the consumer only touches the ring.
+struct ProgressPublisher {
+    ProgressRing ring;
+    const void* solver;
+    int64_t conflicts_step;
+    int64_t start;
+    int64_t next; // conflicts of the next record
+    // Fills the record (except for the time) from the running solver, empty if the solver publishes by itself
+    std::function<void(int64_t*)> sample;
+    std::mutex sampler_mutex;
+    std::condition_variable sampler_cv;
+    bool stopping;
+    std::thread sampler;
+
+    ProgressPublisher(const void* solver, int64_t conflicts_step, int capacity, std::function<void(int64_t*)> sample)
+        : ring(capacity), solver(solver), conflicts_step(std::max<int64_t>(conflicts_step, 1)),
+          start(now_ns()), next(0), sample(sample), stopping(false) {
+        if (sample) {
+            sampler = std::thread(&ProgressPublisher::run_sampler, this);
+        }
+    }
+
+    ~ProgressPublisher() {
+        if (sampler.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(sampler_mutex);
+                stopping = true;
+            }
+            sampler_cv.notify_all();
+            sampler.join();
+        }
+    }
+
+    bool due(int64_t conflicts) const {
+        return conflicts >= next;
+    }
+
+    void publish(int64_t* record) {
+        record[PROGRESS_TIME] = now_ns() - start;
+        ring.push(record);
+        next = record[PROGRESS_CONFLICTS] + conflicts_step;
+    }
+
+    void run_sampler() {
+        std::unique_lock<std::mutex> lock(sampler_mutex);
+        while (!sampler_cv.wait_for(lock, std::chrono::milliseconds(PROGRESS_SAMPLE_MS), [this] { return stopping; })) {
+            int64_t record[PROGRESS_FIELDS];
+            progress_record_init(record);
+            sample(record);
+            if (due(record[PROGRESS_CONFLICTS])) publish(record);
+        }
+    }
+};
+
+// Publishers attached to the solvers, keyed by the address of the solver.
+// Note: a solve publishing by itself holds its own reference,
+//  so the publisher can be detached (and the stream closed) while solving.
+static std::mutex progress_mutex;
+static std::unordered_map<const void*, std::shared_ptr<ProgressPublisher> > progress_publishers;
+
+static inline std::shared_ptr<ProgressPublisher>* decode_progress(jlong h) {
+    return (std::shared_ptr<ProgressPublisher>*) (intptr_t) h;
+}
+
+// Attach a new publisher to the `solver`, replacing the previous one (if any).
+// When `sample` is given, it is called by the sampler thread of the publisher, concurrently with the solves,
+// so it must only read the plain counters of the solver (a benign race on word-sized values),
+// otherwise the solves must publish the records themselves (see `progress_find`).
+// Note: returns a handle of the publisher, to be released via `progress_detach`.
+static jlong progress_attach(const void* solver, int64_t conflicts_step, int capacity,
+                             std::function<void(int64_t*)> sample = std::function<void(int64_t*)>()) {
+    std::shared_ptr<ProgressPublisher>* p = new std::shared_ptr<ProgressPublisher>(
+        new ProgressPublisher(solver, conflicts_step, capacity, sample));
+    std::lock_guard<std::mutex> lock(progress_mutex);
+    progress_publishers[solver] = *p;
+    return (jlong) (intptr_t) p;
+}
+
+static void progress_detach(jlong handle) {
+    std::shared_ptr<ProgressPublisher>* p = decode_progress(handle);
+    {
+        std::lock_guard<std::mutex> lock(progress_mutex);
+        std::unordered_map<const void*, std::shared_ptr<ProgressPublisher> >::iterator it =
+            progress_publishers.find((*p)->solver);
+        if (it != progress_publishers.end() && it->second == *p) {
+            progress_publishers.erase(it);
+        }
+    }
+    delete p;
+}
+
+static std::shared_ptr<ProgressPublisher> progress_find(const void* solver) {
+    std::lock_guard<std::mutex> lock(progress_mutex);
+    std::unordered_map<const void*, std::shared_ptr<ProgressPublisher> >::iterator it =
+        progress_publishers.find(solver);
+    return it != progress_publishers.end() ? it->second : std::shared_ptr<ProgressPublisher>();
+}
+
+// Fill the counters of the stats snapshot (see Stats.hpp) from the `record` of the running solve
+static void progress_stats(const int64_t* record, jlong* values) {
+    values[STAT_LEARNTS] = record[PROGRESS_LEARNTS];
+    values[STAT_CONFLICTS] = record[PROGRESS_CONFLICTS];
+    values[STAT_DECISIONS] = record[PROGRESS_DECISIONS];
+    values[STAT_PROPAGATIONS] = record[PROGRESS_PROPAGATIONS];
+    values[STAT_RESTARTS] = record[PROGRESS_RESTARTS];
+}
+
+// Note: `out` receives up to `out.size / PROGRESS_FIELDS` records, returns their number
+static jint progress_drain(JNIEnv* env, jlong handle, jlongArray out) {
+    jsize max = env->GetArrayLength(out) / PROGRESS_FIELDS;
+    jlong* array = (jlong*) env->GetPrimitiveArrayCritical(out, 0);
+    uint64_t n = (*decode_progress(handle))->ring.drain((int64_t*) array, (uint64_t) max);
+    env->ReleasePrimitiveArrayCritical(out, array, 0);
+    return (jint) n;
+}
+
+#endif // SATLIB_PROGRESS_HPP
@@ -0,0 +1,50 @@
+/**
+ * Copyright © 2020, Darya Grechishkina, Konstantin Chukharev, ITMO University
+ */
+
+#ifndef SATLIB_STATS_HPP
+#define SATLIB_STATS_HPP
+
+#include <jni.h>
+
+#include "Limits.hpp"
+
+// Layout of the statistics snapshot (see `SolverStats`), filled by a single `*_stats` call.
+// Fields not reported by the backend are -1.
+// Note: the layout is versioned, bump `STATS_LAYOUT` on any change (also in `SolverStats`).
+static const jlong STATS_LAYOUT = 1;
+
+static const int STAT_LAYOUT = 0;
+static const int STAT_VARIABLES = 1;
+static const int STAT_CLAUSES = 2; // original (irredundant) clauses
+static const int STAT_LEARNTS = 3; // learnt (redundant) clauses
+static const int STAT_CONFLICTS = 4;
+static const int STAT_DECISIONS = 5;
+static const int STAT_PROPAGATIONS = 6;
+static const int STAT_RESTARTS = 7;
+static const int STAT_ELIMINATED = 8; // eliminated variables
+static const int STAT_REDUCTIONS = 9; // reductions of the learnt clause database
+static const int STAT_MEMORY = 10; // resident memory of the whole process, in bytes
+static const int STAT_SOLVES = 11; // Note: tracked on the JVM side
+static const int STAT_SOLVE_TIME = 12; // in nanoseconds, tracked on the JVM side
+static const int STATS_SIZE = 13;
+
+// Start the snapshot: all fields are "not reported", except for the layout and the process memory
+static void stats_init(jlong* values) {
+    for (int i = 0; i < STATS_SIZE; i++) {
+        values[i] = -1;
+    }
+    values[STAT_LAYOUT] = STATS_LAYOUT;
+    int64_t memory = resident_memory();
+    if (memory > 0) values[STAT_MEMORY] = memory;
+}
+
+// Note: `out` is left untouched if it is too small
+static void stats_store(JNIEnv* env, jlongArray out, const jlong* values) {
+    if (env->GetArrayLength(out) < STATS_SIZE) {
+        return;
+    }
+    env->SetLongArrayRegion(out, 0, STATS_SIZE, values);
+}
+
+#endif // SATLIB_STATS_HPP
@@ -0,0 +1,7 @@
+package com.github.lipen.satlib.jni
+
+/**
+ * Number of words occupied by one projected model (over [projectionSize] literals)
+ * in the buffer filled by `enumerateModels`.
+ */
+fun modelWords(projectionSize: Int): Int = maxOf(1, (projectionSize + 63) / 64)
@@ -0,0 +1,93 @@
+package com.github.lipen.satlib.jni
+
+/**
+ * Set of assumptions kept in native memory, already translated into the literals of the solver,
+ * created by `newAssumptionSet` of the native solvers and passed to their `solve` by handle.
+ *
+ * Updating the set costs O(|delta|), while solving under it requires no marshalling at all,
+ * unlike passing the whole assumption array (copied and converted on each call).
+ * The set is not bound to a particular solver instance, so it can be shared by the solvers of the same kind
+ * (_e.g._, clones), and it stays valid after the solver is reset or closed.
+ *
+ * Note: [remove] does not preserve the order of assumptions (the last one takes the place of the removed one).
+ * Note: the set must not be modified while a solve under it is running.
+ */
+class AssumptionSet internal constructor(
+    handle: Long,
+    private val kind: String,
+    private val natives: Natives,
+) : AutoCloseable {
+    private var handle: Long = handle
+
+    val isClosed: Boolean
+        get() = handle == 0L
+
+    /** Number of assumptions in the set. */
+    val size: Int
+        get() = natives.size(checkedHandle())
+
+    /** Assumptions in the current order. */
+    val literals: IntArray
+        get() = natives.literals(checkedHandle())
+            ?: throw OutOfMemoryError("${kind}_assumptions_literals returned NULL")
+
+    /**
+     * Add the first [size] [literals] to the set, returning the number of actually added ones
+     * (the literals already in the set are skipped).
+     */
+    @JvmOverloads
+    fun add(literals: IntArray, size: Int = literals.size): Int {
+        require(size in 0..literals.size) { "Bad size: $size" }
+        return natives.add(checkedHandle(), literals, size)
+    }
+
+    @JvmName("addVararg")
+    fun add(vararg literals: Int): Int {
+        return add(literals)
+    }
+
+    /**
+     * Remove the first [size] [literals] from the set, returning the number of actually removed ones
+     * (the literals not in the set are skipped).
+     */
+    @JvmOverloads
+    fun remove(literals: IntArray, size: Int = literals.size): Int {
+        require(size in 0..literals.size) { "Bad size: $size" }
+        return natives.remove(checkedHandle(), literals, size)
+    }
+
+    @JvmName("removeVararg")
+    fun remove(vararg literals: Int): Int {
+        return remove(literals)
+    }
+
+    fun clear() {
+        natives.clear(checkedHandle())
+    }
+
+    override fun close() {
+        if (handle != 0L) {
+            natives.delete(handle)
+            handle = 0
+        }
+    }
+
+    internal fun handleFor(solver: String): Long {
+        require(solver == kind) { "Assumption set of $kind cannot be used with $solver" }
+        return checkedHandle()
+    }
+
+    private fun checkedHandle(): Long {
+        check(handle != 0L) { "Assumption set is closed" }
+        return handle
+    }
+
+    internal interface Natives {
+        fun add(set: Long, literals: IntArray, size: Int): Int
+        fun remove(set: Long, literals: IntArray, size: Int): Int
+        fun clear(set: Long)
+        fun size(set: Long): Int
+        fun literals(set: Long): IntArray?
+        fun delete(set: Long)
+    }
+}
@@ -0,0 +1,101 @@
+package com.github.lipen.satlib.jni
+
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.IntBuffer
+
+/**
+ * Off-heap buffer of zero-terminated clauses, which are passed to the [sink] in large batches.
+ *
+ * Literals are stored in a direct [ByteBuffer] (in native byte order),
+ * so the native `add_clauses_direct` methods read them without any copying.
+ * The [sink] is called with the buffer and the number of stored ints,
+ * and always receives whole clauses.
+ */
+@Suppress("MemberVisibilityCanBePrivate")
+class ClauseBuffer @JvmOverloads constructor(
+    capacity: Int = DEFAULT_CAPACITY,
+    private val sink: (buffer: ByteBuffer, size: Int) -> Unit,
+) {
+    private var buffer: ByteBuffer = allocate(capacity)
+    private var ints: IntBuffer = buffer.asIntBuffer()
+
+    /** Capacity of the buffer, in ints. */
+    val capacity: Int get() = ints.capacity()
+
+    /** Number of ints (literals and terminating zeros) currently stored in the buffer. */
+    val size: Int get() = ints.position()
+
+    /** Number of batches passed to the [sink] so far. */
+    var numberOfFlushes: Long = 0L
+        private set
+
+    fun addClause(literals: IntArray) {
+        ensureRemaining(literals.size + 1)
+        ints.put(literals)
+        ints.put(0)
+    }
+
+    /** Add the clause of `literals[fromIndex until toIndex]` (the array is not retained). */
+    fun addClause(literals: IntArray, fromIndex: Int, toIndex: Int) {
+        ensureRemaining(toIndex - fromIndex + 1)
+        ints.put(literals, fromIndex, toIndex - fromIndex)
+        ints.put(0)
+    }
+
+    fun addClause(lit: Int) {
+        ensureRemaining(2)
+        ints.put(lit).put(0)
+    }
+
+    fun addClause(lit1: Int, lit2: Int) {
+        ensureRemaining(3)
+        ints.put(lit1).put(lit2).put(0)
+    }
+
+    fun addClause(lit1: Int, lit2: Int, lit3: Int) {
+        ensureRemaining(4)
+        ints.put(lit1).put(lit2).put(lit3).put(0)
+    }
+
+    fun addClause(literals: List<Int>) {
+        ensureRemaining(literals.size + 1)
+        for (lit in literals) {
+            ints.put(lit)
+        }
+        ints.put(0)
+    }
+
+    /** Pass all buffered clauses to the [sink]. */
+    fun flush() {
+        if (ints.position() > 0) {
+            sink(buffer, ints.position())
+            ints.clear()
+            numberOfFlushes++
+        }
+    }
+
+    /** Drop all buffered clauses. */
+    fun clear() {
+        ints.clear()
+    }
+
+    private fun ensureRemaining(n: Int) {
+        if (ints.remaining() >= n) return
+        flush()
+        if (ints.capacity() < n) {
+            // Note: a single clause is larger than the whole buffer, so we have to grow it
+            buffer = allocate(maxOf(n, 2 * ints.capacity()))
+            ints = buffer.asIntBuffer()
+        }
+    }
+
+    companion object {
+        const val DEFAULT_CAPACITY: Int = 1 shl 16
+
+        private fun allocate(capacity: Int): ByteBuffer {
+            require(capacity > 0) { "Capacity must be positive" }
+            return ByteBuffer.allocateDirect(capacity * Int.SIZE_BYTES).order(ByteOrder.nativeOrder())
+        }
+    }
+}
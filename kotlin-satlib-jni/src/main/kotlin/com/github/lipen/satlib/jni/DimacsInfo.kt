@@ -0,0 +1,30 @@
+package com.github.lipen.satlib.jni
+
+/** Summary of the DIMACS CNF loaded directly into a native solver via `loadDimacs`. */
+data class DimacsInfo(
+    val numberOfVariables: Int,
+    val numberOfClauses: Long,
+    /** The number of clauses declared in the `p cnf` header, or -1 if there is no header. */
+    val declaredClauses: Long = -1,
+    /**
+     * Whether the solver found the formula UNSAT while loading it
+     * (only reported by MiniSat, Glucose and the portfolio, other solvers find it out when solving).
+     */
+    val unsatisfiable: Boolean = false,
+) {
+    /** Whether the number of clauses read differs from the one declared in the header. */
+    val isClauseCountMismatch: Boolean
+        get() = declaredClauses >= 0 && declaredClauses != numberOfClauses
+
+    companion object {
+        /** Unpack the result of the native `load_dimacs` (see `dimacs_result_array` in `Dimacs.hpp`). */
+        internal fun of(info: LongArray): DimacsInfo {
+            return DimacsInfo(
+                numberOfVariables = info[0].toInt(),
+                numberOfClauses = info[1],
+                declaredClauses = info[2],
+                unsatisfiable = info[3] != 0L,
+            )
+        }
+    }
+}
@@ -1,12 +1,36 @@
 package com.github.lipen.satlib.jni
 
 import java.io.File
+import java.io.IOException
+import java.nio.ByteBuffer
 
 @Suppress("FunctionName", "MemberVisibilityCanBePrivate")
 class JCadical(
     val initialSeed: Int? = null, // internal default is 0
 ) : AutoCloseable {
-    private var handle: Long = 0
+    internal var handle: Long = 0
+        private set
+    private var clock = SolveClock()
+    private var progress: ProgressStream? = null
+    private val assumptionNatives = object : AssumptionSet.Natives {
+        override fun add(set: Long, literals: IntArray, size: Int) = cadical_assumptions_add(set, literals, size)
+        override fun remove(set: Long, literals: IntArray, size: Int) = cadical_assumptions_remove(set, literals, size)
+        override fun clear(set: Long) = cadical_assumptions_clear(set)
+        override fun size(set: Long) = cadical_assumptions_size(set)
+        override fun literals(set: Long) = cadical_assumptions_literals(set)
+        override fun delete(set: Long) = cadical_assumptions_delete(set)
+    }
+    private val maxSatNatives = object : MaxSatEngine.Natives {
+        override fun add(engine: Long, literals: IntArray, size: Int, weight: Long) =
+            cadical_maxsat_add(engine, literals, size, weight)
+        override fun size(engine: Long) = cadical_maxsat_size(engine)
+        override fun solve(engine: Long, algorithm: Int, stratify: Boolean, maxVariable: Int) =
+            clock.measure { cadical_maxsat_solve(handle, engine, algorithm, stratify, maxVariable) }
+        override fun nextVariable(engine: Long) = cadical_maxsat_next_var(engine)
+        override fun bounds(engine: Long, out: LongArray) = cadical_maxsat_bounds(engine, out)
+        override fun model(engine: Long) = cadical_maxsat_model(engine)
+        override fun delete(engine: Long) = cadical_maxsat_delete(engine)
+    }
 
     val numberOfVariables: Int get() = cadical_vars(handle)
     val numberOfConflicts: Long get() = cadical_conflicts(handle)
@@ -19,19 +43,89 @@ class JCadical(
     }
 
     fun reset() {
+        progress?.close()
         if (handle != 0L) cadical_delete(handle)
         handle = cadical_create()
         if (handle == 0L) throw OutOfMemoryError("cadical_create returned NULL")
         if (initialSeed != null) setOption("seed", initialSeed)
+        clock = SolveClock()
     }
 
     override fun close() {
+        progress?.close()
         if (handle != 0L) {
             cadical_delete(handle)
             handle = 0
         }
     }
 
+    /**
+     * Take a snapshot of the solver statistics in a single native call (see [SolverStats]).
+     *
+     * Note: the snapshot is only complete between the solves. During a solve (_e.g._, from another thread),
+     * only the conflicts are reported, counted by the learner of the solver (see [startProgress]),
+     * whether or not a progress stream is attached.
+     */
+    fun stats(): SolverStats {
+        val values = SolverStats.newArray()
+        cadical_stats(handle, clock.isSolving, values)
+        return SolverStats.fromArray(values, clock)
+    }
+
+    /**
+     * Start publishing the progress of the solves (see [ProgressStream]), closing the previous stream (if any).
+     *
+     * While the stream is open, the records are published by the solving thread itself, from the learner of CaDiCaL
+     * (called once per conflict), once at least [conflictsStep] conflicts have passed since the previous one.
+     * The ring buffer holds up to [capacity] records.
+     *
+     * Note: the statistics of CaDiCaL cannot be queried during the search, so the records published
+     * during the solve only report the conflicts, and a complete record is published after each solve.
+     */
+    @JvmOverloads
+    fun startProgress(conflictsStep: Long = 1000, capacity: Int = 1024): ProgressStream {
+        require(conflictsStep > 0) { "Bad conflicts step: $conflictsStep" }
+        require(capacity > 0) { "Bad capacity: $capacity" }
+        progress?.close()
+        val publisher = cadical_progress_start(handle, conflictsStep, capacity)
+        if (publisher == 0L) throw OutOfMemoryError("cadical_progress_start returned NULL")
+        return ProgressStream(publisher, capacity, ::cadical_progress_drain, ::cadical_progress_stop).also { progress = it }
+    }
+
+    /**
+     * Create a new (empty) persistent [AssumptionSet], which can be passed to [solve] of any [JCadical].
+     */
+    fun newAssumptionSet(): AssumptionSet {
+        val set = cadical_assumptions_new()
+        if (set == 0L) throw OutOfMemoryError("cadical_assumptions_new returned NULL")
+        return AssumptionSet(set, KIND, assumptionNatives)
+    }
+
+    /**
+     * Create a new (empty) native [MaxSatEngine], whose hard clauses are the clauses of this solver.
+     */
+    fun newMaxSat(): MaxSatEngine {
+        val engine = cadical_maxsat_new()
+        if (engine == 0L) throw OutOfMemoryError("cadical_maxsat_new returned NULL")
+        return MaxSatEngine(engine, maxSatNatives)
+    }
+
+    /**
+     * Create an independent deep copy of this solver, including its options, irredundant clauses, units, frozen variables and eliminated variables.
+     * Note: CaDiCaL does not copy learnt clauses and saved phases.
+     *
+     * The copy can be extended and solved separately (_e.g._, on another thread).
+     * Note: the solver must not be solving at the moment.
+     */
+    fun clone(): JCadical {
+        val copy = cadical_clone(handle)
+        if (copy == 0L) throw OutOfMemoryError("cadical_clone returned NULL")
+        return JCadical(initialSeed).also {
+            cadical_delete(it.handle)
+            it.handle = copy
+        }
+    }
+
     fun setOption(name: String, value: Int): Boolean {
         return cadical_set(handle, name, value)
     }
@@ -65,7 +159,7 @@ class JCadical(
     }
 
     fun simplify() {
-        cadical_simplify(handle)
+        clock.measure { cadical_simplify(handle) }
     }
 
     fun terminate() {
@@ -113,6 +207,61 @@ class JCadical(
         addClause(literals)
     }
 
+    /**
+     * Add zero-terminated clauses stored in the first [size] elements of [literals],
+     * _e.g._ `[1, 2, 0, -1, 3, 0]` adds two clauses.
+     *
+     * Note: the array is pinned while the clauses are being added,
+     * so prefer [ClauseBuffer] for really large batches.
+     */
+    @JvmOverloads
+    fun addClauses(literals: IntArray, size: Int = literals.size) {
+        require(size in 0..literals.size) { "Bad size: $size" }
+        require(size == 0 || literals[size - 1] == 0) { "The last clause is not zero-terminated" }
+        cadical_add_clauses(handle, literals, size)
+    }
+
+    /**
+     * Add zero-terminated clauses stored in the first [size] ints
+     * of the direct [buffer] (in native byte order).
+     */
+    fun addClauses(buffer: ByteBuffer, size: Int) {
+        require(buffer.isDirect) { "Buffer must be direct" }
+        require(size in 0..buffer.capacity() / Int.SIZE_BYTES) { "Bad size: $size" }
+        require(size == 0 || buffer.getInt((size - 1) * Int.SIZE_BYTES) == 0) { "The last clause is not zero-terminated" }
+        cadical_add_clauses_direct(handle, buffer, size)
+    }
+
+    /**
+     * Load all clauses from the native [cnf] in a single native call.
+     */
+    fun loadCnf(cnf: JCnf) {
+        cadical_load_cnf(handle, cnf.handle)
+    }
+
+    /**
+     * Load DIMACS CNF from the file at [path] directly into the solver, bypassing the JVM heap.
+     *
+     * The file is memory-mapped (when possible) and parsed natively,
+     * optionally using multiple [threads] for parsing.
+     *
+     * Throws [IOException] on I/O or syntax error (including the numbers that do not fit into `Int`).
+     * Note: the clauses preceding the syntax error remain in the solver
+     * (they cannot be taken back), so the solver should be [reset] or discarded after the failure.
+     */
+    @JvmOverloads
+    fun loadDimacs(path: String, threads: Int = 1): DimacsInfo {
+        require(threads >= 1) { "Number of threads must be positive" }
+        val info = cadical_load_dimacs(handle, path, threads)
+            ?: throw IOException("Could not load DIMACS from '$path'")
+        return DimacsInfo.of(info)
+    }
+
+    @JvmOverloads
+    fun loadDimacs(file: File, threads: Int = 1): DimacsInfo {
+        return loadDimacs(file.path, threads)
+    }
+
     fun addAssumptions(literals: IntArray) {
         cadical_add_assumptions(handle, literals)
     }
@@ -124,7 +273,7 @@ class JCadical(
 
     // TODO: Return enum SolveResult
     fun solve(): Boolean {
-        return when (val result = cadical_solve(handle)) {
+        return when (val result = clock.measure { cadical_solve(handle) }) {
             0 -> false // UNSOLVED
             10 -> true // SATISFIABLE
             20 -> false // UNSATISFIABLE
@@ -142,6 +291,62 @@ class JCadical(
         return solve(assumptions)
     }
 
+    /**
+     * Solve (under [assumptions]), distinguishing the unknown result:
+     * returns `null` if the search was stopped (_e.g._ via [terminate] or some limit) before the result was known.
+     */
+    @JvmOverloads
+    fun solveLimited(assumptions: IntArray? = null): Boolean? {
+        if (assumptions != null) addAssumptions(assumptions)
+        return when (val result = clock.measure { cadical_solve(handle) }) {
+            0 -> null // UNSOLVED
+            10 -> true // SATISFIABLE
+            20 -> false // UNSATISFIABLE
+            else -> error("cadical_solve returned $result")
+        }
+    }
+
+    /**
+     * Solve under the persistent [assumptions] (see [AssumptionSet]), passed to the solver by handle.
+     */
+    fun solve(assumptions: AssumptionSet): Boolean {
+        val set = assumptions.handleFor(KIND)
+        return when (val result = clock.measure { cadical_solve_assumptions(handle, set) }) {
+            0 -> false // UNSOLVED
+            10 -> true // SATISFIABLE
+            20 -> false // UNSATISFIABLE
+            else -> error("cadical_solve_assumptions returned $result")
+        }
+    }
+
+    /**
+     * Solve (under [assumptions]) and the resource [limits] (see [SolveLimits]),
+     * reporting which of them stopped the search.
+     *
+     * Note: the propagation limit is not supported.
+     */
+    @JvmOverloads
+    fun solveWithLimits(limits: SolveLimits, assumptions: IntArray? = null): LimitedSolveResult {
+        limits.checkNoPropagations("CaDiCaL")
+        if (assumptions != null) addAssumptions(assumptions)
+        val packed = clock.measure { cadical_solve_with_limits(handle, limits.toArray()) }
+        return LimitedSolveResult.decode(packed, "cadical_solve_with_limits")
+    }
+
+    /**
+     * Solve on a native worker thread, without blocking the caller.
+     * Cancelling the resulting future [terminate]s the solver.
+     *
+     * Note: the solver must not be used until the future is done.
+     */
+    @JvmOverloads
+    fun solveAsync(assumptions: IntArray? = null): SolveFuture {
+        val future = SolveFuture(onCancel = { terminate() }, onDone = { clock.stop() })
+        clock.start()
+        cadical_solve_async(handle, assumptions, future)
+        return future
+    }
+
     fun getValue(lit: Int): Boolean {
         return cadical_get_value(handle, lit)
     }
@@ -152,8 +357,98 @@ class JCadical(
             ?: throw OutOfMemoryError("cadical_get_model returned NULL")
     }
 
+    /**
+     * Query the model packed into a bitset, where the `(v-1)`-th bit holds the value of the variable `v`.
+     *
+     * The [bits] array is reused if it is large enough to hold [numberOfVariables] bits,
+     * otherwise a new array is allocated.
+     */
+    @JvmOverloads
+    fun getModelBits(bits: LongArray? = null): LongArray {
+        val words = (numberOfVariables + 63) / 64
+        val out = if (bits != null && bits.size >= words) bits else LongArray(words)
+        cadical_get_model_bits(handle, out)
+        return out
+    }
+
+    /**
+     * Query the values of multiple [literals] in a single native call.
+     *
+     * Note: resulting array is 0-based, i.e. `result[i]` is the value of `literals[i]`.
+     */
+    fun getValues(literals: IntArray): BooleanArray {
+        val values = ByteArray(literals.size)
+        cadical_get_values(handle, literals, values)
+        // Note: native method writes 0 for true and 1 for false
+        return BooleanArray(literals.size) { i -> values[i] == 0.toByte() }
+    }
+
+    /**
+     * Enumerate the models projected onto [projection] natively, blocking each found model with a new clause
+     * (so subsequent calls continue the enumeration).
+     *
+     * Models are written into [buffer] as consecutive bitsets of [modelWords] words each,
+     * where bit `i` is the value of `projection[i]`.
+     * When [minimize] is true, blocking clauses are shrunk by dropping the literals
+     * implied by the rest of the projected model (at the cost of extra solver calls).
+     *
+     * Returns the number of written models, which is less than the buffer capacity
+     * only if the enumeration is complete (or the solver was interrupted).
+     */
+    @JvmOverloads
+    fun enumerateModels(projection: IntArray, buffer: LongArray, minimize: Boolean = false): Int {
+        require(buffer.size >= modelWords(projection.size)) { "Buffer is too small: ${buffer.size}" }
+        return clock.measure { cadical_enumerate(handle, projection, minimize, buffer) }
+    }
+
+    /**
+     * Count (up to the [limit]) the models projected onto [projection], without transferring them.
+     *
+     * @see enumerateModels
+     */
+    @JvmOverloads
+    fun countModels(projection: IntArray, minimize: Boolean = false, limit: Long = Long.MAX_VALUE): Long {
+        return clock.measure { cadical_count_models(handle, projection, minimize, limit) }
+    }
+
+    /**
+     * Query the failed ones among the [assumptions] of the last (UNSAT) solve in a single native call,
+     * _i.e._ the subset of the assumptions sufficient for UNSAT (not necessarily minimal).
+     *
+     * Note: CaDiCaL does not keep the assumptions after the solve, so they have to be passed again.
+     */
+    fun getCore(assumptions: IntArray): IntArray {
+        return cadical_get_core(handle, assumptions)
+            ?: throw OutOfMemoryError("cadical_get_core returned NULL")
+    }
+
+    /**
+     * Query the failed ones among the [assumptions] of the last (UNSAT) solve in a single native call.
+     *
+     * @see getCore
+     */
+    fun getCore(assumptions: AssumptionSet): IntArray {
+        val set = assumptions.handleFor(KIND)
+        return cadical_get_core_assumptions(handle, set)
+            ?: throw OutOfMemoryError("cadical_get_core_assumptions returned NULL")
+    }
+
+    /**
+     * Compute natively a minimal (w.r.t. inclusion) subset of [assumptions] under which the formula is UNSAT,
+     * by repeatedly dropping one literal and solving under the rest (each UNSAT solve also shrinks the core
+     * to its failed assumptions), without returning to the JVM between the solves.
+     *
+     * Returns `null` when the formula is not UNSAT under [assumptions].
+     * Note: the literal is kept when its solve ends without result (_e.g._, interrupted),
+     * so the resulting core may be non-minimal then.
+     */
+    fun minimizeCore(assumptions: IntArray): IntArray? {
+        return clock.measure { cadical_minimize_core(handle, assumptions) }
+    }
+
     private external fun cadical_create(): Long
     private external fun cadical_delete(handle: Long)
+    private external fun cadical_clone(handle: Long): Long
     private external fun cadical_set(handle: Long, name: String, value: Int): Boolean
     private external fun cadical_set_long_option(handle: Long, arg: String): Boolean
     private external fun cadical_vars(handle: Long): Int
@@ -161,6 +456,25 @@ class JCadical(
     private external fun cadical_decisions(handle: Long): Long
     private external fun cadical_restarts(handle: Long): Long
     private external fun cadical_propagations(handle: Long): Long
+    private external fun cadical_stats(handle: Long, solving: Boolean, out: LongArray)
+    private external fun cadical_progress_start(handle: Long, conflictsStep: Long, capacity: Int): Long
+    private external fun cadical_progress_drain(publisher: Long, out: LongArray): Int
+    private external fun cadical_progress_stop(publisher: Long)
+    private external fun cadical_assumptions_new(): Long
+    private external fun cadical_assumptions_delete(set: Long)
+    private external fun cadical_assumptions_add(set: Long, literals: IntArray, size: Int): Int
+    private external fun cadical_assumptions_remove(set: Long, literals: IntArray, size: Int): Int
+    private external fun cadical_assumptions_clear(set: Long)
+    private external fun cadical_assumptions_size(set: Long): Int
+    private external fun cadical_assumptions_literals(set: Long): IntArray?
+    private external fun cadical_maxsat_new(): Long
+    private external fun cadical_maxsat_delete(engine: Long)
+    private external fun cadical_maxsat_add(engine: Long, literals: IntArray, size: Int, weight: Long)
+    private external fun cadical_maxsat_size(engine: Long): Int
+    private external fun cadical_maxsat_next_var(engine: Long): Int
+    private external fun cadical_maxsat_solve(handle: Long, engine: Long, algorithm: Int, stratify: Boolean, maxVar: Int): Int
+    private external fun cadical_maxsat_bounds(engine: Long, out: LongArray)
+    private external fun cadical_maxsat_model(engine: Long): BooleanArray?
     private external fun cadical_frozen(handle: Long, lit: Int): Boolean
     private external fun cadical_freeze(handle: Long, lit: Int)
     private external fun cadical_melt(handle: Long, lit: Int)
@@ -173,15 +487,31 @@ class JCadical(
     private external fun cadical_add(handle: Long, lit: Int)
     private external fun cadical_assume(handle: Long, lit: Int)
     private external fun cadical_add_clause(handle: Long, literals: IntArray)
+    private external fun cadical_add_clauses(handle: Long, literals: IntArray, size: Int)
+    private external fun cadical_add_clauses_direct(handle: Long, buffer: ByteBuffer, size: Int)
+    private external fun cadical_load_cnf(handle: Long, cnf: Long)
+    private external fun cadical_load_dimacs(handle: Long, path: String, threads: Int): LongArray?
     private external fun cadical_add_assumptions(handle: Long, literals: IntArray)
     private external fun cadical_solve(handle: Long): Int
+    private external fun cadical_solve_with_limits(handle: Long, limits: LongArray): Int
+    private external fun cadical_solve_async(handle: Long, assumptions: IntArray?, future: SolveFuture)
     private external fun cadical_get_value(handle: Long, lit: Int): Boolean
     private external fun cadical_get_model(handle: Long): BooleanArray?
+    private external fun cadical_get_model_bits(handle: Long, bits: LongArray)
+    private external fun cadical_get_values(handle: Long, literals: IntArray, values: ByteArray)
+    private external fun cadical_enumerate(handle: Long, projection: IntArray, minimize: Boolean, buffer: LongArray): Int
+    private external fun cadical_count_models(handle: Long, projection: IntArray, minimize: Boolean, limit: Long): Long
+    private external fun cadical_get_core(handle: Long, assumptions: IntArray): IntArray?
+    private external fun cadical_get_core_assumptions(handle: Long, set: Long): IntArray?
+    private external fun cadical_minimize_core(handle: Long, assumptions: IntArray): IntArray?
 
     companion object {
         init {
             Loader.load("jcadical")
         }
+
+        // Kind of the assumption sets, see [AssumptionSet.handleFor]
+        private const val KIND: String = "cadical"
     }
 }
 
@@ -0,0 +1,146 @@
+package com.github.lipen.satlib.jni
+
+/**
+ * Learnt clause sharing between several CaDiCaL [solvers] solving the same formula.
+ *
+ * Each learnt clause of size at most [maxSize] is exported (via CaDiCaL's `Learner`)
+ * into a lock-free ring buffer of the given [capacity], shared by all solvers,
+ * and imported by every other solver between `solve` calls (see [importClauses]).
+ * Clauses overwritten before some solver has imported them are counted as [dropped],
+ * and so are the clauses which could not be exported right away due to the contention,
+ * and the clauses beyond the [maxImports] of the solver.
+ *
+ * Note: CaDiCaL can only add irredundant clauses, so the imported clauses become a **permanent** part
+ * of the formula of the solver: they are never reduced, and they stay after the solver is [disconnect]ed
+ * or the bus is [close]d. Since they are implied by the shared formula, this is sound as long as the formulas
+ * of the connected solvers stay the same (or only grow); disconnect the solver before it diverges.
+ * The number of clauses imported into each solver is capped by [maxImports] for the same reason.
+ *
+ * [solve] runs all solvers in parallel (diversified, _e.g._, by [diversified] seeds and phases)
+ * in rounds of a limited number of conflicts, importing the shared clauses before each round.
+ * A round also ends early once enough shared clauses are pending (but not before 1000 conflicts),
+ * so the clauses are imported soon after they are learnt, whatever the round length.
+ *
+ * Note: all solvers must contain the same formula, and must not be closed or reset until the bus is [close]d.
+ */
+@Suppress("FunctionName", "MemberVisibilityCanBePrivate")
+class JCadicalShare @JvmOverloads constructor(
+    val solvers: List<JCadical>,
+    val maxSize: Int = 8,
+    val capacity: Int = 1 shl 16,
+    val maxImports: Long = 1L shl 20,
+) : AutoCloseable {
+    private var handle: Long = 0
+    private val stats = LongArray(3)
+
+    /** Index (in [solvers]) of the solver which gave the latest definitive answer, or `-1` if there is none. */
+    val winner: Int get() = share_winner(handle)
+
+    val exported: Long get() = stat(0)
+    val imported: Long get() = stat(1)
+    val dropped: Long get() = stat(2)
+
+    init {
+        require(solvers.isNotEmpty()) { "There must be at least one solver" }
+        require(maxSize in 1..MAX_SIZE) { "Bad max size: $maxSize" }
+        require(capacity > 0) { "Bad capacity: $capacity" }
+        require(maxImports >= 0) { "Bad max imports: $maxImports" }
+        handle = share_create(LongArray(solvers.size) { i -> solvers[i].handle }, capacity, maxSize, maxImports)
+        if (handle == 0L) throw OutOfMemoryError("share_create returned NULL")
+    }
+
+    override fun close() {
+        if (handle != 0L) {
+            share_delete(handle)
+            handle = 0
+        }
+    }
+
+    private fun stat(i: Int): Long {
+        share_stats(handle, stats)
+        return stats[i]
+    }
+
+    /**
+     * Import the clauses exported by other solvers into the solver with the given [index],
+     * which must not be solving at the moment.
+     *
+     * This is only needed when the solvers are driven manually, since [solve] imports clauses by itself.
+     *
+     * @return the number of imported clauses.
+     */
+    fun importClauses(index: Int): Int {
+        require(index in solvers.indices) { "Bad index: $index" }
+        return share_import(handle, index)
+    }
+
+    /**
+     * Disconnect the solver with the given [index] from the bus, which must not be solving at the moment:
+     * the solver stops exporting its learnt clauses, importing the clauses of others and taking part in [solve].
+     * The clauses it has already imported are kept.
+     */
+    fun disconnect(index: Int) {
+        require(index in solvers.indices) { "Bad index: $index" }
+        share_disconnect(handle, index)
+    }
+
+    /**
+     * Stop the running [solve] call, which then returns `null`.
+     *
+     * Just like in MiniSat, the interrupt persists until [clearInterrupt] is called.
+     */
+    fun interrupt() {
+        share_interrupt(handle)
+    }
+
+    fun clearInterrupt() {
+        share_clear_interrupt(handle)
+    }
+
+    /**
+     * Solve the formula (under [assumptions]) with all solvers in parallel,
+     * importing the shared clauses at least every [conflictsPerRound] conflicts
+     * (and earlier when enough of them are pending, see above).
+     * See `Bench_share` (in the `jmh` sources) for the effect of the round length.
+     *
+     * @return the first definitive answer, or `null` if interrupted (or no solver is connected).
+     *   The model can then be queried from `solvers[winner]`.
+     */
+    @JvmOverloads
+    fun solve(assumptions: IntArray? = null, conflictsPerRound: Int = 10_000): Boolean? {
+        require(conflictsPerRound > 0) { "Bad number of conflicts per round: $conflictsPerRound" }
+        return when (val result = share_solve(handle, assumptions, conflictsPerRound)) {
+            0 -> null // UNSOLVED
+            10 -> true // SATISFIABLE
+            20 -> false // UNSATISFIABLE
+            else -> error("share_solve returned $result")
+        }
+    }
+
+    private external fun share_create(handles: LongArray, capacity: Int, maxSize: Int, maxImports: Long): Long
+    private external fun share_delete(handle: Long)
+    private external fun share_winner(handle: Long): Int
+    private external fun share_stats(handle: Long, stats: LongArray)
+    private external fun share_import(handle: Long, index: Int): Int
+    private external fun share_disconnect(handle: Long, index: Int)
+    private external fun share_interrupt(handle: Long)
+    private external fun share_clear_interrupt(handle: Long)
+    private external fun share_solve(handle: Long, assumptions: IntArray?, conflicts: Int): Int
+
+    companion object {
+        /** Note: must be in sync with `SHARE_MAX_SIZE` in `JCadical.cpp`. */
+        const val MAX_SIZE: Int = 32
+
+        /**
+         * Create [size] solvers diversified by their random seeds and initial phases.
+         */
+        @JvmStatic
+        fun diversified(size: Int): List<JCadical> = List(size) { i ->
+            JCadical(initialSeed = i).apply { setOption("phase", 1 - i % 2) }
+        }
+
+        init {
+            Loader.load("jcadical")
+        }
+    }
+}
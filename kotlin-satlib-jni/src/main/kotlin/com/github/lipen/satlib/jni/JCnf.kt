@@ -0,0 +1,151 @@
+package com.github.lipen.satlib.jni
+
+import java.nio.ByteBuffer
+
+/**
+ * Native CNF container: zero-terminated clauses stored in a contiguous off-heap arena.
+ *
+ * The formula is filled once (preferably, in bulk via [addClauses])
+ * and can be loaded into any number of [JMiniSat], [JGlucose], [JCadical], [JCryptoMiniSat] or [JKissat] instances
+ * using their `loadCnf` method, each in a single native call.
+ */
+@Suppress("FunctionName", "MemberVisibilityCanBePrivate")
+class JCnf : AutoCloseable {
+    internal var handle: Long = 0
+        private set
+
+    /** Number of ints (literals and terminating zeros) in the arena. */
+    val size: Int get() = cnf_size(handle)
+    val numberOfClauses: Int get() = cnf_num_clauses(handle)
+    val maxVariable: Int get() = cnf_max_var(handle)
+
+    /**
+     * Order-independent hash of the clauses in the arena, maintained natively as they are added
+     * (the same as the sum of `FormulaHash.clause` over the clauses).
+     */
+    val hash: Long get() = cnf_hash(handle)
+
+    init {
+        handle = cnf_create()
+        if (handle == 0L) throw OutOfMemoryError("cnf_create returned NULL")
+    }
+
+    override fun close() {
+        if (handle != 0L) {
+            cnf_delete(handle)
+            handle = 0
+        }
+    }
+
+    fun clear() {
+        cnf_clear(handle)
+    }
+
+    fun addClause(literals: IntArray) {
+        addClauses(literals.copyOf(literals.size + 1))
+    }
+
+    @JvmName("addClauseVararg")
+    fun addClause(vararg literals: Int) {
+        addClause(literals)
+    }
+
+    /**
+     * Add multiple zero-terminated clauses from `literals[0 until size]` at once.
+     *
+     * Note: the last clause must be terminated, otherwise it is merged with the next added clause.
+     */
+    @JvmOverloads
+    fun addClauses(literals: IntArray, size: Int = literals.size) {
+        require(size in 0..literals.size) { "Bad size: $size" }
+        cnf_add_clauses(handle, literals, size)
+    }
+
+    /**
+     * Add multiple zero-terminated clauses from the direct [buffer] (in native byte order) at once.
+     *
+     * @see ClauseBuffer
+     */
+    fun addClauses(buffer: ByteBuffer, size: Int) {
+        require(buffer.isDirect) { "Buffer must be direct" }
+        require(size in 0..buffer.capacity() / Int.SIZE_BYTES) { "Bad size: $size" }
+        cnf_add_clauses_direct(handle, buffer, size)
+    }
+
+    /**
+     * Append the totalizer over [literals] and return its outputs,
+     * where `outputs[i]` is true iff at least `i+1` literals are true.
+     *
+     * Only the first [bound] outputs are encoded (the last one meaning "at least [bound]").
+     * New variables are allocated sequentially starting from [firstVariable],
+     * so that afterwards [maxVariable] is the last allocated variable.
+     */
+    @JvmOverloads
+    fun addTotalizer(literals: IntArray, firstVariable: Int, bound: Int = literals.size): IntArray {
+        require(bound >= 1) { "Bad bound: $bound" }
+        return cnf_add_totalizer(handle, literals, bound, firstVariable)
+            ?: throw OutOfMemoryError("cnf_add_totalizer returned NULL")
+    }
+
+    /**
+     * Append the sequential counter over [literals] and return its outputs.
+     *
+     * @see addTotalizer
+     */
+    @JvmOverloads
+    fun addSequentialCounter(literals: IntArray, firstVariable: Int, bound: Int = literals.size): IntArray {
+        require(bound >= 1) { "Bad bound: $bound" }
+        return cnf_add_sequential_counter(handle, literals, bound, firstVariable)
+            ?: throw OutOfMemoryError("cnf_add_sequential_counter returned NULL")
+    }
+
+    /**
+     * Append the odd-even merge sorting network over [literals] and return its outputs
+     * (the literals sorted in descending order, i.e. all true ones first).
+     *
+     * @see addTotalizer
+     */
+    fun addSortingNetwork(literals: IntArray, firstVariable: Int): IntArray {
+        return cnf_add_sorting_network(handle, literals, firstVariable)
+            ?: throw OutOfMemoryError("cnf_add_sorting_network returned NULL")
+    }
+
+    /**
+     * Append the totalizer over [literals] (see [addTotalizer]), keeping its tree in native memory,
+     * so that its [bound][JTotalizer.bound] can later be [extended][JTotalizer.extend] without re-encoding.
+     */
+    fun addIncrementalTotalizer(literals: IntArray, firstVariable: Int, bound: Int): JTotalizer {
+        require(bound >= 1) { "Bad bound: $bound" }
+        val totalizer = cnf_add_incremental_totalizer(handle, literals, bound, firstVariable)
+        if (totalizer == 0L) throw OutOfMemoryError("cnf_add_incremental_totalizer returned NULL")
+        return JTotalizer(totalizer)
+    }
+
+    /** Copy the whole arena (zero-terminated clauses) into a new array. */
+    fun getLiterals(): IntArray {
+        val literals = IntArray(size)
+        cnf_get_literals(handle, literals)
+        return literals
+    }
+
+    private external fun cnf_create(): Long
+    private external fun cnf_delete(handle: Long)
+    private external fun cnf_clear(handle: Long)
+    private external fun cnf_size(handle: Long): Int
+    private external fun cnf_max_var(handle: Long): Int
+    private external fun cnf_num_clauses(handle: Long): Int
+    private external fun cnf_hash(handle: Long): Long
+    private external fun cnf_add_clauses(handle: Long, literals: IntArray, size: Int)
+    private external fun cnf_add_clauses_direct(handle: Long, buffer: ByteBuffer, size: Int)
+    private external fun cnf_get_literals(handle: Long, literals: IntArray)
+    private external fun cnf_add_totalizer(handle: Long, literals: IntArray, bound: Int, firstVar: Int): IntArray?
+    private external fun cnf_add_sequential_counter(handle: Long, literals: IntArray, bound: Int, firstVar: Int): IntArray?
+    private external fun cnf_add_sorting_network(handle: Long, literals: IntArray, firstVar: Int): IntArray?
+    private external fun cnf_add_incremental_totalizer(handle: Long, literals: IntArray, bound: Int, firstVar: Int): Long
+
+    companion object {
+        init {
+            Loader.load("jcnf")
+        }
+    }
+}
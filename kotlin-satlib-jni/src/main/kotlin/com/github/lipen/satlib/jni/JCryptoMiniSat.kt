@@ -1,13 +1,26 @@
 package com.github.lipen.satlib.jni
 
 import java.io.File
+import java.io.IOException
+import java.nio.ByteBuffer
 import kotlin.math.absoluteValue
 
 @Suppress("FunctionName", "MemberVisibilityCanBePrivate", "unused")
 class JCryptoMiniSat(
     val numberOfThreads: Int = 1,
 ) : AutoCloseable {
-    private var handle: Long = 0
+    internal var handle: Long = 0
+        private set
+    private var clock = SolveClock()
+    private var progress: ProgressStream? = null
+    private val assumptionNatives = object : AssumptionSet.Natives {
+        override fun add(set: Long, literals: IntArray, size: Int) = cms_assumptions_add(set, literals, size)
+        override fun remove(set: Long, literals: IntArray, size: Int) = cms_assumptions_remove(set, literals, size)
+        override fun clear(set: Long) = cms_assumptions_clear(set)
+        override fun size(set: Long) = cms_assumptions_size(set)
+        override fun literals(set: Long) = cms_assumptions_literals(set)
+        override fun delete(set: Long) = cms_assumptions_delete(set)
+    }
 
     val numberOfVariables: Int get() = cms_nvars(handle)
 
@@ -16,19 +29,63 @@ class JCryptoMiniSat(
     }
 
     fun reset() {
+        progress?.close()
         if (handle != 0L) cms_delete(handle)
         handle = cms_create()
         if (handle == 0L) throw OutOfMemoryError("cms_create returned NULL")
         setThreadNumber(numberOfThreads)
+        clock = SolveClock()
     }
 
     override fun close() {
+        progress?.close()
         if (handle != 0L) {
             cms_delete(handle)
             handle = 0
         }
     }
 
+    /**
+     * Take a snapshot of the solver statistics in a single native call (see [SolverStats]).
+     *
+     * Note: the snapshot is only complete between the solves. During a solve (_e.g._, from another thread),
+     * only the counters are reported, read from the running solver without synchronization (so they are approximate),
+     * whether or not a progress stream is attached.
+     */
+    fun stats(): SolverStats {
+        val values = SolverStats.newArray()
+        cms_stats(handle, clock.isSolving, values)
+        return SolverStats.fromArray(values, clock)
+    }
+
+    /**
+     * Start publishing the progress of the solves (see [ProgressStream]), closing the previous stream (if any).
+     *
+     * While the stream is open, its sampler thread reads the counters of the running solver every millisecond
+     * (without touching the search), and publishes a record once at least [conflictsStep] conflicts
+     * have passed since the previous one. The ring buffer holds up to [capacity] records.
+     *
+     * Note: CryptoMiniSat only reports the sums of conflicts, decisions and propagations over all its threads.
+     */
+    @JvmOverloads
+    fun startProgress(conflictsStep: Long = 1000, capacity: Int = 1024): ProgressStream {
+        require(conflictsStep > 0) { "Bad conflicts step: $conflictsStep" }
+        require(capacity > 0) { "Bad capacity: $capacity" }
+        progress?.close()
+        val publisher = cms_progress_start(handle, conflictsStep, capacity)
+        if (publisher == 0L) throw OutOfMemoryError("cms_progress_start returned NULL")
+        return ProgressStream(publisher, capacity, ::cms_progress_drain, ::cms_progress_stop).also { progress = it }
+    }
+
+    /**
+     * Create a new (empty) persistent [AssumptionSet], which can be passed to [solve] of any [JCryptoMiniSat].
+     */
+    fun newAssumptionSet(): AssumptionSet {
+        val set = cms_assumptions_new()
+        if (set == 0L) throw OutOfMemoryError("cms_assumptions_new returned NULL")
+        return AssumptionSet(set, KIND, assumptionNatives)
+    }
+
     fun newVariable() {
         cms_new_var(handle)
     }
@@ -68,6 +125,63 @@ class JCryptoMiniSat(
         addClause(literals)
     }
 
+    /**
+     * Add zero-terminated clauses stored in the first [size] elements of [literals],
+     * _e.g._ `[1, 2, 0, -1, 3, 0]` adds two clauses.
+     *
+     * Note: the array is pinned while the clauses are being added,
+     * so prefer [ClauseBuffer] for really large batches.
+     */
+    @JvmOverloads
+    fun addClauses(literals: IntArray, size: Int = literals.size) {
+        require(size in 0..literals.size) { "Bad size: $size" }
+        require(size == 0 || literals[size - 1] == 0) { "The last clause is not zero-terminated" }
+        cms_add_clauses(handle, literals, size)
+    }
+
+    /**
+     * Add zero-terminated clauses stored in the first [size] ints
+     * of the direct [buffer] (in native byte order).
+     */
+    fun addClauses(buffer: ByteBuffer, size: Int) {
+        require(buffer.isDirect) { "Buffer must be direct" }
+        require(size in 0..buffer.capacity() / Int.SIZE_BYTES) { "Bad size: $size" }
+        require(size == 0 || buffer.getInt((size - 1) * Int.SIZE_BYTES) == 0) { "The last clause is not zero-terminated" }
+        cms_add_clauses_direct(handle, buffer, size)
+    }
+
+    /**
+     * Load all clauses from the native [cnf] in a single native call.
+     *
+     * Missing variables (up to [JCnf.maxVariable]) are created automatically.
+     */
+    fun loadCnf(cnf: JCnf) {
+        cms_load_cnf(handle, cnf.handle)
+    }
+
+    /**
+     * Load DIMACS CNF from the file at [path] directly into the solver, bypassing the JVM heap.
+     *
+     * The file is memory-mapped (when possible) and parsed natively,
+     * optionally using multiple [threads] for parsing.
+     *
+     * Throws [IOException] on I/O or syntax error (including the numbers that do not fit into `Int`).
+     * Note: the clauses preceding the syntax error remain in the solver
+     * (they cannot be taken back), so the solver should be [reset] or discarded after the failure.
+     */
+    @JvmOverloads
+    fun loadDimacs(path: String, threads: Int = 1): DimacsInfo {
+        require(threads >= 1) { "Number of threads must be positive" }
+        val info = cms_load_dimacs(handle, path, threads)
+            ?: throw IOException("Could not load DIMACS from '$path'")
+        return DimacsInfo.of(info)
+    }
+
+    @JvmOverloads
+    fun loadDimacs(file: File, threads: Int = 1): DimacsInfo {
+        return loadDimacs(file.path, threads)
+    }
+
     private fun convertSolveResult(value: Int): Boolean {
         return when (value) {
             0 -> false // UNSOLVED
@@ -78,11 +192,11 @@ class JCryptoMiniSat(
     }
 
     fun solve(): Boolean {
-        return convertSolveResult(cms_solve(handle))
+        return convertSolveResult(clock.measure { cms_solve(handle) })
     }
 
     fun solve(literals: IntArray): Boolean {
-        return convertSolveResult(cms_solve(handle, literals))
+        return convertSolveResult(clock.measure { cms_solve(handle, literals) })
     }
 
     @JvmName("solveVararg")
@@ -90,6 +204,51 @@ class JCryptoMiniSat(
         return solve(literals)
     }
 
+    /**
+     * Solve (under [assumptions]), distinguishing the unknown result:
+     * returns `null` if the search was stopped (_e.g._ via [interrupt] or some limit) before the result was known.
+     */
+    @JvmOverloads
+    fun solveLimited(assumptions: IntArray? = null): Boolean? {
+        val value = clock.measure { if (assumptions == null) cms_solve(handle) else cms_solve(handle, assumptions) }
+        return if (value == 0) null else convertSolveResult(value)
+    }
+
+    /**
+     * Solve under the persistent [assumptions] (see [AssumptionSet]), passed to the solver by handle.
+     */
+    fun solve(assumptions: AssumptionSet): Boolean {
+        val set = assumptions.handleFor(KIND)
+        return convertSolveResult(clock.measure { cms_solve_assumptions(handle, set) })
+    }
+
+    /**
+     * Solve (under [assumptions]) and the resource [limits] (see [SolveLimits]),
+     * reporting which of them stopped the search.
+     *
+     * Note: the propagation limit is not supported.
+     */
+    @JvmOverloads
+    fun solveWithLimits(limits: SolveLimits, assumptions: IntArray? = null): LimitedSolveResult {
+        limits.checkNoPropagations("CryptoMiniSat")
+        val packed = clock.measure { cms_solve_with_limits(handle, assumptions, limits.toArray()) }
+        return LimitedSolveResult.decode(packed, "cms_solve_with_limits")
+    }
+
+    /**
+     * Solve on a native worker thread, without blocking the caller.
+     * Cancelling the resulting future [interrupt]s the solver.
+     *
+     * Note: the solver must not be used until the future is done.
+     */
+    @JvmOverloads
+    fun solveAsync(assumptions: IntArray? = null): SolveFuture {
+        val future = SolveFuture(onCancel = { interrupt() }, onDone = { clock.stop() })
+        clock.start()
+        cms_solve_async(handle, assumptions, future)
+        return future
+    }
+
     fun getValue(lit: Int): Boolean {
         require(lit != 0) { "Literal must be non-zero" }
         return when (val value = cms_get_value(handle, lit.absoluteValue)) {
@@ -106,6 +265,20 @@ class JCryptoMiniSat(
             ?: throw OutOfMemoryError("cms_get_model returned NULL")
     }
 
+    /**
+     * Query the model packed into a bitset, where the `(v-1)`-th bit holds the value of the variable `v`.
+     *
+     * The [bits] array is reused if it is large enough to hold [numberOfVariables] bits,
+     * otherwise a new array is allocated.
+     */
+    @JvmOverloads
+    fun getModelBits(bits: LongArray? = null): LongArray {
+        val words = (numberOfVariables + 63) / 64
+        val out = if (bits != null && bits.size >= words) bits else LongArray(words)
+        cms_get_model_bits(handle, out)
+        return out
+    }
+
     fun setThreadNumber(n: Int) {
         cms_set_num_threads(handle, n)
     }
@@ -130,6 +303,74 @@ class JCryptoMiniSat(
         cms_no_simplify_at_startup(handle)
     }
 
+    /**
+     * Query the values of multiple [literals] in a single native call.
+     *
+     * Note: resulting array is 0-based, i.e. `result[i]` is the value of `literals[i]`.
+     */
+    fun getValues(literals: IntArray): BooleanArray {
+        val values = ByteArray(literals.size)
+        cms_get_values(handle, literals, values)
+        return BooleanArray(literals.size) { i ->
+            when (val value = values[i]) {
+                LBOOL_TRUE -> true
+                LBOOL_FALSE -> false
+                LBOOL_UNDEF -> error("cms_get_values returned l_Undef for literal ${literals[i]}")
+                else -> error("cms_get_values returned $value")
+            }
+        }
+    }
+
+    /**
+     * Enumerate the models projected onto [projection] natively, blocking each found model with a new clause
+     * (so subsequent calls continue the enumeration).
+     *
+     * Models are written into [buffer] as consecutive bitsets of [modelWords] words each,
+     * where bit `i` is the value of `projection[i]`.
+     * When [minimize] is true, blocking clauses are shrunk by dropping the literals
+     * implied by the rest of the projected model (at the cost of extra solver calls).
+     *
+     * Returns the number of written models, which is less than the buffer capacity
+     * only if the enumeration is complete (or the solver was interrupted).
+     */
+    @JvmOverloads
+    fun enumerateModels(projection: IntArray, buffer: LongArray, minimize: Boolean = false): Int {
+        require(buffer.size >= modelWords(projection.size)) { "Buffer is too small: ${buffer.size}" }
+        return clock.measure { cms_enumerate(handle, projection, minimize, buffer) }
+    }
+
+    /**
+     * Count (up to the [limit]) the models projected onto [projection], without transferring them.
+     *
+     * @see enumerateModels
+     */
+    @JvmOverloads
+    fun countModels(projection: IntArray, minimize: Boolean = false, limit: Long = Long.MAX_VALUE): Long {
+        return clock.measure { cms_count_models(handle, projection, minimize, limit) }
+    }
+
+    /**
+     * Query the failed assumptions of the last (UNSAT) solve in a single native call,
+     * _i.e._ the subset of the assumptions sufficient for UNSAT (not necessarily minimal).
+     */
+    fun getCore(): IntArray {
+        return cms_get_core(handle)
+            ?: throw OutOfMemoryError("cms_get_core returned NULL")
+    }
+
+    /**
+     * Compute natively a minimal (w.r.t. inclusion) subset of [assumptions] under which the formula is UNSAT,
+     * by repeatedly dropping one literal and solving under the rest (each UNSAT solve also shrinks the core
+     * to its failed assumptions), without returning to the JVM between the solves.
+     *
+     * Returns `null` when the formula is not UNSAT under [assumptions].
+     * Note: the literal is kept when its solve ends without result (_e.g._, interrupted),
+     * so the resulting core may be non-minimal then.
+     */
+    fun minimizeCore(assumptions: IntArray): IntArray? {
+        return clock.measure { cms_minimize_core(handle, assumptions) }
+    }
+
     private external fun cms_create(): Long
     private external fun cms_delete(handle: Long)
     private external fun cms_interrupt(handle: Long)
@@ -137,12 +378,35 @@ class JCryptoMiniSat(
     private external fun cms_new_var(handle: Long)
     private external fun cms_nvars(handle: Long): Int
     private external fun cms_add_clause(handle: Long, literals: IntArray)
+    private external fun cms_add_clauses(handle: Long, literals: IntArray, size: Int)
+    private external fun cms_add_clauses_direct(handle: Long, buffer: ByteBuffer, size: Int)
+    private external fun cms_load_cnf(handle: Long, cnf: Long)
+    private external fun cms_load_dimacs(handle: Long, path: String, threads: Int): LongArray?
+    private external fun cms_stats(handle: Long, solving: Boolean, out: LongArray)
+    private external fun cms_progress_start(handle: Long, conflictsStep: Long, capacity: Int): Long
+    private external fun cms_progress_drain(publisher: Long, out: LongArray): Int
+    private external fun cms_progress_stop(publisher: Long)
+    private external fun cms_assumptions_new(): Long
+    private external fun cms_assumptions_delete(set: Long)
+    private external fun cms_assumptions_add(set: Long, literals: IntArray, size: Int): Int
+    private external fun cms_assumptions_remove(set: Long, literals: IntArray, size: Int): Int
+    private external fun cms_assumptions_clear(set: Long)
+    private external fun cms_assumptions_size(set: Long): Int
+    private external fun cms_assumptions_literals(set: Long): IntArray?
     private external fun cms_solve(handle: Long): Int
     private external fun cms_solve(handle: Long, literals: IntArray): Int
+    private external fun cms_solve_with_limits(handle: Long, assumptions: IntArray?, limits: LongArray): Int
+    private external fun cms_solve_async(handle: Long, assumptions: IntArray?, future: SolveFuture)
     private external fun cms_simplify(handle: Long): Int
     private external fun cms_simplify(handle: Long, literals: IntArray): Int
     private external fun cms_get_value(handle: Long, lit: Int): Byte
     private external fun cms_get_model(handle: Long): BooleanArray?
+    private external fun cms_get_model_bits(handle: Long, bits: LongArray)
+    private external fun cms_get_values(handle: Long, literals: IntArray, values: ByteArray)
+    private external fun cms_enumerate(handle: Long, projection: IntArray, minimize: Boolean, buffer: LongArray): Int
+    private external fun cms_count_models(handle: Long, projection: IntArray, minimize: Boolean, limit: Long): Long
+    private external fun cms_get_core(handle: Long): IntArray?
+    private external fun cms_minimize_core(handle: Long, assumptions: IntArray): IntArray?
     private external fun cms_set_num_threads(handle: Long, n: Int)
     private external fun cms_set_max_time(handle: Long, time: Double)
     private external fun cms_set_timeout_all_calls(handle: Long, time: Double)
@@ -155,6 +419,9 @@ class JCryptoMiniSat(
             Loader.load("jcms")
         }
 
+        // Kind of the assumption sets, see [AssumptionSet.handleFor]
+        private const val KIND: String = "cms"
+
         private const val LBOOL_TRUE: Byte = 0
         private const val LBOOL_FALSE: Byte = 1
         private const val LBOOL_UNDEF: Byte = 2
@@ -1,6 +1,9 @@
 package com.github.lipen.satlib.jni
 
 import java.io.File
+import java.io.IOException
+import java.nio.ByteBuffer
+import kotlin.math.abs
 
 @Suppress("FunctionName", "MemberVisibilityCanBePrivate")
 class JGlucose(
@@ -9,8 +12,30 @@ class JGlucose(
     val initialRandomPolarities: Boolean = false,
     val initialRandomInitialActivities: Boolean = false,
 ) : AutoCloseable {
-    private var handle: Long = 0
+    internal var handle: Long = 0
+        private set
     private var solvable: Boolean = false
+    private var clock = SolveClock()
+    private var progress: ProgressStream? = null
+    private val assumptionNatives = object : AssumptionSet.Natives {
+        override fun add(set: Long, literals: IntArray, size: Int) = glucose_assumptions_add(set, literals, size)
+        override fun remove(set: Long, literals: IntArray, size: Int) = glucose_assumptions_remove(set, literals, size)
+        override fun clear(set: Long) = glucose_assumptions_clear(set)
+        override fun size(set: Long) = glucose_assumptions_size(set)
+        override fun literals(set: Long) = glucose_assumptions_literals(set)
+        override fun delete(set: Long) = glucose_assumptions_delete(set)
+    }
+    private val maxSatNatives = object : MaxSatEngine.Natives {
+        override fun add(engine: Long, literals: IntArray, size: Int, weight: Long) =
+            glucose_maxsat_add(engine, literals, size, weight)
+        override fun size(engine: Long) = glucose_maxsat_size(engine)
+        override fun solve(engine: Long, algorithm: Int, stratify: Boolean, maxVariable: Int) =
+            clock.measure { glucose_maxsat_solve(handle, engine, algorithm, stratify, maxVariable) }
+        override fun nextVariable(engine: Long) = glucose_maxsat_next_var(engine)
+        override fun bounds(engine: Long, out: LongArray) = glucose_maxsat_bounds(engine, out)
+        override fun model(engine: Long) = glucose_maxsat_model(engine)
+        override fun delete(engine: Long) = glucose_maxsat_delete(engine)
+    }
 
     val numberOfVariables: Int get() = glucose_nvars(handle)
     val numberOfClauses: Int get() = glucose_nclauses(handle)
@@ -24,21 +49,92 @@ class JGlucose(
     }
 
     fun reset() {
+        progress?.close()
         if (handle != 0L) glucose_dtor(handle)
         handle = glucose_ctor()
         if (handle == 0L) throw OutOfMemoryError("glucose_ctor returned NULL")
+        applyInitialOptions()
+        solvable = true
+        clock = SolveClock()
+    }
+
+    private fun applyInitialOptions() {
         if (initialSeed != null) setRandomSeed(initialSeed)
         if (initialRandomVarFreq != null) setRandomVarFreq(initialRandomVarFreq)
         if (initialRandomPolarities) setRandomPolarities(true)
         if (initialRandomInitialActivities) setRandomInitialActivities(true)
-        solvable = true
     }
 
     override fun close() {
+        progress?.close()
         if (handle != 0L) glucose_dtor(handle)
         handle = 0
     }
 
+    /**
+     * Take a snapshot of the solver statistics in a single native call (see [SolverStats]).
+     *
+     * Note: the snapshot is only complete between the solves. During a solve (_e.g._, from another thread),
+     * only the counters are reported, read from the running solver without synchronization (so they are approximate),
+     * whether or not a progress stream is attached.
+     */
+    fun stats(): SolverStats {
+        val values = SolverStats.newArray()
+        glucose_stats(handle, clock.isSolving, values)
+        return SolverStats.fromArray(values, clock)
+    }
+
+    /**
+     * Start publishing the progress of the solves (see [ProgressStream]), closing the previous stream (if any).
+     *
+     * While the stream is open, its sampler thread reads the counters of the running solver every millisecond
+     * (without touching the search), and publishes a record once at least [conflictsStep] conflicts
+     * have passed since the previous one. The ring buffer holds up to [capacity] records.
+     */
+    @JvmOverloads
+    fun startProgress(conflictsStep: Long = 1000, capacity: Int = 1024): ProgressStream {
+        require(conflictsStep > 0) { "Bad conflicts step: $conflictsStep" }
+        require(capacity > 0) { "Bad capacity: $capacity" }
+        progress?.close()
+        val publisher = glucose_progress_start(handle, conflictsStep, capacity)
+        if (publisher == 0L) throw OutOfMemoryError("glucose_progress_start returned NULL")
+        return ProgressStream(publisher, capacity, ::glucose_progress_drain, ::glucose_progress_stop).also { progress = it }
+    }
+
+    /**
+     * Create a new (empty) persistent [AssumptionSet], which can be passed to [solve] of any [JGlucose].
+     */
+    fun newAssumptionSet(): AssumptionSet {
+        val set = glucose_assumptions_new()
+        if (set == 0L) throw OutOfMemoryError("glucose_assumptions_new returned NULL")
+        return AssumptionSet(set, KIND, assumptionNatives)
+    }
+
+    /**
+     * Create a new (empty) native [MaxSatEngine], whose hard clauses are the clauses of this solver.
+     */
+    fun newMaxSat(): MaxSatEngine {
+        val engine = glucose_maxsat_new()
+        if (engine == 0L) throw OutOfMemoryError("glucose_maxsat_new returned NULL")
+        return MaxSatEngine(engine, maxSatNatives)
+    }
+
+    /**
+     * Create an independent deep copy of this solver, including its original and learnt clauses, polarities, frozen and eliminated variables.
+     *
+     * The copy can be extended and solved separately (_e.g._, on another thread).
+     * Note: the solver must not be solving at the moment.
+     */
+    fun clone(): JGlucose {
+        val copy = glucose_clone(handle)
+        if (copy == 0L) throw OutOfMemoryError("glucose_clone returned NULL")
+        return JGlucose(initialSeed, initialRandomVarFreq, initialRandomPolarities, initialRandomInitialActivities).also {
+            glucose_dtor(it.handle)
+            it.handle = copy
+            it.solvable = solvable
+        }
+    }
+
     fun isIncremental(): Boolean {
         return glucose_is_incremental(handle)
     }
@@ -168,15 +264,133 @@ class JGlucose(
         return solvable
     }
 
+    /**
+     * Add zero-terminated clauses stored in the first [size] elements of [literals],
+     * _e.g._ `[1, 2, 0, -1, 3, 0]` adds two clauses.
+     *
+     * Note: the array is pinned while the clauses are being added,
+     * so prefer [ClauseBuffer] for really large batches.
+     */
+    @JvmOverloads
+    fun addClauses(literals: IntArray, size: Int = literals.size): Boolean {
+        require(size in 0..literals.size) { "Bad size: $size" }
+        require(size == 0 || literals[size - 1] == 0) { "The last clause is not zero-terminated" }
+        solvable = glucose_add_clauses(handle, literals, size)
+        return solvable
+    }
+
+    /**
+     * Add zero-terminated clauses stored in the first [size] ints
+     * of the direct [buffer] (in native byte order).
+     */
+    fun addClauses(buffer: ByteBuffer, size: Int): Boolean {
+        require(buffer.isDirect) { "Buffer must be direct" }
+        require(size in 0..buffer.capacity() / Int.SIZE_BYTES) { "Bad size: $size" }
+        require(size == 0 || buffer.getInt((size - 1) * Int.SIZE_BYTES) == 0) { "The last clause is not zero-terminated" }
+        solvable = glucose_add_clauses_direct(handle, buffer, size)
+        return solvable
+    }
+
+    /**
+     * Load all clauses from the native [cnf] in a single native call.
+     *
+     * Missing variables (up to [JCnf.maxVariable]) are created automatically.
+     */
+    fun loadCnf(cnf: JCnf): Boolean {
+        solvable = glucose_load_cnf(handle, cnf.handle)
+        return solvable
+    }
+
+    /**
+     * Load DIMACS CNF from the file at [path] directly into the solver, bypassing the JVM heap.
+     *
+     * The file is memory-mapped (when possible) and parsed natively,
+     * optionally using multiple [threads] for parsing.
+     *
+     * Throws [IOException] on I/O or syntax error (including the numbers that do not fit into `Int`).
+     * Note: the clauses preceding the syntax error remain in the solver
+     * (they cannot be taken back), so the solver should be [reset] or discarded after the failure.
+     */
+    @JvmOverloads
+    fun loadDimacs(path: String, threads: Int = 1): DimacsInfo {
+        require(threads >= 1) { "Number of threads must be positive" }
+        val info = glucose_load_dimacs(handle, path, threads)
+            ?: throw IOException("Could not load DIMACS from '$path'")
+        solvable = glucose_okay(handle)
+        return DimacsInfo.of(info)
+    }
+
+    @JvmOverloads
+    fun loadDimacs(file: File, threads: Int = 1): DimacsInfo {
+        return loadDimacs(file.path, threads)
+    }
+
+    /**
+     * Save the current formula (typically simplified by [eliminate]) into the preprocessed artifact at [path],
+     * along with its frozen and eliminated variables and the reconstruction stack (see [PreprocessCache]).
+     * The [key] (at most 32 bytes) identifies the input, and is checked by [loadPreprocessed].
+     *
+     * Note: learnt clauses are not saved.
+     */
+    fun savePreprocessed(path: String, key: ByteArray) {
+        if (!glucose_save_preprocessed(handle, path, key)) {
+            throw IOException("Could not save preprocessed formula to '$path'")
+        }
+    }
+
+    /**
+     * Replace the solver with the one restored from the preprocessed artifact at [path] (see [savePreprocessed]),
+     * whose models are extended back to the eliminated variables.
+     *
+     * Returns `false` (keeping the solver intact) if the artifact is missing, malformed,
+     * or made for another input (with another [key]).
+     *
+     * Note: the formula is already simplified, so solving it with `do_simp = false` avoids redoing the elimination.
+     */
+    fun loadPreprocessed(path: String, key: ByteArray): Boolean {
+        val loaded = glucose_load_preprocessed(path, key)
+        if (loaded == 0L) return false
+        progress?.close()
+        glucose_dtor(handle)
+        handle = loaded
+        applyInitialOptions()
+        solvable = glucose_okay(handle)
+        clock = SolveClock()
+        return true
+    }
+
+    /**
+     * Load the DIMACS [cnf] preprocessed by [eliminate] (with the [frozen] variables protected from elimination),
+     * reusing the artifact from the [cache] when it exists, otherwise preprocessing the formula and storing it there.
+     * Returns `true` if the artifact was reused.
+     *
+     * Note: the solver is [reset] beforehand.
+     */
+    @JvmOverloads
+    fun loadDimacsPreprocessed(cnf: File, cache: PreprocessCache, frozen: IntArray = IntArray(0), threads: Int = 1): Boolean {
+        val key = cache.key(cnf, frozen)
+        val artifact = cache.artifact(key, KIND)
+        if (artifact.exists() && loadPreprocessed(artifact.path, key)) return true
+        reset()
+        loadDimacs(cnf, threads)
+        for (lit in frozen) {
+            require(abs(lit) <= numberOfVariables) { "Bad frozen literal: $lit" }
+            setFrozen(lit, true)
+        }
+        eliminate()
+        cache.store(artifact) { path -> glucose_save_preprocessed(handle, path, key) }
+        return false
+    }
+
     @JvmOverloads
     fun solve(do_simp: Boolean = true, turn_off_simp: Boolean = false): Boolean {
-        solvable = glucose_solve(handle, do_simp, turn_off_simp)
+        solvable = clock.measure { glucose_solve(handle, do_simp, turn_off_simp) }
         return solvable
     }
 
     @JvmOverloads
     fun solve(assumptions: IntArray, do_simp: Boolean = true, turn_off_simp: Boolean = false): Boolean {
-        solvable = glucose_solve(handle, assumptions, do_simp, turn_off_simp)
+        solvable = clock.measure { glucose_solve(handle, assumptions, do_simp, turn_off_simp) }
         return solvable
     }
 
@@ -186,14 +400,64 @@ class JGlucose(
         return solve(assumptions, do_simp, turn_off_simp)
     }
 
+    /**
+     * Solve under the persistent [assumptions] (see [AssumptionSet]), passed to the solver by handle.
+     */
+    @JvmOverloads
+    fun solve(assumptions: AssumptionSet, do_simp: Boolean = true, turn_off_simp: Boolean = false): Boolean {
+        val set = assumptions.handleFor(KIND)
+        solvable = clock.measure { glucose_solve_assumptions(handle, set, do_simp, turn_off_simp) }
+        return solvable
+    }
+
     @JvmOverloads
     fun solveLimited(assumptions: IntArray, do_simp: Boolean = true, turn_off_simp: Boolean = false): Boolean? {
-        return when (val value = glucose_solve_limited(handle, assumptions, do_simp, turn_off_simp)) {
+        val result = when (val value = clock.measure { glucose_solve_limited(handle, assumptions, do_simp, turn_off_simp) }) {
             LBOOL_TRUE -> true
             LBOOL_FALSE -> false
             LBOOL_UNDEF -> null
             else -> error("glucose_solve_limited returned $value")
         }
+        solvable = result == true
+        return result
+    }
+
+    /**
+     * Solve under the resource [limits] (see [SolveLimits]), reporting which of them stopped the search.
+     *
+     * Note: the budgets set before (via [setConfBudget] and [setPropBudget]) are turned off.
+     */
+    @JvmOverloads
+    fun solveWithLimits(
+        limits: SolveLimits,
+        assumptions: IntArray = IntArray(0),
+        do_simp: Boolean = true,
+        turn_off_simp: Boolean = false,
+    ): LimitedSolveResult {
+        val packed = clock.measure {
+            glucose_solve_with_limits(handle, assumptions, do_simp, turn_off_simp, limits.toArray())
+        }
+        val result = LimitedSolveResult.decode(packed, "glucose_solve_with_limits")
+        solvable = result.value == true
+        return result
+    }
+
+    /**
+     * Solve on a native worker thread, without blocking the caller.
+     * Cancelling the resulting future [interrupt]s the solver.
+     *
+     * Note: the solver must not be used until the future is done.
+     */
+    @JvmOverloads
+    fun solveAsync(
+        assumptions: IntArray? = null,
+        do_simp: Boolean = true,
+        turn_off_simp: Boolean = false,
+    ): SolveFuture {
+        val future = SolveFuture(onCancel = { interrupt() }, onResult = { solvable = it }, onDone = { clock.stop() })
+        clock.start()
+        glucose_solve_async(handle, assumptions, do_simp, turn_off_simp, future)
+        return future
     }
 
     fun getValue(lit: Int): Boolean {
@@ -213,8 +477,97 @@ class JGlucose(
             ?: throw OutOfMemoryError("glucose_get_model returned NULL")
     }
 
+    /**
+     * Query the model packed into a bitset, where the `(v-1)`-th bit holds the value of the variable `v`.
+     *
+     * The [bits] array is reused if it is large enough to hold [numberOfVariables] bits,
+     * otherwise a new array is allocated.
+     */
+    @JvmOverloads
+    fun getModelBits(bits: LongArray? = null): LongArray {
+        assert(solvable)
+        val words = (numberOfVariables + 63) / 64
+        val out = if (bits != null && bits.size >= words) bits else LongArray(words)
+        glucose_get_model_bits(handle, out)
+        return out
+    }
+
+    /**
+     * Query the values of multiple [literals] in a single native call.
+     *
+     * Note: resulting array is 0-based, i.e. `result[i]` is the value of `literals[i]`.
+     */
+    fun getValues(literals: IntArray): BooleanArray {
+        assert(solvable)
+        val values = ByteArray(literals.size)
+        glucose_get_values(handle, literals, values)
+        return BooleanArray(literals.size) { i ->
+            when (val value = values[i]) {
+                LBOOL_TRUE -> true
+                LBOOL_FALSE -> false
+                LBOOL_UNDEF -> error("glucose_get_values returned l_Undef for literal ${literals[i]}")
+                else -> error("glucose_get_values returned $value")
+            }
+        }
+    }
+
+    /**
+     * Enumerate the models projected onto [projection] natively, blocking each found model with a new clause
+     * (so subsequent calls continue the enumeration).
+     *
+     * Models are written into [buffer] as consecutive bitsets of [modelWords] words each,
+     * where bit `i` is the value of `projection[i]`.
+     * When [minimize] is true, blocking clauses are shrunk by dropping the literals
+     * implied by the rest of the projected model (at the cost of extra solver calls).
+     *
+     * Returns the number of written models, which is less than the buffer capacity
+     * only if the enumeration is complete (or the solver was interrupted).
+     *
+     * The projected variables are frozen, so that later simplifications keep them.
+     *
+     * @throws IllegalArgumentException if some projected variable has already been eliminated.
+     */
+    @JvmOverloads
+    fun enumerateModels(projection: IntArray, buffer: LongArray, minimize: Boolean = false): Int {
+        require(buffer.size >= modelWords(projection.size)) { "Buffer is too small: ${buffer.size}" }
+        return clock.measure { glucose_enumerate(handle, projection, minimize, buffer) }
+    }
+
+    /**
+     * Count (up to the [limit]) the models projected onto [projection], without transferring them.
+     *
+     * @see enumerateModels
+     */
+    @JvmOverloads
+    fun countModels(projection: IntArray, minimize: Boolean = false, limit: Long = Long.MAX_VALUE): Long {
+        return clock.measure { glucose_count_models(handle, projection, minimize, limit) }
+    }
+
+    /**
+     * Query the failed assumptions of the last (UNSAT) solve in a single native call,
+     * _i.e._ the subset of the assumptions sufficient for UNSAT (not necessarily minimal).
+     */
+    fun getCore(): IntArray {
+        return glucose_get_core(handle)
+            ?: throw OutOfMemoryError("glucose_get_core returned NULL")
+    }
+
+    /**
+     * Compute natively a minimal (w.r.t. inclusion) subset of [assumptions] under which the formula is UNSAT,
+     * by repeatedly dropping one literal and solving under the rest (each UNSAT solve also shrinks the core
+     * to its failed assumptions), without returning to the JVM between the solves.
+     *
+     * Returns `null` when the formula is not UNSAT under [assumptions].
+     * Note: the literal is kept when its solve ends without result (_e.g._, interrupted),
+     * so the resulting core may be non-minimal then.
+     */
+    fun minimizeCore(assumptions: IntArray): IntArray? {
+        return clock.measure { glucose_minimize_core(handle, assumptions) }
+    }
+
     private external fun glucose_ctor(): Long
     private external fun glucose_dtor(handle: Long)
+    private external fun glucose_clone(handle: Long): Long
     private external fun glucose_okay(handle: Long): Boolean
     private external fun glucose_is_incremental(handle: Long): Boolean
     private external fun glucose_set_incremental(handle: Long)
@@ -224,6 +577,25 @@ class JGlucose(
     private external fun glucose_decisions(handle: Long): Long
     private external fun glucose_propagations(handle: Long): Long
     private external fun glucose_conflicts(handle: Long): Long
+    private external fun glucose_stats(handle: Long, solving: Boolean, out: LongArray)
+    private external fun glucose_progress_start(handle: Long, conflictsStep: Long, capacity: Int): Long
+    private external fun glucose_progress_drain(publisher: Long, out: LongArray): Int
+    private external fun glucose_progress_stop(publisher: Long)
+    private external fun glucose_assumptions_new(): Long
+    private external fun glucose_assumptions_delete(set: Long)
+    private external fun glucose_assumptions_add(set: Long, literals: IntArray, size: Int): Int
+    private external fun glucose_assumptions_remove(set: Long, literals: IntArray, size: Int): Int
+    private external fun glucose_assumptions_clear(set: Long)
+    private external fun glucose_assumptions_size(set: Long): Int
+    private external fun glucose_assumptions_literals(set: Long): IntArray?
+    private external fun glucose_maxsat_new(): Long
+    private external fun glucose_maxsat_delete(engine: Long)
+    private external fun glucose_maxsat_add(engine: Long, literals: IntArray, size: Int, weight: Long)
+    private external fun glucose_maxsat_size(engine: Long): Int
+    private external fun glucose_maxsat_next_var(engine: Long): Int
+    private external fun glucose_maxsat_solve(handle: Long, engine: Long, algorithm: Int, stratify: Boolean, maxVar: Int): Int
+    private external fun glucose_maxsat_bounds(engine: Long, out: LongArray)
+    private external fun glucose_maxsat_model(engine: Long): BooleanArray?
     private external fun glucose_new_var(handle: Long, polarity: Boolean, decision: Boolean): Int
     private external fun glucose_set_polarity(handle: Long, lit: Int, polarity: Boolean)
     private external fun glucose_set_decision(handle: Long, lit: Int, decision: Boolean)
@@ -246,6 +618,12 @@ class JGlucose(
     private external fun glucose_add_clause(handle: Long, lit1: Int, lit2: Int): Boolean
     private external fun glucose_add_clause(handle: Long, lit1: Int, lit2: Int, lit3: Int): Boolean
     private external fun glucose_add_clause(handle: Long, literals: IntArray): Boolean
+    private external fun glucose_add_clauses(handle: Long, literals: IntArray, size: Int): Boolean
+    private external fun glucose_add_clauses_direct(handle: Long, buffer: ByteBuffer, size: Int): Boolean
+    private external fun glucose_load_cnf(handle: Long, cnf: Long): Boolean
+    private external fun glucose_load_dimacs(handle: Long, path: String, threads: Int): LongArray?
+    private external fun glucose_save_preprocessed(handle: Long, path: String, key: ByteArray): Boolean
+    private external fun glucose_load_preprocessed(path: String, key: ByteArray): Long
 
     private external fun glucose_solve(
         handle: Long,
@@ -267,14 +645,39 @@ class JGlucose(
         turn_off_simp: Boolean,
     ): Byte
 
+    private external fun glucose_solve_with_limits(
+        handle: Long,
+        assumptions: IntArray,
+        do_simp: Boolean,
+        turn_off_simp: Boolean,
+        limits: LongArray,
+    ): Int
+
+    private external fun glucose_solve_async(
+        handle: Long,
+        assumptions: IntArray?,
+        do_simp: Boolean,
+        turn_off_simp: Boolean,
+        future: SolveFuture,
+    )
+
     private external fun glucose_get_value(handle: Long, lit: Int): Byte
     private external fun glucose_get_model(handle: Long): BooleanArray?
+    private external fun glucose_get_model_bits(handle: Long, bits: LongArray)
+    private external fun glucose_get_values(handle: Long, literals: IntArray, values: ByteArray)
+    private external fun glucose_enumerate(handle: Long, projection: IntArray, minimize: Boolean, buffer: LongArray): Int
+    private external fun glucose_count_models(handle: Long, projection: IntArray, minimize: Boolean, limit: Long): Long
+    private external fun glucose_get_core(handle: Long): IntArray?
+    private external fun glucose_minimize_core(handle: Long, assumptions: IntArray): IntArray?
 
     companion object {
         init {
             Loader.load("jglucose")
         }
 
+        // Kind of the assumption sets, see [AssumptionSet.handleFor]
+        private const val KIND: String = "glucose"
+
         private const val LBOOL_TRUE: Byte = 0
         private const val LBOOL_FALSE: Byte = 1
         private const val LBOOL_UNDEF: Byte = 2
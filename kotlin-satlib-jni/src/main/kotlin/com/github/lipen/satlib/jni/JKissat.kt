@@ -0,0 +1,330 @@
+package com.github.lipen.satlib.jni
+
+import java.io.File
+import java.io.IOException
+import java.nio.ByteBuffer
+
+/**
+ * Kissat solver.
+ *
+ * Note: Kissat is not incremental: all clauses must be added before the single [solve] call,
+ * after which the solver must be [reset]. Violations are reported with [IllegalStateException]
+ * (the native library would abort the whole process instead).
+ *
+ * The search can be stopped from another thread via [interrupt] or by a [timeout][setTimeout],
+ * both checked by the native termination callback.
+ */
+@Suppress("FunctionName", "MemberVisibilityCanBePrivate")
+class JKissat(
+    val initialSeed: Int? = null, // internal default is 0
+) : AutoCloseable {
+    internal var handle: Long = 0
+        private set
+    private var clock = SolveClock()
+
+    /** Whether [solve] was already called since the last [reset]. */
+    var isSolved: Boolean = false
+        private set
+
+    /** Note: the largest variable mentioned in clauses (or reserved), since Kissat does not report it. */
+    val numberOfVariables: Int get() = kissat_nvars(handle)
+
+    init {
+        reset()
+    }
+
+    fun reset() {
+        if (handle != 0L) kissat_delete(handle)
+        handle = kissat_create()
+        if (handle == 0L) throw OutOfMemoryError("kissat_create returned NULL")
+        isSolved = false
+        if (initialSeed != null) setOption("seed", initialSeed)
+        clock = SolveClock()
+    }
+
+    override fun close() {
+        if (handle != 0L) {
+            kissat_delete(handle)
+            handle = 0
+        }
+    }
+
+    private fun checkNotSolved() {
+        check(!isSolved) { "Kissat is not incremental, reset the solver first" }
+    }
+
+    fun getOption(name: String): Int {
+        return kissat_get_option(handle, name)
+    }
+
+    /** Returns the previous value of the option. */
+    fun setOption(name: String, value: Int): Int {
+        return kissat_set_option(handle, name, value)
+    }
+
+    /** Set the configuration (_e.g._, `"sat"`, `"unsat"` or `"plain"`), returning false if it is unknown. */
+    fun setConfiguration(name: String): Boolean {
+        return kissat_set_configuration(handle, name)
+    }
+
+    /** Reserve the memory for variables `1..maxVariable` upfront, avoiding reallocations while adding clauses. */
+    fun reserve(maxVariable: Int) {
+        require(maxVariable >= 0) { "Bad max variable: $maxVariable" }
+        checkNotSolved()
+        kissat_reserve(handle, maxVariable)
+    }
+
+    fun setConflictLimit(limit: Int) {
+        require(limit >= 0) { "Bad limit: $limit" }
+        kissat_set_conflict_limit(handle, limit)
+    }
+
+    fun setDecisionLimit(limit: Int) {
+        require(limit >= 0) { "Bad limit: $limit" }
+        kissat_set_decision_limit(handle, limit)
+    }
+
+    /**
+     * Stop the [solve] call after [millis] milliseconds from now.
+     * Non-positive [millis] removes the timeout.
+     */
+    fun setTimeout(millis: Long) {
+        kissat_set_timeout(handle, millis)
+    }
+
+    /**
+     * Stop the running (or the upcoming) [solve] call, which then returns `null`.
+     *
+     * Note: this is safe to call from another thread.
+     */
+    fun interrupt() {
+        kissat_interrupt(handle)
+    }
+
+    fun printStatistics() {
+        kissat_print_statistics(handle)
+    }
+
+    /**
+     * Take a snapshot of the solver statistics in a single native call (see [SolverStats]).
+     *
+     * Note: Kissat does not expose its counters, so only the variables, memory and solves are reported.
+     */
+    fun stats(): SolverStats {
+        val values = SolverStats.newArray()
+        kissat_stats(handle, values)
+        return SolverStats.fromArray(values, clock)
+    }
+
+    fun add(lit: Int) {
+        checkNotSolved()
+        kissat_add(handle, lit)
+    }
+
+    fun addClause() {
+        add(0)
+    }
+
+    fun addClause(lit1: Int) {
+        add(lit1); add(0)
+    }
+
+    fun addClause(lit1: Int, lit2: Int) {
+        add(lit1); add(lit2); add(0)
+    }
+
+    fun addClause(lit1: Int, lit2: Int, lit3: Int) {
+        add(lit1); add(lit2); add(lit3); add(0)
+    }
+
+    fun addClause(literals: IntArray) {
+        checkNotSolved()
+        kissat_add_clause(handle, literals)
+    }
+
+    @JvmName("addClauseVararg")
+    fun addClause(vararg literals: Int) {
+        addClause(literals)
+    }
+
+    /**
+     * Add zero-terminated clauses stored in the first [size] elements of [literals],
+     * _e.g._ `[1, 2, 0, -1, 3, 0]` adds two clauses.
+     *
+     * Note: the array is pinned while the clauses are being added,
+     * so prefer [ClauseBuffer] for really large batches.
+     */
+    @JvmOverloads
+    fun addClauses(literals: IntArray, size: Int = literals.size) {
+        require(size in 0..literals.size) { "Bad size: $size" }
+        require(size == 0 || literals[size - 1] == 0) { "The last clause is not zero-terminated" }
+        checkNotSolved()
+        kissat_add_clauses(handle, literals, size)
+    }
+
+    /**
+     * Add zero-terminated clauses stored in the first [size] ints
+     * of the direct [buffer] (in native byte order).
+     */
+    fun addClauses(buffer: ByteBuffer, size: Int) {
+        require(buffer.isDirect) { "Buffer must be direct" }
+        require(size in 0..buffer.capacity() / Int.SIZE_BYTES) { "Bad size: $size" }
+        require(size == 0 || buffer.getInt((size - 1) * Int.SIZE_BYTES) == 0) { "The last clause is not zero-terminated" }
+        checkNotSolved()
+        kissat_add_clauses_direct(handle, buffer, size)
+    }
+
+    /**
+     * Load all clauses from the native [cnf] in a single native call.
+     */
+    fun loadCnf(cnf: JCnf) {
+        checkNotSolved()
+        kissat_load_cnf(handle, cnf.handle)
+    }
+
+    /**
+     * Load DIMACS CNF from the file at [path] directly into the solver, bypassing the JVM heap.
+     *
+     * The file is memory-mapped (when possible) and parsed natively,
+     * optionally using multiple [threads] for parsing.
+     *
+     * Throws [IOException] on I/O or syntax error (including the numbers that do not fit into `Int`).
+     * Note: the clauses preceding the syntax error remain in the solver
+     * (they cannot be taken back), so the solver should be [reset] or discarded after the failure.
+     */
+    @JvmOverloads
+    fun loadDimacs(path: String, threads: Int = 1): DimacsInfo {
+        require(threads >= 1) { "Number of threads must be positive" }
+        checkNotSolved()
+        val info = kissat_load_dimacs(handle, path, threads)
+            ?: throw IOException("Could not load DIMACS from '$path'")
+        return DimacsInfo.of(info)
+    }
+
+    @JvmOverloads
+    fun loadDimacs(file: File, threads: Int = 1): DimacsInfo {
+        return loadDimacs(file.path, threads)
+    }
+
+    /**
+     * Solve the formula.
+     *
+     * @return `true` (SAT), `false` (UNSAT), or `null` if the search was stopped by a limit, timeout or interrupt.
+     */
+    fun solve(): Boolean? {
+        checkNotSolved()
+        isSolved = true
+        return when (val result = clock.measure { kissat_solve(handle) }) {
+            0 -> null // UNSOLVED
+            10 -> true // SATISFIABLE
+            20 -> false // UNSATISFIABLE
+            else -> error("kissat_solve returned $result")
+        }
+    }
+
+    /**
+     * Solve under the resource [limits] (see [SolveLimits]), reporting which of them stopped the search.
+     *
+     * Note: the propagation limit is not supported, and the conflict limit replaces the one set via [setConflictLimit].
+     */
+    fun solveWithLimits(limits: SolveLimits): LimitedSolveResult {
+        limits.checkNoPropagations("Kissat")
+        checkNotSolved()
+        isSolved = true
+        val packed = clock.measure { kissat_solve_with_limits(handle, limits.toArray()) }
+        return LimitedSolveResult.decode(packed, "kissat_solve_with_limits")
+    }
+
+    /**
+     * Solve on a native worker thread, without blocking the caller.
+     * Cancelling the resulting future [interrupt]s the solver.
+     *
+     * Note: the solver must not be used until the future is done.
+     */
+    fun solveAsync(): SolveFuture {
+        checkNotSolved()
+        isSolved = true
+        val future = SolveFuture(onCancel = { interrupt() }, onDone = { clock.stop() })
+        clock.start()
+        kissat_solve_async(handle, future)
+        return future
+    }
+
+    /** Note: variables not mentioned in any clause are false in the model. */
+    fun getValue(lit: Int): Boolean {
+        return when (val value = kissat_get_value(handle, lit)) {
+            1 -> true
+            -1 -> false
+            else -> error("kissat_get_value(lit = $lit) returned $value, probably there is no model")
+        }
+    }
+
+    /**
+     * Query the model packed into a bitset, where the `(v-1)`-th bit holds the value of the variable `v`.
+     *
+     * The [bits] array is reused if it is large enough to hold [numberOfVariables] bits,
+     * otherwise a new array is allocated.
+     */
+    @JvmOverloads
+    fun getModelBits(bits: LongArray? = null): LongArray {
+        val words = (numberOfVariables + 63) / 64
+        val out = if (bits != null && bits.size >= words) bits else LongArray(words)
+        kissat_get_model_bits(handle, out)
+        return out
+    }
+
+    /**
+     * Query the values of multiple [literals] in a single native call.
+     *
+     * Note: resulting array is 0-based, i.e. `result[i]` is the value of `literals[i]`.
+     */
+    fun getValues(literals: IntArray): BooleanArray {
+        val values = ByteArray(literals.size)
+        kissat_get_values(handle, literals, values)
+        // Note: native method writes 0 for true and 1 for false
+        return BooleanArray(literals.size) { i -> values[i] == 0.toByte() }
+    }
+
+    private external fun kissat_create(): Long
+    private external fun kissat_delete(handle: Long)
+    private external fun kissat_nvars(handle: Long): Int
+    private external fun kissat_get_option(handle: Long, name: String): Int
+    private external fun kissat_set_option(handle: Long, name: String, value: Int): Int
+    private external fun kissat_set_configuration(handle: Long, name: String): Boolean
+    private external fun kissat_reserve(handle: Long, maxVar: Int)
+    private external fun kissat_set_conflict_limit(handle: Long, limit: Int)
+    private external fun kissat_set_decision_limit(handle: Long, limit: Int)
+    private external fun kissat_set_timeout(handle: Long, millis: Long)
+    private external fun kissat_interrupt(handle: Long)
+    private external fun kissat_print_statistics(handle: Long)
+    private external fun kissat_stats(handle: Long, out: LongArray)
+    private external fun kissat_add(handle: Long, lit: Int)
+    private external fun kissat_add_clause(handle: Long, literals: IntArray)
+    private external fun kissat_add_clauses(handle: Long, literals: IntArray, size: Int)
+    private external fun kissat_add_clauses_direct(handle: Long, buffer: ByteBuffer, size: Int)
+    private external fun kissat_load_cnf(handle: Long, cnf: Long)
+    private external fun kissat_load_dimacs(handle: Long, path: String, threads: Int): LongArray?
+    private external fun kissat_solve(handle: Long): Int
+    private external fun kissat_solve_with_limits(handle: Long, limits: LongArray): Int
+    private external fun kissat_solve_async(handle: Long, future: SolveFuture)
+    private external fun kissat_get_value(handle: Long, lit: Int): Int
+    private external fun kissat_get_model_bits(handle: Long, bits: LongArray)
+    private external fun kissat_get_values(handle: Long, literals: IntArray, values: ByteArray)
+
+    companion object {
+        @JvmStatic
+        val signature: String by lazy { kissat_signature() }
+
+        @JvmStatic
+        private external fun kissat_signature(): String
+
+        init {
+            Loader.load("jkissat")
+        }
+    }
+}
+
+private fun main() {
+    val solver = JKissat()
+    println("solver = $solver (${JKissat.signature})")
+}
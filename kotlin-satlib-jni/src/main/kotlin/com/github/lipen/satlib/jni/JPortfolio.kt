@@ -0,0 +1,302 @@
+package com.github.lipen.satlib.jni
+
+import java.io.File
+import java.io.IOException
+import java.nio.ByteBuffer
+
+/**
+ * Portfolio of heterogeneous [backends] solving the same formula concurrently on native threads.
+ *
+ * Each clause is passed to the native side once and added to all backends there.
+ * On [solve], all backends are launched in parallel, the first definitive answer wins,
+ * and the remaining backends are stopped (via `interrupt`, `terminate` or `interrupt_asap`).
+ * The model is then queried from the [winner].
+ *
+ * Alternatively, [solveCubes] runs the backends as a work-stealing pool of cube-and-conquer workers.
+ */
+@Suppress("FunctionName", "MemberVisibilityCanBePrivate")
+class JPortfolio(
+    val backends: List<Backend>,
+) : AutoCloseable {
+    private var handle: Long = 0
+
+    /** Underlying solver instances, in the same order as [backends]. */
+    var solvers: List<AutoCloseable> = emptyList()
+        private set
+
+    val numberOfVariables: Int get() = portfolio_nvars(handle)
+
+    /** Index (in [backends]) of the backend which gave the latest definitive answer, or `-1` if there is none. */
+    val winner: Int get() = portfolio_winner(handle)
+
+    constructor(vararg backends: Backend) : this(backends.asList())
+
+    /** Pool of [size] identical backends, e.g., for cube-and-conquer. */
+    constructor(backend: Backend, size: Int) : this(List(size) { backend })
+
+    init {
+        require(backends.isNotEmpty()) { "Portfolio must contain at least one backend" }
+        reset()
+    }
+
+    fun reset() {
+        close()
+        solvers = backends.map { it.create() }
+        val kinds = ByteArray(backends.size) { i -> backends[i].kind }
+        val handles = LongArray(solvers.size) { i -> handleOf(solvers[i]) }
+        handle = portfolio_create(kinds, handles)
+        if (handle == 0L) throw OutOfMemoryError("portfolio_create returned NULL")
+    }
+
+    override fun close() {
+        if (handle != 0L) {
+            portfolio_delete(handle)
+            handle = 0
+        }
+        for (solver in solvers) {
+            solver.close()
+        }
+        solvers = emptyList()
+    }
+
+    /**
+     * Stop the running [solve] call, which then returns `null`.
+     *
+     * Just like in MiniSat, the interrupt persists until [clearInterrupt] is called.
+     */
+    fun interrupt() {
+        portfolio_interrupt(handle)
+    }
+
+    fun clearInterrupt() {
+        portfolio_clear_interrupt(handle)
+    }
+
+    fun newVariable(): Int {
+        return portfolio_new_var(handle)
+    }
+
+    fun addClause(literals: IntArray): Boolean {
+        return portfolio_add_clause(handle, literals)
+    }
+
+    @JvmName("addClauseVararg")
+    fun addClause(vararg literals: Int): Boolean {
+        return addClause(literals)
+    }
+
+    /**
+     * Add multiple zero-terminated clauses from `literals[0 until size]` at once.
+     *
+     * @return `false` if some backend detected a conflict on the top level.
+     */
+    @JvmOverloads
+    fun addClauses(literals: IntArray, size: Int = literals.size): Boolean {
+        require(size in 0..literals.size) { "Bad size: $size" }
+        require(size == 0 || literals[size - 1] == 0) { "The last clause is not zero-terminated" }
+        return portfolio_add_clauses(handle, literals, size)
+    }
+
+    /**
+     * Add multiple zero-terminated clauses from the direct [buffer] (in native byte order) at once.
+     *
+     * @see ClauseBuffer
+     */
+    fun addClauses(buffer: ByteBuffer, size: Int): Boolean {
+        require(buffer.isDirect) { "Buffer must be direct" }
+        require(size in 0..buffer.capacity() / Int.SIZE_BYTES) { "Bad size: $size" }
+        require(size == 0 || buffer.getInt((size - 1) * Int.SIZE_BYTES) == 0) { "The last clause is not zero-terminated" }
+        return portfolio_add_clauses_direct(handle, buffer, size)
+    }
+
+    /**
+     * Load all clauses from the native [cnf] into every backend in a single native call.
+     */
+    fun loadCnf(cnf: JCnf): Boolean {
+        return portfolio_load_cnf(handle, cnf.handle)
+    }
+
+    /**
+     * Load DIMACS CNF from the file at [path] directly into the solver, bypassing the JVM heap.
+     *
+     * The file is memory-mapped (when possible) and parsed natively,
+     * optionally using multiple [threads] for parsing.
+     *
+     * Throws [IOException] on I/O or syntax error (including the numbers that do not fit into `Int`).
+     * Note: the clauses preceding the syntax error remain in the solver
+     * (they cannot be taken back), so the solver should be [reset] or discarded after the failure.
+     */
+    @JvmOverloads
+    fun loadDimacs(path: String, threads: Int = 1): DimacsInfo {
+        require(threads >= 1) { "Number of threads must be positive" }
+        val info = portfolio_load_dimacs(handle, path, threads)
+            ?: throw IOException("Could not load DIMACS from '$path'")
+        return DimacsInfo.of(info)
+    }
+
+    @JvmOverloads
+    fun loadDimacs(file: File, threads: Int = 1): DimacsInfo {
+        return loadDimacs(file.path, threads)
+    }
+
+    /**
+     * Solve the formula (under [assumptions]) with all backends concurrently.
+     *
+     * @return the first definitive answer, or `null` if the portfolio was [interrupt]ed.
+     */
+    @JvmOverloads
+    fun solve(assumptions: IntArray? = null): Boolean? {
+        return when (val value = portfolio_solve(handle, assumptions)) {
+            LBOOL_TRUE -> true
+            LBOOL_FALSE -> false
+            LBOOL_UNDEF -> null
+            else -> error("portfolio_solve returned $value")
+        }
+    }
+
+    @JvmName("solveVararg")
+    fun solve(vararg assumptions: Int): Boolean? {
+        return solve(assumptions)
+    }
+
+    /**
+     * Select up to [depth] splitting variables for [solveCubes], ignoring the variables of [assumptions].
+     *
+     * Variables are ranked by the product of the (Jeroslow-Wang) scores of their literals,
+     * which is a cheap static approximation of the look-ahead "product" heuristic.
+     */
+    @JvmOverloads
+    fun selectCubeVariables(depth: Int, assumptions: IntArray? = null): IntArray {
+        require(depth in 0..MAX_CUBE_DEPTH) { "Bad depth: $depth" }
+        return portfolio_select_cube_vars(handle, depth, assumptions)
+            ?: throw OutOfMemoryError("portfolio_select_cube_vars returned NULL")
+    }
+
+    /**
+     * Solve the formula (under [assumptions]) in the cube-and-conquer mode.
+     *
+     * The search space is split into `2^k` cubes over the `k` given [variables].
+     * All backends act as workers, each solving its block of cubes incrementally under assumptions,
+     * and stealing half of the remaining cubes of another worker when its own block is exhausted.
+     * The first SAT cube stops all the workers and becomes the [winner].
+     *
+     * @return `true` if some cube is SAT, `false` if all cubes are UNSAT,
+     *   or `null` if the portfolio was [interrupt]ed.
+     */
+    @JvmOverloads
+    fun solveCubes(variables: IntArray, assumptions: IntArray? = null): Boolean? {
+        require(variables.size <= MAX_CUBE_DEPTH) { "Too many cube variables: ${variables.size}" }
+        require(variables.all { it > 0 }) { "Cube variables must be positive" }
+        return when (val value = portfolio_solve_cubes(handle, variables, assumptions)) {
+            LBOOL_TRUE -> true
+            LBOOL_FALSE -> false
+            LBOOL_UNDEF -> null
+            else -> error("portfolio_solve_cubes returned $value")
+        }
+    }
+
+    /**
+     * Solve the formula in the cube-and-conquer mode, splitting on [depth] variables chosen by [selectCubeVariables].
+     */
+    @JvmOverloads
+    fun solveCubes(depth: Int, assumptions: IntArray? = null): Boolean? {
+        return solveCubes(selectCubeVariables(depth, assumptions), assumptions)
+    }
+
+    fun getValue(lit: Int): Boolean {
+        return when (val value = portfolio_get_value(handle, lit)) {
+            LBOOL_TRUE -> true
+            LBOOL_FALSE -> false
+            LBOOL_UNDEF -> error("portfolio_get_value returned l_Undef")
+            else -> error("portfolio_get_value returned $value")
+        }
+    }
+
+    /**
+     * Query the values of multiple [literals] in a single native call.
+     *
+     * Note: resulting array is 0-based, i.e. `result[i]` is the value of `literals[i]`.
+     */
+    fun getValues(literals: IntArray): BooleanArray {
+        val values = ByteArray(literals.size)
+        portfolio_get_values(handle, literals, values)
+        return BooleanArray(literals.size) { i ->
+            when (val value = values[i]) {
+                LBOOL_TRUE -> true
+                LBOOL_FALSE -> false
+                LBOOL_UNDEF -> error("portfolio_get_values returned l_Undef for literal ${literals[i]}")
+                else -> error("portfolio_get_values returned $value")
+            }
+        }
+    }
+
+    /**
+     * Query the model found by the [winner] packed into a bitset,
+     * where the `(v-1)`-th bit holds the value of the variable `v`.
+     *
+     * The [bits] array is reused if it is large enough to hold [numberOfVariables] bits,
+     * otherwise a new array is allocated.
+     */
+    @JvmOverloads
+    fun getModelBits(bits: LongArray? = null): LongArray {
+        check(winner >= 0) { "No model is available" }
+        val words = (numberOfVariables + 63) / 64
+        val out = if (bits != null && bits.size >= words) bits else LongArray(words)
+        portfolio_get_model_bits(handle, out)
+        return out
+    }
+
+    private external fun portfolio_create(kinds: ByteArray, handles: LongArray): Long
+    private external fun portfolio_delete(handle: Long)
+    private external fun portfolio_nvars(handle: Long): Int
+    private external fun portfolio_winner(handle: Long): Int
+    private external fun portfolio_new_var(handle: Long): Int
+    private external fun portfolio_interrupt(handle: Long)
+    private external fun portfolio_clear_interrupt(handle: Long)
+    private external fun portfolio_add_clause(handle: Long, literals: IntArray): Boolean
+    private external fun portfolio_add_clauses(handle: Long, literals: IntArray, size: Int): Boolean
+    private external fun portfolio_add_clauses_direct(handle: Long, buffer: ByteBuffer, size: Int): Boolean
+    private external fun portfolio_load_cnf(handle: Long, cnf: Long): Boolean
+    private external fun portfolio_load_dimacs(handle: Long, path: String, threads: Int): LongArray?
+    private external fun portfolio_solve(handle: Long, assumptions: IntArray?): Byte
+    private external fun portfolio_select_cube_vars(handle: Long, depth: Int, excluded: IntArray?): IntArray?
+    private external fun portfolio_solve_cubes(handle: Long, variables: IntArray, assumptions: IntArray?): Byte
+    private external fun portfolio_get_value(handle: Long, lit: Int): Byte
+    private external fun portfolio_get_values(handle: Long, literals: IntArray, values: ByteArray)
+    private external fun portfolio_get_model_bits(handle: Long, bits: LongArray)
+
+    /** Note: the order of constants must be in sync with `enum Kind` in `JPortfolio.cpp`. */
+    enum class Backend {
+        MINISAT, GLUCOSE, CADICAL, CRYPTOMINISAT;
+
+        internal val kind: Byte get() = ordinal.toByte()
+
+        internal fun create(): AutoCloseable = when (this) {
+            MINISAT -> JMiniSat()
+            GLUCOSE -> JGlucose()
+            CADICAL -> JCadical()
+            CRYPTOMINISAT -> JCryptoMiniSat()
+        }
+    }
+
+    companion object {
+        private const val LBOOL_TRUE: Byte = 0
+        private const val LBOOL_FALSE: Byte = 1
+        private const val LBOOL_UNDEF: Byte = 2
+
+        /** Maximum number of splitting variables, i.e. at most `2^30` cubes. */
+        const val MAX_CUBE_DEPTH: Int = 30
+
+        private fun handleOf(solver: AutoCloseable): Long = when (solver) {
+            is JMiniSat -> solver.handle
+            is JGlucose -> solver.handle
+            is JCadical -> solver.handle
+            is JCryptoMiniSat -> solver.handle
+            else -> error("Unsupported backend: $solver")
+        }
+
+        init {
+            Loader.load("jportfolio")
+        }
+    }
+}
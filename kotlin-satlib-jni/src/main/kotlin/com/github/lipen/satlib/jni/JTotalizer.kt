@@ -0,0 +1,50 @@
+package com.github.lipen.satlib.jni
+
+/**
+ * Incremental totalizer, whose tree is kept in native memory.
+ *
+ * Created via [JCnf.addIncrementalTotalizer].
+ * Tightening the bound requires no new clauses (just restrict or assume the existing [outputs]),
+ * while [extend] adds only the outputs and clauses missing for the larger bound.
+ */
+@Suppress("FunctionName", "MemberVisibilityCanBePrivate")
+class JTotalizer internal constructor(handle: Long) : AutoCloseable {
+    internal var handle: Long = handle
+        private set
+
+    /** Current bound: the outputs are encoded up to `min(bound, numberOfInputs)`. */
+    val bound: Int get() = totalizer_bound(handle)
+
+    /** Output literals, where `outputs[i]` is true iff at least `i+1` input literals are true. */
+    val outputs: IntArray
+        get() = totalizer_outputs(handle)
+            ?: throw OutOfMemoryError("totalizer_outputs returned NULL")
+
+    override fun close() {
+        if (handle != 0L) {
+            totalizer_delete(handle)
+            handle = 0
+        }
+    }
+
+    /**
+     * Extend the totalizer up to the [newBound], appending new clauses to the [cnf].
+     *
+     * New variables are allocated sequentially starting from [firstVariable].
+     * Does nothing if [newBound] does not exceed the current [bound].
+     */
+    fun extend(cnf: JCnf, newBound: Int, firstVariable: Int) {
+        totalizer_extend(handle, cnf.handle, newBound, firstVariable)
+    }
+
+    private external fun totalizer_delete(handle: Long)
+    private external fun totalizer_bound(handle: Long): Int
+    private external fun totalizer_outputs(handle: Long): IntArray?
+    private external fun totalizer_extend(handle: Long, cnf: Long, bound: Int, firstVar: Int)
+
+    companion object {
+        init {
+            Loader.load("jcnf")
+        }
+    }
+}
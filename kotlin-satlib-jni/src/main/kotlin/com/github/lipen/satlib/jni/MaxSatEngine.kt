@@ -0,0 +1,166 @@
+package com.github.lipen.satlib.jni
+
+import kotlin.math.abs
+
+/**
+ * Native weighted partial MaxSAT engine over the clauses of its solver (which are hard)
+ * and the soft clauses registered in the engine, created by `newMaxSat` of [JCadical] and [JGlucose].
+ *
+ * The soft clauses are passed to the native side once, and each [solve] runs the whole optimization natively:
+ * the selectors of the soft clauses are added to the solver permanently, while the bounds are only assumed,
+ * so the solver remains usable for other queries (and the engine can be solved again after adding more clauses).
+ * The cardinality constraints built by each [solve] are guarded by its own activation literal,
+ * and are dropped (by fixing that literal) once the solve is over, so repeated solves do not grow the formula.
+ *
+ * Note: the engine allocates new variables above all the variables known to the solver (and [solve]'s `maxVariable`),
+ * which are all below [maxVariable] afterwards.
+ * Note: the engine must not be used after its solver is reset or closed.
+ */
+class MaxSatEngine internal constructor(
+    handle: Long,
+    private val natives: Natives,
+) : AutoCloseable {
+    private var handle: Long = handle
+
+    /** Optimization algorithm. */
+    enum class Algorithm(internal val value: Int) {
+        /**
+         * Linear SAT-UNSAT search: each found model tightens the upper bound,
+         * enforced via the totalizer over the soft clauses (each counted `weight / gcd` times,
+         * so it is only suited for small weights).
+         */
+        LINEAR(0),
+
+        /**
+         * Core-guided OLL search (as in RC2): each core raises the lower bound,
+         * and is relaxed via the totalizer over its literals.
+         */
+        OLL(1),
+    }
+
+    enum class Status {
+        /** The [MaxSatResult.cost] is optimal. */
+        OPTIMUM,
+
+        /** Some solution is found, but the search was interrupted before proving its optimality. */
+        SATISFIABLE,
+
+        /** The hard clauses are infeasible. */
+        UNSATISFIABLE,
+
+        /** The search was interrupted before finding any solution. */
+        UNKNOWN,
+    }
+
+    val isClosed: Boolean
+        get() = handle == 0L
+
+    /** Number of the registered soft clauses. */
+    val numberOfSoftClauses: Int
+        get() = natives.size(checkedHandle())
+
+    /**
+     * Current lower bound of the cost.
+     *
+     * Note: this (as well as [upperBound]) is safe to read from another thread during the [solve].
+     */
+    val lowerBound: Long
+        get() = bounds()[0]
+
+    /** Current upper bound of the cost (the cost of the best found solution), or `null` if there is none yet. */
+    val upperBound: Long?
+        get() = bounds()[1].takeIf { it != Long.MAX_VALUE }
+
+    /** The largest variable used by the engine so far (in the soft clauses, or allocated by the [solve]). */
+    var maxVariable: Int = 0
+        private set
+
+    /** Register the soft clause of the first [size] [literals] with the given (positive) [weight]. */
+    @JvmOverloads
+    fun addSoftClause(literals: IntArray, weight: Long = 1, size: Int = literals.size) {
+        require(weight > 0) { "Bad weight: $weight" }
+        require(size in 0..literals.size) { "Bad size: $size" }
+        natives.add(checkedHandle(), literals, size, weight)
+        for (i in 0 until size) {
+            maxVariable = maxOf(maxVariable, abs(literals[i]))
+        }
+    }
+
+    /** Register the soft unit clause `[lit]` with the given (positive) [weight]. */
+    @JvmOverloads
+    fun addSoftLiteral(lit: Int, weight: Long = 1) {
+        addSoftClause(intArrayOf(lit), weight)
+    }
+
+    /**
+     * Solve the MaxSAT problem natively with the given [algorithm].
+     *
+     * When [stratify] is true, the [OLL][Algorithm.OLL] search starts with the heaviest soft clauses only,
+     * adding the lighter ones each time a solution is found (it is ignored by the [LINEAR][Algorithm.LINEAR] search).
+     * The variables up to [maxVariable] are considered taken, in addition to the ones known to the solver
+     * (_e.g._, CaDiCaL does not know about the variables which do not occur in its clauses yet).
+     *
+     * The search can be stopped by interrupting the solver, then the best found solution (if any) is reported.
+     */
+    @JvmOverloads
+    fun solve(
+        algorithm: Algorithm = Algorithm.OLL,
+        stratify: Boolean = true,
+        maxVariable: Int = this.maxVariable,
+    ): MaxSatResult {
+        val handle = checkedHandle()
+        val status = when (val result = natives.solve(handle, algorithm.value, stratify, maxVariable)) {
+            0 -> Status.UNKNOWN
+            10 -> Status.SATISFIABLE
+            20 -> Status.UNSATISFIABLE
+            30 -> Status.OPTIMUM
+            else -> error("maxsat_solve returned $result")
+        }
+        this.maxVariable = maxOf(this.maxVariable, natives.nextVariable(handle) - 1)
+        return MaxSatResult(status, upperBound, lowerBound)
+    }
+
+    /** Note: resulting array is 1-based, and holds the best found solution. */
+    fun getModel(): BooleanArray {
+        return natives.model(checkedHandle())
+            ?: throw OutOfMemoryError("maxsat_model returned NULL")
+    }
+
+    override fun close() {
+        if (handle != 0L) {
+            natives.delete(handle)
+            handle = 0
+        }
+    }
+
+    private fun bounds(): LongArray {
+        val out = LongArray(2)
+        natives.bounds(checkedHandle(), out)
+        return out
+    }
+
+    private fun checkedHandle(): Long {
+        check(handle != 0L) { "MaxSAT engine is closed" }
+        return handle
+    }
+
+    internal interface Natives {
+        fun add(engine: Long, literals: IntArray, size: Int, weight: Long)
+        fun size(engine: Long): Int
+        fun solve(engine: Long, algorithm: Int, stratify: Boolean, maxVariable: Int): Int
+        fun nextVariable(engine: Long): Int
+        fun bounds(engine: Long, out: LongArray)
+        fun model(engine: Long): BooleanArray?
+        fun delete(engine: Long)
+    }
+}
+
+/**
+ * Result of [MaxSatEngine.solve]: the [cost] of the best found solution (`null` if there is none),
+ * which is optimal iff it equals the [lowerBound].
+ */
+data class MaxSatResult(
+    val status: MaxSatEngine.Status,
+    val cost: Long?,
+    val lowerBound: Long,
+)
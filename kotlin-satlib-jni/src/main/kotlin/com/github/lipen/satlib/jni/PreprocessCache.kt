@@ -0,0 +1,61 @@
+package com.github.lipen.satlib.jni
+
+import java.io.File
+import java.io.IOException
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.file.Files
+import java.nio.file.StandardCopyOption
+import java.security.MessageDigest
+import kotlin.math.abs
+
+/**
+ * On-disk cache of the preprocessed formulas, used by `loadDimacsPreprocessed` of [JMiniSat] and [JGlucose].
+ *
+ * Each artifact holds the simplified formula, the frozen and eliminated variables,
+ * and the reconstruction stack extending the models back to the eliminated variables.
+ * Artifacts are keyed by the SHA-256 of the CNF content and the frozen set,
+ * and are stored in [directory] as `<key>.<solver>` files, replaced atomically.
+ *
+ * Note: the artifacts are only portable between the machines of the same endianness.
+ */
+class PreprocessCache(val directory: File) {
+    init {
+        directory.mkdirs()
+    }
+
+    /** Key of the [cnf] preprocessed with the [frozen] variables. */
+    fun key(cnf: File, frozen: IntArray): ByteArray {
+        val digest = MessageDigest.getInstance("SHA-256")
+        cnf.inputStream().use { input ->
+            val buffer = ByteArray(1 shl 20)
+            while (true) {
+                val n = input.read(buffer)
+                if (n < 0) break
+                digest.update(buffer, 0, n)
+            }
+        }
+        val sorted = frozen.map { abs(it) }.distinct().sorted()
+        val bytes = ByteBuffer.allocate(4 * sorted.size + 1).order(ByteOrder.LITTLE_ENDIAN)
+        bytes.put(0) // separator
+        for (v in sorted) bytes.putInt(v)
+        digest.update(bytes.array())
+        return digest.digest()
+    }
+
+    internal fun artifact(key: ByteArray, kind: String): File {
+        val hex = key.joinToString("") { "%02x".format(it) }
+        return File(directory, "$hex.$kind")
+    }
+
+    /** Write the [artifact] via [save] (given the path of a temporary file), then move it into place atomically. */
+    internal inline fun store(artifact: File, save: (String) -> Boolean) {
+        val temp = File.createTempFile(artifact.name, ".tmp", directory)
+        try {
+            if (!save(temp.path)) throw IOException("Could not write preprocessed artifact to '$temp'")
+            Files.move(temp.toPath(), artifact.toPath(), StandardCopyOption.ATOMIC_MOVE, StandardCopyOption.REPLACE_EXISTING)
+        } finally {
+            temp.delete()
+        }
+    }
+}
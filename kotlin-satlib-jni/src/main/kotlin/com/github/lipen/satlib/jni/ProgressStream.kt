@@ -0,0 +1,80 @@
+package com.github.lipen.satlib.jni
+
+/**
+ * Progress of a running solve, see [ProgressStream].
+ *
+ * Fields not reported by the backend are `-1`.
+ * The counters are accumulated since the creation of the solver,
+ * while [trail] (variables assigned at the top level) and [learnts] (learnt clauses) are the current sizes.
+ */
+data class ProgressRecord(
+    val timeNanos: Long, // since the start of the stream
+    val conflicts: Long,
+    val decisions: Long,
+    val propagations: Long,
+    val restarts: Long,
+    val trail: Long,
+    val learnts: Long,
+) {
+    internal companion object {
+        // Note: see Progress.hpp
+        const val FIELDS: Int = 7
+
+        fun fromArray(values: LongArray, offset: Int): ProgressRecord {
+            return ProgressRecord(
+                timeNanos = values[offset],
+                conflicts = values[offset + 1],
+                decisions = values[offset + 2],
+                propagations = values[offset + 3],
+                restarts = values[offset + 4],
+                trail = values[offset + 5],
+                learnts = values[offset + 6],
+            )
+        }
+    }
+}
+
+/**
+ * Stream of [ProgressRecord]s published by a native solver, created by its `startProgress` method.
+ *
+ * The solves are never split or otherwise changed for the sake of the stream.
+ * Instead, the records are published into a fixed-size single-producer ring buffer, without any upcalls into the JVM,
+ * either by the solving thread from a hook of the solver (CaDiCaL), or by the sampler thread of the stream
+ * reading the counters of the running solver (MiniSat, Glucose and CryptoMiniSat, which have no such hooks),
+ * while the consumer (_e.g._, a dashboard or an adaptive timeout) periodically [drain]s it.
+ * Records not fitting into the ring (when it is not drained often enough) are dropped.
+ *
+ * Note: the stream is closed automatically when the solver is reset or closed.
+ */
+class ProgressStream internal constructor(
+    private var handle: Long,
+    capacity: Int,
+    private val drainNative: (handle: Long, out: LongArray) -> Int,
+    private val stopNative: (handle: Long) -> Unit,
+) : AutoCloseable {
+    private val buffer = LongArray(capacity * ProgressRecord.FIELDS)
+
+    val isClosed: Boolean
+        @Synchronized get() = handle == 0L
+
+    /**
+     * Take all the records published since the last call.
+     */
+    @Synchronized
+    fun drain(): List<ProgressRecord> {
+        if (handle == 0L) return emptyList()
+        val count = drainNative(handle, buffer)
+        return List(count) { i -> ProgressRecord.fromArray(buffer, i * ProgressRecord.FIELDS) }
+    }
+
+    /**
+     * Stop the publishing. The records not yet drained are lost.
+     */
+    @Synchronized
+    override fun close() {
+        if (handle != 0L) {
+            stopNative(handle)
+            handle = 0
+        }
+    }
+}
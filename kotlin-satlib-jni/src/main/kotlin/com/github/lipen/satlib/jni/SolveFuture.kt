@@ -0,0 +1,73 @@
+package com.github.lipen.satlib.jni
+
+import java.util.concurrent.CompletableFuture
+import java.util.concurrent.Executor
+import java.util.concurrent.ForkJoinPool
+import java.util.concurrent.RejectedExecutionException
+
+/**
+ * Result of a native `solveAsync` call: `true` if SAT, `false` if UNSAT or the search was stopped
+ * (just like the blocking `solve`).
+ *
+ * The solve runs on a native worker thread from a bounded pool (see [maxWorkers]): it starts right away
+ * while some worker is free, and waits in a queue otherwise. The worker is attached to the JVM only
+ * for the short upcalls checking the cancellation and reporting the result, so no JVM thread
+ * is blocked while the solver is searching.
+ * Once the solve is over, the future is completed on the [executor] (by default, the common pool),
+ * so the dependent stages never run on the native worker thread.
+ *
+ * Cancelling the future interrupts the solver (via [onCancel]) and skips the solve if it is still queued.
+ * Note: the solver must not be used until the solve is actually over, which may happen
+ * slightly after the cancellation. In MiniSat and Glucose, the interrupt also persists until `clearInterrupt`.
+ */
+class SolveFuture internal constructor(
+    private val onCancel: () -> Unit,
+    private val onResult: (Boolean) -> Unit = {},
+    private val onDone: () -> Unit = {},
+    private val executor: Executor = ForkJoinPool.commonPool(),
+) : CompletableFuture<Boolean>() {
+    override fun cancel(mayInterruptIfRunning: Boolean): Boolean {
+        val cancelled = super.cancel(mayInterruptIfRunning)
+        if (cancelled) onCancel()
+        return cancelled
+    }
+
+    // Note: called from the native worker thread once the solve is over (or skipped due to the cancellation)
+    @Suppress("unused")
+    private fun onSolved(result: Int) {
+        onDone()
+        try {
+            executor.execute { finish(result) }
+        } catch (e: RejectedExecutionException) {
+            completeExceptionally(e)
+        }
+    }
+
+    private fun finish(result: Int) {
+        val value = when (result) {
+            0 -> false // UNSOLVED
+            10 -> true // SATISFIABLE
+            20 -> false // UNSATISFIABLE
+            else -> {
+                completeExceptionally(IllegalStateException("Native solve failed ($result)"))
+                return
+            }
+        }
+        onResult(value)
+        complete(value)
+    }
+
+    companion object {
+        /**
+         * Maximum number of native worker threads running async solves, per solver library.
+         * Defaults to the number of available processors. Changing it affects only the subsequent solves.
+         */
+        @JvmStatic
+        @Volatile
+        var maxWorkers: Int = Runtime.getRuntime().availableProcessors()
+            set(value) {
+                require(value > 0) { "Bad maxWorkers: $value" }
+                field = value
+            }
+    }
+}
@@ -0,0 +1,66 @@
+package com.github.lipen.satlib.jni
+
+/**
+ * Resource limits of a single solve, enforced natively by `solveWithLimits` of the native solvers.
+ * Non-positive values mean "no limit".
+ *
+ * - [timeMillis] is the wall-clock time, checked by a native watchdog thread every few milliseconds.
+ * - [conflicts] and [propagations] are counted since the start of the solve, and are enforced via the solver budgets.
+ *   Note: the propagation limit is only supported by MiniSat and Glucose.
+ * - [memoryBytes] is the resident memory of the **whole process** (the solvers do not account their own memory),
+ *   also checked by the watchdog. Note: it is only supported on Linux and macOS, and ignored elsewhere.
+ */
+data class SolveLimits(
+    val timeMillis: Long = 0,
+    val conflicts: Long = 0,
+    val propagations: Long = 0,
+    val memoryBytes: Long = 0,
+) {
+    /** The limit which stopped the solve. */
+    enum class Kind {
+        TIME, CONFLICTS, PROPAGATIONS, MEMORY
+    }
+
+    /** Whether any limit is set. */
+    val isLimited: Boolean
+        get() = timeMillis > 0 || conflicts > 0 || propagations > 0 || memoryBytes > 0
+
+    internal fun toArray(): LongArray = longArrayOf(timeMillis, conflicts, propagations, memoryBytes)
+
+    internal fun checkNoPropagations(solver: String) {
+        if (propagations > 0) throw UnsupportedOperationException("$solver does not support the propagation limit")
+    }
+
+    companion object {
+        @JvmField
+        val NONE: SolveLimits = SolveLimits()
+    }
+}
+
+/**
+ * Result of a limited solve: [value] is `true` (SAT), `false` (UNSAT) or `null` (unknown),
+ * and [limit] is the limit which stopped the solve, or `null` if the solve was not stopped by any
+ * (_e.g._, it was interrupted, or the result is known).
+ */
+data class LimitedSolveResult(
+    val value: Boolean?,
+    val limit: SolveLimits.Kind?,
+) {
+    internal companion object {
+        // Note: see `limits_result` in Limits.hpp
+        fun decode(packed: Int, method: String): LimitedSolveResult {
+            val value = when (val result = packed and 0xFF) {
+                0 -> null // UNKNOWN
+                10 -> true // SATISFIABLE
+                20 -> false // UNSATISFIABLE
+                else -> error("$method returned $result")
+            }
+            val limit = when (val kind = packed shr 8) {
+                0 -> null
+                in 1..SolveLimits.Kind.values().size -> SolveLimits.Kind.values()[kind - 1]
+                else -> error("$method returned limit $kind")
+            }
+            return LimitedSolveResult(value, limit)
+        }
+    }
+}
@@ -0,0 +1,126 @@
+package com.github.lipen.satlib.jni
+
+/**
+ * Snapshot of the solver statistics, taken in a single native call by `stats()` of the native solvers.
+ *
+ * Fields not reported by the backend are `-1`.
+ * The snapshot is only complete when taken between the solves. During the solve, only the counters are reported:
+ * they are read from the running solver without synchronization (MiniSat, Glucose and CryptoMiniSat),
+ * or counted by a hook of the solver (only the conflicts of CaDiCaL), whether or not a [ProgressStream] is attached.
+ *
+ * - [variables], [clauses] (original) and [learnts] are the current sizes of the formula.
+ * - [conflicts], [decisions], [propagations], [restarts], [eliminated] (variables)
+ *   and [reductions] (of the learnt clause database) are counted since the creation of the solver.
+ * - [memoryBytes] is the resident memory of the **whole process** (Linux and macOS only).
+ * - [solves] and [solveTimeNanos] account the solves made through the JVM wrapper
+ *   (including the one in progress).
+ */
+data class SolverStats(
+    val variables: Long,
+    val clauses: Long,
+    val learnts: Long,
+    val conflicts: Long,
+    val decisions: Long,
+    val propagations: Long,
+    val restarts: Long,
+    val eliminated: Long,
+    val reductions: Long,
+    val memoryBytes: Long,
+    val solves: Long,
+    val solveTimeNanos: Long,
+) {
+    /**
+     * Statistics accumulated since the [previous] snapshot: the counters are subtracted,
+     * while the sizes of the formula and the memory are taken from this snapshot.
+     */
+    operator fun minus(previous: SolverStats): SolverStats {
+        fun diff(current: Long, old: Long): Long = if (current < 0 || old < 0) -1 else current - old
+        return SolverStats(
+            variables = variables,
+            clauses = clauses,
+            learnts = learnts,
+            conflicts = diff(conflicts, previous.conflicts),
+            decisions = diff(decisions, previous.decisions),
+            propagations = diff(propagations, previous.propagations),
+            restarts = diff(restarts, previous.restarts),
+            eliminated = diff(eliminated, previous.eliminated),
+            reductions = diff(reductions, previous.reductions),
+            memoryBytes = memoryBytes,
+            solves = diff(solves, previous.solves),
+            solveTimeNanos = diff(solveTimeNanos, previous.solveTimeNanos),
+        )
+    }
+
+    internal companion object {
+        // Note: see Stats.hpp
+        const val LAYOUT: Long = 1
+        const val SIZE: Int = 13
+
+        fun newArray(): LongArray = LongArray(SIZE)
+
+        fun fromArray(values: LongArray, clock: SolveClock): SolverStats {
+            check(values[0] == LAYOUT) { "Unsupported stats layout: ${values[0]}" }
+            return SolverStats(
+                variables = values[1],
+                clauses = values[2],
+                learnts = values[3],
+                conflicts = values[4],
+                decisions = values[5],
+                propagations = values[6],
+                restarts = values[7],
+                eliminated = values[8],
+                reductions = values[9],
+                memoryBytes = values[10],
+                solves = clock.solves,
+                solveTimeNanos = clock.elapsedNanos,
+            )
+        }
+    }
+}
+
+/**
+ * Number of solves and the total time spent solving, tracked by the native solver wrappers for [SolverStats].
+ */
+internal class SolveClock {
+    @Volatile
+    var solves: Long = 0
+        private set
+
+    @Volatile
+    private var totalNanos: Long = 0
+
+    @Volatile
+    private var startedAt: Long = 0
+
+    @Volatile
+    var isSolving: Boolean = false
+        private set
+
+    /** Total time spent solving, including the solve in progress. */
+    val elapsedNanos: Long
+        get() {
+            val total = totalNanos
+            return if (isSolving) total + (System.nanoTime() - startedAt) else total
+        }
+
+    fun start() {
+        startedAt = System.nanoTime()
+        solves++
+        isSolving = true
+    }
+
+    fun stop() {
+        if (!isSolving) return
+        totalNanos += System.nanoTime() - startedAt
+        isSolving = false
+    }
+
+    inline fun <T> measure(block: () -> T): T {
+        start()
+        try {
+            return block()
+        } finally {
+            stop()
+        }
+    }
+}
@@ -0,0 +1,92 @@
+package com.github.lipen.satlib.solver.jni
+
+import com.github.lipen.satlib.card.CardinalityEncoder
+import com.github.lipen.satlib.card.IncrementalTotalizer
+import com.github.lipen.satlib.core.Lit
+import com.github.lipen.satlib.core.LitArray
+import com.github.lipen.satlib.jni.JCnf
+import com.github.lipen.satlib.jni.JTotalizer
+import com.github.lipen.satlib.jni.LimitedSolveResult
+import com.github.lipen.satlib.jni.SolveLimits
+import com.github.lipen.satlib.solver.AbstractSolver
+
+/**
+ * Base class for JNI-backed solvers.
+ *
+ * Cardinality encodings are generated natively into a [JCnf] arena
+ * and loaded into the backend via [_loadCnf] in a single native call.
+ *
+ * Resource limits of a single solve are enforced natively via [solveWithLimits].
+ */
+abstract class AbstractJniSolver : AbstractSolver(), CardinalityEncoder {
+    protected abstract fun _loadCnf(cnf: JCnf)
+
+    /**
+     * Solve the SAT problem (under [assumptions]) within the resource [limits],
+     * reporting which of them stopped the search (see [SolveLimits] for the supported limits).
+     *
+     * @throws UnsupportedOperationException if the backend does not support some of the [limits].
+     */
+    fun solveWithLimits(limits: SolveLimits): LimitedSolveResult {
+        dropCachedModel()
+        val result = _solveWithLimits(limits)
+        assumptions.clear()
+        return result
+    }
+
+    protected open fun _solveWithLimits(limits: SolveLimits): LimitedSolveResult {
+        throw UnsupportedOperationException("$this does not support solve limits")
+    }
+
+    /**
+     * Run the native [encoder] (allocating variables starting from `numberOfVariables + 1`),
+     * declare the allocated variables and load the generated clauses into the backend.
+     */
+    private inline fun <T> encode(encoder: (cnf: JCnf, firstVariable: Int) -> T): T {
+        JCnf().use { cnf ->
+            val firstVariable = numberOfVariables + 1
+            val result = encoder(cnf, firstVariable)
+            // Note: variables are declared as usual, so that backends can freeze them
+            repeat(cnf.maxVariable - firstVariable + 1) { newLiteral() }
+            _loadCnf(cnf)
+            registerClauses(cnf.numberOfClauses, cnf.hash)
+            return result
+        }
+    }
+
+    override fun encodeTotalizer(literals: LitArray, bound: Int): LitArray {
+        return encode { cnf, firstVariable -> cnf.addTotalizer(literals, firstVariable, bound) }
+    }
+
+    override fun encodeSequentialCounter(literals: LitArray, bound: Int): LitArray {
+        return encode { cnf, firstVariable -> cnf.addSequentialCounter(literals, firstVariable, bound) }
+    }
+
+    override fun encodeSortingNetwork(literals: LitArray): LitArray {
+        return encode { cnf, firstVariable -> cnf.addSortingNetwork(literals, firstVariable) }
+    }
+
+    override fun encodeIncrementalTotalizer(literals: LitArray, bound: Int): IncrementalTotalizer {
+        val totalizer = encode { cnf, firstVariable -> cnf.addIncrementalTotalizer(literals, firstVariable, bound) }
+        return NativeIncrementalTotalizer(totalizer)
+    }
+
+    /** Note: the totalizer is only valid until the solver is reset. */
+    private inner class NativeIncrementalTotalizer(
+        private val totalizer: JTotalizer,
+    ) : IncrementalTotalizer {
+        override val bound: Int get() = totalizer.bound
+        override var outputs: List<Lit> = totalizer.outputs.asList()
+            private set
+
+        override fun extend(newBound: Int) {
+            if (newBound <= bound) return
+            encode { cnf, firstVariable -> totalizer.extend(cnf, newBound, firstVariable) }
+            outputs = totalizer.outputs.asList()
+        }
+
+        override fun close() {
+            totalizer.close()
+        }
+    }
+}
@@ -3,29 +3,55 @@
 package com.github.lipen.satlib.solver.jni
 
 import com.github.lipen.satlib.core.Lit
+import com.github.lipen.satlib.core.LitArray
 import com.github.lipen.satlib.core.Model
+import com.github.lipen.satlib.jni.ClauseBuffer
 import com.github.lipen.satlib.jni.JCadical
+import com.github.lipen.satlib.jni.JCnf
+import com.github.lipen.satlib.jni.LimitedSolveResult
+import com.github.lipen.satlib.jni.SolveLimits
+import com.github.lipen.satlib.op.ModelEnumerator
 import com.github.lipen.satlib.solver.AbstractSolver
 import java.io.File
+import java.util.concurrent.CompletableFuture
 
 class CadicalSolver @JvmOverloads constructor(
-    val backend: JCadical = JCadical(),
-) : AbstractSolver() {
+    backend: JCadical = JCadical(),
+) : AbstractJniSolver(), ModelEnumerator {
+    private val rawBackend: JCadical = backend
+    private val clauseBuffer = ClauseBuffer { buffer, size -> rawBackend.addClauses(buffer, size) }
+
+    /**
+     * The underlying native solver.
+     *
+     * The clauses added via [addClause] are buffered (see [ClauseBuffer]) and flushed on each access,
+     * so the backend always holds the whole formula, and any backend-level API can be used safely.
+     * Note: access it from the thread which adds the clauses.
+     */
+    val backend: JCadical
+        get() {
+            clauseBuffer.flush()
+            return rawBackend
+        }
+
     constructor(initialSeed: Int?) : this(backend = JCadical(initialSeed))
 
     override fun _reset() {
+        clauseBuffer.clear()
         backend.reset()
     }
 
     override fun _close() {
+        clauseBuffer.clear()
         backend.close()
     }
 
     override fun _interrupt() {
-        backend.terminate()
+        rawBackend.terminate()
     }
 
     override fun _dumpDimacs(file: File) {
+        clauseBuffer.flush()
         backend.writeDimacs(file)
     }
 
@@ -36,22 +62,72 @@ class CadicalSolver @JvmOverloads constructor(
     }
 
     override fun _addClause(literals: List<Lit>) {
-        backend.addClause(literals.toIntArray())
+        clauseBuffer.addClause(literals)
     }
 
-    override fun _solve(): Boolean {
-        return if (assumptions.isEmpty()) {
-            backend.solve()
-        } else {
-            backend.solve(assumptions.toIntArray())
-        }
+    override fun _addClause(literals: LitArray, fromIndex: Int, toIndex: Int) {
+        clauseBuffer.addClause(literals, fromIndex, toIndex)
+    }
+
+    override fun _addClause(lit: Lit) {
+        clauseBuffer.addClause(lit)
+    }
+
+    override fun _addClause(lit1: Lit, lit2: Lit) {
+        clauseBuffer.addClause(lit1, lit2)
+    }
+
+    override fun _addClause(lit1: Lit, lit2: Lit, lit3: Lit) {
+        clauseBuffer.addClause(lit1, lit2, lit3)
+    }
+
+    override fun _loadCnf(cnf: JCnf) {
+        backend.loadCnf(cnf)
+    }
+
+    override fun _fork(): AbstractSolver {
+        clauseBuffer.flush()
+        return CadicalSolver(backend.clone())
     }
 
-    override fun getValue(lit: Lit): Boolean {
+    override fun _solve(): Boolean? {
+        clauseBuffer.flush()
+        return backend.solveLimited(if (assumptions.isEmpty()) null else assumptions.toIntArray())
+    }
+
+    override fun _solveWithLimits(limits: SolveLimits): LimitedSolveResult {
+        clauseBuffer.flush()
+        return backend.solveWithLimits(limits, if (assumptions.isEmpty()) null else assumptions.toIntArray())
+    }
+
+    override fun _solveAsync(assumptions: List<Lit>): CompletableFuture<Boolean> {
+        clauseBuffer.flush()
+        return backend.solveAsync(assumptions.toIntArray())
+    }
+
+    override fun _getValue(lit: Lit): Boolean {
         return backend.getValue(lit)
     }
 
-    override fun getModel(): Model {
-        return Model.from(backend.getModel(), zerobased = false)
+    override fun _getValues(literals: LitArray): BooleanArray {
+        return backend.getValues(literals)
+    }
+
+    override fun _getModel(): Model {
+        return Model.fromBits(backend.getModelBits(), backend.numberOfVariables)
+    }
+
+    override fun _getCore(): LitArray {
+        return backend.getCore(assumptions.toIntArray())
+    }
+
+    override fun enumerateModels(projection: LitArray, buffer: LongArray, minimize: Boolean): Int {
+        clauseBuffer.flush()
+        return backend.enumerateModels(projection, buffer, minimize).also { registerClauses(it) }
+    }
+
+    override fun countModels(projection: LitArray, minimize: Boolean, limit: Long): Long {
+        clauseBuffer.flush()
+        return backend.countModels(projection, minimize, limit).also { registerClauses(it) }
     }
 }
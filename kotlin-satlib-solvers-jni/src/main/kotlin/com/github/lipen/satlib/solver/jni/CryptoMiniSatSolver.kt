@@ -3,56 +3,131 @@
 package com.github.lipen.satlib.solver.jni
 
 import com.github.lipen.satlib.core.Lit
+import com.github.lipen.satlib.core.LitArray
 import com.github.lipen.satlib.core.Model
+import com.github.lipen.satlib.jni.ClauseBuffer
+import com.github.lipen.satlib.jni.JCnf
 import com.github.lipen.satlib.jni.JCryptoMiniSat
-import com.github.lipen.satlib.solver.AbstractSolver
+import com.github.lipen.satlib.jni.LimitedSolveResult
+import com.github.lipen.satlib.jni.SolveLimits
+import com.github.lipen.satlib.op.ModelEnumerator
 import java.io.File
+import java.util.concurrent.CompletableFuture
 
 class CryptoMiniSatSolver @JvmOverloads constructor(
-    val backend: JCryptoMiniSat = JCryptoMiniSat(),
-) : AbstractSolver() {
+    backend: JCryptoMiniSat = JCryptoMiniSat(),
+) : AbstractJniSolver(), ModelEnumerator {
+    private val rawBackend: JCryptoMiniSat = backend
+    internal val clauseBuffer = ClauseBuffer { buffer, size -> rawBackend.addClauses(buffer, size) }
+
+    /**
+     * The underlying native solver.
+     *
+     * The clauses added via [addClause] are buffered (see [ClauseBuffer]) and flushed on each access,
+     * so the backend always holds the whole formula, and any backend-level API can be used safely.
+     * The solver itself flushes the buffer only before solving and before querying the model,
+     * so adding clauses interleaved with [newLiteral] calls does not cross JNI per clause.
+     * Note: access it from the thread which adds the clauses.
+     */
+    val backend: JCryptoMiniSat
+        get() {
+            clauseBuffer.flush()
+            return rawBackend
+        }
+
     constructor(numberOfThreads: Int) : this(backend = JCryptoMiniSat(numberOfThreads))
 
     override fun _reset() {
-        backend.reset()
+        clauseBuffer.clear()
+        rawBackend.reset()
     }
 
     override fun _close() {
-        backend.close()
+        clauseBuffer.clear()
+        rawBackend.close()
     }
 
     override fun _interrupt() {
-        backend.interrupt()
+        rawBackend.interrupt()
     }
 
     override fun _dumpDimacs(file: File) {
-        backend.writeDimacs(file)
+        clauseBuffer.flush()
+        rawBackend.writeDimacs(file)
     }
 
     override fun _comment(comment: String) {}
 
     override fun _newLiteral(outer: Lit): Lit {
-        backend.newVariable()
+        rawBackend.newVariable()
         return outer
     }
 
     override fun _addClause(literals: List<Lit>) {
-        backend.addClause(literals.toIntArray())
+        clauseBuffer.addClause(literals)
     }
 
-    override fun _solve(): Boolean {
-        return if (assumptions.isEmpty()) {
-            backend.solve()
-        } else {
-            backend.solve(assumptions.toIntArray())
-        }
+    override fun _addClause(literals: LitArray, fromIndex: Int, toIndex: Int) {
+        clauseBuffer.addClause(literals, fromIndex, toIndex)
+    }
+
+    override fun _addClause(lit: Lit) {
+        clauseBuffer.addClause(lit)
+    }
+
+    override fun _addClause(lit1: Lit, lit2: Lit) {
+        clauseBuffer.addClause(lit1, lit2)
+    }
+
+    override fun _addClause(lit1: Lit, lit2: Lit, lit3: Lit) {
+        clauseBuffer.addClause(lit1, lit2, lit3)
+    }
+
+    override fun _loadCnf(cnf: JCnf) {
+        rawBackend.loadCnf(cnf)
+    }
+
+    override fun _solve(): Boolean? {
+        clauseBuffer.flush()
+        return rawBackend.solveLimited(if (assumptions.isEmpty()) null else assumptions.toIntArray())
+    }
+
+    override fun _solveWithLimits(limits: SolveLimits): LimitedSolveResult {
+        clauseBuffer.flush()
+        return rawBackend.solveWithLimits(limits, if (assumptions.isEmpty()) null else assumptions.toIntArray())
+    }
+
+    override fun _solveAsync(assumptions: List<Lit>): CompletableFuture<Boolean> {
+        clauseBuffer.flush()
+        return rawBackend.solveAsync(assumptions.toIntArray())
+    }
+
+    override fun _getValue(lit: Lit): Boolean {
+        clauseBuffer.flush()
+        return rawBackend.getValue(lit)
+    }
+
+    override fun _getValues(literals: LitArray): BooleanArray {
+        clauseBuffer.flush()
+        return rawBackend.getValues(literals)
+    }
+
+    override fun _getModel(): Model {
+        clauseBuffer.flush()
+        return Model.fromBits(rawBackend.getModelBits(), rawBackend.numberOfVariables)
+    }
+
+    override fun _getCore(): LitArray {
+        return rawBackend.getCore()
     }
 
-    override fun getValue(lit: Lit): Boolean {
-        return backend.getValue(lit)
+    override fun enumerateModels(projection: LitArray, buffer: LongArray, minimize: Boolean): Int {
+        clauseBuffer.flush()
+        return rawBackend.enumerateModels(projection, buffer, minimize).also { registerClauses(it) }
     }
 
-    override fun getModel(): Model {
-        return Model.from(backend.getModel(), zerobased = true)
+    override fun countModels(projection: LitArray, minimize: Boolean, limit: Long): Long {
+        clauseBuffer.flush()
+        return rawBackend.countModels(projection, minimize, limit).also { registerClauses(it) }
     }
 }
@@ -3,16 +3,40 @@
 package com.github.lipen.satlib.solver.jni
 
 import com.github.lipen.satlib.core.Lit
+import com.github.lipen.satlib.core.LitArray
 import com.github.lipen.satlib.core.Model
+import com.github.lipen.satlib.jni.ClauseBuffer
+import com.github.lipen.satlib.jni.JCnf
 import com.github.lipen.satlib.jni.JGlucose
+import com.github.lipen.satlib.jni.LimitedSolveResult
+import com.github.lipen.satlib.jni.SolveLimits
+import com.github.lipen.satlib.op.ModelEnumerator
 import com.github.lipen.satlib.solver.AbstractSolver
 import java.io.File
+import java.util.concurrent.CompletableFuture
 
 class GlucoseSolver @JvmOverloads constructor(
     val simpStrategy: SimpStrategy = SimpStrategy.ONCE,
-    val backend: JGlucose = JGlucose(),
-) : AbstractSolver() {
+    backend: JGlucose = JGlucose(),
+) : AbstractJniSolver(), ModelEnumerator {
     private var simplified = false
+    private val rawBackend: JGlucose = backend
+    internal val clauseBuffer = ClauseBuffer { buffer, size -> rawBackend.addClauses(buffer, size) }
+
+    /**
+     * The underlying native solver.
+     *
+     * The clauses added via [addClause] are buffered (see [ClauseBuffer]) and flushed on each access,
+     * so the backend always holds the whole formula, and any backend-level API can be used safely.
+     * The solver itself flushes the buffer only before solving and before querying the model,
+     * so adding clauses interleaved with [newLiteral] calls does not cross JNI per clause.
+     * Note: access it from the thread which adds the clauses.
+     */
+    val backend: JGlucose
+        get() {
+            clauseBuffer.flush()
+            return rawBackend
+        }
 
     constructor(
         simpStrategy: SimpStrategy = SimpStrategy.ONCE,
@@ -32,38 +56,61 @@ class GlucoseSolver @JvmOverloads constructor(
 
     init {
         if (simpStrategy == SimpStrategy.NEVER) {
-            backend.eliminate(turn_off_elim = true)
+            rawBackend.eliminate(turn_off_elim = true)
         }
     }
 
     override fun _reset() {
-        backend.reset()
+        clauseBuffer.clear()
+        rawBackend.reset()
         if (simpStrategy == SimpStrategy.NEVER) {
-            backend.eliminate(turn_off_elim = true)
+            rawBackend.eliminate(turn_off_elim = true)
         }
         simplified = false
     }
 
     override fun _close() {
-        backend.close()
+        clauseBuffer.clear()
+        rawBackend.close()
     }
 
     override fun _interrupt() {
-        backend.interrupt()
+        rawBackend.interrupt()
     }
 
     override fun _dumpDimacs(file: File) {
-        backend.writeDimacs(file)
+        clauseBuffer.flush()
+        rawBackend.writeDimacs(file)
     }
 
     override fun _comment(comment: String) {}
 
     override fun _newLiteral(outer: Lit): Lit {
-        return backend.newVariable()
+        return rawBackend.newVariable()
     }
 
     override fun _addClause(literals: List<Lit>) {
-        backend.addClause_(literals.toIntArray())
+        clauseBuffer.addClause(literals)
+    }
+
+    override fun _addClause(literals: LitArray, fromIndex: Int, toIndex: Int) {
+        clauseBuffer.addClause(literals, fromIndex, toIndex)
+    }
+
+    override fun _addClause(lit: Lit) {
+        clauseBuffer.addClause(lit)
+    }
+
+    override fun _addClause(lit1: Lit, lit2: Lit) {
+        clauseBuffer.addClause(lit1, lit2)
+    }
+
+    override fun _addClause(lit1: Lit, lit2: Lit, lit3: Lit) {
+        clauseBuffer.addClause(lit1, lit2, lit3)
+    }
+
+    override fun _loadCnf(cnf: JCnf) {
+        rawBackend.loadCnf(cnf)
     }
 
     private fun <T> runMatchingSimpStrategy(block: (do_simp: Boolean, turn_off_simp: Boolean) -> T): T {
@@ -74,22 +121,59 @@ class GlucoseSolver @JvmOverloads constructor(
         }
     }
 
-    override fun _solve(): Boolean {
+    override fun _fork(): AbstractSolver {
+        clauseBuffer.flush()
+        return GlucoseSolver(simpStrategy, rawBackend.clone()).also { it.simplified = simplified }
+    }
+
+    override fun _solve(): Boolean? {
+        clauseBuffer.flush()
         return runMatchingSimpStrategy { do_simp, turn_off_simp ->
-            if (assumptions.isEmpty()) {
-                backend.solve(do_simp, turn_off_simp)
-            } else {
-                backend.solve(assumptions.toIntArray(), do_simp, turn_off_simp)
-            }
+            rawBackend.solveLimited(assumptions.toIntArray(), do_simp, turn_off_simp)
         }
     }
 
-    override fun getValue(lit: Lit): Boolean {
-        return backend.getValue(lit)
+    override fun _solveWithLimits(limits: SolveLimits): LimitedSolveResult {
+        clauseBuffer.flush()
+        return runMatchingSimpStrategy { do_simp, turn_off_simp ->
+            rawBackend.solveWithLimits(limits, assumptions.toIntArray(), do_simp, turn_off_simp)
+        }
+    }
+
+    override fun _solveAsync(assumptions: List<Lit>): CompletableFuture<Boolean> {
+        clauseBuffer.flush()
+        return runMatchingSimpStrategy { do_simp, turn_off_simp ->
+            rawBackend.solveAsync(assumptions.toIntArray(), do_simp, turn_off_simp)
+        }
+    }
+
+    override fun _getValue(lit: Lit): Boolean {
+        clauseBuffer.flush()
+        return rawBackend.getValue(lit)
+    }
+
+    override fun _getValues(literals: LitArray): BooleanArray {
+        clauseBuffer.flush()
+        return rawBackend.getValues(literals)
+    }
+
+    override fun _getModel(): Model {
+        clauseBuffer.flush()
+        return Model.fromBits(rawBackend.getModelBits(), rawBackend.numberOfVariables)
+    }
+
+    override fun _getCore(): LitArray {
+        return rawBackend.getCore()
+    }
+
+    override fun enumerateModels(projection: LitArray, buffer: LongArray, minimize: Boolean): Int {
+        clauseBuffer.flush()
+        return rawBackend.enumerateModels(projection, buffer, minimize).also { registerClauses(it) }
     }
 
-    override fun getModel(): Model {
-        return Model.from(backend.getModel(), zerobased = false)
+    override fun countModels(projection: LitArray, minimize: Boolean, limit: Long): Long {
+        clauseBuffer.flush()
+        return rawBackend.countModels(projection, minimize, limit).also { registerClauses(it) }
     }
 
     companion object {
@@ -0,0 +1,134 @@
+@file:Suppress("MemberVisibilityCanBePrivate")
+
+package com.github.lipen.satlib.solver.jni
+
+import com.github.lipen.satlib.core.Lit
+import com.github.lipen.satlib.core.LitArray
+import com.github.lipen.satlib.core.Model
+import com.github.lipen.satlib.jni.ClauseBuffer
+import com.github.lipen.satlib.jni.JCnf
+import com.github.lipen.satlib.jni.JKissat
+import com.github.lipen.satlib.jni.LimitedSolveResult
+import com.github.lipen.satlib.jni.SolveLimits
+import java.io.File
+import java.util.concurrent.CompletableFuture
+
+/**
+ * Note: Kissat is not incremental, so the solver must be [reset] after each [solve],
+ * and solving with assumptions is not supported.
+ */
+class KissatSolver @JvmOverloads constructor(
+    backend: JKissat = JKissat(),
+) : AbstractJniSolver() {
+    private val rawBackend: JKissat = backend
+    private val clauseBuffer = ClauseBuffer { buffer, size -> rawBackend.addClauses(buffer, size) }
+
+    /**
+     * The underlying native solver.
+     *
+     * The clauses added via [addClause] are buffered (see [ClauseBuffer]) and flushed on each access,
+     * so the backend always holds the whole formula, and any backend-level API can be used safely.
+     * Note: access it from the thread which adds the clauses.
+     */
+    val backend: JKissat
+        get() {
+            clauseBuffer.flush()
+            return rawBackend
+        }
+
+    constructor(initialSeed: Int?) : this(backend = JKissat(initialSeed))
+
+    override fun _reset() {
+        clauseBuffer.clear()
+        backend.reset()
+    }
+
+    override fun _close() {
+        clauseBuffer.clear()
+        backend.close()
+    }
+
+    override fun _interrupt() {
+        rawBackend.interrupt()
+    }
+
+    override fun _dumpDimacs(file: File) {
+        throw UnsupportedOperationException(DUMPING_NOT_SUPPORTED)
+    }
+
+    override fun _comment(comment: String) {}
+
+    override fun _newLiteral(outer: Lit): Lit {
+        return outer
+    }
+
+    override fun _addClause(literals: List<Lit>) {
+        clauseBuffer.addClause(literals)
+    }
+
+    override fun _addClause(literals: LitArray, fromIndex: Int, toIndex: Int) {
+        clauseBuffer.addClause(literals, fromIndex, toIndex)
+    }
+
+    override fun _addClause(lit: Lit) {
+        clauseBuffer.addClause(lit)
+    }
+
+    override fun _addClause(lit1: Lit, lit2: Lit) {
+        clauseBuffer.addClause(lit1, lit2)
+    }
+
+    override fun _addClause(lit1: Lit, lit2: Lit, lit3: Lit) {
+        clauseBuffer.addClause(lit1, lit2, lit3)
+    }
+
+    override fun _loadCnf(cnf: JCnf) {
+        backend.loadCnf(cnf)
+    }
+
+    override fun _solve(): Boolean? {
+        if (assumptions.isNotEmpty()) {
+            throw UnsupportedOperationException(ASSUMPTIONS_NOT_SUPPORTED)
+        }
+        clauseBuffer.flush()
+        return backend.solve()
+    }
+
+    override fun _solveWithLimits(limits: SolveLimits): LimitedSolveResult {
+        if (assumptions.isNotEmpty()) {
+            throw UnsupportedOperationException(ASSUMPTIONS_NOT_SUPPORTED)
+        }
+        clauseBuffer.flush()
+        return backend.solveWithLimits(limits)
+    }
+
+    override fun _solveAsync(assumptions: List<Lit>): CompletableFuture<Boolean> {
+        if (assumptions.isNotEmpty()) {
+            throw UnsupportedOperationException(ASSUMPTIONS_NOT_SUPPORTED)
+        }
+        clauseBuffer.flush()
+        return backend.solveAsync()
+    }
+
+    override fun _getValue(lit: Lit): Boolean {
+        return backend.getValue(lit)
+    }
+
+    override fun _getValues(literals: LitArray): BooleanArray {
+        return backend.getValues(literals)
+    }
+
+    override fun _getModel(): Model {
+        // Note: Kissat only knows the variables mentioned in clauses, the rest are false
+        val bits = backend.getModelBits(LongArray((numberOfVariables + 63) / 64))
+        return Model.fromBits(bits, numberOfVariables)
+    }
+
+    companion object {
+        private const val NAME = "KissatSolver"
+        private const val DUMPING_NOT_SUPPORTED =
+            "$NAME does not support dumping DIMACS"
+        private const val ASSUMPTIONS_NOT_SUPPORTED =
+            "$NAME does not support solving with assumptions"
+    }
+}
@@ -0,0 +1,123 @@
+@file:Suppress("MemberVisibilityCanBePrivate")
+
+package com.github.lipen.satlib.solver.jni
+
+import com.github.lipen.satlib.core.Lit
+import com.github.lipen.satlib.core.LitArray
+import com.github.lipen.satlib.core.Model
+import com.github.lipen.satlib.jni.ClauseBuffer
+import com.github.lipen.satlib.jni.JCnf
+import com.github.lipen.satlib.jni.JPortfolio
+import java.io.File
+
+class PortfolioSolver @JvmOverloads constructor(
+    backend: JPortfolio = JPortfolio(*JPortfolio.Backend.values()),
+) : AbstractJniSolver() {
+    private val rawBackend: JPortfolio = backend
+    private val clauseBuffer = ClauseBuffer { buffer, size -> rawBackend.addClauses(buffer, size) }
+
+    /**
+     * The underlying native solver.
+     *
+     * The clauses added via [addClause] are buffered (see [ClauseBuffer]) and flushed on each access,
+     * so the backend always holds the whole formula, and any backend-level API can be used safely.
+     * Note: access it from the thread which adds the clauses.
+     */
+    val backend: JPortfolio
+        get() {
+            clauseBuffer.flush()
+            return rawBackend
+        }
+
+    constructor(vararg backends: JPortfolio.Backend) : this(backend = JPortfolio(*backends))
+
+    /**
+     * Splitting variables for the cube-and-conquer mode (see [JPortfolio.solveCubes]).
+     * When `null`, [cubeDepth] variables are selected automatically on each [solve].
+     */
+    var cubeVariables: List<Lit>? = null
+
+    /**
+     * Number of automatically selected splitting variables, used when [cubeVariables] is `null`.
+     * When `0` (default), [solve] runs all backends on the whole formula, as a usual portfolio.
+     */
+    var cubeDepth: Int = 0
+
+    override fun _reset() {
+        clauseBuffer.clear()
+        backend.reset()
+    }
+
+    override fun _close() {
+        clauseBuffer.clear()
+        backend.close()
+    }
+
+    override fun _interrupt() {
+        rawBackend.interrupt()
+    }
+
+    override fun _dumpDimacs(file: File) {
+        throw UnsupportedOperationException(DUMPING_NOT_SUPPORTED)
+    }
+
+    override fun _comment(comment: String) {}
+
+    override fun _newLiteral(outer: Lit): Lit {
+        return backend.newVariable()
+    }
+
+    override fun _addClause(literals: List<Lit>) {
+        clauseBuffer.addClause(literals)
+    }
+
+    override fun _addClause(literals: LitArray, fromIndex: Int, toIndex: Int) {
+        clauseBuffer.addClause(literals, fromIndex, toIndex)
+    }
+
+    override fun _addClause(lit: Lit) {
+        clauseBuffer.addClause(lit)
+    }
+
+    override fun _addClause(lit1: Lit, lit2: Lit) {
+        clauseBuffer.addClause(lit1, lit2)
+    }
+
+    override fun _addClause(lit1: Lit, lit2: Lit, lit3: Lit) {
+        clauseBuffer.addClause(lit1, lit2, lit3)
+    }
+
+    override fun _loadCnf(cnf: JCnf) {
+        backend.loadCnf(cnf)
+    }
+
+    override fun _solve(): Boolean? {
+        clauseBuffer.flush()
+        val assumps = if (assumptions.isEmpty()) null else assumptions.toIntArray()
+        val cubeVariables = cubeVariables
+        // Note: interrupted portfolio returns `null` (unknown)
+        return when {
+            cubeVariables != null -> backend.solveCubes(cubeVariables.toIntArray(), assumps)
+            cubeDepth > 0 -> backend.solveCubes(cubeDepth, assumps)
+            else -> backend.solve(assumps)
+        }
+    }
+
+    override fun _getValue(lit: Lit): Boolean {
+        return backend.getValue(lit)
+    }
+
+    override fun _getValues(literals: LitArray): BooleanArray {
+        return backend.getValues(literals)
+    }
+
+    override fun _getModel(): Model {
+        return Model.fromBits(backend.getModelBits(), backend.numberOfVariables)
+    }
+
+    companion object {
+        private const val NAME = "PortfolioSolver"
+        private const val DUMPING_NOT_SUPPORTED =
+            "$NAME does not support dumping DIMACS"
+    }
+}
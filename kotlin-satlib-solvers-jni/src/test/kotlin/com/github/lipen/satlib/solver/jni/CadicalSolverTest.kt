@@ -1,11 +1,29 @@
 package com.github.lipen.satlib.solver.jni
 
+import com.github.lipen.satlib.jni.JCadical
+import com.github.lipen.satlib.jni.JCadicalShare
+import com.github.lipen.satlib.jni.MaxSatEngine
+import com.github.lipen.satlib.jni.SolveLimits
+import com.github.lipen.satlib.solver.addClause
+import com.github.lipen.satlib.solver.solve
 import com.github.lipen.satlib.test.`assumptions are supported`
+import com.github.lipen.satlib.test.`async solving`
 import com.github.lipen.satlib.test.`empty clause leads to UNSAT`
+import com.github.lipen.satlib.test.`many clauses`
+import com.github.lipen.satlib.test.`native cardinality encodings`
+import com.github.lipen.satlib.test.`projected model enumeration`
 import com.github.lipen.satlib.test.`simple SAT`
 import com.github.lipen.satlib.test.`simple UNSAT`
+import com.github.lipen.satlib.test.`solver forking`
 import com.github.lipen.satlib.test.`solving after reset`
+import com.github.lipen.satlib.test.`solving with limits`
 import com.github.lipen.satlib.test.`solving with timeout`
+import org.amshove.kluent.`should be equal to`
+import org.amshove.kluent.`should be false`
+import org.amshove.kluent.`should be greater than`
+import org.amshove.kluent.`should be null`
+import org.amshove.kluent.`should be true`
+import org.amshove.kluent.`should not contain`
 import org.junit.jupiter.api.Test
 import org.junit.jupiter.api.TestInstance
 
@@ -33,6 +51,11 @@ class CadicalSolverTest {
         solver.`solving after reset`()
     }
 
+    @Test
+    fun `many clauses`() {
+        solver.`many clauses`()
+    }
+
     @Test
     fun `assumptions are supported`() {
         solver.`assumptions are supported`()
@@ -44,4 +67,146 @@ class CadicalSolverTest {
             // no need to clear interrupt
         }
     }
+
+    @Test
+    fun `native cardinality encodings`() {
+        solver.`native cardinality encodings`()
+    }
+
+    @Test
+    fun `projected model enumeration`() {
+        solver.`projected model enumeration`()
+    }
+
+    @Test
+    fun `solver forking`() {
+        solver.`solver forking`()
+    }
+
+    @Test
+    fun `async solving`() {
+        solver.`async solving`()
+    }
+
+    @Test
+    fun `solving with limits`() {
+        solver.`solving with limits`(listOf(SolveLimits.Kind.TIME, SolveLimits.Kind.CONFLICTS, SolveLimits.Kind.MEMORY)) { solveWithLimits(it) }
+    }
+
+    @Test
+    fun `statistics snapshot`() {
+        with(solver) {
+            val x = newLiteral()
+            val y = newLiteral()
+            addClause(x, y)
+            val before = backend.stats()
+            solve().`should be true`()
+            val stats = backend.stats()
+            stats.variables `should be equal to` 2L
+            stats.solves `should be equal to` 1L
+            stats.solveTimeNanos `should be greater than` 0L
+            (stats - before).solves `should be equal to` 1L
+        }
+    }
+
+    @Test
+    fun `core extraction and minimization`() {
+        with(solver) {
+            val x = newLiteral()
+            val y = newLiteral()
+            val z = newLiteral()
+            addClause(-x, -y)
+            val assumptions = intArrayOf(x, y, z)
+            backend.solve(assumptions).`should be false`()
+            backend.getCore(assumptions).toList() `should not contain` z
+            backend.minimizeCore(intArrayOf(z, x, y))!!.sorted() `should be equal to` listOf(x, y)
+            backend.minimizeCore(intArrayOf(x, z)).`should be null`()
+        }
+    }
+
+    @Test
+    fun `native maxsat`() {
+        with(solver) {
+            val x = newLiteral()
+            val y = newLiteral()
+            val z = newLiteral()
+            backend.addClause(-x, -y)
+            backend.addClause(-y, -z)
+            backend.newMaxSat().use { maxsat ->
+                maxsat.addSoftLiteral(x, 2)
+                maxsat.addSoftLiteral(y, 3)
+                maxsat.addSoftClause(intArrayOf(z, x), 2)
+                for (algorithm in MaxSatEngine.Algorithm.values()) {
+                    val result = maxsat.solve(algorithm)
+                    result.status `should be equal to` MaxSatEngine.Status.OPTIMUM
+                    result.cost `should be equal to` 3L
+                    result.lowerBound `should be equal to` 3L
+                    val model = maxsat.getModel()
+                    (model[x] && !model[y]).`should be true`()
+                }
+            }
+        }
+    }
+
+    @Test
+    fun `clause sharing bus`() {
+        val solvers = JCadicalShare.diversified(2)
+        try {
+            for (backend in solvers) backend.declarePigeonhole(holes = 7)
+            JCadicalShare(solvers, maxSize = JCadicalShare.MAX_SIZE, capacity = 8).use { bus ->
+                // Note: the learnt clauses of the first solver are exported even when it is driven manually
+                solvers[0].solveWithLimits(SolveLimits(conflicts = 100))
+                val exported = bus.exported
+                exported `should be greater than` 0L
+                bus.importClauses(1) `should be equal to` minOf(exported, 8L).toInt()
+                // Note: the clauses overwritten before the import are dropped
+                bus.imported `should be equal to` minOf(exported, 8L)
+                bus.dropped `should be equal to` maxOf(exported - 8, 0L)
+                bus.solve(conflictsPerRound = 100).`should be false`()
+                (bus.winner in solvers.indices).`should be true`()
+                // Note: the disconnected solver takes no part in the solve
+                bus.disconnect(1)
+                bus.importClauses(1) `should be equal to` 0
+                bus.solve(conflictsPerRound = 100).`should be false`()
+                bus.winner `should be equal to` 0
+            }
+        } finally {
+            solvers.forEach { it.close() }
+        }
+    }
+
+    @Test
+    fun `clause sharing bus caps the imports`() {
+        val solvers = JCadicalShare.diversified(2)
+        try {
+            for (backend in solvers) backend.declarePigeonhole(holes = 7)
+            JCadicalShare(solvers, maxSize = JCadicalShare.MAX_SIZE, maxImports = 1).use { bus ->
+                solvers[0].solveWithLimits(SolveLimits(conflicts = 100))
+                val exported = bus.exported
+                exported `should be greater than` 1L
+                bus.importClauses(1) `should be equal to` 1
+                bus.dropped `should be equal to` exported - 1
+                bus.importClauses(1) `should be equal to` 0
+                bus.solve(conflictsPerRound = 100).`should be false`()
+                // Note: each solver imports at most one clause
+                (bus.imported <= solvers.size).`should be true`()
+            }
+        } finally {
+            solvers.forEach { it.close() }
+        }
+    }
+
+    private fun JCadical.declarePigeonhole(holes: Int) {
+        fun v(pigeon: Int, hole: Int) = pigeon * holes + hole + 1
+        for (p in 0..holes) {
+            addClause(IntArray(holes) { h -> v(p, h) })
+        }
+        for (h in 0 until holes) {
+            for (p in 0..holes) {
+                for (q in p + 1..holes) {
+                    addClause(-v(p, h), -v(q, h))
+                }
+            }
+        }
+    }
 }
@@ -1,11 +1,19 @@
 package com.github.lipen.satlib.solver.jni
 
+import com.github.lipen.satlib.jni.SolveLimits
 import com.github.lipen.satlib.test.`assumptions are supported`
+import com.github.lipen.satlib.test.`async solving`
 import com.github.lipen.satlib.test.`empty clause leads to UNSAT`
+import com.github.lipen.satlib.test.`many clauses`
+import com.github.lipen.satlib.test.`native cardinality encodings`
+import com.github.lipen.satlib.test.`projected model enumeration`
 import com.github.lipen.satlib.test.`simple SAT`
 import com.github.lipen.satlib.test.`simple UNSAT`
 import com.github.lipen.satlib.test.`solving after reset`
+import com.github.lipen.satlib.test.`solving with limits`
 import com.github.lipen.satlib.test.`solving with timeout`
+import org.amshove.kluent.`should be equal to`
+import org.amshove.kluent.`should be true`
 import org.junit.jupiter.api.Test
 import org.junit.jupiter.api.TestInstance
 
@@ -33,6 +41,11 @@ class CryptoMiniSatSolverTest {
         solver.`solving after reset`()
     }
 
+    @Test
+    fun `many clauses`() {
+        solver.`many clauses`()
+    }
+
     @Test
     fun `assumptions are supported`() {
         solver.`assumptions are supported`()
@@ -44,4 +57,42 @@ class CryptoMiniSatSolverTest {
             // no need to clear interrupt
         }
     }
+
+    @Test
+    fun `native cardinality encodings`() {
+        solver.`native cardinality encodings`()
+    }
+
+    @Test
+    fun `interleaved clauses are flushed in one batch`() {
+        with(solver) {
+            var prev = newLiteral()
+            addClause(prev)
+            repeat(100) {
+                val next = newLiteral()
+                addClause(-prev, next)
+                prev = next
+            }
+            clauseBuffer.numberOfFlushes `should be equal to` 0L
+            solve().`should be true`()
+            getModel()
+            getValue(prev).`should be true`()
+            clauseBuffer.numberOfFlushes `should be equal to` 1L
+        }
+    }
+
+    @Test
+    fun `projected model enumeration`() {
+        solver.`projected model enumeration`()
+    }
+
+    @Test
+    fun `async solving`() {
+        solver.`async solving`()
+    }
+
+    @Test
+    fun `solving with limits`() {
+        solver.`solving with limits`(listOf(SolveLimits.Kind.TIME, SolveLimits.Kind.CONFLICTS, SolveLimits.Kind.MEMORY)) { solveWithLimits(it) }
+    }
 }
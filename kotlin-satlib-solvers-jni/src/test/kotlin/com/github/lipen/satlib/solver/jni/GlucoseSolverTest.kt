@@ -1,11 +1,24 @@
 package com.github.lipen.satlib.solver.jni
 
+import com.github.lipen.satlib.jni.MaxSatEngine
+import com.github.lipen.satlib.jni.SolveLimits
 import com.github.lipen.satlib.test.`assumptions are supported`
+import com.github.lipen.satlib.test.`async solving`
 import com.github.lipen.satlib.test.`empty clause leads to UNSAT`
+import com.github.lipen.satlib.test.`many clauses`
+import com.github.lipen.satlib.test.`native cardinality encodings`
+import com.github.lipen.satlib.test.`projected model enumeration`
 import com.github.lipen.satlib.test.`simple SAT`
 import com.github.lipen.satlib.test.`simple UNSAT`
+import com.github.lipen.satlib.test.`solver forking`
 import com.github.lipen.satlib.test.`solving after reset`
+import com.github.lipen.satlib.test.`solving with limits`
 import com.github.lipen.satlib.test.`solving with timeout`
+import org.amshove.kluent.`should be equal to`
+import org.amshove.kluent.`should be false`
+import org.amshove.kluent.`should be true`
+import org.amshove.kluent.invoking
+import org.amshove.kluent.shouldThrow
 import org.junit.jupiter.api.Test
 import org.junit.jupiter.api.TestInstance
 
@@ -33,6 +46,11 @@ class GlucoseSolverTest {
         solver.`solving after reset`()
     }
 
+    @Test
+    fun `many clauses`() {
+        solver.`many clauses`()
+    }
+
     @Test
     fun `assumptions are supported`() {
         solver.`assumptions are supported`()
@@ -44,4 +62,119 @@ class GlucoseSolverTest {
             backend.clearInterrupt()
         }
     }
+
+    @Test
+    fun `native cardinality encodings`() {
+        solver.`native cardinality encodings`()
+    }
+
+    @Test
+    fun `interleaved clauses are flushed in one batch`() {
+        with(solver) {
+            var prev = newLiteral()
+            addClause(prev)
+            repeat(100) {
+                val next = newLiteral()
+                addClause(-prev, next)
+                prev = next
+            }
+            clauseBuffer.numberOfFlushes `should be equal to` 0L
+            solve().`should be true`()
+            getModel()
+            getValue(prev).`should be true`()
+            clauseBuffer.numberOfFlushes `should be equal to` 1L
+        }
+    }
+
+    @Test
+    fun `projected model enumeration`() {
+        solver.`projected model enumeration`()
+    }
+
+    @Test
+    fun `enumeration after simplifying solve`() {
+        with(solver) {
+            val x = newLiteral()
+            val y = newLiteral()
+            val z = newLiteral()
+            addClause(x, y)
+            addClause(-y, z)
+            backend.setFrozen(x, true)
+            backend.setFrozen(z, true)
+            solve().`should be true`()
+            backend.isEliminated(y).`should be true`()
+            invoking { countModels(intArrayOf(x, y)) } shouldThrow IllegalArgumentException::class
+            // Note: `y` is eliminated, so the models are projected onto `x | z`
+            countModels(intArrayOf(x, z)) `should be equal to` 3L
+            solve().`should be false`()
+        }
+    }
+
+    @Test
+    fun `solver forking`() {
+        solver.`solver forking`()
+    }
+
+    @Test
+    fun `async solving`() {
+        solver.`async solving`()
+    }
+
+    @Test
+    fun `solving with limits`() {
+        solver.`solving with limits`(SolveLimits.Kind.values().asList()) { solveWithLimits(it) }
+    }
+
+    @Test
+    fun `native maxsat`() {
+        with(solver) {
+            val a = newLiteral()
+            val b = newLiteral()
+            val c = newLiteral()
+            val d = newLiteral()
+            // At most one of a, b, c
+            backend.addClause(-a, -b)
+            backend.addClause(-a, -c)
+            backend.addClause(-b, -c)
+            backend.addClause(-a, -d)
+            backend.newMaxSat().use { maxsat ->
+                // Note: the distinct weights make the stratified search go through several levels
+                maxsat.addSoftLiteral(a, 4)
+                maxsat.addSoftLiteral(b, 3)
+                maxsat.addSoftLiteral(c, 2)
+                maxsat.addSoftClause(intArrayOf(d, b), 2)
+                // The only optimum is b (falsifying a and c), while a costs 3 + 2 + 2 and c costs 4 + 3
+                for (algorithm in MaxSatEngine.Algorithm.values()) {
+                    for (stratify in listOf(false, true)) {
+                        val result = maxsat.solve(algorithm, stratify)
+                        result.status `should be equal to` MaxSatEngine.Status.OPTIMUM
+                        result.cost `should be equal to` 6L
+                        result.lowerBound `should be equal to` 6L
+                        val model = maxsat.getModel()
+                        (!model[a] && model[b] && !model[c]).`should be true`()
+                    }
+                }
+            }
+        }
+    }
+
+    @Test
+    fun `native maxsat does not accumulate clauses`() {
+        with(solver) {
+            // No two neighbours in the chain are both true, so at most 3 of 6 literals
+            val xs = List(6) { newLiteral() }
+            for (i in 1 until xs.size) backend.addClause(-xs[i - 1], -xs[i])
+            val hard = backend.numberOfClauses
+            backend.newMaxSat().use { maxsat ->
+                for (x in xs) maxsat.addSoftLiteral(x, 1)
+                for (algorithm in MaxSatEngine.Algorithm.values()) {
+                    repeat(3) {
+                        maxsat.solve(algorithm).cost `should be equal to` 3L
+                        // The totalizers of each solve are retired once it is over
+                        backend.numberOfClauses `should be equal to` hard
+                    }
+                }
+            }
+        }
+    }
 }
@@ -0,0 +1,156 @@
+package com.github.lipen.satlib.solver.jni
+
+import com.github.lipen.satlib.jni.ClauseBuffer
+import com.github.lipen.satlib.jni.JCadical
+import com.github.lipen.satlib.jni.JCnf
+import com.github.lipen.satlib.jni.JCryptoMiniSat
+import com.github.lipen.satlib.jni.JGlucose
+import com.github.lipen.satlib.jni.JKissat
+import com.github.lipen.satlib.jni.JMiniSat
+import com.github.lipen.satlib.jni.JPortfolio
+import com.github.lipen.satlib.solver.FormulaHash
+import org.amshove.kluent.`should be equal to`
+import org.amshove.kluent.`should be false`
+import org.amshove.kluent.`should be true`
+import org.amshove.kluent.invoking
+import org.amshove.kluent.shouldThrow
+import org.junit.jupiter.api.Test
+import org.junit.jupiter.api.TestInstance
+import java.nio.ByteBuffer
+
+@TestInstance(TestInstance.Lifecycle.PER_METHOD)
+class JCnfTest {
+    // The only model is x1 = false, x2 = true, x3 = true (x4 is free)
+    private val clauses = listOf(listOf(1, 2), listOf(-1), listOf(-2, 3), listOf(3, 4, -1))
+
+    private fun JCnf.fill() {
+        addClause(*clauses[0].toIntArray())
+        // Note: the trailing garbage beyond the size is ignored
+        addClauses(intArrayOf(-1, 0, 42), size = 2)
+        val buffer = ClauseBuffer(capacity = 2) { data, size -> addClauses(data, size) }
+        for (clause in clauses.drop(2)) buffer.addClause(clause)
+        buffer.flush()
+    }
+
+    // The unsatisfiable formula is detected by MiniSat and Glucose while loading
+    private fun JCnf.fillUnsat() {
+        fill()
+        addClause(-3)
+    }
+
+    private fun checkModel(getValue: (Int) -> Boolean) {
+        getValue(1).`should be false`()
+        getValue(2).`should be true`()
+        getValue(3).`should be true`()
+    }
+
+    @Test
+    fun `filling and hashing`() {
+        JCnf().use { cnf ->
+            cnf.fill()
+            cnf.numberOfClauses `should be equal to` 4
+            cnf.maxVariable `should be equal to` 4
+            cnf.size `should be equal to` 12
+            cnf.getLiterals().toList() `should be equal to` clauses.flatMap { it + 0 }
+            cnf.hash `should be equal to` clauses.sumOf { FormulaHash.clause(it) }
+            // Note: the hash does not depend on the order of clauses and literals
+            JCnf().use { other ->
+                for (clause in clauses.reversed()) other.addClause(*clause.reversed().toIntArray())
+                other.hash `should be equal to` cnf.hash
+            }
+            invoking { cnf.addClauses(ByteBuffer.allocate(16), 4) } shouldThrow IllegalArgumentException::class
+            cnf.clear()
+            cnf.numberOfClauses `should be equal to` 0
+            cnf.maxVariable `should be equal to` 0
+            cnf.size `should be equal to` 0
+            cnf.hash `should be equal to` 0L
+        }
+    }
+
+    @Test
+    fun `loading into MiniSat`() {
+        JCnf().use { cnf ->
+            cnf.fill()
+            JMiniSat().use { backend ->
+                backend.loadCnf(cnf).`should be true`()
+                backend.numberOfVariables `should be equal to` 4
+                backend.solve().`should be true`()
+                checkModel(backend::getValue)
+            }
+        }
+        JCnf().use { cnf ->
+            cnf.fillUnsat()
+            JMiniSat().use { backend ->
+                backend.loadCnf(cnf).`should be false`()
+                backend.okay().`should be false`()
+            }
+        }
+    }
+
+    @Test
+    fun `loading into Glucose`() {
+        JCnf().use { cnf ->
+            cnf.fill()
+            JGlucose().use { backend ->
+                backend.loadCnf(cnf).`should be true`()
+                backend.solve().`should be true`()
+                checkModel(backend::getValue)
+            }
+        }
+        JCnf().use { cnf ->
+            cnf.fillUnsat()
+            JGlucose().use { backend ->
+                backend.loadCnf(cnf).`should be false`()
+                backend.okay().`should be false`()
+            }
+        }
+    }
+
+    @Test
+    fun `loading into CaDiCaL`() {
+        JCnf().use { cnf ->
+            cnf.fill()
+            JCadical().use { backend ->
+                backend.loadCnf(cnf)
+                backend.solve().`should be true`()
+                checkModel(backend::getValue)
+            }
+        }
+    }
+
+    @Test
+    fun `loading into CryptoMiniSat`() {
+        JCnf().use { cnf ->
+            cnf.fill()
+            JCryptoMiniSat().use { backend ->
+                backend.loadCnf(cnf)
+                backend.solve().`should be true`()
+                checkModel(backend::getValue)
+            }
+        }
+    }
+
+    @Test
+    fun `loading into Kissat`() {
+        JCnf().use { cnf ->
+            cnf.fill()
+            JKissat().use { backend ->
+                backend.loadCnf(cnf)
+                backend.solve() `should be equal to` true
+                checkModel(backend::getValue)
+            }
+        }
+    }
+
+    @Test
+    fun `loading into portfolio`() {
+        JCnf().use { cnf ->
+            cnf.fill()
+            JPortfolio(JPortfolio.Backend.MINISAT, JPortfolio.Backend.CADICAL).use { backend ->
+                backend.loadCnf(cnf).`should be true`()
+                backend.solve() `should be equal to` true
+                checkModel(backend::getValue)
+            }
+        }
+    }
+}
@@ -0,0 +1,85 @@
+package com.github.lipen.satlib.solver.jni
+
+import com.github.lipen.satlib.jni.SolveLimits
+import com.github.lipen.satlib.solver.addClause
+import com.github.lipen.satlib.solver.solve
+import com.github.lipen.satlib.test.`empty clause leads to UNSAT`
+import com.github.lipen.satlib.test.`simple SAT`
+import com.github.lipen.satlib.test.`simple UNSAT`
+import com.github.lipen.satlib.test.`solving after reset`
+import com.github.lipen.satlib.test.`solving with limits`
+import com.github.lipen.satlib.test.`solving with timeout`
+import org.amshove.kluent.`should be false`
+import org.amshove.kluent.`should be true`
+import org.junit.jupiter.api.Test
+import org.junit.jupiter.api.TestInstance
+import org.junit.jupiter.api.assertThrows
+
+@TestInstance(TestInstance.Lifecycle.PER_METHOD)
+class KissatSolverTest {
+    private val solver = KissatSolver()
+
+    @Test
+    fun `simple SAT`() {
+        solver.`simple SAT`()
+    }
+
+    @Test
+    fun `simple UNSAT`() {
+        solver.`simple UNSAT`()
+    }
+
+    @Test
+    fun `empty clause leads to UNSAT`() {
+        solver.`empty clause leads to UNSAT`()
+    }
+
+    @Test
+    fun `solving after reset`() {
+        solver.`solving after reset`()
+    }
+
+    @Test
+    fun `solving with timeout`() {
+        solver.`solving with timeout`(continueSolving = false)
+    }
+
+    @Test
+    fun `incremental solving is not supported`() {
+        with(solver) {
+            val x = newLiteral()
+            addClause(x)
+            solve().`should be true`()
+            // Note: unlike the JNA binding, this does not halt the process
+            assertThrows<IllegalStateException> { solve() }
+        }
+    }
+
+    @Test
+    fun `assumptions are not supported`() {
+        with(solver) {
+            val x = newLiteral()
+            addClause(x)
+            assertThrows<UnsupportedOperationException> { solve(x) }
+        }
+    }
+
+    @Test
+    fun `async solving`() {
+        with(solver) {
+            val x = newLiteral()
+            val y = newLiteral()
+            addClause(x, y)
+            addClause(-x)
+            solveAsync().get().`should be true`()
+            getValue(x).`should be false`()
+            getValue(y).`should be true`()
+        }
+    }
+
+    @Test
+    fun `solving with limits`() {
+        // Note: Kissat is not incremental, so only a single limit can be checked
+        solver.`solving with limits`(listOf(SolveLimits.Kind.TIME)) { solveWithLimits(it) }
+    }
+}
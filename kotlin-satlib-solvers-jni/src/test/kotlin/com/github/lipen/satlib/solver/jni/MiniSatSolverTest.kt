@@ -1,13 +1,37 @@
 package com.github.lipen.satlib.solver.jni
 
+import com.github.lipen.satlib.jni.DimacsInfo
+import com.github.lipen.satlib.jni.JMiniSat
+import com.github.lipen.satlib.jni.PreprocessCache
+import com.github.lipen.satlib.jni.SolveFuture
+import com.github.lipen.satlib.jni.SolveLimits
+import com.github.lipen.satlib.solver.LruSolveCache
+import com.github.lipen.satlib.solver.addClause
+import com.github.lipen.satlib.solver.solve
 import com.github.lipen.satlib.test.`assumptions are supported`
+import com.github.lipen.satlib.test.`async solving`
 import com.github.lipen.satlib.test.`empty clause leads to UNSAT`
+import com.github.lipen.satlib.test.`many clauses`
+import com.github.lipen.satlib.test.`native cardinality encodings`
+import com.github.lipen.satlib.test.`projected model enumeration`
 import com.github.lipen.satlib.test.`simple SAT`
 import com.github.lipen.satlib.test.`simple UNSAT`
+import com.github.lipen.satlib.test.`solver forking`
 import com.github.lipen.satlib.test.`solving after reset`
+import com.github.lipen.satlib.test.`solving with limits`
 import com.github.lipen.satlib.test.`solving with timeout`
+import com.github.lipen.satlib.test.declare_sgen_n120_sat
+import org.amshove.kluent.`should be equal to`
+import org.amshove.kluent.`should be false`
+import org.amshove.kluent.`should be greater than`
+import org.amshove.kluent.`should be null`
+import org.amshove.kluent.`should be true`
+import org.amshove.kluent.invoking
+import org.amshove.kluent.shouldThrow
 import org.junit.jupiter.api.Test
 import org.junit.jupiter.api.TestInstance
+import java.io.IOException
+import java.nio.file.Files
 
 @TestInstance(TestInstance.Lifecycle.PER_METHOD)
 class MiniSatSolverTest {
@@ -33,6 +57,11 @@ class MiniSatSolverTest {
         solver.`solving after reset`()
     }
 
+    @Test
+    fun `many clauses`() {
+        solver.`many clauses`()
+    }
+
     @Test
     fun `assumptions are supported`() {
         solver.`assumptions are supported`()
@@ -44,4 +73,300 @@ class MiniSatSolverTest {
             backend.clearInterrupt()
         }
     }
+
+    @Test
+    fun `native cardinality encodings`() {
+        solver.`native cardinality encodings`()
+    }
+
+    @Test
+    fun `interleaved clauses are flushed in one batch`() {
+        with(solver) {
+            var prev = newLiteral()
+            addClause(prev)
+            repeat(100) {
+                val next = newLiteral()
+                addClause(-prev, next)
+                prev = next
+            }
+            clauseBuffer.numberOfFlushes `should be equal to` 0L
+            solve().`should be true`()
+            getModel()
+            getValue(prev).`should be true`()
+            clauseBuffer.numberOfFlushes `should be equal to` 1L
+        }
+    }
+
+    @Test
+    fun `projected model enumeration`() {
+        solver.`projected model enumeration`()
+    }
+
+    @Test
+    fun `enumeration after simplifying solve`() {
+        with(solver) {
+            val x = newLiteral()
+            val y = newLiteral()
+            val z = newLiteral()
+            addClause(x, y)
+            addClause(-y, z)
+            backend.setFrozen(x, true)
+            backend.setFrozen(z, true)
+            solve().`should be true`()
+            backend.isEliminated(y).`should be true`()
+            invoking { countModels(intArrayOf(x, y)) } shouldThrow IllegalArgumentException::class
+            // Note: `y` is eliminated, so the models are projected onto `x | z`
+            countModels(intArrayOf(x, z)) `should be equal to` 3L
+            solve().`should be false`()
+        }
+    }
+
+    @Test
+    fun `solver forking`() {
+        solver.`solver forking`()
+    }
+
+    @Test
+    fun `async solving`() {
+        solver.`async solving`()
+    }
+
+    @Test
+    fun `async solves wait for a free worker`() {
+        invoking { SolveFuture.maxWorkers = 0 } shouldThrow IllegalArgumentException::class
+        val maxWorkers = SolveFuture.maxWorkers
+        SolveFuture.maxWorkers = 1
+        try {
+            val solvers = List(3) { MiniSatSolver() }
+            val futures = solvers.map { s ->
+                val x = s.newLiteral()
+                s.addClause(x)
+                s.solveAsync()
+            }
+            for (future in futures) future.get().`should be true`()
+            solvers.forEach { it.close() }
+        } finally {
+            SolveFuture.maxWorkers = maxWorkers
+        }
+    }
+
+    @Test
+    fun `solving with limits`() {
+        solver.`solving with limits`(SolveLimits.Kind.values().asList()) { solveWithLimits(it) }
+    }
+
+    @Test
+    fun `limited solve keeps the budgets and the interrupt of the user`() {
+        with(solver) {
+            val x = newLiteral()
+            addClause(x)
+            backend.setConfBudget(0)
+            backend.solveLimited(IntArray(0)).`should be null`()
+            solveWithLimits(SolveLimits(conflicts = 1000)).value `should be equal to` true
+            backend.solveLimited(IntArray(0)).`should be null`()
+            backend.budgetOff()
+            backend.interrupt()
+            solveWithLimits(SolveLimits(timeMillis = 1)).value.`should be null`()
+            backend.solveLimited(IntArray(0)).`should be null`()
+            backend.clearInterrupt()
+            backend.solveLimited(IntArray(0)) `should be equal to` true
+        }
+    }
+
+    @Test
+    fun `statistics snapshot`() {
+        with(solver) {
+            val x = newLiteral()
+            val y = newLiteral()
+            addClause(x, y)
+            val before = backend.stats()
+            solve().`should be true`()
+            val stats = backend.stats()
+            stats.variables `should be equal to` 2L
+            stats.solves `should be equal to` 1L
+            stats.solveTimeNanos `should be greater than` 0L
+            (stats - before).solves `should be equal to` 1L
+        }
+    }
+
+    @Test
+    fun `live statistics without progress stream`() {
+        with(solver) {
+            declare_sgen_n120_sat()
+            val future = backend.solveAsync()
+            try {
+                Thread.sleep(200)
+                val stats = backend.stats()
+                stats.conflicts `should be greater than` 0L
+                stats.decisions `should be greater than` 0L
+                // Note: the sizes of the formula are not reported during the solve
+                stats.clauses `should be equal to` -1L
+            } finally {
+                future.cancel(true)
+            }
+        }
+    }
+
+    @Test
+    fun `progress stream`() {
+        with(solver) {
+            declare_sgen_n120_sat()
+            backend.startProgress(conflictsStep = 100).use { progress ->
+                solveWithLimits(SolveLimits(timeMillis = 100))
+                val records = progress.drain()
+                records.isNotEmpty().`should be true`()
+                records.zipWithNext { a, b -> b.conflicts - a.conflicts >= 100 && a.timeNanos < b.timeNanos }
+                    .all { it }.`should be true`()
+            }
+        }
+    }
+
+    @Test
+    fun `progress stream does not change the search`() {
+        val decisions = listOf(false, true).map { withProgress ->
+            MiniSatSolver().use { other ->
+                other.declare_sgen_n120_sat()
+                val progress = if (withProgress) other.backend.startProgress(conflictsStep = 10) else null
+                other.solveWithLimits(SolveLimits(conflicts = 2000)).value.`should be null`()
+                progress?.close()
+                other.backend.numberOfDecisions
+            }
+        }
+        decisions[1] `should be equal to` decisions[0]
+    }
+
+    @Test
+    fun `solve cache`() {
+        with(solver) {
+            val cache = LruSolveCache(capacity = 16)
+            solveCache = cache
+            val x = newLiteral()
+            val y = newLiteral()
+            addClause(-x, -y)
+            solve(x, y).`should be false`()
+            solve(x).`should be true`()
+            cache.size `should be equal to` 2
+            // Note: the repeated solves are answered from the cache, even with the assumptions reordered
+            solve(y, x).`should be false`()
+            solve(x).`should be true`()
+            getValue(y).`should be false`()
+            cache.size `should be equal to` 2
+            // Note: the unknown result (here, the backend is interrupted directly) is not cached
+            backend.interrupt()
+            solve(-x).`should be false`()
+            cache.size `should be equal to` 2
+            backend.clearInterrupt()
+            solve(-x).`should be true`()
+            cache.size `should be equal to` 3
+            addClause(x, y)
+            // Note: the formula hash does not depend on the order of clauses and literals
+            MiniSatSolver().use { other ->
+                other.addClause(y, x)
+                other.addClause(-y, -x)
+                other.formulaHash `should be equal to` formulaHash
+            }
+        }
+    }
+
+    @Test
+    fun `preprocess-once cache`() {
+        val directory = Files.createTempDirectory("satlib-preprocess").toFile()
+        try {
+            // x1 is defined as x2 & x3, so it is eliminated unless frozen
+            val cnf = directory.resolve("input.cnf")
+            cnf.writeText("p cnf 4 4\n-1 2 0\n-1 3 0\n1 -2 -3 0\n2 4 0\n")
+            val cache = PreprocessCache(directory.resolve("cache"))
+            val frozen = intArrayOf(2)
+            for (hit in listOf(false, true, false)) {
+                JMiniSat().use { backend ->
+                    backend.loadDimacsPreprocessed(cnf, cache, frozen) `should be equal to` hit
+                    backend.solve(do_simp = false).`should be true`()
+                    val model = backend.getModel()
+                    (model[1] == (model[2] && model[3])).`should be true`()
+                    (model[2] || model[4]).`should be true`()
+                }
+                if (hit) {
+                    // The corrupted artifact (the last word is out of range) is rejected and rebuilt
+                    val artifact = cache.directory.listFiles()!!.single()
+                    val bytes = artifact.readBytes()
+                    bytes.fill(0xFF.toByte(), bytes.size - 4, bytes.size)
+                    artifact.writeBytes(bytes)
+                }
+            }
+        } finally {
+            directory.deleteRecursively()
+        }
+    }
+
+    @Test
+    fun `loading DIMACS`() {
+        val directory = Files.createTempDirectory("satlib-dimacs").toFile()
+        try {
+            // x5 is only declared in the header, the second clause is split across lines,
+            // and everything after '%' (as in SATLIB) is ignored
+            val cnf = directory.resolve("input.cnf")
+            cnf.writeText("c comment\np cnf 5 3\n1 -2 0\nc comment inside\n2 3\n  -1 0\n-3 0\n%\n0\n")
+            JMiniSat().use { backend ->
+                val info = backend.loadDimacs(cnf, threads = 2)
+                info `should be equal to` DimacsInfo(numberOfVariables = 5, numberOfClauses = 3, declaredClauses = 3)
+                info.isClauseCountMismatch.`should be false`()
+                backend.numberOfVariables `should be equal to` 5
+                backend.solve().`should be true`()
+                val model = backend.getModel()
+                (model[1] == model[2]).`should be true`()
+                model[3].`should be false`()
+            }
+            // The clause count mismatch and the UNSAT found while loading are reported
+            cnf.writeText("p cnf 1 1\n1 0\n-1 0\n")
+            JMiniSat().use { backend ->
+                val info = backend.loadDimacs(cnf)
+                info.isClauseCountMismatch.`should be true`()
+                info.unsatisfiable.`should be true`()
+                backend.okay().`should be false`()
+            }
+            // Variables above Int.MAX_VALUE are rejected
+            cnf.writeText("p cnf 1 1\n2147483648 0\n")
+            JMiniSat().use { backend ->
+                invoking { backend.loadDimacs(cnf) } shouldThrow IOException::class
+            }
+            // Numbers must be separated by whitespace
+            cnf.writeText("p cnf 2 1\n1-2 0\n")
+            JMiniSat().use { backend ->
+                invoking { backend.loadDimacs(cnf) } shouldThrow IOException::class
+            }
+        } finally {
+            directory.deleteRecursively()
+        }
+    }
+
+    @Test
+    fun `persistent assumption set`() {
+        with(solver) {
+            val x = newLiteral()
+            val y = newLiteral()
+            addClause(-x, -y)
+            backend.newAssumptionSet().use { set ->
+                set.add(x, y, x) `should be equal to` 2
+                backend.solve(set).`should be false`()
+                set.remove(y) `should be equal to` 1
+                set.literals.toList() `should be equal to` listOf(x)
+                backend.solve(set).`should be true`()
+                backend.getValue(x).`should be true`()
+            }
+        }
+    }
+
+    @Test
+    fun `core extraction and minimization`() {
+        with(solver) {
+            val x = newLiteral()
+            val y = newLiteral()
+            val z = newLiteral()
+            addClause(-x, -y)
+            backend.solve(intArrayOf(x, y, z)).`should be false`()
+            backend.getCore().sorted() `should be equal to` listOf(x, y)
+            backend.minimizeCore(intArrayOf(z, x, y))!!.sorted() `should be equal to` listOf(x, y)
+            backend.minimizeCore(intArrayOf(x, z)).`should be null`()
+        }
+    }
 }
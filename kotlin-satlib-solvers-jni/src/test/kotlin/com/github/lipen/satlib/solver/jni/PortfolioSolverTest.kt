@@ -0,0 +1,96 @@
+package com.github.lipen.satlib.solver.jni
+
+import com.github.lipen.satlib.jni.JPortfolio
+import com.github.lipen.satlib.solver.addClause
+import com.github.lipen.satlib.solver.solve
+import com.github.lipen.satlib.test.`assumptions are supported`
+import com.github.lipen.satlib.test.`empty clause leads to UNSAT`
+import com.github.lipen.satlib.test.`many clauses`
+import com.github.lipen.satlib.test.`native cardinality encodings`
+import com.github.lipen.satlib.test.`simple SAT`
+import com.github.lipen.satlib.test.`simple UNSAT`
+import com.github.lipen.satlib.test.`solving after reset`
+import com.github.lipen.satlib.test.`solving with timeout`
+import org.amshove.kluent.`should be false`
+import org.amshove.kluent.`should be true`
+import org.junit.jupiter.api.Test
+import org.junit.jupiter.api.TestInstance
+
+@TestInstance(TestInstance.Lifecycle.PER_METHOD)
+class PortfolioSolverTest {
+    private val solver = PortfolioSolver()
+
+    @Test
+    fun `simple SAT`() {
+        solver.`simple SAT`()
+    }
+
+    @Test
+    fun `simple UNSAT`() {
+        solver.`simple UNSAT`()
+    }
+
+    @Test
+    fun `empty clause leads to UNSAT`() {
+        solver.`empty clause leads to UNSAT`()
+    }
+
+    @Test
+    fun `solving after reset`() {
+        solver.`solving after reset`()
+    }
+
+    @Test
+    fun `many clauses`() {
+        solver.`many clauses`()
+    }
+
+    @Test
+    fun `assumptions are supported`() {
+        solver.`assumptions are supported`()
+    }
+
+    @Test
+    fun `solving with timeout`() {
+        solver.`solving with timeout` {
+            backend.clearInterrupt()
+        }
+    }
+
+    @Test
+    fun `native cardinality encodings`() {
+        solver.`native cardinality encodings`()
+    }
+
+    @Test
+    fun `cube and conquer`() {
+        PortfolioSolver(JPortfolio(JPortfolio.Backend.CADICAL, 4)).use { solver ->
+            // Pigeonhole principle: 5 pigeons do not fit into 4 holes
+            val p = List(5) { List(4) { solver.newLiteral() } }
+            for (i in 0 until 5) {
+                solver.addClause(p[i])
+            }
+            for (j in 0 until 4) {
+                for (a in 0 until 5) for (b in a + 1 until 5) {
+                    solver.addClause(-p[a][j], -p[b][j])
+                }
+            }
+            solver.cubeDepth = 4
+            solver.solve().`should be false`()
+
+            // Same, with explicitly chosen splitting variables
+            solver.cubeVariables = listOf(p[0][0], p[1][1], p[2][2])
+            solver.solve().`should be false`()
+        }
+        PortfolioSolver(JPortfolio(JPortfolio.Backend.MINISAT, 3)).use { solver ->
+            val xs = List(8) { solver.newLiteral() }
+            for ((a, b) in xs.zipWithNext()) {
+                solver.addClause(-a, b)
+            }
+            solver.cubeVariables = xs.take(3)
+            solver.solve(xs.first()).`should be true`()
+            solver.getValues(xs.toIntArray()).all { it }.`should be true`()
+            solver.solve(xs.first(), -xs.last()).`should be false`()
+        }
+    }
+}
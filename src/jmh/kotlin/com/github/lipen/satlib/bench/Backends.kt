@@ -0,0 +1,102 @@
+package com.github.lipen.satlib.bench
+
+import com.github.lipen.satlib.jni.JCadical
+import com.github.lipen.satlib.jni.JCryptoMiniSat
+import com.github.lipen.satlib.jni.JGlucose
+import com.github.lipen.satlib.jni.JMiniSat
+import com.github.lipen.satlib.solver.DimacsStreamSolver
+import com.github.lipen.satlib.solver.Solver
+import com.github.lipen.satlib.solver.jni.CadicalSolver
+import com.github.lipen.satlib.solver.jni.CryptoMiniSatSolver
+import com.github.lipen.satlib.solver.jni.GlucoseSolver
+import com.github.lipen.satlib.solver.jni.MiniSatSolver
+import com.github.lipen.satlib.solver.jna.KissatSolver as JnaKissatSolver
+
+/**
+ * Backends compared through the generic [Solver] interface.
+ *
+ * Note: the command of [DimacsStream] is taken from the `satlib.bench.dimacs` system property
+ * (`cryptominisat5` by default).
+ */
+enum class Backend(
+    val supportsAssumptions: Boolean = true,
+) {
+    MiniSat {
+        override fun create(): Solver = MiniSatSolver()
+    },
+    Glucose {
+        override fun create(): Solver = GlucoseSolver()
+    },
+    Cadical {
+        override fun create(): Solver = CadicalSolver()
+    },
+    CryptoMiniSat {
+        override fun create(): Solver = CryptoMiniSatSolver()
+    },
+    KissatJna(supportsAssumptions = false) {
+        override fun create(): Solver = JnaKissatSolver()
+    },
+    DimacsStream(supportsAssumptions = false) {
+        override fun create(): Solver = DimacsStreamSolver(System.getProperty("satlib.bench.dimacs", "cryptominisat5"))
+    };
+
+    abstract fun create(): Solver
+}
+
+/**
+ * Raw JNI bindings, compared by the binding style (one call per clause vs bulk).
+ */
+enum class Binding {
+    MiniSat {
+        override fun create(): Raw = object : Raw {
+            val solver = JMiniSat()
+            override fun declare(numberOfVariables: Int) = repeat(numberOfVariables) { solver.newVariable() }
+            override fun addClause(literals: IntArray) {
+                solver.addClause_(literals)
+            }
+            override fun addClauses(literals: IntArray) {
+                solver.addClauses(literals)
+            }
+            override fun close() = solver.close()
+        }
+    },
+    Glucose {
+        override fun create(): Raw = object : Raw {
+            val solver = JGlucose()
+            override fun declare(numberOfVariables: Int) = repeat(numberOfVariables) { solver.newVariable() }
+            override fun addClause(literals: IntArray) {
+                solver.addClause_(literals)
+            }
+            override fun addClauses(literals: IntArray) {
+                solver.addClauses(literals)
+            }
+            override fun close() = solver.close()
+        }
+    },
+    Cadical {
+        override fun create(): Raw = object : Raw {
+            val solver = JCadical()
+            override fun declare(numberOfVariables: Int) {} // variables are implicit
+            override fun addClause(literals: IntArray) = solver.addClause(literals)
+            override fun addClauses(literals: IntArray) = solver.addClauses(literals)
+            override fun close() = solver.close()
+        }
+    },
+    CryptoMiniSat {
+        override fun create(): Raw = object : Raw {
+            val solver = JCryptoMiniSat()
+            override fun declare(numberOfVariables: Int) = repeat(numberOfVariables) { solver.newVariable() }
+            override fun addClause(literals: IntArray) = solver.addClause(literals)
+            override fun addClauses(literals: IntArray) = solver.addClauses(literals)
+            override fun close() = solver.close()
+        }
+    };
+
+    abstract fun create(): Raw
+
+    interface Raw : AutoCloseable {
+        fun declare(numberOfVariables: Int)
+        fun addClause(literals: IntArray)
+        fun addClauses(literals: IntArray)
+    }
+}
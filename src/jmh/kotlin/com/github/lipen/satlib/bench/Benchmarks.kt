@@ -0,0 +1,402 @@
+@file:Suppress("ClassName")
+
+package com.github.lipen.satlib.bench
+
+import com.github.lipen.satlib.card.declareTotalizer
+import com.github.lipen.satlib.jni.JCadical
+import com.github.lipen.satlib.jni.JCadicalShare
+import com.github.lipen.satlib.op.iffAnd
+import com.github.lipen.satlib.op.implyOr
+import com.github.lipen.satlib.solver.Solver
+import com.github.lipen.satlib.solver.addClause
+import com.github.lipen.satlib.solver.solve
+import org.openjdk.jmh.annotations.Benchmark
+import org.openjdk.jmh.annotations.BenchmarkMode
+import org.openjdk.jmh.annotations.Fork
+import org.openjdk.jmh.annotations.Level
+import org.openjdk.jmh.annotations.Measurement
+import org.openjdk.jmh.annotations.Mode
+import org.openjdk.jmh.annotations.OutputTimeUnit
+import org.openjdk.jmh.annotations.Param
+import org.openjdk.jmh.annotations.Scope
+import org.openjdk.jmh.annotations.Setup
+import org.openjdk.jmh.annotations.State
+import org.openjdk.jmh.annotations.TearDown
+import org.openjdk.jmh.annotations.Warmup
+import org.openjdk.jmh.infra.Blackhole
+import java.util.concurrent.TimeUnit
+import kotlin.random.Random
+
+// Note: all suites use a fresh solver per invocation where the measured operation changes its state,
+//  hence the `SingleShotTime` mode with many iterations (see also `Benchmarks.kt` in the `jni` module).
+
+/**
+ * Clause ingestion throughput via the generic [Solver] interface, by the clause length.
+ */
+@BenchmarkMode(Mode.SingleShotTime)
+@Warmup(iterations = 10)
+@Measurement(iterations = 20)
+@Fork(1)
+@OutputTimeUnit(TimeUnit.MILLISECONDS)
+@State(Scope.Thread)
+open class Bench_ingestion {
+    @Param
+    lateinit var backend: Backend
+
+    @Param("2", "3", "5", "10", "30")
+    var length: Int = 0
+
+    @Param("100000")
+    var clauses: Int = 0
+
+    lateinit var instance: Instance
+    lateinit var solver: Solver
+
+    @Setup(Level.Trial)
+    fun generate() {
+        val n = 10_000
+        instance = randomKSat(n, length, clauses.toDouble() / n)
+    }
+
+    @Setup(Level.Invocation)
+    fun setup() {
+        solver = backend.create()
+        repeat(instance.numberOfVariables) { solver.newLiteral() }
+    }
+
+    @TearDown(Level.Invocation)
+    fun teardown() {
+        solver.close()
+    }
+
+    @Benchmark
+    fun addClauses() {
+        for (clause in instance.clauses) {
+            solver.addClause(clause)
+        }
+    }
+}
+
+/**
+ * Encoding throughput of the small gates (see `Ops.kt`), which produce mostly binary and ternary clauses,
+ * added via the fixed-arity [Solver.addClause] overloads and pooled clause builders.
+ */
+@BenchmarkMode(Mode.SingleShotTime)
+@Warmup(iterations = 10)
+@Measurement(iterations = 20)
+@Fork(1)
+@OutputTimeUnit(TimeUnit.MILLISECONDS)
+@State(Scope.Thread)
+open class Bench_gates {
+    @Param
+    lateinit var backend: Backend
+
+    @Param("100000")
+    var gates: Int = 0
+
+    lateinit var solver: Solver
+
+    @Setup(Level.Invocation)
+    fun setup() {
+        solver = backend.create()
+    }
+
+    @TearDown(Level.Invocation)
+    fun teardown() {
+        solver.close()
+    }
+
+    @Benchmark
+    fun encode() {
+        var prev = solver.newLiteral()
+        repeat(gates) {
+            val a = solver.newLiteral()
+            val b = solver.newLiteral()
+            val gate = solver.newLiteral()
+            solver.iffAnd(gate, prev, a, b)
+            solver.implyOr(gate, a, b)
+            prev = gate
+        }
+    }
+}
+
+/**
+ * Clause ingestion throughput via the raw JNI bindings, by the clause length and the binding style:
+ * `clause` makes a native call per clause, `bulk` passes all the clauses at once (zero-terminated).
+ */
+@BenchmarkMode(Mode.SingleShotTime)
+@Warmup(iterations = 10)
+@Measurement(iterations = 20)
+@Fork(1)
+@OutputTimeUnit(TimeUnit.MILLISECONDS)
+@State(Scope.Thread)
+open class Bench_ingestionRaw {
+    @Param
+    lateinit var binding: Binding
+
+    @Param("clause", "bulk")
+    lateinit var style: String
+
+    @Param("2", "3", "5", "10", "30")
+    var length: Int = 0
+
+    @Param("100000")
+    var clauses: Int = 0
+
+    lateinit var instance: Instance
+    lateinit var literals: IntArray
+    lateinit var raw: Binding.Raw
+
+    @Setup(Level.Trial)
+    fun generate() {
+        val n = 10_000
+        instance = randomKSat(n, length, clauses.toDouble() / n)
+        literals = instance.toZeroTerminated()
+    }
+
+    @Setup(Level.Invocation)
+    fun setup() {
+        raw = binding.create()
+        raw.declare(instance.numberOfVariables)
+    }
+
+    @TearDown(Level.Invocation)
+    fun teardown() {
+        raw.close()
+    }
+
+    @Benchmark
+    fun addClauses() {
+        when (style) {
+            "clause" -> for (clause in instance.clauses) raw.addClause(clause)
+            "bulk" -> raw.addClauses(literals)
+            else -> error("Bad style: $style")
+        }
+    }
+}
+
+/**
+ * Latency of incremental solves under random assumptions, on the same (already loaded) formula.
+ */
+@BenchmarkMode(Mode.AverageTime)
+@Warmup(iterations = 5, time = 1)
+@Measurement(iterations = 10, time = 1)
+@Fork(1)
+@OutputTimeUnit(TimeUnit.MICROSECONDS)
+@State(Scope.Thread)
+open class Bench_incremental {
+    // Note: JNA Kissat and DIMACS streaming do not support assumptions
+    @Param("MiniSat", "Glucose", "Cadical", "CryptoMiniSat")
+    lateinit var backend: Backend
+
+    @Param("RANDOM_3SAT:150", "PIGEONHOLE:7", "CARDINALITY:100")
+    lateinit var family: String
+
+    @Param("1", "10")
+    var assumptions: Int = 0
+
+    lateinit var solver: Solver
+    lateinit var cubes: List<IntArray>
+    var index: Int = 0
+
+    @Setup(Level.Trial)
+    fun setup() {
+        check(backend.supportsAssumptions) { "$backend does not support assumptions" }
+        val (name, size) = family.split(":")
+        val instance = Family.valueOf(name).generate(size.toInt())
+        solver = backend.create()
+        instance.addTo(solver)
+        val random = Random(42)
+        cubes = List(1024) {
+            IntArray(assumptions) {
+                val v = random.nextInt(1, instance.numberOfVariables + 1)
+                if (random.nextBoolean()) v else -v
+            }
+        }
+        solver.solve() // the first solve also includes the preprocessing
+    }
+
+    @TearDown(Level.Trial)
+    fun teardown() {
+        solver.close()
+    }
+
+    @Benchmark
+    fun solve(): Boolean {
+        val cube = cubes[index]
+        index = (index + 1) % cubes.size
+        return solver.solve(cube)
+    }
+}
+
+/**
+ * Model extraction after a satisfiable solve, by the number of variables.
+ */
+@BenchmarkMode(Mode.AverageTime)
+@Warmup(iterations = 5, time = 1)
+@Measurement(iterations = 10, time = 1)
+@Fork(1)
+@OutputTimeUnit(TimeUnit.MICROSECONDS)
+@State(Scope.Thread)
+open class Bench_model {
+    @Param
+    lateinit var backend: Backend
+
+    @Param("1000", "10000", "100000")
+    var n: Int = 0
+
+    lateinit var solver: Solver
+
+    @Setup(Level.Trial)
+    fun setup() {
+        solver = backend.create()
+        // Random 3-SAT far below the threshold is trivially satisfiable, yet has a non-trivial model
+        randomKSat(n, 3, 2.0).addTo(solver)
+        check(solver.solve()) { "Instance must be SAT" }
+    }
+
+    @TearDown(Level.Trial)
+    fun teardown() {
+        solver.close()
+    }
+
+    @Benchmark
+    fun getModel(bh: Blackhole) {
+        bh.consume(solver.getModel())
+    }
+}
+
+/**
+ * Cost of [Solver.reset] and [Solver.close] of a solver holding a formula.
+ */
+@BenchmarkMode(Mode.SingleShotTime)
+@Warmup(iterations = 10)
+@Measurement(iterations = 20)
+@Fork(1)
+@OutputTimeUnit(TimeUnit.MICROSECONDS)
+@State(Scope.Thread)
+open class Bench_lifecycle {
+    @Param
+    lateinit var backend: Backend
+
+    @Param("1000", "100000")
+    var n: Int = 0
+
+    @Param("false", "true")
+    var solved: Boolean = false
+
+    lateinit var instance: Instance
+    lateinit var solver: Solver
+
+    @Setup(Level.Trial)
+    fun generate() {
+        instance = randomKSat(n, 3, 2.0)
+    }
+
+    @Setup(Level.Invocation)
+    fun setup() {
+        solver = backend.create()
+        instance.addTo(solver)
+        if (solved) solver.solve()
+    }
+
+    @TearDown(Level.Invocation)
+    fun teardown() {
+        solver.close()
+    }
+
+    @Benchmark
+    fun reset() {
+        solver.reset()
+    }
+
+    @Benchmark
+    fun close() {
+        solver.close()
+    }
+}
+
+/**
+ * Totalizer encoding, natively (JNI backends) or via [Solver.addClause] (others), by the number of inputs.
+ */
+@BenchmarkMode(Mode.SingleShotTime)
+@Warmup(iterations = 10)
+@Measurement(iterations = 20)
+@Fork(1)
+@OutputTimeUnit(TimeUnit.MILLISECONDS)
+@State(Scope.Thread)
+open class Bench_totalizer {
+    @Param
+    lateinit var backend: Backend
+
+    @Param("10", "100", "1000")
+    var inputs: Int = 0
+
+    lateinit var solver: Solver
+    lateinit var literals: List<Int>
+
+    @Setup(Level.Invocation)
+    fun setup() {
+        solver = backend.create()
+        literals = List(inputs) { solver.newLiteral() }
+    }
+
+    @TearDown(Level.Invocation)
+    fun teardown() {
+        solver.close()
+    }
+
+    @Benchmark
+    fun declareTotalizer(bh: Blackhole) {
+        bh.consume(solver.declareTotalizer(literals))
+    }
+}
+
+/**
+ * Parallel solving by CaDiCaL solvers connected by the clause sharing bus, by the round length
+ * (the rounds also end early once enough shared clauses are pending, see [JCadicalShare.solve]).
+ */
+@BenchmarkMode(Mode.SingleShotTime)
+@Warmup(iterations = 3)
+@Measurement(iterations = 10)
+@Fork(1)
+@OutputTimeUnit(TimeUnit.MILLISECONDS)
+@State(Scope.Thread)
+open class Bench_share {
+    @Param("PIGEONHOLE:9", "RANDOM_3SAT:300")
+    lateinit var family: String
+
+    @Param("2", "4")
+    var solvers: Int = 0
+
+    @Param("1000", "3000", "10000", "30000")
+    var conflictsPerRound: Int = 0
+
+    lateinit var literals: IntArray
+    lateinit var backends: List<JCadical>
+    lateinit var bus: JCadicalShare
+
+    @Setup(Level.Trial)
+    fun generate() {
+        val (name, size) = family.split(":")
+        literals = Family.valueOf(name).generate(size.toInt()).toZeroTerminated()
+    }
+
+    @Setup(Level.Invocation)
+    fun setup() {
+        backends = JCadicalShare.diversified(solvers)
+        for (backend in backends) backend.addClauses(literals)
+        bus = JCadicalShare(backends)
+    }
+
+    @TearDown(Level.Invocation)
+    fun teardown() {
+        bus.close()
+        backends.forEach { it.close() }
+    }
+
+    @Benchmark
+    fun solve(): Boolean? {
+        return bus.solve(conflictsPerRound = conflictsPerRound)
+    }
+}
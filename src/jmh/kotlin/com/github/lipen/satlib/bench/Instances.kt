@@ -0,0 +1,128 @@
+package com.github.lipen.satlib.bench
+
+import com.github.lipen.satlib.solver.Solver
+import com.github.lipen.satlib.solver.addClause
+import kotlin.math.roundToInt
+import kotlin.random.Random
+
+/**
+ * Generated CNF, with literals in DIMACS convention (variables are `1..numberOfVariables`).
+ *
+ * All generators are deterministic (seeded), so the same parameters yield the same instance
+ * on every backend and in every run, making the results comparable across commits.
+ */
+class Instance(
+    val numberOfVariables: Int,
+    val clauses: List<IntArray>,
+) {
+    /** All clauses, zero-terminated, as expected by the bulk `addClauses` of the native solvers. */
+    fun toZeroTerminated(): IntArray {
+        val result = IntArray(clauses.sumOf { it.size + 1 })
+        var i = 0
+        for (clause in clauses) {
+            clause.copyInto(result, i)
+            i += clause.size + 1
+        }
+        return result
+    }
+
+    /** Declare the variables and add the clauses to the [solver]. */
+    fun addTo(solver: Solver) {
+        repeat(numberOfVariables) { solver.newLiteral() }
+        for (clause in clauses) {
+            solver.addClause(clause)
+        }
+    }
+}
+
+/**
+ * Families of generated instances, sized by a single parameter.
+ */
+enum class Family {
+    /** Random 3-SAT with [size] variables near the phase transition (`m/n = 4.2`). */
+    RANDOM_3SAT {
+        override fun generate(size: Int, seed: Int): Instance = randomKSat(size, 3, 4.2, seed)
+    },
+
+    /** Pigeonhole principle with [size] holes and `size+1` pigeons (UNSAT). */
+    PIGEONHOLE {
+        override fun generate(size: Int, seed: Int): Instance = pigeonhole(size)
+    },
+
+    /** [size] variables constrained by many overlapping "exactly `k` of a group" constraints. */
+    CARDINALITY {
+        override fun generate(size: Int, seed: Int): Instance = cardinalityHeavy(size, seed)
+    };
+
+    abstract fun generate(size: Int, seed: Int = 42): Instance
+}
+
+/**
+ * Random k-SAT with [n] variables and `ratio * n` clauses of [k] distinct variables.
+ */
+fun randomKSat(n: Int, k: Int, ratio: Double, seed: Int = 42): Instance {
+    require(k <= n) { "k = $k is too much for n = $n" }
+    val random = Random(seed)
+    val m = (n * ratio).roundToInt()
+    val clauses = List(m) {
+        val variables = generateSequence { random.nextInt(1, n + 1) }.distinct().take(k).toList()
+        IntArray(k) { i -> if (random.nextBoolean()) variables[i] else -variables[i] }
+    }
+    return Instance(n, clauses)
+}
+
+/**
+ * Pigeonhole principle: `holes+1` pigeons, each in some hole, no two in the same one.
+ */
+fun pigeonhole(holes: Int): Instance {
+    val pigeons = holes + 1
+    fun p(i: Int, j: Int): Int = i * holes + j + 1
+    val clauses = mutableListOf<IntArray>()
+    for (i in 0 until pigeons) {
+        clauses.add(IntArray(holes) { j -> p(i, j) })
+    }
+    for (j in 0 until holes) {
+        for (i1 in 0 until pigeons) {
+            for (i2 in i1 + 1 until pigeons) {
+                clauses.add(intArrayOf(-p(i1, j), -p(i2, j)))
+            }
+        }
+    }
+    return Instance(pigeons * holes, clauses)
+}
+
+/**
+ * [n] variables split into many random overlapping groups of 20,
+ * each constrained to have exactly 5 true variables via the sequential counter.
+ */
+fun cardinalityHeavy(n: Int, seed: Int = 42, groupSize: Int = 20, k: Int = 5): Instance {
+    require(groupSize <= n) { "groupSize = $groupSize is too much for n = $n" }
+    val random = Random(seed)
+    val clauses = mutableListOf<IntArray>()
+    var numberOfVariables = n
+    fun newVariable(): Int = ++numberOfVariables
+
+    // Sinz's sequential counter for `sum(xs) <= bound`
+    fun atMost(xs: List<Int>, bound: Int) {
+        val s = List(xs.size - 1) { IntArray(bound) { newVariable() } }
+        clauses.add(intArrayOf(-xs[0], s[0][0]))
+        for (j in 1 until bound) clauses.add(intArrayOf(-s[0][j]))
+        for (i in 1 until xs.size - 1) {
+            clauses.add(intArrayOf(-xs[i], s[i][0]))
+            clauses.add(intArrayOf(-s[i - 1][0], s[i][0]))
+            for (j in 1 until bound) {
+                clauses.add(intArrayOf(-xs[i], -s[i - 1][j - 1], s[i][j]))
+                clauses.add(intArrayOf(-s[i - 1][j], s[i][j]))
+            }
+            clauses.add(intArrayOf(-xs[i], -s[i - 1][bound - 1]))
+        }
+        clauses.add(intArrayOf(-xs.last(), -s[xs.size - 2][bound - 1]))
+    }
+
+    repeat(n / 2) {
+        val group = (1..n).shuffled(random).take(groupSize)
+        atMost(group, k)
+        atMost(group.map { -it }, groupSize - k)
+    }
+    return Instance(numberOfVariables, clauses)
+}
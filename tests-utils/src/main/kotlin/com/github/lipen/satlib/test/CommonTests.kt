@@ -2,10 +2,16 @@
 
 package com.github.lipen.satlib.test
 
+import com.github.lipen.satlib.card.CardinalityEncoder
+import com.github.lipen.satlib.jni.LimitedSolveResult
+import com.github.lipen.satlib.jni.SolveLimits
+import com.github.lipen.satlib.op.allProjectedSolutions
+import com.github.lipen.satlib.op.countSolutions
 import com.github.lipen.satlib.op.runWithTimeout
 import com.github.lipen.satlib.solver.Solver
 import com.github.lipen.satlib.solver.addClause
 import com.github.lipen.satlib.solver.solve
+import com.github.lipen.satlib.solver.solveAsync
 import org.amshove.kluent.`should be equal to`
 import org.amshove.kluent.`should be false`
 import org.amshove.kluent.`should be in`
@@ -21,6 +27,7 @@ fun Solver.`simple SAT`() {
     solve().`should be true`()
     getValue(x).`should be true`()
     getValue(y).`should be false`()
+    getValues(intArrayOf(x, -x, y, -y)).asList() `should be equal to` listOf(true, false, false, true)
     getModel().data `should be equal to` listOf(true, false)
 }
 
@@ -97,3 +104,127 @@ fun <S : Solver> S.`solving with timeout`(
         solve().`should be true`()
     }
 }
+
+fun <S : Solver> S.`solving with limits`(
+    kinds: Collection<SolveLimits.Kind>,
+    solveWithLimits: S.(SolveLimits) -> LimitedSolveResult,
+) {
+    declare_sgen_n120_sat()
+    // Note: the memory limit is process-wide and only supported on Linux and macOS
+    val os = System.getProperty("os.name").lowercase()
+    val memorySupported = "linux" in os || "mac" in os
+    for (kind in kinds) {
+        if (kind == SolveLimits.Kind.MEMORY && !memorySupported) continue
+        // Each of these limits is definitely exceeded long before the problem is solved
+        val limits = when (kind) {
+            SolveLimits.Kind.TIME -> SolveLimits(timeMillis = 1)
+            SolveLimits.Kind.CONFLICTS -> SolveLimits(conflicts = 1)
+            SolveLimits.Kind.PROPAGATIONS -> SolveLimits(propagations = 1)
+            SolveLimits.Kind.MEMORY -> SolveLimits(memoryBytes = 1)
+        }
+        solveWithLimits(limits) `should be equal to` LimitedSolveResult(value = null, limit = kind)
+    }
+}
+
+fun Solver.`many clauses`(n: Int = 100_000) {
+    val xs = List(n) { newLiteral() }
+
+    addClause(xs.first())
+    for ((a, b) in xs.zipWithNext()) {
+        addClause(-a, b)
+    }
+
+    numberOfClauses `should be equal to` n
+    solve().`should be true`()
+    getValue(xs.last()).`should be true`()
+    solve(-xs.last()).`should be false`()
+}
+
+fun Solver.`projected model enumeration`() {
+    run {
+        val x = newLiteral()
+        val y = newLiteral()
+        newLiteral() // free variable, not in the projection
+        addClause(x, y)
+        val models = allProjectedSolutions(intArrayOf(x, y), batchSize = 2).map { it.data }.toList()
+        models.size `should be equal to` 3
+        models.toSet() `should be equal to` setOf(
+            listOf(true, true),
+            listOf(true, false),
+            listOf(false, true),
+        )
+    }
+    reset()
+    run {
+        val x = newLiteral()
+        val y = newLiteral()
+        val z = newLiteral()
+        addClause(x, y)
+        addClause(-x, z)
+        // Note: `z` is implied by `x`, so minimization may drop it from blocking clauses
+        countSolutions(intArrayOf(x, y, z), minimize = true) `should be equal to` 4L
+        solve().`should be false`()
+    }
+}
+
+fun Solver.`async solving`() {
+    val x = newLiteral()
+    val y = newLiteral()
+    addClause(x, y)
+    addClause(-x)
+
+    val future = solveAsync()
+    // Assumptions are consumed by `solveAsync` right away
+    assumptions.size `should be equal to` 0
+    future.get().`should be true`()
+    getValue(y).`should be true`()
+
+    solveAsync(-y).get().`should be false`()
+    solveAsync().get().`should be true`()
+}
+
+fun Solver.`solver forking`() {
+    val x = newLiteral()
+    val y = newLiteral()
+    addClause(x, y)
+    solve().`should be true`()
+
+    fork().use { fork ->
+        fork.numberOfVariables `should be equal to` 2
+        fork.numberOfClauses `should be equal to` 1
+        fork.addClause(-x)
+        fork.solve().`should be true`()
+        fork.getValue(y).`should be true`()
+        fork.addClause(-y)
+        fork.solve().`should be false`()
+    }
+
+    // The original solver is not affected by the fork
+    addClause(-y)
+    solve().`should be true`()
+    getValue(x).`should be true`()
+}
+
+fun <S> S.`native cardinality encodings`() where S : Solver, S : CardinalityEncoder {
+    val xs = IntArray(5) { newLiteral() }
+    val outputs = listOf(
+        encodeTotalizer(xs),
+        encodeSequentialCounter(xs, bound = 4),
+        encodeSortingNetwork(xs),
+    )
+    val incremental = encodeIncrementalTotalizer(xs, bound = 2)
+    incremental.outputs.size `should be equal to` 2
+    incremental.extend(4)
+    incremental.outputs.size `should be equal to` 4
+    (numberOfVariables > xs.size).`should be true`()
+
+    for (out in outputs + listOf(incremental.outputs.toIntArray())) {
+        for (k in 0 until 4) {
+            // Exactly `k` literals are true: "at least k" and not "at least k+1"
+            val assumptions = listOfNotNull(out.getOrNull(k - 1), -out[k])
+            solve(assumptions).`should be true`()
+            getValues(xs).count { it } `should be equal to` k
+        }
+    }
+    incremental.close()
+}